@@ -24,7 +24,7 @@ in that dialog, select 'Libraries' in the combo box and add the
 \lib\win32 directory. That's it, with your IDE set up like this,
 you will now be able to develop applications with the Irrlicht Engine.
 */
-#include <irrlicht.h>
+#include <Irrlicht.h>
 
 /*
 In the Irrlicht Engine, everything can be found in the namespace 
@@ -60,13 +60,13 @@ to make it easy, we use a pragma comment lib:
 #pragma comment(lib, "Irrlicht.lib")
 
 /*
-This is the main method. We can use void main() on every platform.
+This is the main method. We can use int main() on every platform.
 On Windows platforms, we could also use the WinMain method
 if we would want to get rid of the console window, which pops up when
 starting a program with main(), but to keep this example simple,
 we use main().
 */
-void main()
+int main()
 {
 	/*
 	The most important function of the engine is the 'createDevice'
@@ -181,5 +181,7 @@ void main()
 	for more information.
 	*/
 	device->drop();
+
+	return 0;
 }
 
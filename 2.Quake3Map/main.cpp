@@ -1,6 +1,7 @@
 
-#include <irrlicht.h>
+#include <Irrlicht.h>
 #include <stdio.h>
+#include <wchar.h>
 
 using namespace irr;
 
@@ -25,7 +26,7 @@ public:
 Ok, lets start. Again, we use the main() method as start, not the
 WinMain(), because its shorter to write.
 */
-void main()
+int main()
 {
 	MyEventReceiver receiver;
 
@@ -61,7 +62,7 @@ void main()
 		if (lastFPS != fps)
 		{
 			wchar_t tmp[255];
-			swprintf(tmp, L"Quake 3 Map Example - Irrlicht Engine (fps:%d) Triangles:%d", 
+			swprintf(tmp, 255, L"Quake 3 Map Example - Irrlicht Engine (fps:%d) Triangles:%d", 
 				fps, driver->getPrimitiveCountDrawed());
 
 			device->setWindowCaption(tmp);
@@ -70,5 +71,7 @@ void main()
 	}
 
 	device->drop();
+
+	return 0;
 }
 
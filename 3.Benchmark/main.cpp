@@ -0,0 +1,472 @@
+/*
+This is the frame time benchmark of the Irrlicht Engine. It loads the same
+scenes as the HelloWorld and the Quake3Map examples, flies a recorded camera
+path through the Quake 3 level with the software driver and prints statistics 
+about the frame times, the triangle and the pixel throughput.
+
+The camera and the animated models are not driven by the wall clock. The
+clock of the device is switched to fixed step mode, so it advances by the
+same amount of time with every frame and every run renders exactly the
+same frames. This makes the results comparable between two versions of
+the engine.
+
+The benchmark runs on a headless device, so it needs no window and no
+graphics card. Parameters:
+
+	-width <pixels>    width of the back buffer, default 640
+	-height <pixels>   height of the back buffer, default 480
+	-step <ms>         simulated time between two frames, default 20
+	-warmup <frames>   frames rendered before measuring, default 10
+	-gate <ms>         if the p95 frame time is above this value, the
+	                   benchmark exits with 1. Useful for automatic
+	                   regression tests.
+	-trace <file>      enables the profiler of the engine and writes the
+	                   zones of the last measured frames into a file,
+	                   which can be viewed with chrome://tracing.
+	-stats <0|1>       if 1, prints the rasterizer counters of the 
+	                   software driver, averaged per frame.
+	-threads <count>   amount of threads rasterizing screen tiles, 
+	                   default 1 (no tiles), 0 for one per processor.
+	-bits <16|32>      color depth of the back buffer and the textures,
+	                   default 16.
+	-zbits <16|32>     precision of the z buffer, default 16.
+	-occlusion <0|1>   if 0, disables the occlusion culling of the
+	                   software driver, default 1.
+	-perspective <0|1> if 1, the software driver maps the textures
+	                   perspective correct, default 0.
+	-precombine <0|1>  if 1, the software driver samples the lightmaps
+	                   of the level at the vertices only, default 0.
+	-scaling <0|1>     if 1, flies the path with 1, 2, 4, 8 and 16
+	                   rasterizer threads and prints the frame times and
+	                   the speedup over one thread for each, in place of
+	                   the statistics of one flight. -threads and -gate
+	                   are ignored. The speedup is only meaningful on a
+	                   processor with at least as many cores.
+*/
+#include <Irrlicht.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+using namespace irr;
+
+#pragma comment(lib, "Irrlicht.lib")
+
+
+/*
+The engine timer only has a resolution of milliseconds, which is too coarse
+for measuring single frames. So we use the best timer of the platform.
+*/
+f64 getPreciseTime()
+{
+#ifdef WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (f64)counter.QuadPart * 1000.0 / (f64)frequency.QuadPart;
+#else
+	timeval tv;
+	gettimeofday(&tv, 0);
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+#endif
+}
+
+
+//! returns the amount of processors, printed with the thread scaling
+s32 getProcessorCount()
+{
+#ifdef WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (s32)info.dwNumberOfProcessors;
+#else
+	return (s32)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+
+/*
+The recorded camera path. Every key is reached after KEY_TIME milliseconds
+of simulated time, between the keys the camera position and target are
+interpolated linearly. The path starts and ends at the same position in the
+middle of the level, where the Quake3Map example starts.
+*/
+struct SCameraKey
+{
+	f32 PosX, PosY, PosZ;
+	f32 TargetX, TargetY, TargetZ;
+};
+
+const SCameraKey CameraPath[] =
+{
+	{    0.0f,  30.0f,    0.0f,    300.0f,  30.0f,  200.0f },
+	{  300.0f,  30.0f,  200.0f,    500.0f,  60.0f, -200.0f },
+	{  500.0f,  60.0f, -200.0f,    100.0f, 100.0f, -500.0f },
+	{  100.0f, 100.0f, -500.0f,   -400.0f,  60.0f, -300.0f },
+	{ -400.0f,  60.0f, -300.0f,   -600.0f,  30.0f,  200.0f },
+	{ -600.0f,  30.0f,  200.0f,   -200.0f,  30.0f,  500.0f },
+	{ -200.0f,  30.0f,  500.0f,      0.0f,  30.0f,    0.0f },
+	{    0.0f,  30.0f,    0.0f,    300.0f,  30.0f,  200.0f }
+};
+
+const s32 CAMERA_KEY_COUNT = sizeof(CameraPath) / sizeof(SCameraKey);
+const u32 KEY_TIME = 2000;
+
+
+//! places the camera at the position of the path at the simulated time
+void animateCamera(scene::ICameraSceneNode* camera, u32 timeMs)
+{
+	s32 key = timeMs / KEY_TIME;
+	if (key >= CAMERA_KEY_COUNT-1)
+		key = CAMERA_KEY_COUNT-2;
+
+	f32 t = (f32)(timeMs - key * KEY_TIME) / (f32)KEY_TIME;
+	if (t > 1.0f)
+		t = 1.0f;
+
+	const SCameraKey& a = CameraPath[key];
+	const SCameraKey& b = CameraPath[key+1];
+
+	camera->setRelativePosition(core::vector3df(
+		a.PosX + (b.PosX - a.PosX) * t,
+		a.PosY + (b.PosY - a.PosY) * t,
+		a.PosZ + (b.PosZ - a.PosZ) * t));
+
+	camera->setTarget(core::vector3df(
+		a.TargetX + (b.TargetX - a.TargetX) * t,
+		a.TargetY + (b.TargetY - a.TargetY) * t,
+		a.TargetZ + (b.TargetZ - a.TargetZ) * t));
+}
+
+
+//! returns a percentile out of a sorted array
+f64 getPercentile(const core::array<f64>& sorted, s32 percent)
+{
+	if (sorted.empty())
+		return 0.0;
+
+	return sorted[(sorted.size()-1) * percent / 100];
+}
+
+
+//! the measurements of one flight along the camera path
+struct SPathResults
+{
+	core::array<f64> FrameTimes;	// sorted
+	f64 TotalTime;
+	f64 Triangles;
+	f64 Pixels;
+	video::SRasterizerStatistics Statistics;
+};
+
+
+/*
+Renders the path. The first frames are not measured, they only
+fill the caches, the clock is paused while they are rendered.
+*/
+void renderPath(IHeadlessDevice* device, scene::ICameraSceneNode* camera,
+	u32 timeStep, s32 warmup, SPathResults& results)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+
+	timer->setMode(ETM_PAUSED);
+	timer->setTime(0);
+
+	const u32 pathTime = (CAMERA_KEY_COUNT-1) * KEY_TIME;
+	const s32 frameCount = pathTime / timeStep;
+
+	results.FrameTimes.clear();
+	results.TotalTime = 0.0;
+	results.Triangles = 0.0;
+	results.Pixels = 0.0;
+	results.Statistics.reset();
+
+	for (s32 frame=-warmup; frame<frameCount && device->run(); ++frame)
+	{
+		if (!frame)
+		{
+			timer->setFixedStep(timeStep);
+			timer->setMode(ETM_FIXED_STEP);
+		}
+
+		animateCamera(camera, timer->getTime());
+
+		f64 start = getPreciseTime();
+
+		driver->beginScene(true, true, video::Color(0,100,100,100));
+		smgr->drawAll();
+		driver->endScene();
+
+		f64 time = getPreciseTime() - start;
+
+		if (frame < 0)
+			continue;
+
+		results.FrameTimes.push_back(time);
+		results.TotalTime += time;
+		results.Triangles += driver->getPrimitiveCountDrawed();
+
+		if (driver->getRasterizerStatistics())
+		{
+			results.Pixels += driver->getRasterizerStatistics()->PixelsWritten;
+			results.Statistics.add(*driver->getRasterizerStatistics());
+		}
+	}
+
+	results.FrameTimes.sort();
+}
+
+
+//! the amounts of threads compared by -scaling 1
+const s32 ScalingThreads[] = { 1, 2, 4, 8, 16 };
+const s32 SCALING_RUNS = sizeof(ScalingThreads) / sizeof(s32);
+
+
+int main(int argc, char* argv[])
+{
+	s32 width = 640;
+	s32 height = 480;
+	u32 timeStep = 20;
+	s32 warmup = 10;
+	f64 gate = 0.0;
+	const c8* traceFile = 0;
+	bool printStatistics = false;
+	s32 threads = 1;
+	u32 bits = 16;
+	u32 zbits = 16;
+	bool occlusion = true;
+	bool perspective = false;
+	bool precombine = false;
+	bool scaling = false;
+
+	for (s32 i=1; i<argc-1; i+=2)
+	{
+		if (!strcmp(argv[i], "-width"))
+			width = atoi(argv[i+1]);
+		else
+		if (!strcmp(argv[i], "-height"))
+			height = atoi(argv[i+1]);
+		else
+		if (!strcmp(argv[i], "-step"))
+			timeStep = atoi(argv[i+1]);
+		else
+		if (!strcmp(argv[i], "-warmup"))
+			warmup = atoi(argv[i+1]);
+		else
+		if (!strcmp(argv[i], "-gate"))
+			gate = atof(argv[i+1]);
+		else
+		if (!strcmp(argv[i], "-trace"))
+			traceFile = argv[i+1];
+		else
+		if (!strcmp(argv[i], "-stats"))
+			printStatistics = atoi(argv[i+1]) != 0;
+		else
+		if (!strcmp(argv[i], "-threads"))
+			threads = atoi(argv[i+1]);
+		else
+		if (!strcmp(argv[i], "-bits"))
+			bits = atoi(argv[i+1]);
+		else
+		if (!strcmp(argv[i], "-zbits"))
+			zbits = atoi(argv[i+1]);
+		else
+		if (!strcmp(argv[i], "-occlusion"))
+			occlusion = atoi(argv[i+1]) != 0;
+		else
+		if (!strcmp(argv[i], "-perspective"))
+			perspective = atoi(argv[i+1]) != 0;
+		else
+		if (!strcmp(argv[i], "-precombine"))
+			precombine = atoi(argv[i+1]) != 0;
+		else
+		if (!strcmp(argv[i], "-scaling"))
+			scaling = atoi(argv[i+1]) != 0;
+	}
+
+	if (width <= 0 || height <= 0 || !timeStep || (bits != 16 && bits != 32) ||
+		(zbits != 16 && zbits != 32))
+	{
+		printf("Invalid parameters.\n");
+		return 1;
+	}
+
+	IHeadlessDevice* device =
+		createHeadlessDevice(video::DT_SOFTWARE, core::dimension2d<s32>(width, height), 0, 0, bits);
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+
+	// the clock stands still until the measured frames begin
+
+	timer->setMode(ETM_PAUSED);
+	timer->setTime(0);
+
+	if (traceFile)
+		device->getProfiler()->setEnabled(true);
+
+	// the counters are always collected, the pixel throughput is taken
+	// from the amount of pixels the rasterizers really have written.
+	driver->setRasterizerStatisticsEnabled(true);
+	driver->setRasterizerThreads(threads);
+	driver->setZBufferFormat(zbits == 32 ? video::EZF_32BIT : video::EZF_16BIT);
+	driver->setOcclusionCullingEnabled(occlusion);
+	driver->setPerspectiveCorrection(perspective);
+	driver->setLightmapsPrecombined(precombine);
+
+	/*
+	Load the Quake 3 level like the Quake3Map example does, and
+	put the two models of the HelloWorld example into it.
+	*/
+	device->getFileSystem()->addZipFileArchive("../media/map-20kdm2.pk3");
+
+	scene::IAnimatedMesh* mesh = smgr->getMesh("20kdm2.bsp");
+	scene::ISceneNode* node = 0;
+
+	if (mesh)
+		node = smgr->addOctTreeSceneNode(mesh->getMesh(0));
+
+	if (!node)
+	{
+		printf("Could not load the Quake 3 level.\n");
+		device->drop();
+		return 1;
+	}
+
+	node->setRelativePosition(core::vector3df(-1300,-144,-1249));
+
+	scene::IAnimatedMeshSceneNode* model =
+		smgr->addAnimatedMeshSceneNode(smgr->getMesh("../media/sydney.md2"),
+			0, -1, core::vector3df(300,-20,200));
+
+	if (model)
+	{
+		model->setMaterialFlag(video::EMF_LIGHTING, false);
+		model->setFrameLoop(0, 310);
+		model->setMaterialTexture(0, driver->getTexture("../media/sydney.BMP"));
+	}
+
+	model = smgr->addAnimatedMeshSceneNode(smgr->getMesh("../media/faerie.md2"),
+			0, -1, core::vector3df(-400,-20,-300));
+
+	if (model)
+	{
+		model->setMaterialFlag(video::EMF_LIGHTING, false);
+		model->setMaterialTexture(0, driver->getTexture("../media/faerie2.bmp"));
+	}
+
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode();
+
+	/*
+	Fly along the path, once per amount of threads when measuring the
+	scaling of the tile rasterizer.
+	*/
+	const s32 runCount = scaling ? SCALING_RUNS : 1;
+	SPathResults results[SCALING_RUNS];
+
+	for (s32 run=0; run<runCount; ++run)
+	{
+		if (scaling)
+			driver->setRasterizerThreads(ScalingThreads[run]);
+
+		renderPath(device, camera, timeStep, warmup, results[run]);
+	}
+
+	if (traceFile && !device->getProfiler()->writeChromeTrace(traceFile))
+		printf("Could not write the trace file %s.\n", traceFile);
+
+	device->drop();
+
+	/*
+	Print the results.
+	*/
+	for (s32 run=0; run<runCount; ++run)
+		if (results[run].FrameTimes.empty() || results[run].TotalTime <= 0.0)
+		{
+			printf("No frames were measured.\n");
+			return 1;
+		}
+
+	printf("Irrlicht Engine frame time benchmark\n");
+	printf("resolution:    %dx%d\n", width, height);
+	if (scaling)
+		printf("processors:    %d\n", getProcessorCount());
+	else
+		printf("threads:       %d\n", threads);
+	printf("bits:          %d\n", bits);
+	printf("z bits:        %d\n", zbits);
+	printf("occlusion:     %s\n", occlusion ? "on" : "off");
+	printf("perspective:   %s\n", perspective ? "on" : "off");
+	printf("lightmaps:     %s\n", precombine ? "precombined" : "per pixel");
+	printf("frames:        %d (%u ms simulated time step)\n", results[0].FrameTimes.size(), timeStep);
+
+	if (scaling)
+	{
+		const f64 singleMean = results[0].TotalTime / results[0].FrameTimes.size();
+
+		printf("threads     mean ms      p95 ms    speedup\n");
+
+		for (s32 run=0; run<runCount; ++run)
+		{
+			f64 mean = results[run].TotalTime / results[run].FrameTimes.size();
+
+			printf("%7d %11.3f %11.3f %10.2f\n", ScalingThreads[run], mean,
+				getPercentile(results[run].FrameTimes, 95), singleMean / mean);
+		}
+
+		return 0;
+	}
+
+	const core::array<f64>& frameTimes = results[0].FrameTimes;
+	const f64 totalTime = results[0].TotalTime;
+	const f64 pixels = results[0].Pixels;
+	const video::SRasterizerStatistics& statistics = results[0].Statistics;
+	f64 p95 = getPercentile(frameTimes, 95);
+
+	printf("min:           %.3f ms\n", frameTimes[0]);
+	printf("mean:          %.3f ms\n", totalTime / frameTimes.size());
+	printf("p50:           %.3f ms\n", getPercentile(frameTimes, 50));
+	printf("p95:           %.3f ms\n", p95);
+	printf("p99:           %.3f ms\n", getPercentile(frameTimes, 99));
+	printf("max:           %.3f ms\n", frameTimes[frameTimes.size()-1]);
+	printf("triangles/s:   %.0f\n", results[0].Triangles * 1000.0 / totalTime);
+	printf("pixels/s:      %.0f\n", pixels * 1000.0 / totalTime);
+
+	if (printStatistics)
+	{
+		f64 frames = (f64)frameTimes.size();
+
+		printf("per frame:\n");
+		printf("  triangles:        %.0f\n", statistics.Triangles / frames);
+		printf("  back face culled: %.0f\n", statistics.BackFaceCulled / frames);
+		printf("  near plane culled:%.0f\n", statistics.NearPlaneCulled / frames);
+		printf("  viewport culled:  %.0f\n", statistics.ViewPortCulled / frames);
+		printf("  degenerate:       %.0f\n", statistics.DegenerateCulled / frames);
+		printf("  clipped:          %.0f\n", statistics.Clipped / frames);
+		printf("  hi-z culled:      %.0f\n", statistics.HiZCulled / frames);
+		printf("  spans:            %.0f\n", statistics.SpansTested / frames);
+		printf("  pixels tested:    %.0f\n", statistics.PixelsTested / frames);
+		printf("  z-test failed:    %.0f\n", statistics.ZTestFailed / frames);
+		printf("  pixels written:   %.0f\n", pixels / frames);
+		printf("  overdraw:         %.2f\n", pixels / (frames * width * height));
+	}
+
+	if (gate > 0.0 && p95 > gate)
+	{
+		printf("FAILED: p95 frame time %.3f ms is above %.3f ms.\n", p95, gate);
+		return 1;
+	}
+
+	return 0;
+}
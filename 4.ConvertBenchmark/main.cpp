@@ -0,0 +1,243 @@
+/*
+This is the micro benchmark of the color conversions of the Irrlicht Engine.
+The image loaders convert every image they load with CColorConverter, which
+converts the images row by row with kernels for the instruction sets of the
+processor, like the span kernels of the software driver. The benchmark
+converts the same image with the row functions of every instruction set the
+processor supports, prints how many pixels per second each of them converts
+and checks that they all calculate the same pixels as the scalar ones.
+
+The benchmark is built from the sources of the color converter, it does not
+need the engine. Parameters:
+
+	-width <pixels>    width of the converted image, default 1024
+	-height <pixels>   height of the converted image, default 1024
+	-repeat <count>    conversions of the image per measurement, default 10
+*/
+#include "CColorConverter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+using namespace irr;
+using namespace video;
+
+
+//! returns the time in milliseconds, with the best timer of the platform
+f64 getPreciseTime()
+{
+#ifdef WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (f64)counter.QuadPart * 1000.0 / (f64)frequency.QuadPart;
+#else
+	timeval tv;
+	gettimeofday(&tv, 0);
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+#endif
+}
+
+
+/*
+The measured conversions. Every one of them converts the rows of the source
+image into the target image with one row function.
+*/
+enum ECONVERSION
+{
+	EC_24_TO_32 = 0,
+	EC_24_TO_16,
+	EC_24_TO_16_DITHERED,
+	EC_32_TO_32,
+	EC_32_TO_16,
+	EC_32_TO_16_DITHERED,
+	EC_16_TO_32,
+	EC_8_TO_16,
+	EC_8_TO_32,
+	EC_MIRROR_16,
+	EC_MIRROR_32,
+	EC_COUNT
+};
+
+const c8* const ConversionNames[EC_COUNT] =
+{
+	"R8G8B8 to X8R8G8B8",
+	"R8G8B8 to R5G5B5",
+	"R8G8B8 to R5G5B5, dithered",
+	"R8G8B8A8 to A8R8G8B8",
+	"A8R8G8B8 to A1R5G5B5",
+	"A8R8G8B8 to A1R5G5B5, dithered",
+	"A1R5G5B5 to A8R8G8B8",
+	"8 bit palette to R5G5B5",
+	"8 bit palette to X8R8G8B8",
+	"mirror 16 bit",
+	"mirror 32 bit"
+};
+
+
+//! converts all rows of the source into the target
+void convert(const SConvertKernels* kernels, s32 conversion, const u8* source,
+	void* target, const s32* palette, s32 width, s32 height)
+{
+	s16* target16 = (s16*)target;
+	s32* target32 = (s32*)target;
+
+	for (s32 y=0; y<height; ++y)
+	{
+		switch(conversion)
+		{
+		case EC_24_TO_32:
+			kernels->Convert24To32(source + y*width*3, target32 + y*width, width, true);
+			break;
+		case EC_24_TO_16:
+		case EC_24_TO_16_DITHERED:
+			kernels->Convert24To16(source + y*width*3, target16 + y*width, width, true,
+				conversion == EC_24_TO_16_DITHERED ? getDitherRow(y) : 0);
+			break;
+		case EC_32_TO_32:
+			kernels->Convert32To32(source + y*width*4, target32 + y*width, width, true, true);
+			break;
+		case EC_32_TO_16:
+		case EC_32_TO_16_DITHERED:
+			kernels->Convert32To16(source + y*width*4, target16 + y*width, width, false, true,
+				conversion == EC_32_TO_16_DITHERED ? getDitherRow(y) : 0);
+			break;
+		case EC_16_TO_32:
+			kernels->Convert16To32((const s16*)source + y*width, target32 + y*width, width);
+			break;
+		case EC_8_TO_16:
+			kernels->Lookup8To16(source + y*width, target16 + y*width, width, palette);
+			break;
+		case EC_8_TO_32:
+			kernels->Lookup8To32(source + y*width, target32 + y*width, width, palette);
+			break;
+		case EC_MIRROR_16:
+			kernels->ReverseRow16(target16 + y*width, width);
+			break;
+		case EC_MIRROR_32:
+			kernels->ReverseRow32(target32 + y*width, width);
+			break;
+		}
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	s32 width = 1024;
+	s32 height = 1024;
+	s32 repeat = 10;
+
+	for (s32 i=1; i<argc-1; i+=2)
+	{
+		if (!strcmp(argv[i], "-width"))
+			width = atoi(argv[i+1]);
+		else
+		if (!strcmp(argv[i], "-height"))
+			height = atoi(argv[i+1]);
+		else
+		if (!strcmp(argv[i], "-repeat"))
+			repeat = atoi(argv[i+1]);
+	}
+
+	if (width <= 0 || height <= 0 || repeat <= 0)
+	{
+		printf("Invalid parameters.\n");
+		return 1;
+	}
+
+	/*
+	The source has random pixels, the palette holds colors for both the 16
+	and the 32 bit lookups, which are only compared with themselves.
+	*/
+	const s32 pixels = width * height;
+	u8* source = new u8[pixels * 4];
+	u8* reference = new u8[pixels * 4];
+	u8* target = new u8[pixels * 4];
+	s32 palette[256];
+
+	srand(1);
+	for (s32 i=0; i<pixels*4; ++i)
+		source[i] = (u8)rand();
+
+	for (s32 i=0; i<256; ++i)
+		palette[i] = (s16)((rand() << 8) ^ rand());
+
+	printf("Irrlicht Engine color conversion benchmark\n");
+	printf("image: %dx%d, %d conversions per measurement\n", width, height, repeat);
+	printf("%-32s", "Mpixels/s");
+
+	for (s32 set=0; set<ESKS_COUNT; ++set)
+	{
+		const SConvertKernels* kernels = getConvertKernels((ESpanKernelSet)set);
+		if (kernels)
+			printf("%18s", kernels->Name);
+	}
+
+	printf("\n");
+
+	bool failed = false;
+
+	for (s32 conversion=0; conversion<EC_COUNT; ++conversion)
+	{
+		printf("%-32s", ConversionNames[conversion]);
+		f64 scalarTime = 0.0;
+
+		for (s32 set=0; set<ESKS_COUNT; ++set)
+		{
+			const SConvertKernels* kernels = getConvertKernels((ESpanKernelSet)set);
+			if (!kernels)
+				continue;
+
+			// the mirrors reverse the target in place, once per repetition
+			memcpy(target, source, pixels * 4);
+
+			f64 start = getPreciseTime();
+
+			for (s32 r=0; r<repeat; ++r)
+				convert(kernels, conversion, source, target, palette, width, height);
+
+			f64 time = getPreciseTime() - start;
+
+			if (set == ESKS_SCALAR)
+			{
+				scalarTime = time;
+				memcpy(reference, target, pixels * 4);
+				printf("%18.1f", pixels * (f64)repeat / (time * 1000.0));
+			}
+			else
+			{
+				if (memcmp(reference, target, pixels * 4))
+				{
+					printf("%18s", "DIFFERENT");
+					failed = true;
+					continue;
+				}
+
+				printf("%10.1f (x%4.1f)", pixels * (f64)repeat / (time * 1000.0),
+					time > 0.0 ? scalarTime / time : 0.0);
+			}
+		}
+
+		printf("\n");
+	}
+
+	delete [] target;
+	delete [] reference;
+	delete [] source;
+
+	if (failed)
+	{
+		printf("FAILED: some kernels calculate other pixels than the scalar ones.\n");
+		return 1;
+	}
+
+	return 0;
+}
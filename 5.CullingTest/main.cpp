@@ -0,0 +1,133 @@
+/*
+This is a test of the visibility culling of the scene manager. Before the
+scene manager renders a node, it tests the bounding box of the node against
+the view frustum and the occlusion buffer of the software driver. A node
+which is added to a running scene has to be drawn in the first frame it is
+part of, even if its origin is outside of the screen, which it only is if
+its box is valid before the node is rendered for the first time.
+
+The test renders one frame of an empty scene on a headless device, adds
+the sydney model as an animated and as a static mesh, renders a second
+frame and counts the pixels which are not the background. It does this with
+the occlusion culling disabled and enabled, and exits with 1 if the model
+is missing or if the two counts differ.
+
+The test loads its media from ../media, so it has to be started from its
+own directory.
+*/
+#include <Irrlicht.h>
+#include <stdio.h>
+
+using namespace irr;
+
+#pragma comment(lib, "Irrlicht.lib")
+
+
+const s32 Width = 320;
+const s32 Height = 240;
+
+
+//! returns how many pixels of the last frame are not the background
+s32 countDrawnPixels(IHeadlessDevice* device)
+{
+	const s16* frame = (const s16*)device->getFrame(0);
+	if (!frame)
+		return 0;
+
+	const s16 background = frame[0];
+	s32 count = 0;
+
+	for (s32 i=0; i<Width*Height; ++i)
+		if (frame[i] != background)
+			++count;
+
+	return count;
+}
+
+
+//! renders one frame of the scene
+void drawFrame(IHeadlessDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	device->run();
+	driver->beginScene(true, true, video::Color(0,100,100,100));
+	device->getSceneManager()->drawAll();
+	driver->endScene();
+}
+
+
+/*
+Renders an empty frame, adds the model and returns the pixels drawn in the
+next frame. The camera looks at the body of the model, so the origin of the
+model, at its feet, is below the screen.
+*/
+s32 drawAddedModel(bool occlusion, bool animated)
+{
+	IHeadlessDevice* device = createHeadlessDevice(video::DT_SOFTWARE,
+		core::dimension2d<s32>(Width, Height));
+
+	if (!device)
+		return 0;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+
+	driver->setOcclusionCullingEnabled(occlusion);
+	smgr->addCameraSceneNode(0, core::vector3df(0,20,-40), core::vector3df(0,40,0));
+
+	drawFrame(device);
+
+	scene::IAnimatedMesh* mesh = smgr->getMesh("../media/sydney.md2");
+	scene::ISceneNode* node = 0;
+
+	if (mesh)
+	{
+		if (animated)
+			node = smgr->addAnimatedMeshSceneNode(mesh);
+		else
+			node = smgr->addMeshSceneNode(mesh->getMesh(0));
+	}
+
+	s32 pixels = 0;
+
+	if (node)
+	{
+		node->setMaterialFlag(video::EMF_LIGHTING, false);
+		node->setMaterialTexture(0, driver->getTexture("../media/sydney.BMP"));
+
+		drawFrame(device);
+		pixels = countDrawnPixels(device);
+	}
+
+	device->drop();
+	return pixels;
+}
+
+
+int main()
+{
+	printf("Irrlicht Engine culling test\n");
+
+	bool failed = false;
+
+	for (s32 animated=0; animated<2; ++animated)
+	{
+		s32 withoutOcclusion = drawAddedModel(false, animated != 0);
+		s32 withOcclusion = drawAddedModel(true, animated != 0);
+
+		printf("%-14s pixels without occlusion culling: %6d, with: %6d\n",
+			animated ? "animated mesh:" : "static mesh:", withoutOcclusion, withOcclusion);
+
+		if (!withoutOcclusion || withoutOcclusion != withOcclusion)
+			failed = true;
+	}
+
+	if (failed)
+	{
+		printf("FAILED: the model was culled in the first frame it was part of the scene.\n");
+		return 1;
+	}
+
+	return 0;
+}
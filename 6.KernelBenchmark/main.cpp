@@ -0,0 +1,780 @@
+/*
+This is the micro benchmark of the kernels of the software driver. The
+triangle renderers draw their spans, the surfaces draw their rows in 2d and
+the surface scaler scales them with kernels for the instruction sets of the
+processor. The benchmark draws the same random spans and rows with the
+kernels of every instruction set the processor supports, prints how many
+pixels per second each of them draws and checks that they all write the
+same pixels as the scalar ones, like the color conversion benchmark does
+for the color converter.
+
+All 256 feature combinations of the span kernels are checked for every
+color and z buffer format, but only the most common ones are measured and
+printed. The benchmark exits with 1 if any kernel writes other pixels than
+the scalar one.
+
+The benchmark is built from the sources of the kernels, it does not need
+the engine. Parameters:
+
+	-rows <count>      spans or rows drawn per measurement, default 1024
+	-repeat <count>    drawings of all rows per measurement, default 100
+*/
+#include "CTRSpanKernels.h"
+#include "CBlitKernels.h"
+#include "CSurfaceScaler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+using namespace irr;
+using namespace video;
+
+
+//! returns the time in milliseconds, with the best timer of the platform
+f64 getPreciseTime()
+{
+#ifdef WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (f64)counter.QuadPart * 1000.0 / (f64)frequency.QuadPart;
+#else
+	timeval tv;
+	gettimeofday(&tv, 0);
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+#endif
+}
+
+
+//! returns 32 random bits, rand() returns only 15 on some platforms
+u32 getRandom()
+{
+	return ((u32)rand() << 30) ^ ((u32)rand() << 15) ^ (u32)rand();
+}
+
+
+//! returns a random number from 0 to range-1
+s32 getRandom(s32 range)
+{
+	return (s32)(getRandom() % (u32)range);
+}
+
+
+//! sets a value which is interpolated from a random start to a random end
+//! in 0 to range-1 over count pixels, like the triangle renderers do.
+void setRandomRamp(s32 range, s32 count, s32& value, s32& step)
+{
+	value = getRandom(range);
+	step = (getRandom(range) - value) / (count ? count : 1);
+}
+
+
+/*
+Every span or row starts at up to ROW_OFFSETS pixels into its own row of
+the target and is at most MAX_ROW_PIXELS long, so the vector kernels start
+and end at every alignment. The rows are never drawn over each other, so
+every pixel a kernel writes differently shows up in the comparison.
+*/
+const s32 ROW_OFFSETS = 16;
+const s32 MAX_ROW_PIXELS = 64;
+const s32 ROW_PITCH = ROW_OFFSETS + MAX_ROW_PIXELS + 16;
+
+
+/*
+A measured operation. Every kernel set draws the operation into the target,
+always starting with the same random content, and the scalar one writes
+the reference the others are compared with.
+*/
+struct SKernelTest
+{
+	SKernelTest() : Target(0), Initial(0), Reference(0), TargetSize(0) {}
+
+	~SKernelTest()
+	{
+		delete [] Target;
+		delete [] Initial;
+		delete [] Reference;
+	}
+
+	//! allocates a target with random content
+	void createTarget(s32 size)
+	{
+		TargetSize = size;
+		Target = new u8[size];
+		Initial = new u8[size];
+		Reference = new u8[size];
+
+		for (s32 i=0; i<size; ++i)
+			Initial[i] = (u8)getRandom();
+	}
+
+	u8* Target;
+	u8* Initial;
+	u8* Reference;
+	s32 TargetSize;
+};
+
+
+//! prints the column titles of a table, one column per supported set
+template <class T>
+void printHeader(T& test, const c8* title)
+{
+	printf("\n%-32s", title);
+
+	for (s32 set=0; set<ESKS_COUNT; ++set)
+	{
+		const typename T::SKernels* kernels = test.getKernels((ESpanKernelSet)set);
+		if (kernels)
+			printf("%18s", kernels->Name);
+	}
+
+	printf("\n");
+}
+
+
+//! draws an operation of a test with the kernels of every set the processor
+//! supports and compares the targets with the one of the scalar kernels.
+//! \param name: Name of the row of the table, or 0 to only check the kernels.
+//! \return Returns false if a set wrote other pixels than the scalar one.
+template <class T>
+bool measure(T& test, s32 operation, s32 repeat, const c8* name)
+{
+	bool equal = true;
+	f64 scalarTime = 0.0;
+
+	if (name)
+		printf("%-32s", name);
+
+	for (s32 set=0; set<ESKS_COUNT; ++set)
+	{
+		const typename T::SKernels* kernels = test.getKernels((ESpanKernelSet)set);
+		if (!kernels)
+			continue;
+
+		f64 pixels = 0.0;
+		f64 time = 0.0;
+
+		// every drawing starts with the same target, else the spans
+		// would fail the z test from the second drawing on
+		for (s32 r=0; r<repeat; ++r)
+		{
+			memcpy(test.Target, test.Initial, test.TargetSize);
+
+			f64 start = getPreciseTime();
+			pixels += test.draw(kernels, operation);
+			time += getPreciseTime() - start;
+		}
+
+		f64 rate = time > 0.0 ? pixels / (time * 1000.0) : 0.0;
+
+		if (set == ESKS_SCALAR)
+		{
+			scalarTime = time;
+			memcpy(test.Reference, test.Target, test.TargetSize);
+
+			if (name)
+				printf("%18.1f", rate);
+		}
+		else
+		{
+			if (memcmp(test.Reference, test.Target, test.TargetSize))
+			{
+				if (name)
+					printf("%18s", "DIFFERENT");
+
+				equal = false;
+				continue;
+			}
+
+			if (name)
+				printf("%10.1f (x%4.1f)", rate, time > 0.0 ? scalarTime / time : 0.0);
+		}
+	}
+
+	if (name)
+		printf("\n");
+
+	return equal;
+}
+
+
+
+/*
+The spans of the triangle renderers. P is the pixel type of the color
+format, Z the one of the z buffer format. The target holds the pixels, the
+z values and the amount of pixels written by every span.
+*/
+const s32 TEXTURE_WIDTH = 256;
+const s32 TEXTURE_HEIGHT = 128;
+const s32 LIGHTMAP_WIDTH = 64;
+const s32 LIGHTMAP_HEIGHT = 32;
+
+template <class P, class Z>
+struct SSpanTest : public SKernelTest
+{
+	typedef SSpanKernels SKernels;
+
+	SSpanTest(ECOLOR_FORMAT format, E_ZBUFFER_FORMAT zFormat, s32 rows)
+		: Format(format), ZFormat(zFormat), Rows(rows)
+	{
+		createTarget(Rows * ROW_PITCH * (sizeof(P) + sizeof(Z)) + Rows * sizeof(s32));
+
+		P* pixels = (P*)Target;
+		Z* zValues = (Z*)(pixels + Rows * ROW_PITCH);
+		Written = (s32*)(zValues + Rows * ROW_PITCH);
+
+		// the textures are used directly, as indices into the palette
+		// or stored in tiles of 4x4 texels, the z values have the range
+		// of the z buffer format.
+		for (s32 i=0; i<TEXTURE_WIDTH*TEXTURE_HEIGHT; ++i)
+		{
+			Texture[i] = (P)getRandom();
+			Indices[i] = (u8)getRandom();
+		}
+
+		for (s32 i=0; i<256; ++i)
+			Palette[i] = (P)getRandom();
+
+		Z* initialZValues = (Z*)(Initial + ((u8*)zValues - Target));
+
+		for (s32 i=0; i<Rows*ROW_PITCH; ++i)
+			initialZValues[i] = (Z)getRandomZ();
+
+		const s32 colorRange = (sizeof(P) == 2 ? 32 : 256) << 8;
+
+		Spans = new SSpan[Rows];
+
+		for (s32 i=0; i<Rows; ++i)
+		{
+			SSpan& span = Spans[i];
+			memset(&span, 0, sizeof(SSpan));
+
+			s32 offset = i * ROW_PITCH + getRandom(ROW_OFFSETS);
+			span.Target = pixels + offset;
+			span.ZTarget = zValues + offset;
+			span.Count = getRandom(MAX_ROW_PIXELS + 1);
+
+			span.ZValue = getRandomZ();
+			span.ZStep = (getRandomZ() - span.ZValue) / (span.Count ? span.Count : 1);
+
+			setRandomRamp(colorRange, span.Count, span.R, span.StepR);
+			setRandomRamp(colorRange, span.Count, span.G, span.StepG);
+			setRandomRamp(colorRange, span.Count, span.B, span.StepB);
+			setRandomRamp(256 << 8, span.Count, span.A, span.StepA);
+			span.Color = (s32)getRandom();
+
+			span.Tx = getRandom(1 << 20);
+			span.Ty = getRandom(1 << 20);
+			span.TxStep = getRandom(4096) - 2048;
+			span.TyStep = getRandom(4096) - 2048;
+			span.Texture = Texture;
+			span.TextureWidth = TEXTURE_WIDTH;
+			span.TextureXMask = TEXTURE_WIDTH - 1;
+			span.TextureYMask = TEXTURE_HEIGHT - 1;
+			span.TextureTiled = getRandom(2) != 0;
+
+			span.Tx2 = getRandom(1 << 20);
+			span.Ty2 = getRandom(1 << 20);
+			span.Tx2Step = getRandom(1024) - 512;
+			span.Ty2Step = getRandom(1024) - 512;
+			span.Texture2 = Texture + TEXTURE_WIDTH * TEXTURE_HEIGHT - LIGHTMAP_WIDTH * LIGHTMAP_HEIGHT;
+			span.Texture2Width = LIGHTMAP_WIDTH;
+			span.Texture2XMask = LIGHTMAP_WIDTH - 1;
+			span.Texture2YMask = LIGHTMAP_HEIGHT - 1;
+
+			if (!getRandom(3))
+			{
+				span.Texture = Indices;
+				span.Palette = Palette;
+			}
+
+			if (!getRandom(3))
+			{
+				span.Texture2 = Indices + TEXTURE_WIDTH * TEXTURE_HEIGHT - LIGHTMAP_WIDTH * LIGHTMAP_HEIGHT;
+				span.Palette2 = Palette;
+			}
+		}
+	}
+
+	~SSpanTest()
+	{
+		delete [] Spans;
+	}
+
+	//! returns a z value in the range of the z buffer format
+	s32 getRandomZ()
+	{
+		if (sizeof(Z) == 2)
+			return getRandom(0x10000) - 0x8000;
+
+		return (s32)(getRandom() >> 1) - 0x40000000;
+	}
+
+	const SKernels* getKernels(ESpanKernelSet set)
+	{
+		return getSpanKernels(Format, ZFormat, set);
+	}
+
+	//! draws all spans with a combination of features
+	s32 draw(const SKernels* kernels, s32 features)
+	{
+		TDrawSpan drawSpan = kernels->Draw[features];
+		s32 pixels = 0;
+
+		for (s32 i=0; i<Rows; ++i)
+		{
+			Written[i] = drawSpan(Spans[i]);
+			pixels += Spans[i].Count;
+		}
+
+		return pixels;
+	}
+
+	ECOLOR_FORMAT Format;
+	E_ZBUFFER_FORMAT ZFormat;
+	s32 Rows;
+	SSpan* Spans;
+	s32* Written;
+	P Texture[TEXTURE_WIDTH*TEXTURE_HEIGHT];
+	u8 Indices[TEXTURE_WIDTH*TEXTURE_HEIGHT];
+	P Palette[256];
+};
+
+
+//! the measured span features, the other combinations are only checked
+const s32 MEASURED_SPAN_COUNT = 8;
+
+const s32 MeasuredSpanFeatures[MEASURED_SPAN_COUNT] =
+{
+	0,
+	ESF_GOURAUD,
+	ESF_TEXTURE,
+	ESF_TEXTURE | ESF_GOURAUD,
+	ESF_TEXTURE | ESF_GOURAUD | ESF_BILINEAR,
+	ESF_TEXTURE | ESF_LIGHTMAP,
+	ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ALPHA | ESF_NO_ZWRITE,
+	ESF_TEXTURE | ESF_BLEND_ADD | ESF_NO_ZWRITE
+};
+
+const c8* const MeasuredSpanNames[MEASURED_SPAN_COUNT] =
+{
+	"flat",
+	"gouraud",
+	"texture",
+	"texture, gouraud",
+	"texture, gouraud, bilinear",
+	"texture, lightmap",
+	"texture, gouraud, alpha blended",
+	"texture, additive"
+};
+
+
+//! measures the common span features and checks all others
+template <class P, class Z>
+bool measureSpans(ECOLOR_FORMAT format, E_ZBUFFER_FORMAT zFormat, const c8* title,
+	s32 rows, s32 repeat)
+{
+	SSpanTest<P, Z>* test = new SSpanTest<P, Z>(format, zFormat, rows);
+	bool equal = true;
+
+	printHeader(*test, title);
+
+	for (s32 i=0; i<MEASURED_SPAN_COUNT; ++i)
+		if (!measure(*test, MeasuredSpanFeatures[i], repeat, MeasuredSpanNames[i]))
+			equal = false;
+
+	s32 different = 0;
+
+	for (s32 features=0; features<ESF_COUNT; ++features)
+		if (!measure(*test, features, 1, 0))
+			++different;
+
+	printf("%-32s%d of %d feature combinations different\n", "all others", different, ESF_COUNT);
+
+	delete test;
+	return equal && !different;
+}
+
+
+
+/*
+The rows of the 2d drawing of surfaces. P is the pixel type of the color
+format. The target holds the pixels, the source the pixels copied onto it.
+*/
+enum EBLIT_OPERATION
+{
+	EBO_FILL = 0,
+	EBO_BLEND,
+	EBO_COPY_WITH_ALPHA,
+	EBO_MODULATE_WITH_ALPHA,
+	EBO_COUNT
+};
+
+const c8* const BlitOperationNames[EBO_COUNT] =
+{
+	"fill",
+	"blend with color",
+	"copy with alpha",
+	"copy with alpha, modulated"
+};
+
+template <class P>
+struct SBlitTest : public SKernelTest
+{
+	typedef SBlitKernels SKernels;
+
+	SBlitTest(ECOLOR_FORMAT format, s32 rows)
+		: Format(format), Rows(rows)
+	{
+		createTarget(Rows * ROW_PITCH * sizeof(P));
+
+		Source = new P[Rows * ROW_PITCH];
+		Offsets = new s32[Rows];
+		Counts = new s32[Rows];
+		FillColors = new s32[Rows];
+		Colors = new Color[Rows];
+
+		for (s32 i=0; i<Rows*ROW_PITCH; ++i)
+			Source[i] = (P)getRandom();
+
+		// a quarter of the fill colors has only equal bytes, which are
+		// filled with memset
+		for (s32 i=0; i<Rows; ++i)
+		{
+			Offsets[i] = i * ROW_PITCH + getRandom(ROW_OFFSETS);
+			Counts[i] = getRandom(MAX_ROW_PIXELS + 1);
+			Colors[i] = Color(getRandom());
+
+			if (sizeof(P) == 2)
+				FillColors[i] = getRandom(4) ? (s16)getRandom() : getRandom(256) * 0x101;
+			else
+				FillColors[i] = getRandom(4) ? (s32)getRandom() : getRandom(256) * 0x01010101;
+		}
+	}
+
+	~SBlitTest()
+	{
+		delete [] Source;
+		delete [] Offsets;
+		delete [] Counts;
+		delete [] FillColors;
+		delete [] Colors;
+	}
+
+	const SKernels* getKernels(ESpanKernelSet set)
+	{
+		return getBlitKernels(Format, set);
+	}
+
+	//! draws all rows with an operation
+	s32 draw(const SKernels* kernels, s32 operation)
+	{
+		P* target = (P*)Target;
+		s32 pixels = 0;
+
+		for (s32 i=0; i<Rows; ++i)
+		{
+			P* t = target + Offsets[i];
+			const P* s = Source + Offsets[i];
+
+			switch(operation)
+			{
+			case EBO_FILL:
+				kernels->FillRow(t, Counts[i], FillColors[i]);
+				break;
+			case EBO_BLEND:
+				kernels->BlendRow(t, Counts[i], Colors[i]);
+				break;
+			case EBO_COPY_WITH_ALPHA:
+				kernels->CopyRowWithAlpha(s, t, Counts[i]);
+				break;
+			case EBO_MODULATE_WITH_ALPHA:
+				kernels->ModulateRowWithAlpha(s, t, Counts[i], Colors[i]);
+				break;
+			}
+
+			pixels += Counts[i];
+		}
+
+		return pixels;
+	}
+
+	ECOLOR_FORMAT Format;
+	s32 Rows;
+	P* Source;
+	s32* Offsets;
+	s32* Counts;
+	s32* FillColors;
+	Color* Colors;
+};
+
+
+//! measures and checks all blit operations of a color format
+template <class P>
+bool measureBlits(ECOLOR_FORMAT format, const c8* title, s32 rows, s32 repeat)
+{
+	SBlitTest<P> test(format, rows);
+	bool equal = true;
+
+	printHeader(test, title);
+
+	for (s32 operation=0; operation<EBO_COUNT; ++operation)
+		if (!measure(test, operation, repeat, BlitOperationNames[operation]))
+			equal = false;
+
+	return equal;
+}
+
+
+
+/*
+The rows of the surface scaler. The inputs of the kernels are set up like
+the scaler does it: the bilinear offsets are neighbours weighted by 7 bit
+weights, the boxes cover up to 4 pixels of up to 8 rows, with the rounded
+up reciprocals of their pixel counts. The target holds 1024 bytes for every
+row, which is enough for the largest output, the sums of the box filter.
+*/
+enum ESCALE_OPERATION
+{
+	ESO_NEAREST = 0,
+	ESO_FILTER_BILINEAR,
+	ESO_BLEND_BILINEAR,
+	ESO_ADD_BOX,
+	ESO_AVERAGE_BOX,
+	ESO_COUNT
+};
+
+const c8* const ScaleOperationNames[ESO_COUNT] =
+{
+	"nearest",
+	"bilinear, filter row",
+	"bilinear, blend rows",
+	"box, add row",
+	"box, average row"
+};
+
+const s32 SCALE_SOURCE_WIDTH = 2 * MAX_ROW_PIXELS;
+const s32 SCALE_TARGET_PITCH = 256;
+
+struct SScaleTest : public SKernelTest
+{
+	typedef SScaleKernels SKernels;
+
+	SScaleTest(s32 rows)
+		: Rows(rows)
+	{
+		createTarget(Rows * SCALE_TARGET_PITCH * sizeof(u32));
+
+		Counts = new s32[Rows];
+		Source = new s32[Rows * SCALE_SOURCE_WIDTH];
+		BilinearOffsets = new s32[Rows * MAX_ROW_PIXELS * 2];
+		Weights = new s16[Rows * MAX_ROW_PIXELS * 2];
+		FilteredRows = new s16[Rows * MAX_ROW_PIXELS * 8];
+		RowWeights = new s32[Rows];
+		BoxOffsets = new s32[Rows * MAX_ROW_PIXELS * 2];
+		Sums = new u32[Rows * SCALE_SOURCE_WIDTH * 4];
+		Reciprocals = new u32[Rows * MAX_ROW_PIXELS];
+
+		for (s32 i=0; i<Rows*SCALE_SOURCE_WIDTH; ++i)
+			Source[i] = (s32)getRandom();
+
+		// the box sums added to start with up to 8 rows of 255
+		for (s32 i=0; i<Rows*SCALE_TARGET_PITCH; ++i)
+			((u32*)Initial)[i] = getRandom(255 * 8 + 1);
+
+		for (s32 i=0; i<Rows*MAX_ROW_PIXELS*8; ++i)
+			FilteredRows[i] = (s16)getRandom(255 * 128 + 1);
+
+		for (s32 row=0; row<Rows; ++row)
+		{
+			Counts[row] = getRandom(MAX_ROW_PIXELS + 1);
+			RowWeights[row] = getRandom(129);
+
+			s32* bilinear = BilinearOffsets + row * MAX_ROW_PIXELS * 2;
+			s16* weights = Weights + row * MAX_ROW_PIXELS * 2;
+			s32* box = BoxOffsets + row * MAX_ROW_PIXELS * 2;
+			u32* sums = Sums + row * SCALE_SOURCE_WIDTH * 4;
+			u32* reciprocals = Reciprocals + row * MAX_ROW_PIXELS;
+
+			s32 boxRows = 1 + getRandom(8);
+			s32 x = 0;
+
+			for (s32 i=0; i<MAX_ROW_PIXELS; ++i)
+			{
+				bilinear[2*i] = getRandom(SCALE_SOURCE_WIDTH - 1);
+				bilinear[2*i+1] = bilinear[2*i] + getRandom(2);
+				weights[2*i+1] = (s16)getRandom(129);
+				weights[2*i] = 128 - weights[2*i+1];
+
+				s32 width = 1 + getRandom(4);
+				if (x + width > SCALE_SOURCE_WIDTH)
+					x = 0;
+
+				box[2*i] = x;
+				box[2*i+1] = x + width;
+				x += width;
+
+				s64 count = (s64)width * boxRows;
+				s64 r = (((s64)1 << 32) + count - 1) / count;
+				reciprocals[i] = r > 0xFFFFFFFF ? 0xFFFFFFFF : (u32)r;
+			}
+
+			for (s32 i=0; i<SCALE_SOURCE_WIDTH*4; ++i)
+				sums[i] = getRandom(255 * boxRows + 1);
+		}
+	}
+
+	~SScaleTest()
+	{
+		delete [] Counts;
+		delete [] Source;
+		delete [] BilinearOffsets;
+		delete [] Weights;
+		delete [] FilteredRows;
+		delete [] RowWeights;
+		delete [] BoxOffsets;
+		delete [] Sums;
+		delete [] Reciprocals;
+	}
+
+	const SKernels* getKernels(ESpanKernelSet set)
+	{
+		return getScaleKernels(set);
+	}
+
+	//! scales all rows with an operation
+	s32 draw(const SKernels* kernels, s32 operation)
+	{
+		s32 pixels = 0;
+
+		for (s32 row=0; row<Rows; ++row)
+		{
+			u8* target = Target + row * SCALE_TARGET_PITCH * sizeof(u32);
+			const s32* source = Source + row * SCALE_SOURCE_WIDTH;
+			const s32* bilinear = BilinearOffsets + row * MAX_ROW_PIXELS * 2;
+			const s16* filtered = FilteredRows + row * MAX_ROW_PIXELS * 8;
+			s32 count = Counts[row];
+
+			switch(operation)
+			{
+			case ESO_NEAREST:
+				kernels->ScaleRowNearest(source, bilinear, (s32*)target, count);
+				break;
+			case ESO_FILTER_BILINEAR:
+				kernels->FilterRowBilinear(source, bilinear, Weights + row * MAX_ROW_PIXELS * 2,
+					(s16*)target, count);
+				break;
+			case ESO_BLEND_BILINEAR:
+				kernels->BlendRowsBilinear(filtered, filtered + MAX_ROW_PIXELS * 4,
+					RowWeights[row], (s32*)target, count);
+				break;
+			case ESO_ADD_BOX:
+				kernels->AddRowBox(source, (u32*)target, count);
+				break;
+			case ESO_AVERAGE_BOX:
+				kernels->AverageRowBox(Sums + row * SCALE_SOURCE_WIDTH * 4,
+					BoxOffsets + row * MAX_ROW_PIXELS * 2, Reciprocals + row * MAX_ROW_PIXELS,
+					(s32*)target, count);
+				break;
+			}
+
+			pixels += count;
+		}
+
+		return pixels;
+	}
+
+	s32 Rows;
+	s32* Counts;
+	s32* Source;
+	s32* BilinearOffsets;
+	s16* Weights;
+	s16* FilteredRows;
+	s32* RowWeights;
+	s32* BoxOffsets;
+	u32* Sums;
+	u32* Reciprocals;
+};
+
+
+//! measures and checks all operations of the surface scaler
+bool measureScales(s32 rows, s32 repeat)
+{
+	SScaleTest test(rows);
+	bool equal = true;
+
+	printHeader(test, "scale kernels, A8R8G8B8");
+
+	for (s32 operation=0; operation<ESO_COUNT; ++operation)
+		if (!measure(test, operation, repeat, ScaleOperationNames[operation]))
+			equal = false;
+
+	return equal;
+}
+
+
+
+int main(int argc, char* argv[])
+{
+	s32 rows = 1024;
+	s32 repeat = 100;
+
+	for (s32 i=1; i<argc-1; i+=2)
+	{
+		if (!strcmp(argv[i], "-rows"))
+			rows = atoi(argv[i+1]);
+		else
+		if (!strcmp(argv[i], "-repeat"))
+			repeat = atoi(argv[i+1]);
+	}
+
+	if (rows <= 0 || repeat <= 0)
+	{
+		printf("Invalid parameters.\n");
+		return 1;
+	}
+
+	srand(1);
+
+	printf("Irrlicht Engine kernel benchmark\n");
+	printf("%d spans or rows of up to %d pixels, drawn %d times per measurement, in Mpixels/s\n",
+		rows, MAX_ROW_PIXELS, repeat);
+
+	bool equal = true;
+
+	if (!measureSpans<s16, s16>(EHCF_R5G5B5, EZF_16BIT, "span kernels, R5G5B5, 16 bit z", rows, repeat))
+		equal = false;
+
+	if (!measureSpans<s16, s32>(EHCF_R5G5B5, EZF_32BIT, "span kernels, R5G5B5, 32 bit z", rows, repeat))
+		equal = false;
+
+	if (!measureSpans<s32, s16>(EHCF_A8R8G8B8, EZF_16BIT, "span kernels, A8R8G8B8, 16 bit z", rows, repeat))
+		equal = false;
+
+	if (!measureSpans<s32, s32>(EHCF_A8R8G8B8, EZF_32BIT, "span kernels, A8R8G8B8, 32 bit z", rows, repeat))
+		equal = false;
+
+	if (!measureBlits<s16>(EHCF_R5G5B5, "blit kernels, R5G5B5", rows, repeat))
+		equal = false;
+
+	if (!measureBlits<s32>(EHCF_A8R8G8B8, "blit kernels, A8R8G8B8", rows, repeat))
+		equal = false;
+
+	if (!measureScales(rows, repeat))
+		equal = false;
+
+	if (!equal)
+	{
+		printf("FAILED: some kernels write other pixels than the scalar ones.\n");
+		return 1;
+	}
+
+	return 0;
+}
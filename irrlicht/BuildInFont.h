@@ -14,7 +14,7 @@ namespace gui
 {
 
 s32 BuildInFontDataSize = 8310; // data size in bytes.s32 intCount = 2078; // count of ints
-s32 BuildInFontData[] = 
+u32 BuildInFontData[] = 
 	{
 	0x20764d42, 0x0, 0x760000, 0x280000, 0x800000,
 	0x800000, 0x10000, 0x4, 0x20000000, 0xb630000, 0xb630000,
@@ -1,6 +1,6 @@
 #include "CAnimatedMeshMD2.h"
 #include "os.h"
-#include "color.h"
+#include "Color.h"
 #include "IReadFile.h"
 
 namespace irr
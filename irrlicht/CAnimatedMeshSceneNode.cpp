@@ -1,6 +1,7 @@
 #include "CAnimatedMeshSceneNode.h"
 #include "IVideoDriver.h"
 #include "ISceneManager.h"
+#include "ITimer.h"
 #include "S3DVertex.h"
 #include "os.h"
 
@@ -17,7 +18,7 @@ CAnimatedMeshSceneNode::CAnimatedMeshSceneNode(IAnimatedMesh* mesh, ISceneNode*
 : IAnimatedMeshSceneNode(parent, mgr, id, position, rotation, scale), Mesh(mesh), 
 	BeginFrameTime(0), StartFrame(0), EndFrame(0), FramesPerSecond(100)
 {
-	BeginFrameTime = os::Timer::getTime();
+	BeginFrameTime = SceneManager->getTimer()->getTime();
 
 	if (Mesh)
 	{
@@ -35,6 +36,11 @@ CAnimatedMeshSceneNode::CAnimatedMeshSceneNode(IAnimatedMesh* mesh, ISceneNode*
 
 				Materials.push_back(mat);
 			}
+
+			// the scene manager tests the box before the node is rendered
+			// for the first time, so it has to be valid from the start.
+
+			Box = m->getBoundingBox();
 		}
 
 		// get start and begin time
@@ -70,7 +76,18 @@ void CAnimatedMeshSceneNode::setCurrentFrame(s32 frame)
 void CAnimatedMeshSceneNode::OnPreRender()
 {
 	if (IsVisible)
+	{
+		// update the box to the frame which is going to be rendered,
+		// it is tested for visibility before render() is called.
+		if (Mesh)
+		{
+			scene::IMesh* m = Mesh->getMesh(getFrameNr());
+			if (m)
+				Box = m->getBoundingBox();
+		}
+
 		SceneManager->registerNodeForRendering(this);
+	}
 
 	ISceneNode::OnPreRender();
 }
@@ -87,16 +104,10 @@ void CAnimatedMeshSceneNode::render()
 
 	driver->setTransform(video::TS_WORLD, AbsoluteTransformation);
 
-	s32 frame = StartFrame + 
-		( (s32)((os::Timer::getTime() - BeginFrameTime) * (FramesPerSecond/1000.0f)) 
-		% (EndFrame - StartFrame));
-
-	scene::IMesh* m = Mesh->getMesh(frame);
+	scene::IMesh* m = Mesh->getMesh(getFrameNr());
 
 	if (m)
 	{
-		Box = m->getBoundingBox();
-
 		for (s32 i=0; i<m->getMeshBufferCount(); ++i)
 		{
 			scene::IMeshBuffer* mb = m->getMeshBuffer(i);
@@ -123,6 +134,16 @@ void CAnimatedMeshSceneNode::render()
 
 
 
+//! returns the frame of the animation at the current time
+s32 CAnimatedMeshSceneNode::getFrameNr()
+{
+	return StartFrame + 
+		( (s32)((SceneManager->getTimer()->getTime() - BeginFrameTime) * (FramesPerSecond/1000.0f)) 
+		% (EndFrame - StartFrame));
+}
+
+
+
 //! sets the frames between the animation is looped.
 //! the default is 0 - MaximalFrameCount of the mesh.
 bool CAnimatedMeshSceneNode::setFrameLoop(s32 begin, s32 end)
@@ -138,7 +159,7 @@ bool CAnimatedMeshSceneNode::setFrameLoop(s32 begin, s32 end)
 
 	StartFrame = begin;
 	EndFrame = end;
-	BeginFrameTime = os::Timer::getTime();
+	BeginFrameTime = SceneManager->getTimer()->getTime();
 
 	return true;
 }
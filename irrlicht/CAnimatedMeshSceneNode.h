@@ -57,6 +57,9 @@ namespace scene
 
 	private:
 
+		//! returns the frame of the animation at the current time
+		s32 getFrameNr();
+
 		core::array<video::SMaterial> Materials;
 		core::aabbox3d<f32> Box;
 		IAnimatedMesh* Mesh;
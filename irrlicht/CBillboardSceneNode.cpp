@@ -3,6 +3,7 @@
 #include "ISceneManager.h"
 #include "ICameraSceneNode.h"
 #include "os.h"
+#include <math.h>
 
 namespace irr
 {
@@ -115,6 +116,12 @@ void CBillboardSceneNode::setSize(const core::dimension2d<f32>& size)
 {
 	Size = size;
 
+	// the billboard turns to the camera, so the box has to
+	// contain it in every direction.
+	f32 r = 0.5f * (f32)sqrt(Size.Width * Size.Width + Size.Height * Size.Height);
+	BBox.MinEdge.set(-r, -r, -r);
+	BBox.MaxEdge.set(r, r, r);
+
 	/*vertices[0].Pos.Z = 0;
 	vertices[1].Pos.Z = 0;
 	vertices[2].Pos.Z = 0;
@@ -0,0 +1,678 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "CBlitKernels.h"
+#include <memory.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define _IRR_BLIT_KERNELS_X86_
+#endif
+
+#ifdef _IRR_BLIT_KERNELS_X86_
+
+#include <immintrin.h>
+
+// see CTRSpanKernels.cpp
+#ifdef __GNUC__
+#define _IRR_TARGET_SSE2_ __attribute__((target("sse2")))
+#define _IRR_TARGET_AVX2_ __attribute__((target("avx2")))
+#else
+#define _IRR_TARGET_SSE2_
+#define _IRR_TARGET_AVX2_
+#endif
+
+#endif
+
+namespace irr
+{
+namespace video
+{
+
+// The scalar kernels draw the pixels like CSurface always did, the vector
+// kernels draw the rest of their rows with them.
+
+
+//! fills a row of 16 bit pixels
+static void fillRow16(void* target, s32 count, s32 color)
+{
+	// clears, and other colors with two equal bytes, are set by memset
+	if (((color >> 8) & 0xFF) == (color & 0xFF))
+	{
+		memset(target, color & 0xFF, count * sizeof(s16));
+		return;
+	}
+
+	s16* t = (s16*)target;
+
+	for (s32 i=0; i<count; ++i)
+		t[i] = (s16)color;
+}
+
+
+
+//! fills a row of 32 bit pixels
+static void fillRow32(void* target, s32 count, s32 color)
+{
+	if ((u32)color == (color & 0xFF) * 0x01010101u)
+	{
+		memset(target, color & 0xFF, count * sizeof(s32));
+		return;
+	}
+
+	s32* t = (s32*)target;
+
+	for (s32 i=0; i<count; ++i)
+		t[i] = color;
+}
+
+
+
+//! blends a row of 16 bit pixels with a color
+static void blendRow16(void* target, s32 count, Color color)
+{
+	s32 ia = color.getAlpha();
+	s32 a = 255-ia;
+
+	s32 r = getRed(color.toA1R5G5B5()) * ia;
+	s32 g = getGreen(color.toA1R5G5B5()) * ia;
+	s32 b = getBlue(color.toA1R5G5B5()) * ia;
+
+	s16* t = (s16*)target;
+
+	for (s32 i=0; i<count; ++i)
+		t[i] = video::RGB16(
+			(video::getRed(t[i])*a + r)>>5,
+			(video::getGreen(t[i])*a + g)>>5,
+			(video::getBlue(t[i])*a + b)>>5);
+}
+
+
+
+//! blends a row of 32 bit pixels with a color, the alpha of the pixels is kept
+static void blendRow32(void* target, s32 count, Color color)
+{
+	s32 ia = color.getAlpha();
+	s32 a = 255-ia;
+
+	s32 r = color.getRed() * ia;
+	s32 g = color.getGreen() * ia;
+	s32 b = color.getBlue() * ia;
+
+	s32* t = (s32*)target;
+
+	for (s32 i=0; i<count; ++i)
+		t[i] = (t[i] & 0xFF000000) |
+			(((((t[i]>>16) & 0xFF)*a + r)>>8)<<16) |
+			(((((t[i]>>8) & 0xFF)*a + g)>>8)<<8) |
+			((((t[i]) & 0xFF)*a + b)>>8);
+}
+
+
+
+//! copies the 16 bit pixels of a row which have the alpha bit set
+static void copyRowWithAlpha16(const void* source, void* target, s32 count)
+{
+	const s16* p = (const s16*)source;
+	s16* t = (s16*)target;
+
+	for (s32 i=0; i<count; ++i)
+		if (p[i] & 0x8000)
+			t[i] = p[i];
+}
+
+
+
+//! copies the 32 bit pixels of a row which have the alpha bit set
+static void copyRowWithAlpha32(const void* source, void* target, s32 count)
+{
+	const s32* p = (const s32*)source;
+	s32* t = (s32*)target;
+
+	for (s32 i=0; i<count; ++i)
+		if (p[i] & 0x80000000)
+			t[i] = p[i];
+}
+
+
+
+//! copies the 16 bit pixels of a row which have the alpha bit set,
+//! modulated by a color. The copied pixels lose their alpha bit.
+static void modulateRowWithAlpha16(const void* source, void* target, s32 count, Color color)
+{
+	s32 r = getRed(color.toA1R5G5B5());
+	s32 g = getGreen(color.toA1R5G5B5());
+	s32 b = getBlue(color.toA1R5G5B5());
+
+	const s16* p = (const s16*)source;
+	s16* t = (s16*)target;
+
+	for (s32 i=0; i<count; ++i)
+		if (p[i] & 0x8000)
+			t[i] = video::RGB16(video::getRed(p[i]) * (r) >>2, video::getGreen(p[i]) * (g) >>2, video::getBlue(p[i]) * (b) >>2);
+}
+
+
+
+//! copies the 32 bit pixels of a row which have the alpha bit set,
+//! modulated by a color. The copied pixels lose their alpha.
+static void modulateRowWithAlpha32(const void* source, void* target, s32 count, Color color)
+{
+	s32 r = color.getRed() + 1;
+	s32 g = color.getGreen() + 1;
+	s32 b = color.getBlue() + 1;
+
+	const s32* p = (const s32*)source;
+	s32* t = (s32*)target;
+
+	for (s32 i=0; i<count; ++i)
+		if (p[i] & 0x80000000)
+			t[i] = (((((p[i]>>16) & 0xFF) * r) >> 8) << 16) |
+				(((((p[i]>>8) & 0xFF) * g) >> 8) << 8) |
+				((((p[i]) & 0xFF) * b) >> 8);
+}
+
+
+
+#ifdef _IRR_BLIT_KERNELS_X86_
+
+// SSE2 kernels, 8 16 bit pixels or 4 32 bit pixels per iteration. The
+// channels are multiplied in 16 bit lanes, all products fit into them.
+
+
+//! fills a row of 16 bit pixels
+static _IRR_TARGET_SSE2_ void fillRow16SSE2(void* target, s32 count, s32 color)
+{
+	if (((color >> 8) & 0xFF) == (color & 0xFF))
+	{
+		fillRow16(target, count, color);
+		return;
+	}
+
+	const __m128i c = _mm_set1_epi16((s16)color);
+	s16* t = (s16*)target;
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+		_mm_storeu_si128((__m128i*)(t + i), c);
+
+	fillRow16(t + i, count - i, color);
+}
+
+
+
+//! fills a row of 32 bit pixels
+static _IRR_TARGET_SSE2_ void fillRow32SSE2(void* target, s32 count, s32 color)
+{
+	if ((u32)color == (color & 0xFF) * 0x01010101u)
+	{
+		fillRow32(target, count, color);
+		return;
+	}
+
+	const __m128i c = _mm_set1_epi32(color);
+	s32* t = (s32*)target;
+	s32 i = 0;
+
+	for (; i+4 <= count; i += 4)
+		_mm_storeu_si128((__m128i*)(t + i), c);
+
+	fillRow32(t + i, count - i, color);
+}
+
+
+
+//! blends a row of 16 bit pixels with a color, see blendRow16()
+static _IRR_TARGET_SSE2_ void blendRow16SSE2(void* target, s32 count, Color color)
+{
+	const s32 ia = color.getAlpha();
+	const __m128i a = _mm_set1_epi16((s16)(255-ia));
+	const __m128i r = _mm_set1_epi16((s16)(getRed(color.toA1R5G5B5()) * ia));
+	const __m128i g = _mm_set1_epi16((s16)(getGreen(color.toA1R5G5B5()) * ia));
+	const __m128i b = _mm_set1_epi16((s16)(getBlue(color.toA1R5G5B5()) * ia));
+	const __m128i mask = _mm_set1_epi16(0x1F);
+
+	s16* t = (s16*)target;
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+	{
+		__m128i p = _mm_loadu_si128((__m128i*)(t + i));
+
+		__m128i pr = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 10), mask), a), r);
+		__m128i pg = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(p, 5), mask), a), g);
+		__m128i pb = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(p, mask), a), b);
+
+		// RGB16() takes 8 bit channels, so they are shifted by 5+3 bits
+		p = _mm_or_si128(_mm_or_si128(
+			_mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(pr, 8), mask), 10),
+			_mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(pg, 8), mask), 5)),
+			_mm_and_si128(_mm_srli_epi16(pb, 8), mask));
+
+		_mm_storeu_si128((__m128i*)(t + i), p);
+	}
+
+	blendRow16(t + i, count - i, color);
+}
+
+
+
+//! blends a row of 32 bit pixels with a color, see blendRow32(). The alpha
+//! channel is multiplied by 256 and shifted back, so it is kept.
+static _IRR_TARGET_SSE2_ void blendRow32SSE2(void* target, s32 count, Color color)
+{
+	const s32 ia = color.getAlpha();
+	const s16 a = (s16)(255-ia);
+	const __m128i factor = _mm_setr_epi16(a, a, a, 256, a, a, a, 256);
+	const __m128i add = _mm_setr_epi16(
+		(s16)(color.getBlue() * ia), (s16)(color.getGreen() * ia), (s16)(color.getRed() * ia), 0,
+		(s16)(color.getBlue() * ia), (s16)(color.getGreen() * ia), (s16)(color.getRed() * ia), 0);
+	const __m128i zero = _mm_setzero_si128();
+
+	s32* t = (s32*)target;
+	s32 i = 0;
+
+	for (; i+4 <= count; i += 4)
+	{
+		__m128i p = _mm_loadu_si128((__m128i*)(t + i));
+
+		__m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), factor), add);
+		__m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), factor), add);
+
+		_mm_storeu_si128((__m128i*)(t + i), _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+	}
+
+	blendRow32(t + i, count - i, color);
+}
+
+
+
+//! copies the 16 bit pixels of a row which have the alpha bit set
+static _IRR_TARGET_SSE2_ void copyRowWithAlpha16SSE2(const void* source, void* target, s32 count)
+{
+	const s16* p = (const s16*)source;
+	s16* t = (s16*)target;
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i*)(p + i));
+		__m128i d = _mm_loadu_si128((__m128i*)(t + i));
+		__m128i mask = _mm_srai_epi16(s, 15);
+
+		_mm_storeu_si128((__m128i*)(t + i), _mm_or_si128(_mm_and_si128(mask, s), _mm_andnot_si128(mask, d)));
+	}
+
+	copyRowWithAlpha16(p + i, t + i, count - i);
+}
+
+
+
+//! copies the 32 bit pixels of a row which have the alpha bit set
+static _IRR_TARGET_SSE2_ void copyRowWithAlpha32SSE2(const void* source, void* target, s32 count)
+{
+	const s32* p = (const s32*)source;
+	s32* t = (s32*)target;
+	s32 i = 0;
+
+	for (; i+4 <= count; i += 4)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i*)(p + i));
+		__m128i d = _mm_loadu_si128((__m128i*)(t + i));
+		__m128i mask = _mm_srai_epi32(s, 31);
+
+		_mm_storeu_si128((__m128i*)(t + i), _mm_or_si128(_mm_and_si128(mask, s), _mm_andnot_si128(mask, d)));
+	}
+
+	copyRowWithAlpha32(p + i, t + i, count - i);
+}
+
+
+
+//! copies the 16 bit pixels of a row which have the alpha bit set,
+//! modulated by a color, see modulateRowWithAlpha16()
+static _IRR_TARGET_SSE2_ void modulateRowWithAlpha16SSE2(const void* source, void* target, s32 count, Color color)
+{
+	const __m128i r = _mm_set1_epi16((s16)getRed(color.toA1R5G5B5()));
+	const __m128i g = _mm_set1_epi16((s16)getGreen(color.toA1R5G5B5()));
+	const __m128i b = _mm_set1_epi16((s16)getBlue(color.toA1R5G5B5()));
+	const __m128i mask = _mm_set1_epi16(0x1F);
+
+	const s16* p = (const s16*)source;
+	s16* t = (s16*)target;
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i*)(p + i));
+		__m128i d = _mm_loadu_si128((__m128i*)(t + i));
+		__m128i alpha = _mm_srai_epi16(s, 15);
+
+		__m128i pr = _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(s, 10), mask), r);
+		__m128i pg = _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(s, 5), mask), g);
+		__m128i pb = _mm_mullo_epi16(_mm_and_si128(s, mask), b);
+
+		s = _mm_or_si128(_mm_or_si128(
+			_mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(pr, 5), mask), 10),
+			_mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(pg, 5), mask), 5)),
+			_mm_and_si128(_mm_srli_epi16(pb, 5), mask));
+
+		_mm_storeu_si128((__m128i*)(t + i), _mm_or_si128(_mm_and_si128(alpha, s), _mm_andnot_si128(alpha, d)));
+	}
+
+	modulateRowWithAlpha16(p + i, t + i, count - i, color);
+}
+
+
+
+//! copies the 32 bit pixels of a row which have the alpha bit set,
+//! modulated by a color, see modulateRowWithAlpha32(). The factor of the
+//! alpha channel is 0.
+static _IRR_TARGET_SSE2_ void modulateRowWithAlpha32SSE2(const void* source, void* target, s32 count, Color color)
+{
+	const s16 r = (s16)(color.getRed() + 1);
+	const s16 g = (s16)(color.getGreen() + 1);
+	const s16 b = (s16)(color.getBlue() + 1);
+	const __m128i factor = _mm_setr_epi16(b, g, r, 0, b, g, r, 0);
+	const __m128i zero = _mm_setzero_si128();
+
+	const s32* p = (const s32*)source;
+	s32* t = (s32*)target;
+	s32 i = 0;
+
+	for (; i+4 <= count; i += 4)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i*)(p + i));
+		__m128i d = _mm_loadu_si128((__m128i*)(t + i));
+		__m128i alpha = _mm_srai_epi32(s, 31);
+
+		__m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), factor);
+		__m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), factor);
+		s = _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+
+		_mm_storeu_si128((__m128i*)(t + i), _mm_or_si128(_mm_and_si128(alpha, s), _mm_andnot_si128(alpha, d)));
+	}
+
+	modulateRowWithAlpha32(p + i, t + i, count - i, color);
+}
+
+
+
+// AVX2 kernels, the same as the SSE2 kernels with twice as many pixels.
+// The unpack and pack instructions work inside the 128 bit halves, so the
+// pixels come out in order again. The rest of a row is drawn by the SSE2
+// kernels, which are not VEX encoded, so the upper halves of the ymm
+// registers are cleared before.
+
+
+//! fills a row of 16 bit pixels
+static _IRR_TARGET_AVX2_ void fillRow16AVX2(void* target, s32 count, s32 color)
+{
+	if (((color >> 8) & 0xFF) == (color & 0xFF))
+	{
+		fillRow16(target, count, color);
+		return;
+	}
+
+	const __m256i c = _mm256_set1_epi16((s16)color);
+	s16* t = (s16*)target;
+	s32 i = 0;
+
+	for (; i+16 <= count; i += 16)
+		_mm256_storeu_si256((__m256i*)(t + i), c);
+
+	_mm256_zeroupper();
+	fillRow16SSE2(t + i, count - i, color);
+}
+
+
+
+//! fills a row of 32 bit pixels
+static _IRR_TARGET_AVX2_ void fillRow32AVX2(void* target, s32 count, s32 color)
+{
+	if ((u32)color == (color & 0xFF) * 0x01010101u)
+	{
+		fillRow32(target, count, color);
+		return;
+	}
+
+	const __m256i c = _mm256_set1_epi32(color);
+	s32* t = (s32*)target;
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+		_mm256_storeu_si256((__m256i*)(t + i), c);
+
+	_mm256_zeroupper();
+	fillRow32SSE2(t + i, count - i, color);
+}
+
+
+
+//! blends a row of 16 bit pixels with a color, see blendRow16SSE2()
+static _IRR_TARGET_AVX2_ void blendRow16AVX2(void* target, s32 count, Color color)
+{
+	const s32 ia = color.getAlpha();
+	const __m256i a = _mm256_set1_epi16((s16)(255-ia));
+	const __m256i r = _mm256_set1_epi16((s16)(getRed(color.toA1R5G5B5()) * ia));
+	const __m256i g = _mm256_set1_epi16((s16)(getGreen(color.toA1R5G5B5()) * ia));
+	const __m256i b = _mm256_set1_epi16((s16)(getBlue(color.toA1R5G5B5()) * ia));
+	const __m256i mask = _mm256_set1_epi16(0x1F);
+
+	s16* t = (s16*)target;
+	s32 i = 0;
+
+	for (; i+16 <= count; i += 16)
+	{
+		__m256i p = _mm256_loadu_si256((__m256i*)(t + i));
+
+		__m256i pr = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 10), mask), a), r);
+		__m256i pg = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(p, 5), mask), a), g);
+		__m256i pb = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(p, mask), a), b);
+
+		p = _mm256_or_si256(_mm256_or_si256(
+			_mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(pr, 8), mask), 10),
+			_mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(pg, 8), mask), 5)),
+			_mm256_and_si256(_mm256_srli_epi16(pb, 8), mask));
+
+		_mm256_storeu_si256((__m256i*)(t + i), p);
+	}
+
+	_mm256_zeroupper();
+	blendRow16SSE2(t + i, count - i, color);
+}
+
+
+
+//! blends a row of 32 bit pixels with a color, see blendRow32SSE2()
+static _IRR_TARGET_AVX2_ void blendRow32AVX2(void* target, s32 count, Color color)
+{
+	const s32 ia = color.getAlpha();
+	const s16 a = (s16)(255-ia);
+	const s16 r = (s16)(color.getRed() * ia);
+	const s16 g = (s16)(color.getGreen() * ia);
+	const s16 b = (s16)(color.getBlue() * ia);
+	const __m256i factor = _mm256_setr_epi16(a, a, a, 256, a, a, a, 256, a, a, a, 256, a, a, a, 256);
+	const __m256i add = _mm256_setr_epi16(b, g, r, 0, b, g, r, 0, b, g, r, 0, b, g, r, 0);
+	const __m256i zero = _mm256_setzero_si256();
+
+	s32* t = (s32*)target;
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+	{
+		__m256i p = _mm256_loadu_si256((__m256i*)(t + i));
+
+		__m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(p, zero), factor), add);
+		__m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(p, zero), factor), add);
+
+		_mm256_storeu_si256((__m256i*)(t + i), _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8)));
+	}
+
+	_mm256_zeroupper();
+	blendRow32SSE2(t + i, count - i, color);
+}
+
+
+
+//! copies the 16 bit pixels of a row which have the alpha bit set
+static _IRR_TARGET_AVX2_ void copyRowWithAlpha16AVX2(const void* source, void* target, s32 count)
+{
+	const s16* p = (const s16*)source;
+	s16* t = (s16*)target;
+	s32 i = 0;
+
+	for (; i+16 <= count; i += 16)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i*)(p + i));
+		__m256i d = _mm256_loadu_si256((__m256i*)(t + i));
+
+		_mm256_storeu_si256((__m256i*)(t + i), _mm256_blendv_epi8(d, s, _mm256_srai_epi16(s, 15)));
+	}
+
+	_mm256_zeroupper();
+	copyRowWithAlpha16SSE2(p + i, t + i, count - i);
+}
+
+
+
+//! copies the 32 bit pixels of a row which have the alpha bit set
+static _IRR_TARGET_AVX2_ void copyRowWithAlpha32AVX2(const void* source, void* target, s32 count)
+{
+	const s32* p = (const s32*)source;
+	s32* t = (s32*)target;
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i*)(p + i));
+		__m256i d = _mm256_loadu_si256((__m256i*)(t + i));
+
+		_mm256_storeu_si256((__m256i*)(t + i), _mm256_blendv_epi8(d, s, _mm256_srai_epi32(s, 31)));
+	}
+
+	_mm256_zeroupper();
+	copyRowWithAlpha32SSE2(p + i, t + i, count - i);
+}
+
+
+
+//! copies the 16 bit pixels of a row which have the alpha bit set,
+//! modulated by a color, see modulateRowWithAlpha16SSE2()
+static _IRR_TARGET_AVX2_ void modulateRowWithAlpha16AVX2(const void* source, void* target, s32 count, Color color)
+{
+	const __m256i r = _mm256_set1_epi16((s16)getRed(color.toA1R5G5B5()));
+	const __m256i g = _mm256_set1_epi16((s16)getGreen(color.toA1R5G5B5()));
+	const __m256i b = _mm256_set1_epi16((s16)getBlue(color.toA1R5G5B5()));
+	const __m256i mask = _mm256_set1_epi16(0x1F);
+
+	const s16* p = (const s16*)source;
+	s16* t = (s16*)target;
+	s32 i = 0;
+
+	for (; i+16 <= count; i += 16)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i*)(p + i));
+		__m256i d = _mm256_loadu_si256((__m256i*)(t + i));
+		__m256i alpha = _mm256_srai_epi16(s, 15);
+
+		__m256i pr = _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(s, 10), mask), r);
+		__m256i pg = _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(s, 5), mask), g);
+		__m256i pb = _mm256_mullo_epi16(_mm256_and_si256(s, mask), b);
+
+		s = _mm256_or_si256(_mm256_or_si256(
+			_mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(pr, 5), mask), 10),
+			_mm256_slli_epi16(_mm256_and_si256(_mm256_srli_epi16(pg, 5), mask), 5)),
+			_mm256_and_si256(_mm256_srli_epi16(pb, 5), mask));
+
+		_mm256_storeu_si256((__m256i*)(t + i), _mm256_blendv_epi8(d, s, alpha));
+	}
+
+	_mm256_zeroupper();
+	modulateRowWithAlpha16SSE2(p + i, t + i, count - i, color);
+}
+
+
+
+//! copies the 32 bit pixels of a row which have the alpha bit set,
+//! modulated by a color, see modulateRowWithAlpha32SSE2()
+static _IRR_TARGET_AVX2_ void modulateRowWithAlpha32AVX2(const void* source, void* target, s32 count, Color color)
+{
+	const s16 r = (s16)(color.getRed() + 1);
+	const s16 g = (s16)(color.getGreen() + 1);
+	const s16 b = (s16)(color.getBlue() + 1);
+	const __m256i factor = _mm256_setr_epi16(b, g, r, 0, b, g, r, 0, b, g, r, 0, b, g, r, 0);
+	const __m256i zero = _mm256_setzero_si256();
+
+	const s32* p = (const s32*)source;
+	s32* t = (s32*)target;
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i*)(p + i));
+		__m256i d = _mm256_loadu_si256((__m256i*)(t + i));
+		__m256i alpha = _mm256_srai_epi32(s, 31);
+
+		__m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), factor);
+		__m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), factor);
+		s = _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8));
+
+		_mm256_storeu_si256((__m256i*)(t + i), _mm256_blendv_epi8(d, s, alpha));
+	}
+
+	_mm256_zeroupper();
+	modulateRowWithAlpha32SSE2(p + i, t + i, count - i, color);
+}
+
+#endif // _IRR_BLIT_KERNELS_X86_
+
+
+
+//! the kernels of every instruction set, for EHCF_R5G5B5 and EHCF_A8R8G8B8
+static const SBlitKernels BlitKernels[ESKS_COUNT][2] =
+{
+	{
+		{ "scalar", fillRow16, blendRow16, copyRowWithAlpha16, modulateRowWithAlpha16 },
+		{ "scalar", fillRow32, blendRow32, copyRowWithAlpha32, modulateRowWithAlpha32 }
+	},
+#ifdef _IRR_BLIT_KERNELS_X86_
+	{
+		{ "SSE2", fillRow16SSE2, blendRow16SSE2, copyRowWithAlpha16SSE2, modulateRowWithAlpha16SSE2 },
+		{ "SSE2", fillRow32SSE2, blendRow32SSE2, copyRowWithAlpha32SSE2, modulateRowWithAlpha32SSE2 }
+	},
+	{
+		{ "AVX2", fillRow16AVX2, blendRow16AVX2, copyRowWithAlpha16AVX2, modulateRowWithAlpha16AVX2 },
+		{ "AVX2", fillRow32AVX2, blendRow32AVX2, copyRowWithAlpha32AVX2, modulateRowWithAlpha32AVX2 }
+	}
+#endif
+};
+
+
+
+//! returns the blit kernels of an instruction set
+const SBlitKernels* getBlitKernels(ECOLOR_FORMAT format, ESpanKernelSet set)
+{
+	if (!isKernelSetSupported(set))
+		return 0;
+
+	return &BlitKernels[set][format == EHCF_A8R8G8B8 ? 1 : 0];
+}
+
+
+
+//! returns the fastest blit kernels the processor supports
+const SBlitKernels* getBlitKernels(ECOLOR_FORMAT format)
+{
+	static const SBlitKernels* best[2] = { 0, 0 };
+
+	const SBlitKernels*& kernels = best[format == EHCF_A8R8G8B8 ? 1 : 0];
+
+	for (s32 i=ESKS_COUNT-1; !kernels && i>=0; --i)
+		kernels = getBlitKernels(format, (ESpanKernelSet)i);
+
+	return kernels;
+}
+
+} // end namespace video
+} // end namespace irr
\ No newline at end of file
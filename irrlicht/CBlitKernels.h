@@ -0,0 +1,53 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __C_BLIT_KERNELS_H_INCLUDED__
+#define __C_BLIT_KERNELS_H_INCLUDED__
+
+#include "CTRSpanKernels.h"
+#include "Color.h"
+
+namespace irr
+{
+namespace video
+{
+	//! fills a row of pixels with a color in the format of the kernels
+	typedef void (*TFillRow)(void* target, s32 count, s32 color);
+
+	//! blends a row of pixels with a color by its alpha, like
+	//! ISurface::drawRectangle() does with colors which are not opaque
+	typedef void (*TBlendRow)(void* target, s32 count, Color color);
+
+	//! copies the pixels of a row which have the alpha bit set
+	typedef void (*TCopyRowWithAlpha)(const void* source, void* target, s32 count);
+
+	//! copies the pixels of a row which have the alpha bit set, modulated
+	//! by a color
+	typedef void (*TModulateRowWithAlpha)(const void* source, void* target, s32 count, Color color);
+
+	//! row functions of the 2d drawing of surfaces, for one instruction set
+	//! and color format. They draw whole rows, so the vector kernels work
+	//! on 8 or 16 pixels at once instead of testing pixel by pixel. All sets
+	//! of a format write exactly the same pixels.
+	struct SBlitKernels
+	{
+		const c8* Name;
+		TFillRow FillRow;
+		TBlendRow BlendRow;
+		TCopyRowWithAlpha CopyRowWithAlpha;
+		TModulateRowWithAlpha ModulateRowWithAlpha;
+	};
+
+	//! returns the fastest blit kernels the processor supports for
+	//! EHCF_R5G5B5 or EHCF_A8R8G8B8 surfaces.
+	const SBlitKernels* getBlitKernels(ECOLOR_FORMAT format);
+
+	//! returns the blit kernels of an instruction set, or 0 if the
+	//! processor or the compiler does not support it.
+	const SBlitKernels* getBlitKernels(ECOLOR_FORMAT format, ESpanKernelSet set);
+
+} // end namespace video
+} // end namespace irr
+
+#endif
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "CCameraSceneNode.h"
 #include "ISceneManager.h"
 #include "IVideoDriver.h"
-#include "os.h"
+#include "ITimer.h"
 
 namespace irr
 {
@@ -187,7 +187,7 @@ void CCameraSceneNode::OnPreRender()
 //! post render event
 void CCameraSceneNode::OnPostRender()
 {
-	ISceneNode::OnPostRender(os::Timer::getTime());
+	ISceneNode::OnPostRender(SceneManager->getTimer()->getTime());
 }
 
 
@@ -4,203 +4,913 @@
 
 #include "Color.h"
 #include "CColorConverter.h"
+#include <memory.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define _IRR_CONVERT_KERNELS_X86_
+#endif
+
+#ifdef _IRR_CONVERT_KERNELS_X86_
+
+#include <immintrin.h>
+
+// see CTRSpanKernels.cpp
+#ifdef __GNUC__
+#define _IRR_TARGET_SSE2_ __attribute__((target("sse2")))
+#define _IRR_TARGET_AVX2_ __attribute__((target("avx2")))
+#else
+#define _IRR_TARGET_SSE2_
+#define _IRR_TARGET_AVX2_
+#endif
+
+#endif
 
 namespace irr
 {
 namespace video
 {
 
-//! converts a 4 bit palettized image into R5G5B5
-void CColorConverter::convert4BitTo16BitFlipMirror(const c8* in, s16* out, s32 width, s32 height, s32 pitch, const s32* palette)
+//! ordered 4x4 Bayer matrix, scaled to the 3 bits a channel loses when it
+//! is quantized to 5 bits
+static const u8 DitherMatrix[4][4] =
+{
+	{ 0, 4, 1, 5 },
+	{ 6, 2, 7, 3 },
+	{ 1, 5, 0, 4 },
+	{ 7, 3, 6, 2 }
+};
+
+
+//! no dithering, for the scalar kernels
+static const u8 NoDither[4] = { 0, 0, 0, 0 };
+
+
+
+//! returns the dither values of a row
+const u8* getDitherRow(s32 y)
+{
+	return DitherMatrix[y & 3];
+}
+
+
+
+// The scalar kernels convert the pixels like the converter always did, the
+// vector kernels convert the rest of their rows with them. The vector
+// kernels work on a multiple of 4 pixels, so the dither values of the rest
+// of the row start at x%4 == 0 again.
+
+
+//! quantizes a channel to 5 bits after adding a dither value
+static inline s32 quantize5(s32 channel, s32 dither)
 {
-	s32 shift = 0;
-	out += width*height;
-	s16* oout = out;
+	channel += dither;
+	return (channel > 255 ? 255 : channel) >> 3;
+}
+
+
 
-	for (s32 y=0; y<height; ++y)
+//! converts a row of 24 bit pixels into X8R8G8B8 pixels
+static void convert24To32(const u8* in, s32* out, s32 count, bool rgb)
+{
+	const s32 r = rgb ? 0 : 2;
+	const s32 b = 2 - r;
+
+	for (s32 i=0; i<count; ++i, in+=3)
+		out[i] = (in[r]<<16) | (in[1]<<8) | in[b];
+}
+
+
+
+//! converts a row of 24 bit pixels into R5G5B5 pixels
+static void convert24To16(const u8* in, s16* out, s32 count, bool rgb, const u8* dither)
+{
+	const s32 r = rgb ? 0 : 2;
+	const s32 b = 2 - r;
+	const u8* d = dither ? dither : NoDither;
+
+	for (s32 i=0; i<count; ++i, in+=3)
 	{
-		shift = 4;
+		const s32 t = d[i&3];
+		out[i] = (s16)((quantize5(in[r], t)<<10) | (quantize5(in[1], t)<<5) | quantize5(in[b], t));
+	}
+}
 
-		out = oout - (y*width) - width;
 
-		for (s32 x=0; x<width; ++x)
-		{
-			*out = X8R8G8B8toA1R5G5B5(palette[(u8)((*in >> shift) & 0xf)]);
-			++out;
-
-			shift -= 4;
-			if (shift<0)
-			{
-				shift = 4;
-				++in;
-			}
-		}
 
-		if (shift !=4)
-			++in;
+//! converts a row of 32 bit pixels into A8R8G8B8 pixels
+static void convert32To32(const u8* in, s32* out, s32 count, bool rgb, bool alpha)
+{
+	const s32 r = rgb ? 0 : 2;
+	const s32 b = 2 - r;
+	const u32 a = alpha ? 0xFF : 0;
+
+	for (s32 i=0; i<count; ++i, in+=4)
+		out[i] = (s32)(((in[3] & a)<<24) | (in[r]<<16) | (in[1]<<8) | in[b]);
+}
 
-		in+=pitch;
+
+
+//! converts a row of 32 bit pixels into A1R5G5B5 pixels
+static void convert32To16(const u8* in, s16* out, s32 count, bool rgb, bool alpha, const u8* dither)
+{
+	const s32 r = rgb ? 0 : 2;
+	const s32 b = 2 - r;
+	const s32 a = alpha ? 0x80 : 0;
+	const u8* d = dither ? dither : NoDither;
+
+	for (s32 i=0; i<count; ++i, in+=4)
+	{
+		const s32 t = d[i&3];
+		out[i] = (s16)(((in[3] & a)<<8) | (quantize5(in[r], t)<<10) |
+			(quantize5(in[1], t)<<5) | quantize5(in[b], t));
 	}
 }
 
 
 
+//! converts a row of A1R5G5B5 pixels into A8R8G8B8 pixels
+static void convert16To32(const s16* in, s32* out, s32 count)
+{
+	for (s32 i=0; i<count; ++i)
+		out[i] = A1R5G5B5toA8R8G8B8(in[i]);
+}
 
-//! converts a 8 bit palettized image into R5G5B5
-void CColorConverter::convert8BitTo16BitFlipMirror(const c8* in, s16* out, s32 width, s32 height, s32 pitch, const s32* palette)
+
+
+//! replaces indices by 16 bit colors
+static void lookup8To16(const u8* in, s16* out, s32 count, const s32* palette)
+{
+	for (s32 i=0; i<count; ++i)
+		out[i] = (s16)palette[in[i]];
+}
+
+
+
+//! replaces indices by 32 bit colors
+static void lookup8To32(const u8* in, s32* out, s32 count, const s32* palette)
 {
-	out += width * height;
-	s32 lineWidth = width + pitch;
-	const c8* p = in;
+	for (s32 i=0; i<count; ++i)
+		out[i] = palette[in[i]];
+}
+
 
-	for (s32 y=1; y<=height; ++y)
+
+//! reverses a row of 16 bit pixels
+static void reverseRow16(s16* row, s32 count)
+{
+	for (s32 i=0, j=count-1; i<j; ++i, --j)
 	{
-		p= in + lineWidth*y - pitch;
+		s16 t = row[i];
+		row[i] = row[j];
+		row[j] = t;
+	}
+}
 
-		for (s32 x=0; x<width; ++x)
-		{
-			--out;
-			--p;
-			*out = X8R8G8B8toA1R5G5B5(palette[(u8)(*p)]);
-		}
+
+
+//! reverses a row of 32 bit pixels
+static void reverseRow32(s32* row, s32 count)
+{
+	for (s32 i=0, j=count-1; i<j; ++i, --j)
+	{
+		s32 t = row[i];
+		row[i] = row[j];
+		row[j] = t;
 	}
 }
 
 
-//! converts a monochrome bitmap to A1R5G5B5 data
-void CColorConverter::convert1BitTo16BitFlipMirror(const c8* in, s16* out, s32 width, s32 height, s32 pitch)
+
+#ifdef _IRR_CONVERT_KERNELS_X86_
+
+// SSE2 kernels, 4 or 8 pixels per iteration. Without pshufb, 24 bit pixels
+// are picked out of a register by byte shifts, and red and blue are swapped
+// by shifts and masks. The lookups stay scalar, SSE2 has no gather.
+
+
+//! swaps red and blue of 4 32 bit pixels
+static _IRR_TARGET_SSE2_ inline __m128i swapRedBlueSSE2(__m128i p)
+{
+	const __m128i rb = _mm_set1_epi32(0x00FF00FF);
+
+	__m128i c = _mm_and_si128(p, rb);
+	c = _mm_or_si128(_mm_srli_epi32(c, 16), _mm_slli_epi32(c, 16));
+
+	return _mm_or_si128(_mm_andnot_si128(rb, p), c);
+}
+
+
+
+//! loads 4 24 bit pixels as 32 bit pixels with an alpha of 0. Reads 16 bytes.
+static _IRR_TARGET_SSE2_ inline __m128i load24SSE2(const u8* in, bool rgb)
+{
+	const __m128i v = _mm_loadu_si128((const __m128i*)in);
+	__m128i lo = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+	__m128i hi = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+	__m128i p = _mm_and_si128(_mm_unpacklo_epi64(lo, hi), _mm_set1_epi32(0x00FFFFFF));
+
+	return rgb ? swapRedBlueSSE2(p) : p;
+}
+
+
+
+//! quantizes 4 32 bit pixels to A1R5G5B5, in the low half of each pixel
+static _IRR_TARGET_SSE2_ inline __m128i quantizeSSE2(__m128i p, __m128i alphaMask, __m128i dither)
+{
+	p = _mm_adds_epu8(p, dither);
+
+	__m128i c = _mm_or_si128(
+		_mm_and_si128(_mm_srli_epi32(p, 9), _mm_set1_epi32(0x7C00)),
+		_mm_and_si128(_mm_srli_epi32(p, 6), _mm_set1_epi32(0x03E0)));
+	c = _mm_or_si128(c, _mm_and_si128(_mm_srli_epi32(p, 3), _mm_set1_epi32(0x001F)));
+
+	return _mm_or_si128(c, _mm_and_si128(_mm_srli_epi32(p, 16), alphaMask));
+}
+
+
+
+//! packs 8 quantized pixels into 16 bit
+static _IRR_TARGET_SSE2_ inline __m128i pack16SSE2(__m128i a, __m128i b)
+{
+	// sign extended, so packssdw does not saturate the alpha bit
+	a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+	b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+
+	return _mm_packs_epi32(a, b);
+}
+
+
+
+//! returns the dither values for 4 pixels, added to red, green and blue
+static _IRR_TARGET_SSE2_ inline __m128i getDitherSSE2(const u8* dither)
+{
+	if (!dither)
+		return _mm_setzero_si128();
+
+	return _mm_set_epi32(dither[3] * 0x010101, dither[2] * 0x010101,
+		dither[1] * 0x010101, dither[0] * 0x010101);
+}
+
+
+
+//! expands 4 A1R5G5B5 pixels in the low half of each 32 bit lane
+static _IRR_TARGET_SSE2_ inline __m128i expand16SSE2(__m128i c)
+{
+	__m128i p = _mm_or_si128(
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x8000)), 16),
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x7C00)), 9));
+	p = _mm_or_si128(p, _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x03E0)), 6));
+
+	return _mm_or_si128(p, _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001F)), 3));
+}
+
+
+
+//! converts a row of 24 bit pixels into X8R8G8B8 pixels
+static _IRR_TARGET_SSE2_ void convert24To32SSE2(const u8* in, s32* out, s32 count, bool rgb)
+{
+	s32 i = 0;
+
+	// the last load reads 4 bytes more than the 4 pixels have
+	for (; i+6 <= count; i += 4)
+		_mm_storeu_si128((__m128i*)(out + i), load24SSE2(in + 3*i, rgb));
+
+	convert24To32(in + 3*i, out + i, count - i, rgb);
+}
+
+
+
+//! converts a row of 24 bit pixels into R5G5B5 pixels
+static _IRR_TARGET_SSE2_ void convert24To16SSE2(const u8* in, s16* out, s32 count, bool rgb, const u8* dither)
 {
-	s16* p = out + width * height;
+	const __m128i d = getDitherSSE2(dither);
+	const __m128i noAlpha = _mm_setzero_si128();
+	s32 i = 0;
 
-	for (s32 y=0; y<height; ++y)
+	for (; i+10 <= count; i += 8)
 	{
-		s32 shift = 7;
-		out = p - y * width - width;
+		__m128i a = quantizeSSE2(load24SSE2(in + 3*i, rgb), noAlpha, d);
+		__m128i b = quantizeSSE2(load24SSE2(in + 3*i + 12, rgb), noAlpha, d);
+
+		_mm_storeu_si128((__m128i*)(out + i), pack16SSE2(a, b));
+	}
+
+	convert24To16(in + 3*i, out + i, count - i, rgb, dither);
+}
 
-		for (s32 x=0; x<width; ++x)
-		{
-			*out = *in>>shift & 0x01 ? (s16)0xffff : (s16)0x0000;
-			++out;
-							
-			--shift;
-			if (shift<0)
-			{
-				shift=7;
-				++in;
-			}
-		}
 
-		if (shift != 7)
-			++in;
 
-		in += pitch;
+//! converts a row of 32 bit pixels into A8R8G8B8 pixels
+static _IRR_TARGET_SSE2_ void convert32To32SSE2(const u8* in, s32* out, s32 count, bool rgb, bool alpha)
+{
+	const __m128i mask = _mm_set1_epi32(alpha ? 0xFFFFFFFF : 0x00FFFFFF);
+	s32 i = 0;
+
+	for (; i+4 <= count; i += 4)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i*)(in + 4*i));
+
+		if (rgb)
+			p = swapRedBlueSSE2(p);
+
+		_mm_storeu_si128((__m128i*)(out + i), _mm_and_si128(p, mask));
 	}
+
+	convert32To32(in + 4*i, out + i, count - i, rgb, alpha);
 }
 
 
-//! converts R8G8B8 24 bit data to A1R5G5B5 data, and flips and 
-//! mirrors the image during the process.
-void CColorConverter::convert24BitTo16BitFlipMirror(const c8* in, s16* out, s32 width, s32 height, s32 pitch)
+
+//! converts a row of 32 bit pixels into A1R5G5B5 pixels
+static _IRR_TARGET_SSE2_ void convert32To16SSE2(const u8* in, s16* out, s32 count, bool rgb, bool alpha, const u8* dither)
 {
-	const c8 *p = in;
-	const s32 lineWidth = 3 * width + pitch;
-	out += width * height;
+	const __m128i d = getDitherSSE2(dither);
+	const __m128i alphaMask = _mm_set1_epi32(alpha ? 0x8000 : 0);
+	s32 i = 0;
 
-	for (s32 y=0; y<height; ++y)
+	for (; i+8 <= count; i += 8)
 	{
-		for (s32 x=0; x<width; ++x)
+		__m128i a = _mm_loadu_si128((const __m128i*)(in + 4*i));
+		__m128i b = _mm_loadu_si128((const __m128i*)(in + 4*i + 16));
+
+		if (rgb)
 		{
-			p = in + (width-x-1)*3;
-			--out;
-			*out = RGB16(p[2], p[1], *p);
+			a = swapRedBlueSSE2(a);
+			b = swapRedBlueSSE2(b);
 		}
 
-		in += lineWidth;
+		_mm_storeu_si128((__m128i*)(out + i),
+			pack16SSE2(quantizeSSE2(a, alphaMask, d), quantizeSSE2(b, alphaMask, d)));
 	}
+
+	convert32To16(in + 4*i, out + i, count - i, rgb, alpha, dither);
 }
 
 
-//! converts R8G8B8 24 bit data to A1R5G5B5 data (used e.g for JPG to A1R5G5B5)
-void CColorConverter::convert24BitTo16BitColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch)
+
+//! converts a row of A1R5G5B5 pixels into A8R8G8B8 pixels
+static _IRR_TARGET_SSE2_ void convert16To32SSE2(const s16* in, s32* out, s32 count)
 {
-	const c8 *p = in;
-	const s32 lineWidth = 3 * width + pitch;
+	const __m128i zero = _mm_setzero_si128();
+	s32 i = 0;
 
-	for (s32 y=0; y<height; ++y)
+	for (; i+8 <= count; i += 8)
 	{
-		for (s32 x=0; x<width; ++x)
-		{
-			p = in + (width-x-1)*3;
-			*out = RGB16(*p, p[1], p[2]);
-			++out;
-		}
+		__m128i c = _mm_loadu_si128((const __m128i*)(in + i));
 
-		in += lineWidth;
+		_mm_storeu_si128((__m128i*)(out + i), expand16SSE2(_mm_unpacklo_epi16(c, zero)));
+		_mm_storeu_si128((__m128i*)(out + i + 4), expand16SSE2(_mm_unpackhi_epi16(c, zero)));
 	}
+
+	convert16To32(in + i, out + i, count - i);
 }
 
 
-//! converts R8G8B8 24 bit data to A1R5G5B5 data (used e.g for JPG to A1R5G5B5)
-//! accepts colors in different order.
-void CColorConverter::convert24BitTo16BitFlipColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch)
+
+//! reverses a row of 16 bit pixels, swapping 8 pixels of both ends at once
+static _IRR_TARGET_SSE2_ void reverseRow16SSE2(s16* row, s32 count)
 {
-	const c8 *p = in;
-	const s32 lineWidth = 3 * width + pitch;
+	s32 i = 0;
+	s32 j = count - 8;
 
-	for (s32 y=0; y<height; ++y)
+	for (; i+8 <= j; i += 8, j -= 8)
 	{
-		for (s32 x=0; x<width; ++x)
-		{
-			p = in + (x)*3;
-			*out = RGB16(*p, p[1], p[2]);
-			++out;
-		}
+		__m128i a = _mm_loadu_si128((const __m128i*)(row + i));
+		__m128i b = _mm_loadu_si128((const __m128i*)(row + j));
+
+		a = _mm_shuffle_epi32(_mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0x1B), 0x1B), 0x4E);
+		b = _mm_shuffle_epi32(_mm_shufflehi_epi16(_mm_shufflelo_epi16(b, 0x1B), 0x1B), 0x4E);
+
+		_mm_storeu_si128((__m128i*)(row + i), b);
+		_mm_storeu_si128((__m128i*)(row + j), a);
+	}
+
+	reverseRow16(row + i, j + 8 - i);
+}
+
 
-		in += lineWidth;
+
+//! reverses a row of 32 bit pixels, swapping 4 pixels of both ends at once
+static _IRR_TARGET_SSE2_ void reverseRow32SSE2(s32* row, s32 count)
+{
+	s32 i = 0;
+	s32 j = count - 4;
+
+	for (; i+4 <= j; i += 4, j -= 4)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i*)(row + i));
+		__m128i b = _mm_loadu_si128((const __m128i*)(row + j));
+
+		_mm_storeu_si128((__m128i*)(row + i), _mm_shuffle_epi32(b, 0x1B));
+		_mm_storeu_si128((__m128i*)(row + j), _mm_shuffle_epi32(a, 0x1B));
 	}
+
+	reverseRow32(row + i, j + 4 - i);
 }
 
 
-//! converts X8R8G8B8 32 bit data to A1R5G5B5 data, and flips and 
-//! mirrors the image during the process.
-void CColorConverter::convert32BitTo16BitColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch)
+
+// AVX2 kernels, 8 or 16 pixels per iteration. The bytes of 24 bit and 32
+// bit pixels are rearranged by pshufb, and the lookups use the gather
+// instruction, which loads 8 colors of the palette at once. The rest of a
+// row is converted by the SSE2 or scalar kernels, which are not VEX
+// encoded, so the upper halves of the ymm registers are cleared before.
+
+
+//! returns the pshufb mask moving 4 24 bit pixels of a lane into 32 bit
+static _IRR_TARGET_AVX2_ inline __m256i getShuffle24AVX2(bool rgb)
+{
+	if (rgb)
+		return _mm256_setr_epi8(
+			2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+			2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+
+	return _mm256_setr_epi8(
+		0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+		0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+}
+
+
+
+//! returns the pshufb mask of 32 bit pixels, swapping red and blue if rgb
+static _IRR_TARGET_AVX2_ inline __m256i getShuffle32AVX2(bool rgb)
+{
+	if (rgb)
+		return _mm256_setr_epi8(
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+	return _mm256_setr_epi8(
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+}
+
+
+
+//! loads 8 24 bit pixels as 32 bit pixels with an alpha of 0. Reads 28 bytes.
+static _IRR_TARGET_AVX2_ inline __m256i load24AVX2(const u8* in, __m256i shuffle)
+{
+	__m256i v = _mm256_inserti128_si256(
+		_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)in)),
+		_mm_loadu_si128((const __m128i*)(in + 12)), 1);
+
+	return _mm256_shuffle_epi8(v, shuffle);
+}
+
+
+
+//! quantizes 8 32 bit pixels to A1R5G5B5, in the low half of each pixel
+static _IRR_TARGET_AVX2_ inline __m256i quantizeAVX2(__m256i p, __m256i alphaMask, __m256i dither)
+{
+	p = _mm256_adds_epu8(p, dither);
+
+	__m256i c = _mm256_or_si256(
+		_mm256_and_si256(_mm256_srli_epi32(p, 9), _mm256_set1_epi32(0x7C00)),
+		_mm256_and_si256(_mm256_srli_epi32(p, 6), _mm256_set1_epi32(0x03E0)));
+	c = _mm256_or_si256(c, _mm256_and_si256(_mm256_srli_epi32(p, 3), _mm256_set1_epi32(0x001F)));
+
+	return _mm256_or_si256(c, _mm256_and_si256(_mm256_srli_epi32(p, 16), alphaMask));
+}
+
+
+
+//! packs 16 pixels with sign extended 16 bit values in 32 bit lanes
+static _IRR_TARGET_AVX2_ inline __m256i pack16AVX2(__m256i a, __m256i b)
+{
+	// packssdw works per 128 bit lane, the permute puts the pixels in order
+	return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+}
+
+
+
+//! sign extends the low halves of 32 bit lanes
+static _IRR_TARGET_AVX2_ inline __m256i signExtend16AVX2(__m256i c)
+{
+	return _mm256_srai_epi32(_mm256_slli_epi32(c, 16), 16);
+}
+
+
+
+//! returns the dither values for 8 pixels, added to red, green and blue
+static _IRR_TARGET_AVX2_ inline __m256i getDitherAVX2(const u8* dither)
+{
+	if (!dither)
+		return _mm256_setzero_si256();
+
+	return _mm256_set_epi32(dither[3] * 0x010101, dither[2] * 0x010101,
+		dither[1] * 0x010101, dither[0] * 0x010101, dither[3] * 0x010101,
+		dither[2] * 0x010101, dither[1] * 0x010101, dither[0] * 0x010101);
+}
+
+
+
+//! expands 8 A1R5G5B5 pixels in the low half of each 32 bit lane
+static _IRR_TARGET_AVX2_ inline __m256i expand16AVX2(__m256i c)
+{
+	__m256i p = _mm256_or_si256(
+		_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x8000)), 16),
+		_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x7C00)), 9));
+	p = _mm256_or_si256(p, _mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x03E0)), 6));
+
+	return _mm256_or_si256(p, _mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x001F)), 3));
+}
+
+
+
+//! converts a row of 24 bit pixels into X8R8G8B8 pixels
+static _IRR_TARGET_AVX2_ void convert24To32AVX2(const u8* in, s32* out, s32 count, bool rgb)
 {
-	const c8 *p = in;
-	const s32 lineWidth = 4 * width + pitch;
+	const __m256i shuffle = getShuffle24AVX2(rgb);
+	s32 i = 0;
+
+	// the last load reads 4 bytes more than the 8 pixels have
+	for (; i+10 <= count; i += 8)
+		_mm256_storeu_si256((__m256i*)(out + i), load24AVX2(in + 3*i, shuffle));
+
+	_mm256_zeroupper();
+	convert24To32SSE2(in + 3*i, out + i, count - i, rgb);
+}
+
 
-	for (s32 y=0; y<height; ++y)
+
+//! converts a row of 24 bit pixels into R5G5B5 pixels
+static _IRR_TARGET_AVX2_ void convert24To16AVX2(const u8* in, s16* out, s32 count, bool rgb, const u8* dither)
+{
+	const __m256i shuffle = getShuffle24AVX2(rgb);
+	const __m256i d = getDitherAVX2(dither);
+	const __m256i noAlpha = _mm256_setzero_si256();
+	s32 i = 0;
+
+	for (; i+18 <= count; i += 16)
 	{
-		for (s32 x=0; x<width; ++x)
+		__m256i a = quantizeAVX2(load24AVX2(in + 3*i, shuffle), noAlpha, d);
+		__m256i b = quantizeAVX2(load24AVX2(in + 3*i + 24, shuffle), noAlpha, d);
+
+		_mm256_storeu_si256((__m256i*)(out + i), pack16AVX2(signExtend16AVX2(a), signExtend16AVX2(b)));
+	}
+
+	_mm256_zeroupper();
+	convert24To16SSE2(in + 3*i, out + i, count - i, rgb, dither);
+}
+
+
+
+//! converts a row of 32 bit pixels into A8R8G8B8 pixels
+static _IRR_TARGET_AVX2_ void convert32To32AVX2(const u8* in, s32* out, s32 count, bool rgb, bool alpha)
+{
+	const __m256i shuffle = getShuffle32AVX2(rgb);
+	const __m256i mask = _mm256_set1_epi32(alpha ? 0xFFFFFFFF : 0x00FFFFFF);
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+	{
+		__m256i p = _mm256_loadu_si256((const __m256i*)(in + 4*i));
+		p = _mm256_and_si256(_mm256_shuffle_epi8(p, shuffle), mask);
+
+		_mm256_storeu_si256((__m256i*)(out + i), p);
+	}
+
+	_mm256_zeroupper();
+	convert32To32SSE2(in + 4*i, out + i, count - i, rgb, alpha);
+}
+
+
+
+//! converts a row of 32 bit pixels into A1R5G5B5 pixels
+static _IRR_TARGET_AVX2_ void convert32To16AVX2(const u8* in, s16* out, s32 count, bool rgb, bool alpha, const u8* dither)
+{
+	const __m256i shuffle = getShuffle32AVX2(rgb);
+	const __m256i d = getDitherAVX2(dither);
+	const __m256i alphaMask = _mm256_set1_epi32(alpha ? 0x8000 : 0);
+	s32 i = 0;
+
+	for (; i+16 <= count; i += 16)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i*)(in + 4*i));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(in + 4*i + 32));
+
+		a = quantizeAVX2(_mm256_shuffle_epi8(a, shuffle), alphaMask, d);
+		b = quantizeAVX2(_mm256_shuffle_epi8(b, shuffle), alphaMask, d);
+
+		_mm256_storeu_si256((__m256i*)(out + i), pack16AVX2(signExtend16AVX2(a), signExtend16AVX2(b)));
+	}
+
+	_mm256_zeroupper();
+	convert32To16SSE2(in + 4*i, out + i, count - i, rgb, alpha, dither);
+}
+
+
+
+//! converts a row of A1R5G5B5 pixels into A8R8G8B8 pixels
+static _IRR_TARGET_AVX2_ void convert16To32AVX2(const s16* in, s32* out, s32 count)
+{
+	s32 i = 0;
+
+	for (; i+16 <= count; i += 16)
+	{
+		__m128i lo = _mm_loadu_si128((const __m128i*)(in + i));
+		__m128i hi = _mm_loadu_si128((const __m128i*)(in + i + 8));
+
+		_mm256_storeu_si256((__m256i*)(out + i), expand16AVX2(_mm256_cvtepu16_epi32(lo)));
+		_mm256_storeu_si256((__m256i*)(out + i + 8), expand16AVX2(_mm256_cvtepu16_epi32(hi)));
+	}
+
+	_mm256_zeroupper();
+	convert16To32SSE2(in + i, out + i, count - i);
+}
+
+
+
+//! replaces indices by 16 bit colors
+static _IRR_TARGET_AVX2_ void lookup8To16AVX2(const u8* in, s16* out, s32 count, const s32* palette)
+{
+	s32 i = 0;
+
+	for (; i+16 <= count; i += 16)
+	{
+		__m256i a = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in + i)));
+		__m256i b = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in + i + 8)));
+
+		a = _mm256_i32gather_epi32((const int*)palette, a, 4);
+		b = _mm256_i32gather_epi32((const int*)palette, b, 4);
+
+		_mm256_storeu_si256((__m256i*)(out + i), pack16AVX2(a, b));
+	}
+
+	_mm256_zeroupper();
+	lookup8To16(in + i, out + i, count - i, palette);
+}
+
+
+
+//! replaces indices by 32 bit colors
+static _IRR_TARGET_AVX2_ void lookup8To32AVX2(const u8* in, s32* out, s32 count, const s32* palette)
+{
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+	{
+		__m256i c = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(in + i)));
+		_mm256_storeu_si256((__m256i*)(out + i), _mm256_i32gather_epi32((const int*)palette, c, 4));
+	}
+
+	_mm256_zeroupper();
+	lookup8To32(in + i, out + i, count - i, palette);
+}
+
+
+
+//! reverses a row of 16 bit pixels, swapping 16 pixels of both ends at once
+static _IRR_TARGET_AVX2_ void reverseRow16AVX2(s16* row, s32 count)
+{
+	const __m256i shuffle = _mm256_setr_epi8(
+		14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+		14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+	s32 i = 0;
+	s32 j = count - 16;
+
+	for (; i+16 <= j; i += 16, j -= 16)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i*)(row + i));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(row + j));
+
+		a = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(a, shuffle), 0x4E);
+		b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(b, shuffle), 0x4E);
+
+		_mm256_storeu_si256((__m256i*)(row + i), b);
+		_mm256_storeu_si256((__m256i*)(row + j), a);
+	}
+
+	_mm256_zeroupper();
+	reverseRow16SSE2(row + i, j + 16 - i);
+}
+
+
+
+//! reverses a row of 32 bit pixels, swapping 8 pixels of both ends at once
+static _IRR_TARGET_AVX2_ void reverseRow32AVX2(s32* row, s32 count)
+{
+	const __m256i order = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+	s32 i = 0;
+	s32 j = count - 8;
+
+	for (; i+8 <= j; i += 8, j -= 8)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i*)(row + i));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(row + j));
+
+		_mm256_storeu_si256((__m256i*)(row + i), _mm256_permutevar8x32_epi32(b, order));
+		_mm256_storeu_si256((__m256i*)(row + j), _mm256_permutevar8x32_epi32(a, order));
+	}
+
+	_mm256_zeroupper();
+	reverseRow32SSE2(row + i, j + 8 - i);
+}
+
+#endif // _IRR_CONVERT_KERNELS_X86_
+
+
+
+//! the kernels of every instruction set
+static const SConvertKernels ConvertKernels[ESKS_COUNT] =
+{
+	{ "scalar", convert24To32, convert24To16, convert32To32, convert32To16, convert16To32,
+		lookup8To16, lookup8To32, reverseRow16, reverseRow32 },
+#ifdef _IRR_CONVERT_KERNELS_X86_
+	{ "SSE2", convert24To32SSE2, convert24To16SSE2, convert32To32SSE2, convert32To16SSE2, convert16To32SSE2,
+		lookup8To16, lookup8To32, reverseRow16SSE2, reverseRow32SSE2 },
+	{ "AVX2", convert24To32AVX2, convert24To16AVX2, convert32To32AVX2, convert32To16AVX2, convert16To32AVX2,
+		lookup8To16AVX2, lookup8To32AVX2, reverseRow16AVX2, reverseRow32AVX2 }
+#endif
+};
+
+
+
+//! returns the convert kernels of an instruction set
+const SConvertKernels* getConvertKernels(ESpanKernelSet set)
+{
+	if (!isKernelSetSupported(set))
+		return 0;
+
+	return &ConvertKernels[set];
+}
+
+
+
+//! returns the fastest convert kernels the processor supports
+const SConvertKernels* getConvertKernels()
+{
+	static const SConvertKernels* best = 0;
+
+	for (s32 i=ESKS_COUNT-1; !best && i>=0; --i)
+		best = getConvertKernels((ESpanKernelSet)i);
+
+	return best;
+}
+
+
+
+//! converts the rows of a 24 or 32 bit image into A8R8G8B8 or A1R5G5B5 rows
+//! \param out: First row of the target, or the last one if outPitch is
+//! negative.
+//! \param outPitch: Pixels from one row of the target to the next.
+static void convertImage(const u8* in, s32 inBytes, s32 pitch, void* out, ECOLOR_FORMAT outFormat,
+	s32 outPitch, s32 width, s32 height, bool rgb, bool alpha, bool mirror, bool dither)
+{
+	const SConvertKernels* kernels = getConvertKernels();
+	const s32 lineWidth = inBytes * width + pitch;
+
+	for (s32 y=0; y<height; ++y, in+=lineWidth)
+	{
+		if (outFormat == EHCF_A8R8G8B8)
 		{
-			p = in + (width-x-1)*4;
-			*out = RGB16(p[2], p[1], p[0]);
-			++out;
+			s32* row = (s32*)out + y*outPitch;
+
+			if (inBytes == 3)
+				kernels->Convert24To32(in, row, width, rgb);
+			else
+				kernels->Convert32To32(in, row, width, rgb, alpha);
+
+			if (mirror)
+				kernels->ReverseRow32(row, width);
 		}
+		else
+		{
+			s16* row = (s16*)out + y*outPitch;
+			const u8* d = dither ? getDitherRow(outPitch < 0 ? height-1-y : y) : 0;
+
+			if (inBytes == 3)
+				kernels->Convert24To16(in, row, width, rgb, d);
+			else
+				kernels->Convert32To16(in, row, width, rgb, alpha, d);
 
-		in += lineWidth;
+			if (mirror)
+				kernels->ReverseRow16(row, width);
+		}
 	}
 }
 
 
-//! converts X8R8G8B8 32 bit data to A1R5G5B5 data, and flips and 
-//! mirrors the image during the process.
-void CColorConverter::convert32BitTo16BitFlipMirrorColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch)
+
+//! replaces the 1, 4 or 8 bit indices of an image by colors, and flips it
+//! \param colors: Colors in the format of the target, sign extended to 32
+//! bit for A1R5G5B5.
+static void lookupImage(const u8* in, s32 bits, s32 pitch, void* out, ECOLOR_FORMAT outFormat,
+	s32 width, s32 height, const s32* colors)
 {
-	const c8 *p = in;
-	const s32 lineWidth = 4 * width + pitch;
-	out += (width+pitch) * height;
+	const SConvertKernels* kernels = getConvertKernels();
+	const s32 lineWidth = (bits * width + 7) / 8 + pitch;
+	u8* indices = bits == 8 ? 0 : new u8[width];
 
-	for (s32 y=0; y<height; ++y)
+	for (s32 y=0; y<height; ++y, in+=lineWidth)
 	{
-		for (s32 x=0; x<width; ++x)
+		const u8* row = in;
+
+		if (bits == 4)
 		{
-			p = in + (width-x-1)*4;
-			--out;
-			*out = RGB16(p[2], p[1], p[0]);
+			// the high nibble first
+			for (s32 x=0; x<width; ++x)
+				indices[x] = (in[x>>1] >> ((~x & 1) << 2)) & 0xF;
+
+			row = indices;
+		}
+		else
+		if (bits == 1)
+		{
+			// the highest bit first
+			for (s32 x=0; x<width; ++x)
+				indices[x] = (in[x>>3] >> (7 - (x & 7))) & 0x1;
+
+			row = indices;
 		}
 
-		in += lineWidth;
+		const s32 offset = (height-1-y) * width;
+
+		if (outFormat == EHCF_A8R8G8B8)
+			kernels->Lookup8To32(row, (s32*)out + offset, width, colors);
+		else
+			kernels->Lookup8To16(row, (s16*)out + offset, width, colors);
 	}
+
+	delete [] indices;
+}
+
+
+
+//! converts a 4 bit palettized image into R5G5B5
+void CColorConverter::convert4BitTo16BitFlipMirror(const c8* in, s16* out, s32 width, s32 height, s32 pitch, const s32* palette)
+{
+	s32 colors[16];
+	for (s32 i=0; i<16; ++i)
+		colors[i] = X8R8G8B8toA1R5G5B5(palette[i]);
+
+	lookupImage((const u8*)in, 4, pitch, out, EHCF_R5G5B5, width, height, colors);
+}
+
+
+
+
+//! converts a 8 bit palettized image into R5G5B5
+void CColorConverter::convert8BitTo16BitFlipMirror(const c8* in, s16* out, s32 width, s32 height, s32 pitch, const s32* palette)
+{
+	s32 colors[256];
+	for (s32 i=0; i<256; ++i)
+		colors[i] = X8R8G8B8toA1R5G5B5(palette[i]);
+
+	lookupImage((const u8*)in, 8, pitch, out, EHCF_R5G5B5, width, height, colors);
+}
+
+
+//! converts a monochrome bitmap to A1R5G5B5 data
+void CColorConverter::convert1BitTo16BitFlipMirror(const c8* in, s16* out, s32 width, s32 height, s32 pitch)
+{
+	const s32 colors[2] = { 0, (s16)0xffff };
+
+	lookupImage((const u8*)in, 1, pitch, out, EHCF_R5G5B5, width, height, colors);
+}
+
+
+//! converts R8G8B8 24 bit data to A1R5G5B5 data, and flips and 
+//! mirrors the image during the process.
+void CColorConverter::convert24BitTo16BitFlipMirror(const c8* in, s16* out, s32 width, s32 height, s32 pitch, bool dither)
+{
+	convertImage((const u8*)in, 3, pitch, out + (height-1)*width, EHCF_R5G5B5, -width,
+		width, height, false, false, false, dither);
+}
+
+
+//! converts R8G8B8 24 bit data to A1R5G5B5 data (used e.g for JPG to A1R5G5B5)
+void CColorConverter::convert24BitTo16BitColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch, bool dither)
+{
+	convertImage((const u8*)in, 3, pitch, out, EHCF_R5G5B5, width,
+		width, height, true, false, true, dither);
+}
+
+
+//! converts R8G8B8 24 bit data to A1R5G5B5 data (used e.g for JPG to A1R5G5B5)
+//! accepts colors in different order.
+void CColorConverter::convert24BitTo16BitFlipColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch, bool dither)
+{
+	convertImage((const u8*)in, 3, pitch, out, EHCF_R5G5B5, width,
+		width, height, true, false, false, dither);
+}
+
+
+//! converts X8R8G8B8 32 bit data to A1R5G5B5 data, and flips and 
+//! mirrors the image during the process.
+void CColorConverter::convert32BitTo16BitColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch, bool dither)
+{
+	convertImage((const u8*)in, 4, pitch, out, EHCF_R5G5B5, width,
+		width, height, false, false, true, dither);
+}
+
+
+//! converts X8R8G8B8 32 bit data to A1R5G5B5 data, and flips and 
+//! mirrors the image during the process.
+void CColorConverter::convert32BitTo16BitFlipMirrorColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch, bool dither)
+{
+	convertImage((const u8*)in, 4, pitch, out + (width+pitch)*height - width, EHCF_R5G5B5, -width,
+		width, height, false, false, false, dither);
 }
 
 
@@ -212,32 +922,176 @@ void CColorConverter::convert16bitToA8R8G8B8andResize(const s16* in, s32* out, s
 	if (!newWidth || !newHeight)
 		return;
 
-	// note: this is very very slow. (i didn't want to write a fast version.
-	// but hopefully, nobody wants to convert surfaces every frame.	
+	// the source pixels of a row are picked into a row of the new width,
+	// which is converted at once
+
+	f32 sourceXStep = (f32)currentWidth / (f32)newWidth;
+	f32 sourceYStep = (f32)currentHeight / (f32)newHeight;
+	f32 sy = 0.0f;
 
-	s32 nDataSize = newWidth * newHeight;
-	s32 nDataSizeInBytes = nDataSize * sizeof(s32);
-	//s32* nData = new s32[nDataSize];
+	s16* row = new s16[newWidth];
+	const TConvert16To32 convert = getConvertKernels()->Convert16To32;
+
+	for (s32 y=0; y<newHeight; ++y)
+	{
+		const s32 start = ((s32)sy)*currentWidth;
+
+		for (s32 x=0; x<newWidth; ++x)
+			row[x] = in[(s32)(start + x*sourceXStep)];
+
+		convert(row, out + y*newWidth, newWidth);
+		sy+=sourceYStep;
+	}
+
+	delete [] row;
+}
 
+
+
+//! Resizes A8R8G8B8 data to a new size.
+void CColorConverter::convert32bitToA8R8G8B8andResize(const s32* in, s32* out, s32 newWidth, s32 newHeight, s32 currentWidth, s32 currentHeight)
+{
+	if (!newWidth || !newHeight)
+		return;
+
+	// row by row, the old loops went down the columns and missed the
+	// cache with every pixel
 	f32 sourceXStep = (f32)currentWidth / (f32)newWidth;
 	f32 sourceYStep = (f32)currentHeight / (f32)newHeight;
-	f32 sy;
-	s32 t;
+	f32 sy = 0.0f;
 
-	for (s32 x=0; x<newWidth; ++x)
+	for (s32 y=0; y<newHeight; ++y)
 	{
-		sy = 0.0f;
+		const s32 start = ((s32)sy)*currentWidth;
+		s32* o = out + y*newWidth;
 
-		for (s32 y=0; y<newHeight; ++y)
-		{
-			t = in[(s32)(((s32)sy)*currentWidth + x*sourceXStep)];
-			t = (((t >> 15)&0x1)<<31) |	(((t >> 10)&0x1F)<<19) |
-				(((t >> 5)&0x1F)<<11) |	(t&0x1F)<<3;
-			out[(s32)(y*newWidth + x)] = t;
+		for (s32 x=0; x<newWidth; ++x)
+			o[x] = in[(s32)(start + x*sourceXStep)];
 
-			sy+=sourceYStep;
-		}
+		sy+=sourceYStep;
+	}
+}
+
+
+
+//! converts a 4 bit palettized image into X8R8G8B8
+void CColorConverter::convert4BitTo32BitFlipMirror(const c8* in, s32* out, s32 width, s32 height, s32 pitch, const s32* palette)
+{
+	s32 colors[16];
+	for (s32 i=0; i<16; ++i)
+		colors[i] = palette[i] & 0x00ffffff;
+
+	lookupImage((const u8*)in, 4, pitch, out, EHCF_A8R8G8B8, width, height, colors);
+}
+
+
+
+//! converts a 8 bit palettized image into X8R8G8B8
+void CColorConverter::convert8BitTo32BitFlipMirror(const c8* in, s32* out, s32 width, s32 height, s32 pitch, const s32* palette)
+{
+	s32 colors[256];
+	for (s32 i=0; i<256; ++i)
+		colors[i] = palette[i] & 0x00ffffff;
+
+	lookupImage((const u8*)in, 8, pitch, out, EHCF_A8R8G8B8, width, height, colors);
+}
+
+
+
+//! converts a monochrome bitmap to A8R8G8B8 data
+void CColorConverter::convert1BitTo32BitFlipMirror(const c8* in, s32* out, s32 width, s32 height, s32 pitch)
+{
+	const s32 colors[2] = { 0, (s32)0xffffffff };
+
+	lookupImage((const u8*)in, 1, pitch, out, EHCF_A8R8G8B8, width, height, colors);
+}
+
+
+
+//! converts R8G8B8 24 bit data to X8R8G8B8 data, and flips and 
+//! mirrors the image during the process.
+void CColorConverter::convert24BitTo32BitFlipMirror(const c8* in, s32* out, s32 width, s32 height, s32 pitch)
+{
+	convert24BitTo32Bit(in, out, width, height, pitch, false, true);
+}
+
+
+
+//! converts R8G8B8 24 bit data to X8R8G8B8 data (used e.g for JPG)
+//! accepts colors in different order.
+void CColorConverter::convert24BitTo32BitFlipColorShuffle(const c8* in, s32* out, s32 width, s32 height, s32 pitch)
+{
+	convert24BitTo32Bit(in, out, width, height, pitch, true, false);
+}
+
+
+
+//! converts X8R8G8B8 32 bit data to X8R8G8B8 data, mirrors the image
+//! and accepts colors in different order.
+void CColorConverter::convert32BitTo32BitColorShuffle(const c8* in, s32* out, s32 width, s32 height, s32 pitch)
+{
+	convertImage((const u8*)in, 4, pitch, out, EHCF_A8R8G8B8, width,
+		width, height, false, false, true, false);
+}
+
+
+
+//! converts A8R8G8B8 32 bit data to A8R8G8B8 data, and flips and 
+//! mirrors the image during the process, accepts colors in different order.
+void CColorConverter::convert32BitTo32BitFlipMirrorColorShuffle(const c8* in, s32* out, s32 width, s32 height, s32 pitch)
+{
+	convert32BitTo32Bit(in, out, width, height, pitch, false, true);
+}
+
+
+
+//! converts R8G8B8 or B8G8R8 24 bit data to X8R8G8B8 data
+void CColorConverter::convert24BitTo32Bit(const c8* in, s32* out, s32 width, s32 height, s32 pitch, bool rgb, bool flip)
+{
+	if (flip)
+		convertImage((const u8*)in, 3, pitch, out + (height-1)*width, EHCF_A8R8G8B8, -width,
+			width, height, rgb, false, false, false);
+	else
+		convertImage((const u8*)in, 3, pitch, out, EHCF_A8R8G8B8, width,
+			width, height, rgb, false, false, false);
+}
+
+
+
+//! converts R8G8B8A8 or B8G8R8A8 32 bit data to A8R8G8B8 data
+void CColorConverter::convert32BitTo32Bit(const c8* in, s32* out, s32 width, s32 height, s32 pitch, bool rgb, bool flip)
+{
+	if (flip)
+		convertImage((const u8*)in, 4, pitch, out + (height-1)*width, EHCF_A8R8G8B8, -width,
+			width, height, rgb, true, false, false);
+	else
+		convertImage((const u8*)in, 4, pitch, out, EHCF_A8R8G8B8, width,
+			width, height, rgb, true, false, false);
+}
+
+
+
+//! converts a row of pixels from one color format into another.
+void CColorConverter::convertRow(const void* in, ECOLOR_FORMAT inFormat, s32 count, void* out, ECOLOR_FORMAT outFormat)
+{
+	if (inFormat == outFormat)
+	{
+		memcpy(out, in, count * (inFormat == EHCF_A8R8G8B8 ? sizeof(s32) : sizeof(s16)));
+		return;
 	}
+
+	if (inFormat == EHCF_A8R8G8B8)
+		getConvertKernels()->Convert32To16((const u8*)in, (s16*)out, count, false, true, 0);
+	else
+		getConvertKernels()->Convert16To32((const s16*)in, (s32*)out, count);
+}
+
+
+
+//! converts a row of A8R8G8B8 pixels into dithered A1R5G5B5 pixels
+void CColorConverter::convertRowDithered(const s32* in, s16* out, s32 count, s32 y)
+{
+	getConvertKernels()->Convert32To16((const u8*)in, out, count, false, true, getDitherRow(y));
 }
 
 } // end namespace video
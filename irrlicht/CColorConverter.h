@@ -5,11 +5,75 @@
 #ifndef __C_COLOR_CONVERTER_H_INCLUDED__
 #define __C_COLOR_CONVERTER_H_INCLUDED__
 
+#include "ITexture.h"
+#include "CTRSpanKernels.h"
+
 namespace irr
 {
 namespace video
 {
+	//! converts a row of 24 bit pixels into X8R8G8B8 pixels with an alpha
+	//! of 0. The bytes of a pixel are blue, green, red, or red, green, blue
+	//! if rgb is true.
+	typedef void (*TConvert24To32)(const u8* in, s32* out, s32 count, bool rgb);
+
+	//! converts a row of 24 bit pixels into R5G5B5 pixels without alpha bit
+	//! \param dither: 4 values from 0 to 7 added to the channels of the
+	//! pixels at x%4 before they lose their lowest 3 bits, or 0.
+	typedef void (*TConvert24To16)(const u8* in, s16* out, s32 count, bool rgb, const u8* dither);
+
+	//! converts a row of 32 bit pixels into A8R8G8B8 pixels. The bytes of a
+	//! pixel are blue, green, red, alpha, or red, green, blue, alpha if rgb
+	//! is true. Without alpha, the alpha of the pixels is 0.
+	typedef void (*TConvert32To32)(const u8* in, s32* out, s32 count, bool rgb, bool alpha);
+
+	//! converts a row of 32 bit pixels into A1R5G5B5 pixels, the alpha bit
+	//! is set if alpha is true and the alpha of the pixel is 128 or more.
+	typedef void (*TConvert32To16)(const u8* in, s16* out, s32 count, bool rgb, bool alpha, const u8* dither);
+
+	//! converts a row of A1R5G5B5 pixels into A8R8G8B8 pixels
+	typedef void (*TConvert16To32)(const s16* in, s32* out, s32 count);
+
+	//! replaces 8 bit indices by the colors of a palette. The 16 bit
+	//! version takes the 16 bit colors sign extended to 32 bit.
+	typedef void (*TLookup8To16)(const u8* in, s16* out, s32 count, const s32* palette);
+	typedef void (*TLookup8To32)(const u8* in, s32* out, s32 count, const s32* palette);
+
+	//! reverses the order of the pixels of a row, for mirrored images
+	typedef void (*TReverseRow16)(s16* row, s32 count);
+	typedef void (*TReverseRow32)(s32* row, s32 count);
 
+	//! row functions of the color converter for one instruction set. All
+	//! sets calculate exactly the same pixels.
+	struct SConvertKernels
+	{
+		const c8* Name;
+		TConvert24To32 Convert24To32;
+		TConvert24To16 Convert24To16;
+		TConvert32To32 Convert32To32;
+		TConvert32To16 Convert32To16;
+		TConvert16To32 Convert16To32;
+		TLookup8To16 Lookup8To16;
+		TLookup8To32 Lookup8To32;
+		TReverseRow16 ReverseRow16;
+		TReverseRow32 ReverseRow32;
+	};
+
+	//! returns the fastest convert kernels the processor supports
+	const SConvertKernels* getConvertKernels();
+
+	//! returns the convert kernels of an instruction set, or 0 if the
+	//! processor or the compiler does not support it.
+	const SConvertKernels* getConvertKernels(ESpanKernelSet set);
+
+	//! returns the 4 values added to the channels of the pixels of a row
+	//! when they are dithered to 5 bits, an ordered 4x4 Bayer matrix.
+	const u8* getDitherRow(s32 y);
+
+//! Converts images and rows of pixels between color formats. The images
+//! are converted row by row with the convert kernels. The conversions to
+//! 16 bit can be dithered, which hides the bands of color gradients
+//! quantized to 5 bits per channel by an ordered pattern.
 class CColorConverter
 {
 public:
@@ -25,28 +89,78 @@ public:
 
 	//! converts R8G8B8 24 bit data to A1R5G5B5 data, and flips and 
 	//! mirrors the image during the process.
-	static void convert24BitTo16BitFlipMirror(const c8* in, s16* out, s32 width, s32 height, s32 pitch);
+	static void convert24BitTo16BitFlipMirror(const c8* in, s16* out, s32 width, s32 height, s32 pitch, bool dither = false);
 
 	//! converts R8G8B8 24 bit data to A1R5G5B5 data (used e.g for JPG to A1R5G5B5)
 	//! accepts colors in different order.
-	static void convert24BitTo16BitColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch);
+	static void convert24BitTo16BitColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch, bool dither = false);
 
 	//! converts R8G8B8 24 bit data to A1R5G5B5 data (used e.g for JPG to A1R5G5B5)
 	//! accepts colors in different order.
-	static void convert24BitTo16BitFlipColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch);
+	static void convert24BitTo16BitFlipColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch, bool dither = false);
 
 	//! converts X8R8G8B8 32 bit data to A1R5G5B5 data, and flips and 
 	//! accepts colors in different order.
-	static void convert32BitTo16BitColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch);
+	static void convert32BitTo16BitColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch, bool dither = false);
 
 	//! converts X8R8G8B8 32 bit data to A1R5G5B5 data, and flips and 
 	//! mirrors the image during the process, accepts colors in different order.
-	static void convert32BitTo16BitFlipMirrorColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch);
+	static void convert32BitTo16BitFlipMirrorColorShuffle(const c8* in, s16* out, s32 width, s32 height, s32 pitch, bool dither = false);
 
 	//! Resizes the surface to a new size and converts it at the same time
 	//! to an A8R8G8B8 format, returning the pointer to the new buffer.
 	//! The returned pointer has to be deleted.
 	static void convert16bitToA8R8G8B8andResize(const s16* in, s32* out, s32 newWidth, s32 newHeight, s32 currentWidth, s32 currentHeight);
+
+	//! Resizes A8R8G8B8 data to a new size.
+	static void convert32bitToA8R8G8B8andResize(const s32* in, s32* out, s32 newWidth, s32 newHeight, s32 currentWidth, s32 currentHeight);
+
+	//! converts a 4 bit palettized image into X8R8G8B8
+	static void convert4BitTo32BitFlipMirror(const c8* in, s32* out, s32 width, s32 height, s32 pitch, const s32* palette);
+
+	//! converts a 8 bit palettized image into X8R8G8B8
+	static void convert8BitTo32BitFlipMirror(const c8* in, s32* out, s32 width, s32 height, s32 pitch, const s32* palette);
+
+	//! converts a monochrome bitmap to A8R8G8B8 data
+	static void convert1BitTo32BitFlipMirror(const c8* in, s32* out, s32 width, s32 height, s32 pitch);
+
+	//! converts R8G8B8 24 bit data to X8R8G8B8 data, and flips and 
+	//! mirrors the image during the process.
+	static void convert24BitTo32BitFlipMirror(const c8* in, s32* out, s32 width, s32 height, s32 pitch);
+
+	//! converts R8G8B8 24 bit data to X8R8G8B8 data (used e.g for JPG)
+	//! accepts colors in different order.
+	static void convert24BitTo32BitFlipColorShuffle(const c8* in, s32* out, s32 width, s32 height, s32 pitch);
+
+	//! converts X8R8G8B8 32 bit data to X8R8G8B8 data, mirrors the image
+	//! and accepts colors in different order.
+	static void convert32BitTo32BitColorShuffle(const c8* in, s32* out, s32 width, s32 height, s32 pitch);
+
+	//! converts A8R8G8B8 32 bit data to A8R8G8B8 data, and flips and 
+	//! mirrors the image during the process, accepts colors in different order.
+	static void convert32BitTo32BitFlipMirrorColorShuffle(const c8* in, s32* out, s32 width, s32 height, s32 pitch);
+
+	//! converts R8G8B8 or B8G8R8 24 bit data to X8R8G8B8 data, with an
+	//! alpha of 0.
+	//! \param rgb: The bytes of a pixel are red, green, blue instead of
+	//! blue, green, red.
+	//! \param flip: The first row of the data is the last one of the image.
+	static void convert24BitTo32Bit(const c8* in, s32* out, s32 width, s32 height, s32 pitch, bool rgb, bool flip);
+
+	//! converts R8G8B8A8 or B8G8R8A8 32 bit data to A8R8G8B8 data, keeping
+	//! the alpha of the pixels.
+	//! \param rgb: The bytes of a pixel are red, green, blue, alpha instead
+	//! of blue, green, red, alpha.
+	//! \param flip: The first row of the data is the last one of the image.
+	static void convert32BitTo32Bit(const c8* in, s32* out, s32 width, s32 height, s32 pitch, bool rgb, bool flip);
+
+	//! converts a row of pixels from one color format into another. Only
+	//! EHCF_R5G5B5 and EHCF_A8R8G8B8 are supported.
+	static void convertRow(const void* in, ECOLOR_FORMAT inFormat, s32 count, void* out, ECOLOR_FORMAT outFormat);
+
+	//! converts a row of A8R8G8B8 pixels into A1R5G5B5 pixels, dithered
+	//! with the pattern of row y of the image.
+	static void convertRowDithered(const s32* in, s16* out, s32 count, s32 y);
 };
 
 
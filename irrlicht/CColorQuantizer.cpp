@@ -0,0 +1,257 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "CColorQuantizer.h"
+#include "array.h"
+#include <memory.h>
+
+namespace irr
+{
+namespace video
+{
+
+//! amount of A1R5G5B5 colors
+const s32 QUANTIZER_COLORS = 0x10000;
+
+//! a box of A1R5G5B5 colors, the channels from Min to Max and one alpha bit
+struct SColorBox
+{
+	s32 Min[3], Max[3];		// red, green, blue
+	s32 Alpha;				// 0 or 0x8000
+	u32 Pixels;
+};
+
+
+
+//! returns the A1R5G5B5 color of the channels of a box
+static inline s32 getBoxColor(const SColorBox& box, s32 r, s32 g, s32 b)
+{
+	return box.Alpha | (r<<10) | (g<<5) | b;
+}
+
+
+
+//! shrinks a box to the colors of its pixels and counts them
+static void shrinkBox(SColorBox& box, const u32* histogram)
+{
+	s32 min[3] = { 31, 31, 31 };
+	s32 max[3] = { 0, 0, 0 };
+	box.Pixels = 0;
+
+	for (s32 r=box.Min[0]; r<=box.Max[0]; ++r)
+		for (s32 g=box.Min[1]; g<=box.Max[1]; ++g)
+			for (s32 b=box.Min[2]; b<=box.Max[2]; ++b)
+			{
+				u32 pixels = histogram[getBoxColor(box, r, g, b)];
+
+				if (pixels)
+				{
+					box.Pixels += pixels;
+
+					if (r < min[0]) min[0] = r;
+					if (r > max[0]) max[0] = r;
+					if (g < min[1]) min[1] = g;
+					if (g > max[1]) max[1] = g;
+					if (b < min[2]) min[2] = b;
+					if (b > max[2]) max[2] = b;
+				}
+			}
+
+	for (s32 i=0; i<3; ++i)
+	{
+		box.Min[i] = min[i];
+		box.Max[i] = max[i];
+	}
+}
+
+
+
+//! splits a box at the median of its pixels along its longest side
+static void splitBox(SColorBox& box, SColorBox& second, const u32* histogram)
+{
+	s32 axis = 0;
+	for (s32 i=1; i<3; ++i)
+		if (box.Max[i] - box.Min[i] > box.Max[axis] - box.Min[axis])
+			axis = i;
+
+	// pixels of every slice of the box along the axis
+	u32 slices[32];
+	memset(slices, 0, sizeof(slices));
+
+	s32 c[3];
+	for (c[0]=box.Min[0]; c[0]<=box.Max[0]; ++c[0])
+		for (c[1]=box.Min[1]; c[1]<=box.Max[1]; ++c[1])
+			for (c[2]=box.Min[2]; c[2]<=box.Max[2]; ++c[2])
+				slices[c[axis]] += histogram[getBoxColor(box, c[0], c[1], c[2])];
+
+	// the last slice of the first box, both boxes keep at least one
+	s32 cut = box.Min[axis];
+	u32 pixels = slices[cut];
+
+	while (cut+1 < box.Max[axis] && pixels + slices[cut+1] <= box.Pixels / 2)
+	{
+		++cut;
+		pixels += slices[cut];
+	}
+
+	second = box;
+	second.Min[axis] = cut + 1;
+	box.Max[axis] = cut;
+
+	shrinkBox(box, histogram);
+	shrinkBox(second, histogram);
+}
+
+
+
+//! creates an EHCF_P8 surface with the pixels of a surface
+ISurface* CColorQuantizer::createPalettedSurface(ISurface* surface, ECOLOR_FORMAT paletteFormat)
+{
+	const core::dimension2d<s32>& size = surface->getDimension();
+	const s32 count = size.Width * size.Height;
+
+	ISurface* source = surface;
+
+	if (surface->getColorFormat() != EHCF_A8R8G8B8)
+	{
+		source = createSurface(EHCF_A8R8G8B8, size);
+		surface->copyTo(source, 0, 0);
+	}
+	else
+		source->grab();
+
+	const s32* pixels = (const s32*)source->lock();
+
+	// histogram of the A1R5G5B5 colors. The bits of the channels which
+	// are cut off are summed up for the average colors of the boxes.
+	u32* histogram = new u32[QUANTIZER_COLORS * 5];
+	u32* sums = histogram + QUANTIZER_COLORS;
+	memset(histogram, 0, QUANTIZER_COLORS * 5 * sizeof(u32));
+
+	for (s32 i=0; i<count; ++i)
+	{
+		s32 p = pixels[i];
+		u32 color = (u16)A8R8G8B8toA1R5G5B5(p);
+
+		++histogram[color];
+		sums[color*4 + 0] += (p >> 24) & 0x7F;
+		sums[color*4 + 1] += (p >> 16) & 0x7;
+		sums[color*4 + 2] += (p >> 8) & 0x7;
+		sums[color*4 + 3] += p & 0x7;
+	}
+
+	// median cut, the pixels with the alpha bit start in their own box
+
+	core::array<SColorBox> boxes;
+
+	for (s32 alpha=0; alpha<2; ++alpha)
+	{
+		SColorBox box;
+		box.Alpha = alpha << 15;
+
+		for (s32 i=0; i<3; ++i)
+		{
+			box.Min[i] = 0;
+			box.Max[i] = 31;
+		}
+
+		shrinkBox(box, histogram);
+
+		if (box.Pixels)
+			boxes.push_back(box);
+	}
+
+	while (boxes.size() < 256)
+	{
+		s32 largest = -1;
+
+		for (u32 i=0; i<boxes.size(); ++i)
+			if ((boxes[i].Min[0] != boxes[i].Max[0] || boxes[i].Min[1] != boxes[i].Max[1] ||
+				boxes[i].Min[2] != boxes[i].Max[2]) &&
+				(largest == -1 || boxes[i].Pixels > boxes[largest].Pixels))
+				largest = i;
+
+		if (largest == -1)
+			break;
+
+		SColorBox second;
+		splitBox(boxes[largest], second, histogram);
+		boxes.push_back(second);
+	}
+
+	// the colors of the palette, and the index of every color
+
+	u8* indices = new u8[QUANTIZER_COLORS];
+	ISurface* palette = createSurface(EHCF_A8R8G8B8, core::dimension2d<s32>(256, 1));
+	s32* colors = (s32*)palette->lock();
+	memset(colors, 0, 256 * sizeof(s32));
+
+	for (u32 i=0; i<boxes.size(); ++i)
+	{
+		const SColorBox& box = boxes[i];
+		u32 sum[7] = { 0, 0, 0, 0, 0, 0, 0 };
+
+		for (s32 r=box.Min[0]; r<=box.Max[0]; ++r)
+			for (s32 g=box.Min[1]; g<=box.Max[1]; ++g)
+				for (s32 b=box.Min[2]; b<=box.Max[2]; ++b)
+				{
+					s32 color = getBoxColor(box, r, g, b);
+					u32 n = histogram[color];
+
+					if (!n)
+						continue;
+
+					indices[color] = (u8)i;
+					sum[0] += n * r;
+					sum[1] += n * g;
+					sum[2] += n * b;
+
+					for (s32 j=0; j<4; ++j)
+						sum[3+j] += sums[color*4 + j];
+				}
+
+		// the channels of the boxes are 5 bit, the cut off bits are added
+		// as their average
+		const u32 n = box.Pixels;
+		s32 a = (box.Alpha ? 0x80 : 0) + (sum[3] + n/2) / n;
+		s32 r = ((sum[0] << 3) + sum[4] + n/2) / n;
+		s32 g = ((sum[1] << 3) + sum[5] + n/2) / n;
+		s32 b = ((sum[2] << 3) + sum[6] + n/2) / n;
+
+		colors[i] = (a<<24) | (r<<16) | (g<<8) | b;
+	}
+
+	palette->unlock();
+
+	ISurface* target = 0;
+
+	if (paletteFormat == EHCF_A8R8G8B8)
+		target = video::createPalettedSurface(palette, size);
+	else
+	{
+		ISurface* converted = createSurface(paletteFormat, palette->getDimension());
+		palette->copyTo(converted, 0, 0);
+		target = video::createPalettedSurface(converted, size);
+		converted->drop();
+	}
+
+	palette->drop();
+
+	u8* t = (u8*)target->lock();
+
+	for (s32 i=0; i<count; ++i)
+		t[i] = indices[(u16)A8R8G8B8toA1R5G5B5(pixels[i])];
+
+	target->unlock();
+	source->unlock();
+	source->drop();
+
+	delete [] indices;
+	delete [] histogram;
+
+	return target;
+}
+
+} // end namespace video
+} // end namespace irr
\ No newline at end of file
@@ -0,0 +1,34 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __C_COLOR_QUANTIZER_H_INCLUDED__
+#define __C_COLOR_QUANTIZER_H_INCLUDED__
+
+#include "ISurface.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! reduces the colors of surfaces to palettes of 256 colors
+class CColorQuantizer
+{
+public:
+
+	//! creates an EHCF_P8 surface with the pixels of a surface. The palette
+	//! is chosen by median cut on a histogram of the A1R5G5B5 colors of the
+	//! pixels: the box of colors with the most pixels is split at its
+	//! median, until there are 256 boxes. Every box gets the average color
+	//! of its pixels, so surfaces with 256 or fewer A1R5G5B5 colors keep
+	//! them. Pixels with and without the alpha bit never share a color.
+	//! \param paletteFormat: Color format of the palette, EHCF_R5G5B5 or
+	//! EHCF_A8R8G8B8.
+	static ISurface* createPalettedSurface(ISurface* surface, ECOLOR_FORMAT paletteFormat);
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
\ No newline at end of file
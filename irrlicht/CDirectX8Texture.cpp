@@ -24,11 +24,18 @@ CDirectX8Texture::CDirectX8Texture(ISurface* surface, IDirect3DDevice9* device,
 
 	if (Surface)
 	{
-		Surface->grab();
-
 		core::dimension2d<s32> optSize;
 		SurfaceSize = Surface->getDimension();
 
+		// the texture is A1R5G5B5, so other surfaces are converted once.
+		if (Surface->getColorFormat() != EHCF_R5G5B5)
+		{
+			Surface = createSurface(EHCF_R5G5B5, SurfaceSize);
+			surface->copyTo(Surface, 0, 0);
+		}
+		else
+			Surface->grab();
+
 		optSize.Width = getTextureSizeFromSurfaceSize(SurfaceSize.Width);
 		optSize.Height = getTextureSizeFromSurfaceSize(SurfaceSize.Height);
 
@@ -79,7 +86,7 @@ bool CDirectX8Texture::copyTexture()
 		}
 
 		s16* dest = (s16*)rect.pBits;
-		s16* source = Surface->lock();
+		s16* source = (s16*)Surface->lock();
 		Pitch = rect.Pitch;
 
 
@@ -11,6 +11,8 @@
 
 #ifdef WIN32
 #include <direct.h> // for _chdir
+#else
+#include <unistd.h> // for chdir
 #endif
 
 namespace irr
@@ -84,6 +86,9 @@ const c8* CFileSystem::getWorkingDirectory()
 #ifdef WIN32
 	_getcwd(WorkingDirectory, FILE_SYSTEM_MAX_PATH);
 	return WorkingDirectory;
+#else
+	if (getcwd(WorkingDirectory, FILE_SYSTEM_MAX_PATH))
+		return WorkingDirectory;
 #endif
 
 	return 0;
@@ -100,6 +105,8 @@ bool CFileSystem::changeWorkingDirectoryTo(const c8* newDirectory)
 {
 #ifdef WIN32
 	return (_chdir(newDirectory) == 0);
+#else
+	return (chdir(newDirectory) == 0);
 #endif
 	return false;
 }
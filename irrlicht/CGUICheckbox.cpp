@@ -1,4 +1,4 @@
-#include "CGUICheckBox.h"
+#include "CGUICheckbox.h"
 #include "IGUISkin.h"
 #include "IGUIEnvironment.h"
 #include "IVideoDriver.h"
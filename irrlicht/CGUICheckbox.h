@@ -5,7 +5,7 @@
 #ifndef __C_GUI_CHECKBOX_H_INCLUDED__
 #define __C_GUI_CHECKBOX_H_INCLUDED__
 
-#include "IGUICheckBox.h"
+#include "IGUICheckbox.h"
 
 namespace irr
 {
@@ -8,7 +8,7 @@
 #include "CGUIFont.h"
 #include "CGUIImage.h"
 #include "CGUIMeshViewer.h"
-#include "CGUICheckBox.h"
+#include "CGUICheckbox.h"
 #include "CGUIListBox.h"
 #include "CGUIFileOpenDialog.h"
 #include "CGUIStaticText.h"
@@ -21,10 +21,10 @@ namespace gui
 {
 
 //! constructor
-CGUIEnvironment::CGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* driver, IEventReceiver* userReceiver)
+CGUIEnvironment::CGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* driver, ITimer* timer, IProfiler* profiler, IEventReceiver* userReceiver)
 : IGUIElement(0, 0, 0, core::rectEx<s32>(core::position2d<s32>(0,0), driver ? driver->getScreenSize() : core::dimension2d<s32>(0,0))),
 	UserReceiver(userReceiver), Hovered(0), CurrentSkin(0), Driver(driver),
-	MouseFocus(0), KeyFocus(0), FileSystem(fs)
+	MouseFocus(0), KeyFocus(0), FileSystem(fs), Timer(timer), Profiler(profiler)
 {
 	if (Driver)
 		Driver->grab();
@@ -32,6 +32,12 @@ CGUIEnvironment::CGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* drive
 	if (FileSystem)
 		FileSystem->grab();
 
+	if (Timer)
+		Timer->grab();
+
+	if (Profiler)
+		Profiler->grab();
+
 	#ifdef _DEBUG
 	IGUIEnvironment::setDebugName("CGUIEnvironment IGUIEnvironment");
 	IGUIElement::setDebugName("CGUIEnvironment IGUIElement");
@@ -65,6 +71,12 @@ CGUIEnvironment::~CGUIEnvironment()
 	if (FileSystem)
 		FileSystem->drop();
 
+	if (Timer)
+		Timer->drop();
+
+	if (Profiler)
+		Profiler->drop();
+
 	// delete all fonts
 
 	for (u32 i=0; i<Fonts.size(); ++i)
@@ -103,6 +115,7 @@ void CGUIEnvironment::loadBuidInFont()
 //! draws all gui elements
 void CGUIEnvironment::drawAll()
 {
+	SProfileScope zone(Profiler, "CGUIEnvironment::drawAll");
 	draw();
 }
 
@@ -173,6 +186,14 @@ video::IVideoDriver* CGUIEnvironment::getVideoDriver()
 
 
 
+//! returns the clock of the device
+ITimer* CGUIEnvironment::getTimer()
+{
+	return Timer;
+}
+
+
+
 //! called by ui if an event happened.
 bool CGUIEnvironment::OnEvent(SEvent event)
 {
@@ -400,9 +421,9 @@ IGUIFont* CGUIEnvironment::getBuildInFont()
 
 
 //! creates an GUI Environment
-IGUIEnvironment* createGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* Driver, IEventReceiver* userReceiver)
+IGUIEnvironment* createGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* Driver, ITimer* timer, IProfiler* profiler, IEventReceiver* userReceiver)
 {
-	return new CGUIEnvironment(fs, Driver, userReceiver);
+	return new CGUIEnvironment(fs, Driver, timer, profiler, userReceiver);
 }
 
 } // end namespace gui
@@ -9,6 +9,8 @@
 #include "IGUIElement.h"
 #include "array.h"
 #include "IFileSystem.h"
+#include "ITimer.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -20,7 +22,7 @@ class CGUIEnvironment : public IGUIEnvironment, public IGUIElement
 public:
 
 	//! constructor
-	CGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* driver, irr::IEventReceiver* userReceiver);
+	CGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* driver, ITimer* timer, IProfiler* profiler, irr::IEventReceiver* userReceiver);
 
 	//! destructor
 	virtual ~CGUIEnvironment();
@@ -37,6 +39,9 @@ public:
 	//! returns the current video driver
 	virtual video::IVideoDriver* getVideoDriver();
 
+	//! returns the clock of the device
+	virtual ITimer* getTimer();
+
 	//! posts an input event to the environment
 	virtual void postEventFromUser(SEvent event);
 
@@ -110,6 +115,8 @@ private:
 	IGUIElement* KeyFocus;
 	IGUISkin* CurrentSkin;
 	io::IFileSystem* FileSystem;
+	ITimer* Timer;
+	IProfiler* Profiler;
 };
 
 } // end namespace gui
@@ -142,6 +142,78 @@ bool CGUIFont::loadTexture(video::ITexture* texture)
 			os::Warning::print("The amount of upper corner pixels and the lower corner pixels is not equal, font file may be corrupted.");
 
 	}
+	else
+	if (texture->getColorFormat() == video::EHCF_A8R8G8B8)
+	{
+		s32* p = (s32*)texture->lock();
+		if (!p)
+		{
+			os::Warning::print("Could not lock texture while preparing texture for a font.");
+			return false;
+		}
+
+		s32 colorTopLeft = *p;
+		s32 colorLowerRight = *(p+1);
+		s32 colorBackGround = *(p+2);
+		s32 colorBackGroundWithAlphaFalse = 0x00ffffff & colorBackGround;
+		s32 colorFont = 0xffffffff;
+
+		*(p+1) = colorBackGround;
+		*(p+2) = colorBackGround;
+
+		// start parsing
+
+		core::position2d<s32> pos(0,0);
+
+		c8* row = (c8*)((void*)p);
+
+		for (pos.Y=0; pos.Y<size.Height; ++pos.Y)
+		{
+			p = (s32*)((void*)row);
+
+			for (pos.X=0; pos.X<size.Width; ++pos.X)
+			{
+				if (*p == colorTopLeft)
+				{
+					*p = colorBackGroundWithAlphaFalse;
+					Positions.push_back(core::rectEx<s32>(pos, pos));
+				}
+				else
+				if (*p == colorLowerRight)
+				{
+					if (Positions.size()<=(u32)lowerRightPostions)
+					{
+						texture->unlock();
+						return false;
+					}
+
+					*p = colorBackGroundWithAlphaFalse;
+					Positions[lowerRightPostions].LowerRightCorner = pos;
+					++lowerRightPostions;
+				}
+				else 
+				if (*p == colorBackGround)
+					*p = colorBackGroundWithAlphaFalse;
+				else
+					*p = colorFont;
+
+
+				++p;
+			}
+
+			row += pitch;
+		}
+
+		// Positions parsed.
+
+		texture->unlock();
+
+		if (!lowerRightPostions || !Positions.size())
+			os::Warning::print("The amount of upper corner pixels or lower corner pixels is == 0, font file may be corrupted.");
+		else
+		if (lowerRightPostions != (s32)Positions.size())
+			os::Warning::print("The amount of upper corner pixels and the lower corner pixels is not equal, font file may be corrupted.");
+	}
 
 	if (Positions.size() > 127)
 		WrongCharacter = 127;
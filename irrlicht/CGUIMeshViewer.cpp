@@ -5,6 +5,7 @@
 #include "irrmath.h"
 #include "os.h"
 #include "IGUISkin.h"
+#include "ITimer.h"
 
 namespace irr
 {
@@ -142,7 +143,7 @@ void CGUIMeshViewer::draw()
 
 		driver->setMaterial(Material);
 
-		scene::IMesh* m = Mesh->getMesh(os::Timer::getTime()/20);
+		scene::IMesh* m = Mesh->getMesh(Environment->getTimer()->getTime()/20);
 		for (s32 i=0; i<m->getMeshBufferCount(); ++i)
 		{
 			scene::IMeshBuffer* mb = m->getMeshBuffer(i);
@@ -2,7 +2,7 @@
 #include "IGUISkin.h"
 #include "IGUIEnvironment.h"
 #include "IGUIFont.h"
-#include "IVideoDriver.H"
+#include "IVideoDriver.h"
 
 namespace irr
 {
@@ -0,0 +1,353 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "CIrrDeviceHeadless.h"
+#include "IEventReceiver.h"
+#include "os.h"
+#include "CTimer.h"
+#include "CProfiler.h"
+#include <memory.h>
+
+namespace irr
+{
+	namespace io
+	{
+		//! creates a filesystem which is able to open files from the ordinary file system,
+		//! and out of zipfiles, which are able to be added to the filesystem.
+		IFileSystem* createFileSystem();
+	}
+
+	namespace gui
+	{
+		IGUIEnvironment* createGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* Driver, ITimer* timer, IProfiler* profiler, IEventReceiver* userReceiver);
+	}
+
+	namespace video
+	{
+		IVideoDriver* createSoftwareDriver(const core::dimension2d<s32>& windowSize, ECOLOR_FORMAT format, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler, video::ISurfacePresenter* presenter);
+		IVideoDriver* createNullDriver(io::IFileSystem* io, ITimer* timer, IProfiler* profiler, const core::dimension2d<s32>& screenSize);
+	}
+
+
+//! constructor
+CIrrDeviceHeadless::CIrrDeviceHeadless(video::EDriverType driverType, 
+									   const core::dimension2d<s32>& windowSize,
+									   u32 frameRingSize, u32 bits, IEventReceiver* receiver)
+: VideoDriver(0), GUIEnvironment(0), SceneManager(0), Timer(0), Profiler(0), FrameReceiver(0),
+	FrameSize(windowSize), PresentedFrames(0), RunCount(0), Close(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CIrrDeviceHeadless");	
+	#endif
+
+	// create filesystem
+	FileSystem = io::createFileSystem();
+
+	// create clock
+	Timer = new CTimer();
+
+	// create profiler
+	Profiler = new CProfiler();
+
+	// create frame ring
+
+	FrameFormat = (bits == 32) ? video::EHCF_A8R8G8B8 : video::EHCF_R5G5B5;
+	FrameSizeInBytes = windowSize.Width * windowSize.Height *
+		(FrameFormat == video::EHCF_A8R8G8B8 ? 4 : 2);
+
+	for (u32 i=0; i<frameRingSize; ++i)
+	{
+		c8* frame = new c8[FrameSizeInBytes];
+		memset(frame, 0, FrameSizeInBytes);
+		FrameRing.push_back(frame);
+	}
+
+	// create driver
+
+	createDriver(driverType, windowSize, FrameFormat);
+
+	// create gui environment
+
+	GUIEnvironment = gui::createGUIEnvironment(FileSystem, VideoDriver, Timer, Profiler, receiver);
+
+	// create Scene manager
+
+	SceneManager = scene::createSceneManager(VideoDriver, FileSystem, Timer, Profiler);
+}
+
+
+
+//! destructor
+CIrrDeviceHeadless::~CIrrDeviceHeadless()
+{
+	FileSystem->drop();
+
+	if (GUIEnvironment)
+		GUIEnvironment->drop();
+
+	if (VideoDriver)
+		VideoDriver->drop();
+
+	if (SceneManager)
+		SceneManager->drop();
+
+	Timer->drop();
+	Profiler->drop();
+
+	for (u32 i=0; i<FrameRing.size(); ++i)
+		delete [] FrameRing[i];
+}
+
+
+
+//! create the driver
+void CIrrDeviceHeadless::createDriver(video::EDriverType driverType,
+									  const core::dimension2d<s32>& windowSize,
+									  video::ECOLOR_FORMAT format)
+{
+	switch(driverType)
+	{
+	case video::DT_SOFTWARE:
+		VideoDriver = video::createSoftwareDriver(windowSize, format, false, FileSystem, Timer, Profiler, this);
+		break;
+	case video::DT_NULL:
+		VideoDriver = video::createNullDriver(FileSystem, Timer, Profiler, windowSize);
+		break;
+	default:
+		os::Warning::print("The headless device is only able to run the software or the null driver.");
+		VideoDriver = video::createNullDriver(FileSystem, Timer, Profiler, windowSize);
+		break;
+	}
+}
+
+
+
+//! runs the device. Returns false if device wants to be deleted
+bool CIrrDeviceHeadless::run()
+{
+	if (Close)
+		return false;
+
+	// post all scripted events which are due now
+
+	for (u32 i=0; i<EventQueue.size(); )
+	{
+		if (EventQueue[i].RunCall <= RunCount)
+		{
+			SEvent event = EventQueue[i].Event;
+			EventQueue.erase(i);
+			postEventFromUser(event);
+
+			if (Close)
+				return false;
+		}
+		else
+			++i;
+	}
+
+	Timer->tick();
+
+	++RunCount;
+	return true;
+}
+
+
+
+//! returns the video driver
+video::IVideoDriver* CIrrDeviceHeadless::getVideoDriver()
+{
+	return VideoDriver;
+}
+
+
+
+//! return file system
+io::IFileSystem* CIrrDeviceHeadless::getFileSystem()
+{
+	return FileSystem;
+}
+
+
+
+//! returns the gui environment
+gui::IGUIEnvironment* CIrrDeviceHeadless::getGUIEnvironment()
+{
+	return GUIEnvironment;
+}
+
+
+
+//! returns the scene manager
+scene::ISceneManager* CIrrDeviceHeadless::getSceneManager()
+{
+	return SceneManager;
+}
+
+
+
+//! returns the clock of the device
+ITimer* CIrrDeviceHeadless::getTimer()
+{
+	return Timer;
+}
+
+
+
+//! returns the profiler of the device
+IProfiler* CIrrDeviceHeadless::getProfiler()
+{
+	return Profiler;
+}
+
+
+
+//! sets the caption of the window
+void CIrrDeviceHeadless::setWindowCaption(const wchar_t* text)
+{
+	// there is no window.
+}
+
+
+
+//! returns if window is active. if not, nothing need to be drawn
+bool CIrrDeviceHeadless::isWindowActive()
+{
+	return true;
+}
+
+
+
+//! notifies the device that it should close itself
+void CIrrDeviceHeadless::closeDevice()
+{
+	Close = true;
+}
+
+
+
+//! presents a surface in the client area
+void CIrrDeviceHeadless::present(video::ISurface* surface)
+{
+	const core::dimension2d<s32>& size = surface->getDimension();
+	void* memory = surface->lock();
+
+	if (FrameRing.size() && size == FrameSize && surface->getColorFormat() == FrameFormat)
+		memcpy(FrameRing[PresentedFrames % FrameRing.size()], memory, FrameSizeInBytes);
+
+	if (FrameReceiver)
+		FrameReceiver->OnFrame(memory, surface->getColorFormat(), size, PresentedFrames);
+
+	surface->unlock();
+
+	++PresentedFrames;
+}
+
+
+
+//! sets a receiver which gets every finished frame
+void CIrrDeviceHeadless::setFrameReceiver(IFrameReceiver* receiver)
+{
+	FrameReceiver = receiver;
+}
+
+
+
+//! returns the amount of frames presented so far
+u32 CIrrDeviceHeadless::getPresentedFrameCount()
+{
+	return PresentedFrames;
+}
+
+
+
+//! returns a frame out of the ring of the last presented frames
+const void* CIrrDeviceHeadless::getFrame(u32 age)
+{
+	if (age >= FrameRing.size() || age >= PresentedFrames)
+		return 0;
+
+	return FrameRing[(PresentedFrames - 1 - age) % FrameRing.size()];
+}
+
+
+
+//! returns the color format of the frames
+video::ECOLOR_FORMAT CIrrDeviceHeadless::getFrameFormat()
+{
+	return FrameFormat;
+}
+
+
+
+//! returns the size of the frames in pixels
+const core::dimension2d<s32>& CIrrDeviceHeadless::getFrameSize()
+{
+	return FrameSize;
+}
+
+
+
+//! posts an input event, as if it came from the user
+void CIrrDeviceHeadless::postEventFromUser(SEvent event)
+{
+	if (GUIEnvironment)
+		GUIEnvironment->postEventFromUser(event);
+}
+
+
+
+//! queues an input event which will be posted by run()
+void CIrrDeviceHeadless::queueEvent(SEvent event, u32 runCall)
+{
+	SQueuedEvent e;
+	e.Event = event;
+	e.RunCall = runCall;
+	EventQueue.push_back(e);
+}
+
+
+
+//! returns how often run() was called so far
+u32 CIrrDeviceHeadless::getRunCount()
+{
+	return RunCount;
+}
+
+
+
+#ifdef WIN32
+#ifdef IRRLICHT_EXPORTS
+#define IRRLICHT_API __declspec(dllexport)
+#else
+#define IRRLICHT_API __declspec(dllimport)
+#endif
+#else
+#define IRRLICHT_API
+#endif
+
+IRRLICHT_API IHeadlessDevice* createHeadlessDevice(video::EDriverType driverType,
+												  const core::dimension2d<s32>& windowSize,
+												  u32 frameRingSize, IEventReceiver* res,
+												  u32 bits)
+{
+	return new CIrrDeviceHeadless(driverType, windowSize, frameRingSize, bits, res);
+}
+
+
+#ifndef WIN32
+
+// there is no window system device on this platform yet, so the
+// headless device is used.
+
+IRRLICHT_API IrrlichtDevice* createDevice(video::EDriverType driverType,
+										  const core::dimension2d<s32>& windowSize,
+										  u32 bits, bool fullscreen, IEventReceiver* res)
+{
+	return new CIrrDeviceHeadless(driverType, windowSize, 1, bits, res);
+}
+
+#endif
+
+
+} // end namespace 
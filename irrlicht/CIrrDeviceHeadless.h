@@ -0,0 +1,122 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __C_IRR_DEVICE_HEADLESS_H_INCLUDED__
+#define __C_IRR_DEVICE_HEADLESS_H_INCLUDED__
+
+#include "IHeadlessDevice.h"
+#include "ISurfacePresenter.h"
+#include "IGUIEnvironment.h"
+#include "array.h"
+
+namespace irr
+{
+
+	class CIrrDeviceHeadless : public IHeadlessDevice, video::ISurfacePresenter
+	{
+	public:
+
+		//! constructor
+		CIrrDeviceHeadless(video::EDriverType deviceType, 
+			const core::dimension2d<s32>& windowSize, u32 frameRingSize,
+			u32 bits, IEventReceiver* receiver=0);
+
+		//! destructor
+		virtual ~CIrrDeviceHeadless();
+
+		//! runs the device. Returns false if device wants to be deleted
+		virtual bool run();
+
+		//! returns the video driver
+		virtual video::IVideoDriver* getVideoDriver();
+
+		//! return file system
+		virtual io::IFileSystem* getFileSystem();
+
+		//! returns the gui environment
+		virtual gui::IGUIEnvironment* getGUIEnvironment();
+
+		//! returns the scene manager
+		virtual scene::ISceneManager* getSceneManager();
+
+		//! returns the clock of the device
+		virtual ITimer* getTimer();
+
+		//! returns the profiler of the device
+		virtual IProfiler* getProfiler();
+
+		//! sets the caption of the window
+		virtual void setWindowCaption(const wchar_t* text);
+
+		//! returns if window is active. if not, nothing need to be drawn
+		virtual bool isWindowActive();
+
+		//! notifies the device that it should close itself
+		virtual void closeDevice();
+
+		//! presents a surface in the client area
+		virtual void present(video::ISurface* surface);
+
+		//! sets a receiver which gets every finished frame
+		virtual void setFrameReceiver(IFrameReceiver* receiver);
+
+		//! returns the amount of frames presented so far
+		virtual u32 getPresentedFrameCount();
+
+		//! returns a frame out of the ring of the last presented frames
+		virtual const void* getFrame(u32 age);
+
+		//! returns the color format of the frames
+		virtual video::ECOLOR_FORMAT getFrameFormat();
+
+		//! returns the size of the frames in pixels
+		virtual const core::dimension2d<s32>& getFrameSize();
+
+		//! posts an input event, as if it came from the user
+		virtual void postEventFromUser(SEvent event);
+
+		//! queues an input event which will be posted by run()
+		virtual void queueEvent(SEvent event, u32 runCall);
+
+		//! returns how often run() was called so far
+		virtual u32 getRunCount();
+
+	private:
+
+		//! create the driver
+		void createDriver(video::EDriverType driverType,
+			const core::dimension2d<s32>& windowSize, video::ECOLOR_FORMAT format);
+
+		struct SQueuedEvent
+		{
+			SEvent Event;
+			u32 RunCall;
+		};
+
+		io::IFileSystem* FileSystem;
+		video::IVideoDriver* VideoDriver;
+		gui::IGUIEnvironment* GUIEnvironment;
+		scene::ISceneManager* SceneManager;
+		ITimer* Timer;
+		IProfiler* Profiler;
+
+		IFrameReceiver* FrameReceiver;
+
+		core::array<c8*> FrameRing;
+		core::dimension2d<s32> FrameSize;
+		video::ECOLOR_FORMAT FrameFormat;
+		s32 FrameSizeInBytes;
+		u32 PresentedFrames;
+
+		core::array<SQueuedEvent> EventQueue;
+		u32 RunCount;
+
+		bool Close;
+	};
+
+
+} // end namespace irr
+
+#endif
+
@@ -8,6 +8,8 @@
 #include "IEventReceiver.h"
 #include "list.h"
 #include "os.h"
+#include "CTimer.h"
+#include "CProfiler.h"
 #include <cstdio>
 
 using namespace std;
@@ -24,16 +26,16 @@ namespace irr
 
 	namespace gui
 	{
-		IGUIEnvironment* createGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* Driver, IEventReceiver* userReceiver);
+		IGUIEnvironment* createGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* Driver, ITimer* timer, IProfiler* profiler, IEventReceiver* userReceiver);
 	}
 
 
 	namespace video
 	{
-		IVideoDriver* createSoftwareDriver(const core::dimension2d<s32>& windowSize, bool fullscreen, io::IFileSystem* io, video::ISurfacePresenter* presenter);
-		IVideoDriver* createDirectX8Driver(const core::dimension2d<s32>& screenSize, HWND window, u32 bits, bool fullscreen, io::IFileSystem* io, bool pureSoftware);
-		IVideoDriver* createNullDriver(io::IFileSystem* io, const core::dimension2d<s32>& screenSize);
-		IVideoDriver* createOpenGLDriver(const core::dimension2d<s32>& screenSize, HWND window, bool fullscreen, io::IFileSystem* io);
+		IVideoDriver* createSoftwareDriver(const core::dimension2d<s32>& windowSize, ECOLOR_FORMAT format, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler, video::ISurfacePresenter* presenter);
+		IVideoDriver* createDirectX8Driver(const core::dimension2d<s32>& screenSize, HWND window, u32 bits, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler, bool pureSoftware);
+		IVideoDriver* createNullDriver(io::IFileSystem* io, ITimer* timer, IProfiler* profiler, const core::dimension2d<s32>& screenSize);
+		IVideoDriver* createOpenGLDriver(const core::dimension2d<s32>& screenSize, HWND window, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler);
 	}
 
 
@@ -188,11 +190,17 @@ namespace irr
 CIrrDeviceWin32::CIrrDeviceWin32(video::EDriverType driverType, 
 								 const core::dimension2d<s32>& windowSize,
 								 u32 bits, bool fullscreen, IEventReceiver* receiver)
-: VideoDriver(0), SceneManager(0), HWnd(0), ChangedToFullScreen(false)
+: VideoDriver(0), SceneManager(0), Timer(0), Profiler(0), HWnd(0), ChangedToFullScreen(false)
 {
 	// create filesystem
 	FileSystem = io::createFileSystem();
 
+	// create clock
+	Timer = new CTimer();
+
+	// create profiler
+	Profiler = new CProfiler();
+
 	// create window
 
 	HINSTANCE hInstance = GetModuleHandle(0);
@@ -267,11 +275,11 @@ CIrrDeviceWin32::CIrrDeviceWin32(video::EDriverType driverType,
 
 	// create gui environment
 
-	GUIEnvironment = gui::createGUIEnvironment(FileSystem, VideoDriver, receiver);
+	GUIEnvironment = gui::createGUIEnvironment(FileSystem, VideoDriver, Timer, Profiler, receiver);
 
 	// create Scene manager
 
-	SceneManager = scene::createSceneManager(VideoDriver, FileSystem);
+	SceneManager = scene::createSceneManager(VideoDriver, FileSystem, Timer, Profiler);
 
 	// register environment
 
@@ -298,6 +306,9 @@ CIrrDeviceWin32::~CIrrDeviceWin32()
 	if (SceneManager)
 		SceneManager->drop();
 
+	Timer->drop();
+	Profiler->drop();
+
 	// unregister environment
 
 	irr::core::list<SEnvMapper>::Iterator it = EnvMap.begin();
@@ -323,19 +334,20 @@ void CIrrDeviceWin32::createDriver(video::EDriverType driverType,
 	switch(driverType)
 	{
 	case video::DT_DIRECTX8:
-		VideoDriver = video::createDirectX8Driver(windowSize, HWnd, bits, fullscreen, FileSystem, false);
+		VideoDriver = video::createDirectX8Driver(windowSize, HWnd, bits, fullscreen, FileSystem, Timer, Profiler, false);
 		break;
 	case video::DT_SOFTWARE:
 		if (fullscreen)	switchToFullScreen(windowSize.Width, windowSize.Height, bits);
-		VideoDriver = video::createSoftwareDriver(windowSize, fullscreen, FileSystem, this);
+		VideoDriver = video::createSoftwareDriver(windowSize,
+			bits == 32 ? video::EHCF_A8R8G8B8 : video::EHCF_R5G5B5, fullscreen, FileSystem, Timer, Profiler, this);
 		break;
 	case video::DT_OPENGL:
 		if (fullscreen)	switchToFullScreen(windowSize.Width, windowSize.Height, bits);
-		VideoDriver = video::createOpenGLDriver(windowSize, HWnd, fullscreen, FileSystem);
+		VideoDriver = video::createOpenGLDriver(windowSize, HWnd, fullscreen, FileSystem, Timer, Profiler);
 		break;
 	default:
 		// create null driver if a bad programmer made a mistake
-		VideoDriver = video::createNullDriver(FileSystem, windowSize);
+		VideoDriver = video::createNullDriver(FileSystem, Timer, Profiler, windowSize);
 		break;
 	}
 }
@@ -347,6 +359,8 @@ bool CIrrDeviceWin32::run()
 {
 	MSG msg;
 
+	Timer->tick();
+
 	if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
 	{
 		TranslateMessage(&msg);
@@ -398,6 +412,22 @@ scene::ISceneManager* CIrrDeviceWin32::getSceneManager()
 
 
 
+//! returns the clock of the device
+ITimer* CIrrDeviceWin32::getTimer()
+{
+	return Timer;
+}
+
+
+
+//! returns the profiler of the device
+IProfiler* CIrrDeviceWin32::getProfiler()
+{
+	return Profiler;
+}
+
+
+
 //! presents a surface in the client area
 void CIrrDeviceWin32::present(video::ISurface* surface)
 {
@@ -405,12 +435,12 @@ void CIrrDeviceWin32::present(video::ISurface* surface)
 	RECT rect;
 	GetClientRect(HWnd, &rect);
 
-	s16* memory = surface->lock();
+	void* memory = surface->lock();
 			
 	BITMAPV4HEADER bi;
 	ZeroMemory (&bi, sizeof(bi));
 	bi.bV4Size          = sizeof(BITMAPINFOHEADER);
-	bi.bV4BitCount      = 16;
+	bi.bV4BitCount      = surface->getBytesPerPixel() * 8;
 	bi.bV4Planes        = 1;
 	bi.bV4Width         = surface->getDimension().Width;
 	bi.bV4Height        = -surface->getDimension().Height;
@@ -44,6 +44,12 @@ namespace irr
 		//! returns the scene manager
 		virtual scene::ISceneManager* getSceneManager();
 
+		//! returns the clock of the device
+		virtual ITimer* getTimer();
+
+		//! returns the profiler of the device
+		virtual IProfiler* getProfiler();
+
 		//! sets the caption of the window
 		virtual void setWindowCaption(const wchar_t* text);
 
@@ -71,6 +77,8 @@ namespace irr
 		video::IVideoDriver* VideoDriver;
 		gui::IGUIEnvironment* GUIEnvironment;
 		scene::ISceneManager* SceneManager;
+		ITimer* Timer;
+		IProfiler* Profiler;
 
 		bool ChangedToFullScreen;
 	};
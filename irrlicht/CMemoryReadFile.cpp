@@ -3,7 +3,7 @@
 // For conditions of distribution and use, see copyright notice in Irrlicht.h
 
 #include "CMemoryReadFile.h"
-#include <memory.H>
+#include <memory.h>
 
 namespace irr
 {
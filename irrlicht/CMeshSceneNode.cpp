@@ -28,6 +28,11 @@ CMeshSceneNode::CMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* m
 			Materials.push_back(mat);
 		}
 
+		// the scene manager tests the box before the node is rendered
+		// for the first time, so it has to be valid from the start.
+
+		Box = Mesh->getBoundingBox();
+
 		// grab the mesh
 
 		Mesh->grab();
@@ -49,7 +54,12 @@ CMeshSceneNode::~CMeshSceneNode()
 void CMeshSceneNode::OnPreRender()
 {
 	if (IsVisible)
+	{
+		if (Mesh)
+			Box = Mesh->getBoundingBox();
+
 		SceneManager->registerNodeForRendering(this);
+	}
 
 	ISceneNode::OnPreRender();
 }
@@ -65,7 +75,6 @@ void CMeshSceneNode::render()
 		return;
 
 	driver->setTransform(video::TS_WORLD, AbsoluteTransformation);
-	Box = Mesh->getBoundingBox();
 
 	for (s32 i=0; i<Mesh->getMeshBufferCount(); ++i)
 	{
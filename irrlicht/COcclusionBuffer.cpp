@@ -0,0 +1,343 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "COcclusionBuffer.h"
+#include <math.h>
+
+namespace irr
+{
+namespace video
+{
+
+//! constructor
+COcclusionBuffer::COcclusionBuffer(s32 scale)
+: Width(0), Height(0), Scale(scale < 1 ? 1 : scale), Generation(0)
+{
+	Transform.makeIdentity();
+}
+
+
+
+//! destructor
+COcclusionBuffer::~COcclusionBuffer()
+{
+}
+
+
+
+//! removes all occluders and sets the size of the viewport the
+//! buffer covers.
+void COcclusionBuffer::clear(const core::dimension2d<s32>& viewPortSize)
+{
+	Width = (viewPortSize.Width + Scale - 1) / Scale;
+	Height = (viewPortSize.Height + Scale - 1) / Scale;
+
+	s32 count = Width * Height;
+	Buffer.set_used(count);
+
+	for (s32 i=0; i<count; ++i)
+		Buffer[i] = 0.0f;
+}
+
+
+
+//! sets the transformation from object space to clip space
+void COcclusionBuffer::setTransform(const core::matrix4& transform)
+{
+	Transform = transform;
+}
+
+
+
+//! transforms a point to clip space
+void COcclusionBuffer::transform(const core::vector3df& p, SClipVertex& out) const
+{
+	const core::matrix4& m = Transform;
+
+	out.X = m(0,0)*p.X + m(0,1)*p.Y + m(0,2)*p.Z + m(0,3);
+	out.Y = m(1,0)*p.X + m(1,1)*p.Y + m(1,2)*p.Z + m(1,3);
+	out.Z = m(2,0)*p.X + m(2,1)*p.Y + m(2,2)*p.Z + m(2,3);
+	out.W = m(3,0)*p.X + m(3,1)*p.Y + m(3,2)*p.Z + m(3,3);
+	out.Tx = out.Ty = 0.0f;
+	out.Color = 0;
+}
+
+
+
+//! projects a vertex in clip space behind the near plane into the buffer
+void COcclusionBuffer::project(const SClipVertex& v, SVertex& out) const
+{
+	f32 zDiv = 1.0f / v.W;
+
+	out.X = (v.X * zDiv + 1.0f) * 0.5f * Width;
+	out.Y = (1.0f - v.Y * zDiv) * 0.5f * Height;
+	out.Z = zDiv;
+}
+
+
+
+//! sets up an edge from a to b of a front facing triangle
+void COcclusionBuffer::setEdge(SEdge& edge, const SVertex& a, const SVertex& b)
+{
+	edge.X = a.X;
+	edge.Y = a.Y;
+	edge.DX = a.Y - b.Y;
+	edge.DY = b.X - a.X;
+	edge.Slope = edge.DX != 0.0f ? edge.DY / edge.DX : 0.0f;
+}
+
+
+
+//! clips the pixel centers from left to right of a row to the inside of
+//! an edge, returns false if nothing is left of them.
+bool COcclusionBuffer::clipToEdge(const SEdge& edge, f32 y, f32& left, f32& right)
+{
+	if (edge.DX == 0.0f)
+		return edge.DY * (y - edge.Y) >= 0.0f;
+
+	// x where the edge crosses the row
+	f32 x = edge.X - edge.Slope * (y - edge.Y);
+
+	if (edge.DX > 0.0f)
+	{
+		if (x > left)
+			left = x;
+	}
+	else
+	{
+		if (x < right)
+			right = x;
+	}
+
+	return left <= right;
+}
+
+
+
+//! draws an indexed triangle list in object space into the buffer
+void COcclusionBuffer::drawIndexedTriangleList(const core::vector3df* positions, s32 stride,
+	s32 vertexCount, const u16* indexList, s32 triangleCount)
+{
+	if (!Width || !Height)
+		return;
+
+	// the vertices are tagged with the generation of the draw call
+
+	if ((s32)TransformTags.size() < vertexCount)
+	{
+		s32 oldSize = TransformTags.size();
+		Transformed.set_used(vertexCount);
+		Projected.set_used(vertexCount);
+		TransformTags.set_used(vertexCount);
+
+		for (s32 i=oldSize; i<vertexCount; ++i)
+			TransformTags[i] = Generation;
+	}
+
+	++Generation;
+	if (!Generation)
+	{
+		for (u32 i=0; i<TransformTags.size(); ++i)
+			TransformTags[i] = 0;
+		Generation = 1;
+	}
+
+	const c8* base = (const c8*)positions;
+	const u16* end = indexList + triangleCount * 3;
+
+	for (; indexList != end; indexList += 3)
+	{
+		u32 nearVertices = 0;
+
+		for (s32 i=0; i<3; ++i)
+		{
+			u16 index = indexList[i];
+			SClipVertex& v = Transformed[index];
+
+			if (TransformTags[index] != Generation)
+			{
+				transform(*(const core::vector3df*)(base + index * stride), v);
+				if (v.Z >= 0.0f)
+					project(v, Projected[index]);
+
+				TransformTags[index] = Generation;
+			}
+
+			if (v.Z < 0.0f)
+				nearVertices |= 1 << i;
+		}
+
+		if (!nearVertices)
+		{
+			drawTriangle(Projected[indexList[0]], Projected[indexList[1]], 
+				Projected[indexList[2]]);
+			continue;
+		}
+
+		if (nearVertices == 7)
+			continue;
+
+		// the walls and floors next to the camera are the best occluders,
+		// so the triangles crossing the near plane are clipped.
+		SClipVertex polygon[MAX_CLIPPED_VERTICES];
+		for (s32 i=0; i<3; ++i)
+			polygon[i] = Transformed[indexList[i]];
+
+		s32 count = clipPolygon(polygon, 3, ECC_NEAR);
+
+		SVertex clipped[MAX_CLIPPED_VERTICES];
+		for (s32 i=0; i<count; ++i)
+			project(polygon[i], clipped[i]);
+
+		for (s32 i=2; i<count; ++i)
+			drawTriangle(clipped[0], clipped[i-1], clipped[i]);
+	}
+}
+
+
+
+//! draws a projected triangle
+void COcclusionBuffer::drawTriangle(const SVertex& v0, const SVertex& v1, const SVertex& v2)
+{
+	// only front faces occlude, back faces are either behind them or
+	// invisible, with the same test as the back face culling of the
+	// triangle renderers.
+	f32 area = (v1.X - v0.X) * (v2.Y - v0.Y) - (v2.X - v0.X) * (v1.Y - v0.Y);
+	if (area < 0.0001f)
+		return;
+
+	// pixels whose center is inside of the triangle
+	f32 minX = v0.X, maxX = v0.X, minY = v0.Y, maxY = v0.Y;
+	if (v1.X < minX)
+		minX = v1.X;
+	if (v1.X > maxX)
+		maxX = v1.X;
+	if (v2.X < minX)
+		minX = v2.X;
+	if (v2.X > maxX)
+		maxX = v2.X;
+	if (v1.Y < minY)
+		minY = v1.Y;
+	if (v1.Y > maxY)
+		maxY = v1.Y;
+	if (v2.Y < minY)
+		minY = v2.Y;
+	if (v2.Y > maxY)
+		maxY = v2.Y;
+
+	if (maxX < 0.0f || maxY < 0.0f || minX > (f32)Width || minY > (f32)Height)
+		return;
+
+	s32 x1 = minX < 0.0f ? 0 : (s32)minX;
+	s32 y1 = minY < 0.0f ? 0 : (s32)minY;
+	s32 x2 = maxX >= (f32)Width ? Width - 1 : (s32)maxX;
+	s32 y2 = maxY >= (f32)Height ? Height - 1 : (s32)maxY;
+
+	// plane of 1/w. It is linear in screen space, the value stored for a
+	// pixel is the smallest one the triangle has inside of the pixel, so
+	// everything tested against it is really behind the triangle.
+	f32 invArea = 1.0f / area;
+	f32 dzdx = ((v1.Z - v0.Z) * (v2.Y - v0.Y) - (v2.Z - v0.Z) * (v1.Y - v0.Y)) * invArea;
+	f32 dzdy = ((v2.Z - v0.Z) * (v1.X - v0.X) - (v1.Z - v0.Z) * (v2.X - v0.X)) * invArea;
+	f32 zOffset = 0.5f * ((f32)fabs(dzdx) + (f32)fabs(dzdy));
+
+	f32 zMin = v0.Z;
+	if (v1.Z < zMin) zMin = v1.Z;
+	if (v2.Z < zMin) zMin = v2.Z;
+
+	// each row is clipped to the pixel centers inside of all edges
+	SEdge edges[3];
+	setEdge(edges[0], v0, v1);
+	setEdge(edges[1], v1, v2);
+	setEdge(edges[2], v2, v0);
+
+	for (s32 y=y1; y<=y2; ++y)
+	{
+		f32 py = y + 0.5f;
+		f32 left = x1 + 0.5f;
+		f32 right = x2 + 0.5f;
+
+		if (!clipToEdge(edges[0], py, left, right) ||
+			!clipToEdge(edges[1], py, left, right) ||
+			!clipToEdge(edges[2], py, left, right))
+			continue;
+
+		s32 xStart = (s32)ceil(left - 0.5f);
+		s32 xEnd = (s32)floor(right - 0.5f);
+
+		f32 z = v0.Z + dzdx * (xStart + 0.5f - v0.X) + dzdy * (py - v0.Y) - zOffset;
+		f32* p = &Buffer[y * Width + xStart];
+
+		for (s32 x=xStart; x<=xEnd; ++x, ++p, z += dzdx)
+		{
+			f32 value = z < zMin ? zMin : z;
+			if (value > *p)
+				*p = value;
+		}
+	}
+}
+
+
+
+//! returns if a box in object space may be visible
+bool COcclusionBuffer::isBoxVisible(const core::aabbox3d<f32>& box)
+{
+	if (!Width || !Height)
+		return true;
+
+	const core::vector3df& a = box.MinEdge;
+	const core::vector3df& b = box.MaxEdge;
+
+	core::vector3df edges[8] =
+	{
+		core::vector3df(a.X, a.Y, a.Z), core::vector3df(b.X, a.Y, a.Z),
+		core::vector3df(a.X, b.Y, a.Z), core::vector3df(b.X, b.Y, a.Z),
+		core::vector3df(a.X, a.Y, b.Z), core::vector3df(b.X, a.Y, b.Z),
+		core::vector3df(a.X, b.Y, b.Z), core::vector3df(b.X, b.Y, b.Z)
+	};
+
+	SClipVertex c;
+	SVertex v;
+	f32 minX = 0.0f, maxX = 0.0f, minY = 0.0f, maxY = 0.0f, zMax = 0.0f;
+
+	for (s32 i=0; i<8; ++i)
+	{
+		transform(edges[i], c);
+		if (c.Z < 0.0f || c.W <= 0.0f)
+			return true;
+
+		project(c, v);
+
+		if (!i || v.X < minX) minX = v.X;
+		if (!i || v.X > maxX) maxX = v.X;
+		if (!i || v.Y < minY) minY = v.Y;
+		if (!i || v.Y > maxY) maxY = v.Y;
+		if (v.Z > zMax) zMax = v.Z;
+	}
+
+	if (maxX < 0.0f || maxY < 0.0f || minX > (f32)Width || minY > (f32)Height)
+		return false;
+
+	// one pixel more on each side, the occluders only cover the pixels
+	// whose center is inside of them.
+	s32 x1 = minX < 1.0f ? 0 : (s32)minX - 1;
+	s32 y1 = minY < 1.0f ? 0 : (s32)minY - 1;
+	s32 x2 = maxX >= (f32)(Width - 1) ? Width - 1 : (s32)maxX + 1;
+	s32 y2 = maxY >= (f32)(Height - 1) ? Height - 1 : (s32)maxY + 1;
+
+	for (s32 y=y1; y<=y2; ++y)
+	{
+		const f32* p = &Buffer[y * Width + x1];
+
+		for (s32 x=x1; x<=x2; ++x, ++p)
+			if (*p < zMax)
+				return true;
+	}
+
+	return false;
+}
+
+
+} // end namespace video
+} // end namespace irr
\ No newline at end of file
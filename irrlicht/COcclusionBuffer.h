@@ -0,0 +1,108 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __C_OCCLUSION_BUFFER_H_INCLUDED__
+#define __C_OCCLUSION_BUFFER_H_INCLUDED__
+
+#include "IUnknown.h"
+#include "matrix4.h"
+#include "aabbox3d.h"
+#include "dimension2d.h"
+#include "array.h"
+#include "CVertexTransform.h"
+
+namespace irr
+{
+namespace video
+{
+
+	//! A low resolution depth buffer for occlusion culling. Occluders are
+	//! drawn into it, and boxes are tested against it before the triangles
+	//! inside them are sent to the rasterizer. The buffer stores 1/w like the
+	//! z buffer, with the farthest value an occluder can have inside a pixel,
+	//! so a box is only reported as hidden if it is behind the occluders.
+	class COcclusionBuffer : public IUnknown
+	{
+	public:
+
+		//! constructor
+		//! \param scale: Amount of screen pixels in each direction covered by 
+		//! one pixel of the buffer.
+		COcclusionBuffer(s32 scale = 8);
+
+		//! destructor
+		virtual ~COcclusionBuffer();
+
+		//! removes all occluders and sets the size of the viewport the
+		//! buffer covers.
+		void clear(const core::dimension2d<s32>& viewPortSize);
+
+		//! sets the transformation from object space to clip space,
+		//! projection * view * world.
+		void setTransform(const core::matrix4& transform);
+
+		//! draws an indexed triangle list in object space into the buffer.
+		//! Only front faces are drawn, back faces are either hidden by front
+		//! faces or not drawn by the renderers.
+		//! \param positions: Position of the first vertex.
+		//! \param stride: Size of a vertex in bytes.
+		void drawIndexedTriangleList(const core::vector3df* positions, s32 stride,
+			s32 vertexCount, const u16* indexList, s32 triangleCount);
+
+		//! returns if a box in object space may be visible. Boxes crossing
+		//! the near plane are always visible, boxes outside of the viewport
+		//! never.
+		bool isBoxVisible(const core::aabbox3d<f32>& box);
+
+	private:
+
+		//! a vertex projected into the buffer
+		struct SVertex
+		{
+			f32 X, Y;	// position in pixels of the buffer
+			f32 Z;		// 1/w
+		};
+
+		//! an edge of a triangle, the pixels inside of the triangle are
+		//! where DX * (x - X) + DY * (y - Y) >= 0.
+		struct SEdge
+		{
+			f32 X, Y;
+			f32 DX, DY;
+			f32 Slope;	// DY / DX
+		};
+
+		//! transforms a point to clip space
+		void transform(const core::vector3df& p, SClipVertex& out) const;
+
+		//! projects a vertex in clip space behind the near plane into the buffer
+		void project(const SClipVertex& v, SVertex& out) const;
+
+		//! draws a projected triangle
+		void drawTriangle(const SVertex& v0, const SVertex& v1, const SVertex& v2);
+
+		//! sets up an edge from a to b of a front facing triangle
+		static void setEdge(SEdge& edge, const SVertex& a, const SVertex& b);
+
+		//! clips the pixel centers from left to right of a row to the 
+		//! inside of an edge, returns false if nothing is left of them.
+		static bool clipToEdge(const SEdge& edge, f32 y, f32& left, f32& right);
+
+		core::array<f32> Buffer;
+		s32 Width, Height;
+		s32 Scale;
+		core::matrix4 Transform;
+
+		// vertices transformed by the current draw call, each vertex is
+		// only transformed once.
+		core::array<SClipVertex> Transformed;
+		core::array<SVertex> Projected;
+		core::array<u32> TransformTags;
+		u32 Generation;
+	};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
@@ -68,8 +68,9 @@ void COctTreeSceneNode::render()
 
 	core::vector3df p;
 
-	invTrans.transformVect(camera->getAbsolutePosition(), p);
-	box.reset(p);
+	core::vector3df cameraPosition;
+	invTrans.transformVect(camera->getAbsolutePosition(), cameraPosition);
+	box.reset(cameraPosition);
 
 	invTrans.transformVect(camera->getViewFrustrum()->rightFarDown, p);
 	box.addInternalPoint(p);
@@ -80,11 +81,19 @@ void COctTreeSceneNode::render()
 	invTrans.transformVect(camera->getViewFrustrum()->leftFarUp, p);
 	box.addInternalPoint(p);
 
+	// only solid polygons are occluders
+
+	Occluders.set_used(Materials.size());
+
+	for (u32 i=0; i<Materials.size(); ++i)
+		Occluders[i] = !Materials[i].isTransparent() && 
+			!Materials[i].Wireframe && Materials[i].ZWriteEnable;
+
 	switch(vertexType)
 	{
 	case video::EVT_STANDARD:
 		{
-			StdOctTree->calculatePolys(box);
+			StdOctTree->calculatePolys(box, cameraPosition, driver, StdMeshes, Occluders.const_pointer());
 			OctTree<video::S3DVertex>::SIndexData* d =  StdOctTree->getIndexData();
 
 			for (u32 i=0; i<Materials.size(); ++i)
@@ -99,7 +108,7 @@ void COctTreeSceneNode::render()
 		}
 	case video::EVT_2TCOORDS:
 		{
-			LightMapOctTree->calculatePolys(box);
+			LightMapOctTree->calculatePolys(box, cameraPosition, driver, LightMapMeshes, Occluders.const_pointer());
 			OctTree<video::S3DVertex2TCoords>::SIndexData* d =  LightMapOctTree->getIndexData();
 
 			for (u32 i=0; i<Materials.size(); ++i)
@@ -135,6 +144,7 @@ bool COctTreeSceneNode::createTree(IMesh* mesh)
 	if (mesh->getMeshBufferCount())
 	{
 		vertexType = mesh->getMeshBuffer(0)->getVertexType();
+		bool boxSet = false;	// the box of the node contains all vertices
 
 		switch(vertexType)
 		{
@@ -151,7 +161,14 @@ bool COctTreeSceneNode::createTree(IMesh* mesh)
 					OctTree<video::S3DVertex>::SMeshChunk &nchunk = StdMeshes[StdMeshes.size()-1];
 
 					for (s32 v=0; v<b->getVertexCount(); ++v)
+					{
 						nchunk.Vertices.push_back(((video::S3DVertex*)b->getVertices())[v]);
+						if (boxSet)
+							Box.addInternalPoint(nchunk.Vertices[v].Pos);
+						else
+							Box.reset(nchunk.Vertices[v].Pos);
+						boxSet = true;
+					}
 
 					for (s32 v=0; v<b->getIndexCount(); ++v)
 						nchunk.Indices.push_back(b->getIndices()[v]);
@@ -175,7 +192,14 @@ bool COctTreeSceneNode::createTree(IMesh* mesh)
 						LightMapMeshes[LightMapMeshes.size()-1];
 
 					for (s32 v=0; v<b->getVertexCount(); ++v)
+					{
 						nchunk.Vertices.push_back(((video::S3DVertex2TCoords*)b->getVertices())[v]);
+						if (boxSet)
+							Box.addInternalPoint(nchunk.Vertices[v].Pos);
+						else
+							Box.reset(nchunk.Vertices[v].Pos);
+						boxSet = true;
+					}
 
 					for (int v=0; v<b->getIndexCount(); ++v)
 						nchunk.Indices.push_back(b->getIndices()[v]);
@@ -57,6 +57,7 @@ namespace scene
 
 		video::E_VERTEX_TYPE vertexType;
 		core::array< video::SMaterial > Materials;
+		core::array< bool > Occluders;	// if the polygons of a material hide what is behind them
 	};
 
 } // end namespace scene
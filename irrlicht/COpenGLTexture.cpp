@@ -57,9 +57,14 @@ void COpenGLTexture::copyTexture()
 
 	glBindTexture(GL_TEXTURE_2D, textureName);
 
-	CColorConverter::convert16bitToA8R8G8B8andResize(
-		Surface->lock(), imageData, nSurfaceSize.Width, nSurfaceSize.Height,
-		SurfaceSize.Width, SurfaceSize.Height);
+	if (Surface->getColorFormat() == EHCF_A8R8G8B8)
+		CColorConverter::convert32bitToA8R8G8B8andResize(
+			(s32*)Surface->lock(), imageData, nSurfaceSize.Width, nSurfaceSize.Height,
+			SurfaceSize.Width, SurfaceSize.Height);
+	else
+		CColorConverter::convert16bitToA8R8G8B8andResize(
+			(s16*)Surface->lock(), imageData, nSurfaceSize.Width, nSurfaceSize.Height,
+			SurfaceSize.Width, SurfaceSize.Height);
 
 	glTexImage2D(GL_TEXTURE_2D, 0, 4, nSurfaceSize.Width, 
 		nSurfaceSize.Height, 0, GL_BGRA_EXT , GL_UNSIGNED_BYTE, imageData);
@@ -126,7 +131,7 @@ EDriverType COpenGLTexture::getDriverType()
 //! returns color format of texture
 ECOLOR_FORMAT COpenGLTexture::getColorFormat()
 {
-	return EHCF_R5G5B5;
+	return Surface ? Surface->getColorFormat() : EHCF_R5G5B5;
 }
 
 
@@ -134,7 +139,7 @@ ECOLOR_FORMAT COpenGLTexture::getColorFormat()
 //! returns pitch of texture (in bytes)
 s32 COpenGLTexture::getPitch()
 {
-	return Surface ? Surface->getDimension().Width * 2 : 0;
+	return Surface ? Surface->getPitch() : 0;
 }
 
 
@@ -0,0 +1,236 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "CProfiler.h"
+#include "os.h"
+#include <stdio.h>
+
+namespace irr
+{
+
+
+//! constructor
+CProfiler::CProfiler(u32 frameRingSize)
+: FramesFinished(0), FrameNumber(0), Current(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CProfiler");
+	#endif
+
+	setFrameRingSize(frameRingSize);
+}
+
+
+
+//! destructor
+CProfiler::~CProfiler()
+{
+}
+
+
+
+//! enables or disables the profiler
+void CProfiler::setEnabled(bool enabled)
+{
+	Enabled = enabled;
+
+	if (!Enabled)
+	{
+		Current = 0;
+		Stack.set_used(0);
+	}
+}
+
+
+
+//! sets how many of the last frames are kept
+void CProfiler::setFrameRingSize(u32 frameCount)
+{
+	// one more frame than requested is allocated, the frame
+	// being recorded never overwrites one of the stored frames.
+
+	Frames.clear();
+	Frames.set_used(frameCount + 1);
+
+	FramesFinished = 0;
+	Current = 0;
+	Stack.set_used(0);
+}
+
+
+
+//! returns the amount of stored frames
+u32 CProfiler::getStoredFrameCount()
+{
+	u32 stored = Frames.size() - 1;
+	return FramesFinished < stored ? FramesFinished : stored;
+}
+
+
+
+//! returns a stored frame
+const SProfileFrame* CProfiler::getFrame(u32 age)
+{
+	if (age >= getStoredFrameCount())
+		return 0;
+
+	return &Frames[(FramesFinished - 1 - age) % Frames.size()];
+}
+
+
+
+//! begins a new frame
+void CProfiler::beginFrame()
+{
+	if (!Enabled)
+		return;
+
+	if (Current)
+		endFrame();
+
+	Current = &Frames[FramesFinished % Frames.size()];
+	Current->FrameNumber = FrameNumber;
+	Current->Zones.set_used(0);
+	Current->Duration = 0.0;
+	Stack.set_used(0);
+
+	Current->Start = os::Timer::getPreciseTime();
+}
+
+
+
+//! finishes the current frame and stores it in the ring
+void CProfiler::endFrame()
+{
+	if (!Current)
+		return;
+
+	f64 now = os::Timer::getPreciseTime() - Current->Start;
+
+	// close zones which were not left
+
+	for (u32 i=0; i<Stack.size(); ++i)
+		if (Stack[i] != -1)
+			Current->Zones[Stack[i]].Duration = now - Current->Zones[Stack[i]].Start;
+
+	Stack.set_used(0);
+
+	Current->Duration = now;
+	Current = 0;
+
+	++FramesFinished;
+	++FrameNumber;
+}
+
+
+
+//! enters a zone
+void CProfiler::beginZone(const c8* name, s32 id)
+{
+	if (!Current)
+	{
+		Stack.push_back(-1);
+		return;
+	}
+
+	SProfileZone zone;
+	zone.Name = name;
+	zone.Id = id;
+	zone.Parent = -1;
+	zone.Depth = 0;
+
+	// find enclosing zone, skipping zones which were entered outside of the frame
+
+	for (s32 i=(s32)Stack.size()-1; i>=0; --i)
+		if (Stack[i] != -1)
+		{
+			zone.Parent = Stack[i];
+			zone.Depth = Current->Zones[Stack[i]].Depth + 1;
+			break;
+		}
+
+	zone.Duration = 0.0;
+
+	Stack.push_back(Current->Zones.size());
+	Current->Zones.push_back(zone);
+
+	Current->Zones[Current->Zones.size()-1].Start = 
+		os::Timer::getPreciseTime() - Current->Start;
+}
+
+
+
+//! leaves the zone entered last
+void CProfiler::endZone()
+{
+	if (Stack.empty())
+		return;
+
+	s32 index = Stack[Stack.size()-1];
+	Stack.set_used(Stack.size()-1);
+
+	if (Current && index != -1)
+	{
+		SProfileZone& zone = Current->Zones[index];
+		zone.Duration = os::Timer::getPreciseTime() - Current->Start - zone.Start;
+	}
+}
+
+
+
+//! writes all stored frames into a file in the chrome trace event format
+bool CProfiler::writeChromeTrace(const c8* filename)
+{
+	FILE* file = fopen(filename, "wt");
+	if (!file)
+	{
+		os::Warning::print("Could not write profiler trace", filename);
+		return false;
+	}
+
+	fprintf(file, "{\"traceEvents\":[\n");
+
+	bool first = true;
+
+	// oldest frame first, times are written in microseconds.
+
+	for (s32 age=(s32)getStoredFrameCount()-1; age>=0; --age)
+	{
+		const SProfileFrame* frame = getFrame(age);
+
+		fprintf(file, "%s{\"name\":\"frame %u\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f}",
+			first ? "" : ",\n", frame->FrameNumber, frame->Start * 1000.0, frame->Duration * 1000.0);
+		first = false;
+
+		for (u32 i=0; i<frame->Zones.size(); ++i)
+		{
+			const SProfileZone& zone = frame->Zones[i];
+
+			fprintf(file, ",\n{\"name\":\"");
+
+			for (const c8* c = zone.Name ? zone.Name : "unnamed"; *c; ++c)
+			{
+				if (*c == '"' || *c == '\\')
+					fputc('\\', file);
+				fputc(*c, file);
+			}
+
+			fprintf(file, "\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f",
+				(frame->Start + zone.Start) * 1000.0, zone.Duration * 1000.0);
+
+			if (zone.Id != -1)
+				fprintf(file, ",\"args\":{\"id\":%d}", zone.Id);
+
+			fprintf(file, "}");
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+
+	return true;
+}
+
+
+} // end namespace
@@ -0,0 +1,62 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __C_PROFILER_H_INCLUDED__
+#define __C_PROFILER_H_INCLUDED__
+
+#include "IProfiler.h"
+
+namespace irr
+{
+
+	class CProfiler : public IProfiler
+	{
+	public:
+
+		//! constructor
+		CProfiler(u32 frameRingSize = 60);
+
+		//! destructor
+		virtual ~CProfiler();
+
+		//! enables or disables the profiler
+		virtual void setEnabled(bool enabled);
+
+		//! sets how many of the last frames are kept
+		virtual void setFrameRingSize(u32 frameCount);
+
+		//! returns the amount of stored frames
+		virtual u32 getStoredFrameCount();
+
+		//! returns a stored frame
+		virtual const SProfileFrame* getFrame(u32 age);
+
+		//! begins a new frame
+		virtual void beginFrame();
+
+		//! finishes the current frame and stores it in the ring
+		virtual void endFrame();
+
+		//! enters a zone
+		virtual void beginZone(const c8* name, s32 id=-1);
+
+		//! leaves the zone entered last
+		virtual void endZone();
+
+		//! writes all stored frames into a file in the chrome trace event format
+		virtual bool writeChromeTrace(const c8* filename);
+
+	private:
+
+		core::array<SProfileFrame> Frames;	// ring of the last frames
+		u32 FramesFinished;					// amount of frames stored since the ring was cleared
+		u32 FrameNumber;
+
+		SProfileFrame* Current;				// frame being recorded, or 0
+		core::array<s32> Stack;				// indices of the open zones, -1 for ignored zones
+	};
+
+} // end namespace
+
+#endif
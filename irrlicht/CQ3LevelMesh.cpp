@@ -422,6 +422,20 @@ void CQ3LevelMesh::loadTextures()
 							p[x*128 +y] = video::RGB16(r,g,b);*/
 						}
 				}
+				else
+				if (lig[t]->getColorFormat() == video::EHCF_A8R8G8B8)
+				{
+					tBSPLightmap* lm;
+					lm = &LightMaps[t-1];
+					s32* p32 = (s32*)((void*)p);
+
+					for (s32 x=0; x<128; ++x)
+						for (s32 y=0; y<128; ++y)
+							p32[x*128 +y] = video::Color(0,
+								lm->imageBits[x][y][0],
+								lm->imageBits[x][y][1],
+								lm->imageBits[x][y][2]).color;
+				}
 				else
 					os::Warning::print("Could not create lightmap, unsupported texture format.");
 			}
@@ -5,7 +5,7 @@
 #ifndef __C_READ_FILE_H_INCLUDED__
 #define __C_READ_FILE_H_INCLUDED__
 
-#include <stdio.H>
+#include <stdio.h>
 #include "IReadFile.h"
 #include "irrstring.h"
 
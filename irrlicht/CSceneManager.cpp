@@ -20,8 +20,8 @@
 #include "CBillboardSceneNode.h"
 #include "CMeshSceneNode.h"
 
-#include "CSceneNodeAnimatorRotation.H"
-#include "CSceneNodeAnimatorFlyCircle.H"
+#include "CSceneNodeAnimatorRotation.h"
+#include "CSceneNodeAnimatorFlyCircle.h"
 
 namespace irr
 {
@@ -30,8 +30,8 @@ namespace scene
 
 
 //! constructor
-CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs)
-: ISceneNode(0, 0), Driver(driver), FileSystem(fs), ActiveCamera(0)
+CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs, ITimer* timer, IProfiler* profiler)
+: ISceneNode(0, 0), Driver(driver), FileSystem(fs), Timer(timer), Profiler(profiler), ActiveCamera(0)
 {
 	#ifdef _DEBUG
 	ISceneManager::setDebugName("CSceneManager ISceneManager");
@@ -43,6 +43,12 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs)
 
 	if (FileSystem)
 		FileSystem->grab();
+
+	if (Timer)
+		Timer->grab();
+
+	if (Profiler)
+		Profiler->grab();
 }
 
 //! destructor
@@ -54,6 +60,12 @@ CSceneManager::~CSceneManager()
 	if (FileSystem)
 		FileSystem->drop();
 
+	if (Timer)
+		Timer->drop();
+
+	if (Profiler)
+		Profiler->drop();
+
 	for (u32 i=0; i<Meshes.size(); ++i)
 		Meshes[i].Mesh->drop();
 }
@@ -178,6 +190,14 @@ video::IVideoDriver* CSceneManager::getVideoDriver()
 }
 
 
+
+//! returns the clock all animations of the scene are driven by
+ITimer* CSceneManager::getTimer()
+{
+	return Timer;
+}
+
+
 //! adds a test scene node for test purposes to the scene. It is a simple cube of (1,1,1) size. 
 //! the returned pointer must not be dropped.
 ISceneNode* CSceneManager::addTestSceneNode(f32 size, ISceneNode* parent, s32 id,
@@ -409,57 +429,131 @@ void CSceneManager::registerNodeForRendering(ISceneNode* node, ESceneNodeRenderT
 					TransparentNodeList.push_back(e);
 					return;
 				}
-			
-			DefaultNodeList.push_back(node);
+
+			// the nodes are sorted by the first time their texture was
+			// registered, which keeps the order independent of where
+			// the textures are in memory.
+			video::ITexture* texture = count ? node->getMaterial(0).Texture1 : 0;
+			s32 textureIndex = 0;
+
+			while (textureIndex < DefaultNodeTextures.size() &&
+				DefaultNodeTextures[textureIndex] != texture)
+				++textureIndex;
+
+			if (textureIndex == DefaultNodeTextures.size())
+				DefaultNodeTextures.push_back(texture);
+
+			DefaultNodeList.push_back(DefaultNodeEntry(node, textureIndex));
 		}
 		break;
 	}
 }
 
 
+//! renders a single node, measured by the profiler if it is enabled
+void CSceneManager::renderNode(ISceneNode* node)
+{
+	if (Profiler && Profiler->isEnabled())
+	{
+		SProfileScope zone(Profiler, 
+			node->getDebugName() ? node->getDebugName() : "ISceneNode::render",
+			node->getID());
+
+		node->render();
+	}
+	else
+		node->render();
+}
+
+
+
+//! returns if the bounding box of a node may be visible. Sets the
+//! world transformation to the one of the node.
+bool CSceneManager::isNodeVisible(ISceneNode* node)
+{
+	Driver->setTransform(video::TS_WORLD, node->getAbsoluteTransformation());
+	return Driver->isBoxVisible(node->getBoundingBox());
+}
+
+
+
 //! draws all scene nodes
 void CSceneManager::drawAll()
 {
 	if (!Driver)
 		return;
 
+	SProfileScope zone(Profiler, "CSceneManager::drawAll");
+
 	// calculate camera pos.
 	camTransPos.set(0,0,0);
 	if (ActiveCamera)
 		camTransPos = ActiveCamera->getAbsolutePosition();
 
 	// let all nodes register themselfes
-	OnPreRender();
+	{
+		SProfileScope phase(Profiler, "OnPreRender");
+		OnPreRender();
+	}
 
 	//render lights and cameras
 
 	Driver->deleteAllDynamicLights();
 
-	for (u32 i=0; i<LightAndCameraList.size(); ++i)
-		LightAndCameraList[i]->render();
+	{
+		SProfileScope phase(Profiler, "render lights and cameras");
+
+		for (u32 i=0; i<LightAndCameraList.size(); ++i)
+			renderNode(LightAndCameraList[i]);
+	}
 
 	LightAndCameraList.clear();
 
+	// the cameras have set the view and projection, the nodes and the 
+	// octrees are now tested against the occluders drawn before them.
+
+	Driver->clearOcclusionBuffer();
+
 	// render default objects
 
-	DefaultNodeList.sort(); // sort by textures
+	{
+		SProfileScope phase(Profiler, "sort default nodes");
+		DefaultNodeList.sort(); // sort by textures
+	}
+
+	{
+		SProfileScope phase(Profiler, "render default nodes");
 
-	for (s32 i = 0; i<DefaultNodeList.size(); ++i)
-		DefaultNodeList[i].node->render();
+		for (s32 i = 0; i<DefaultNodeList.size(); ++i)
+			if (isNodeVisible(DefaultNodeList[i].node))
+				renderNode(DefaultNodeList[i].node);
+	}
 
 	DefaultNodeList.clear();
+	DefaultNodeTextures.clear();
 
 	// render transparent objects.
 
-	TransparentNodeList.sort(); // sort by distance from camera
+	{
+		SProfileScope phase(Profiler, "sort transparent nodes");
+		TransparentNodeList.sort(); // sort by distance from camera
+	}
 
-	for (s32 i = 0; i<TransparentNodeList.size(); ++i)
-		TransparentNodeList[i].node->render();
+	{
+		SProfileScope phase(Profiler, "render transparent nodes");
+
+		for (s32 i = 0; i<TransparentNodeList.size(); ++i)
+			if (isNodeVisible(TransparentNodeList[i].node))
+				renderNode(TransparentNodeList[i].node);
+	}
 
 	TransparentNodeList.clear();
 
 	// do animations and other stuff.
-	OnPostRender(os::Timer::getTime());
+	{
+		SProfileScope phase(Profiler, "OnPostRender");
+		OnPostRender(Timer->getTime());
+	}
 }
 
 
@@ -488,9 +582,9 @@ ISceneNodeAnimator* CSceneManager::createFlyCircleAnimator(const core::vector3df
 
 
 // creates a scenemanager
-ISceneManager* createSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs)
+ISceneManager* createSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs, ITimer* timer, IProfiler* profiler)
 {
-	return new CSceneManager(driver, fs);
+	return new CSceneManager(driver, fs, timer, profiler);
 }
 
 
@@ -9,6 +9,8 @@
 #include "ISceneNode.h"
 #include "irrstring.h"
 #include "array.h"
+#include "ITimer.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -23,7 +25,7 @@ namespace scene
 	public:
 
 		//! constructor
-		CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs);
+		CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs, ITimer* timer, IProfiler* profiler);
 
 		//! destructor
 		virtual ~CSceneManager();
@@ -34,6 +36,9 @@ namespace scene
 		//! returns the video driver
 		virtual video::IVideoDriver* getVideoDriver();
 
+		//! returns the clock all animations of the scene are driven by
+		virtual ITimer* getTimer();
+
 		//! adds a test scene node for test purposes to the scene. It is a simple cube of (1,1,1) size. 
 		//! the returned pointer must not be dropped.
 		virtual ISceneNode* addTestSceneNode(f32 size=10.0f, ISceneNode* parent=0, s32 id=-1,
@@ -131,6 +136,13 @@ namespace scene
 
 		//! returns an already loaded mesh
 		IAnimatedMesh* findMesh(const c8* lowerMadeFilename);
+
+		//! renders a single node, measured by the profiler if it is enabled
+		void renderNode(ISceneNode* node);
+
+		//! returns if the bounding box of a node may be visible. Sets the
+		//! world transformation to the one of the node.
+		bool isNodeVisible(ISceneNode* node);
 		
 
 		struct MeshEntry
@@ -148,13 +160,12 @@ namespace scene
 		{
 			DefaultNodeEntry() {};
 
-			DefaultNodeEntry(ISceneNode* n)
+			//! texture is the index of the first texture of the node in the
+			//! order in which the textures were registered this frame. Unlike
+			//! the address of the texture, it is the same in every run.
+			DefaultNodeEntry(ISceneNode* n, s32 texture)
 			{
-				textureValue = 0;
-
-				if (n->getMaterialCount())
-					textureValue = (s32)(n->getMaterial(0).Texture1);
-
+				textureValue = texture;
 				node = n;
 			}
 
@@ -198,9 +209,16 @@ namespace scene
 		//! file system
 		io::IFileSystem* FileSystem;
 
+		//! clock of the device
+		ITimer* Timer;
+
+		//! profiler of the device
+		IProfiler* Profiler;
+
 		//! render pass lists
 		core::array<ISceneNode*> LightAndCameraList;
 		core::array<DefaultNodeEntry> DefaultNodeList;
+		core::array<video::ITexture*> DefaultNodeTextures;
 		core::array<TransparentNodeEntry> TransparentNodeList;
 
 		//! current active camera
@@ -1,14 +1,76 @@
 #include "CSoftwareTexture.h"
+#include "CColorQuantizer.h"
+#include "CColorConverter.h"
+#include "CSurfaceScaler.h"
 #include "os.h"
+#include <memory.h>
 
 namespace irr
 {
 namespace video  
 {
 
+//! creates a surface of the color format of another one, sharing its
+//! palette if it is an EHCF_P8 surface
+static ISurface* createSurfaceLike(ISurface* surface, const core::dimension2d<s32>& size)
+{
+	if (surface->getColorFormat() == EHCF_P8)
+		return createPalettedSurface(surface->getPalette(), size);
+
+	return createSurface(surface->getColorFormat(), size);
+}
+
+
+
+//! copies the indices and the colors of the palette of an EHCF_P8 surface
+//! into another one of the same size and palette format
+static void copyPalettedSurface(ISurface* source, ISurface* target)
+{
+	ISurface* palette = target->getPalette();
+	memcpy(palette->lock(), source->getPalette()->lock(), 256 * palette->getBytesPerPixel());
+	source->getPalette()->unlock();
+	palette->unlock();
+
+	source->copyTo(target, 0, 0);
+}
+
+
+
+//! converts an A8R8G8B8 surface into an EHCF_R5G5B5 one of the same size,
+//! dithered
+static void ditherSurface(ISurface* source, ISurface* target)
+{
+	const core::dimension2d<s32> size = source->getDimension();
+	const s32* s = (const s32*)source->lock();
+	s16* t = (s16*)target->lock();
+
+	for (s32 y=0; y<size.Height; ++y)
+		CColorConverter::convertRowDithered(s + y*size.Width, t + y*size.Width, size.Width, y);
+
+	target->unlock();
+	source->unlock();
+}
+
+
+
+//! scales a surface into the texture made of it, which has the same
+//! format. The textures only grow to the next power of 2, so they are
+//! filtered bilinear.
+static void scaleTexture(ISurface* surface, ISurface* texture, CThreadPool* threads)
+{
+	CSurfaceScaler::scale(surface->lock(), surface->getDimension(), texture->lock(),
+		texture->getDimension(), surface->getColorFormat(), ESSF_BILINEAR, threads);
+
+	texture->unlock();
+	surface->unlock();
+}
+
+
+
 //! constructor
-CSoftwareTexture::CSoftwareTexture(ISurface* surface)
-: Surface(surface), Texture(0)
+CSoftwareTexture::CSoftwareTexture(ISurface* surface, ECOLOR_FORMAT format, bool generateMipLevels,
+	bool tiled, bool dithered, CThreadPool* threads)
+: Surface(surface), Texture(0), TiledTexture(0), Unpacked(0), Tiled(tiled)
 {
 	#ifdef _DEBUG
 	setDebugName("CSoftwareTexture");
@@ -16,24 +78,78 @@ CSoftwareTexture::CSoftwareTexture(ISurface* surface)
 
 	if (Surface)
 	{
-		Surface->grab();
-
 		core::dimension2d<s32> optSize;
 		core::dimension2d<s32> origSize = Surface->getDimension();
 
+		if (Surface->getColorFormat() == EHCF_P8)
+		{
+			// the indices are kept, only the palette gets the format
+			ISurface* palette = Surface->getPalette();
+
+			if (format != EHCF_P8 && palette->getColorFormat() != format)
+			{
+				palette = createSurface(format, palette->getDimension());
+				surface->getPalette()->copyTo(palette, 0, 0);
+				Surface = createPalettedSurface(palette, origSize);
+				surface->copyTo(Surface, 0, 0);
+				palette->drop();
+			}
+			else
+				Surface->grab();
+		}
+		else
+		if (Surface->getColorFormat() != format)
+		{
+			// the renderers only draw textures in the format of the render target
+			Surface = createSurface(format, origSize);
+
+			if (dithered && format == EHCF_R5G5B5)
+				ditherSurface(surface, Surface);
+			else
+				surface->copyTo(Surface, 0, 0);
+		}
+		else
+			Surface->grab();
+
 		optSize.Width = getTextureSizeFromSurfaceSize(origSize.Width);
 		optSize.Height = getTextureSizeFromSurfaceSize(origSize.Height);
 
 		if (optSize != origSize)
 		{
-			Texture = createSurface(optSize);
-			Surface->copyToScaling(Texture);
+			Texture = createSurfaceLike(Surface, optSize);
+			scaleTexture(Surface, Texture, threads);
 		}
 		else
 		{
 			Texture = Surface;
 			Texture->grab();
 		}
+
+		if (Tiled && optSize.Width >= 4 && optSize.Height >= 4)
+			TiledTexture = createSurfaceLike(Texture, optSize);
+
+		if (generateMipLevels)
+		{
+			core::dimension2d<s32> size = optSize;
+
+			while (size.Width > 1 || size.Height > 1)
+			{
+				size.Width = size.Width > 1 ? size.Width >> 1 : 1;
+				size.Height = size.Height > 1 ? size.Height >> 1 : 1;
+
+				if (Texture->getColorFormat() == EHCF_P8)
+				{
+					// every level gets a palette of its own
+					ISurface* palette = createSurface(getColorFormat(), core::dimension2d<s32>(256, 1));
+					MipMaps.push_back(createPalettedSurface(palette, size));
+					palette->drop();
+				}
+				else
+					MipMaps.push_back(createSurface(Texture->getColorFormat(), size));
+			}
+		}
+
+		updateRendererSurfaces();
 	}
 }
 
@@ -47,6 +163,15 @@ CSoftwareTexture::~CSoftwareTexture()
 
 	if (Texture)
 		Texture->drop();
+
+	if (TiledTexture)
+		TiledTexture->drop();
+
+	if (Unpacked)
+		Unpacked->drop();
+
+	for (u32 i=0; i<MipMaps.size(); ++i)
+		MipMaps[i]->drop();
 }
 
 
@@ -54,7 +179,17 @@ CSoftwareTexture::~CSoftwareTexture()
 //! lock function
 void* CSoftwareTexture::lock()
 {
-	return Surface->lock();
+	if (Surface->getColorFormat() != EHCF_P8)
+		return Surface->lock();
+
+	// paletted textures are unpacked while they are locked
+	if (!Unpacked)
+	{
+		Unpacked = createSurface(getColorFormat(), Surface->getDimension());
+		Surface->copyTo(Unpacked, 0, 0);
+	}
+
+	return Unpacked->lock();
 }
 
 
@@ -62,15 +197,27 @@ void* CSoftwareTexture::lock()
 //! unlock function
 void CSoftwareTexture::unlock()
 {
+	if (Unpacked)
+	{
+		// the colors may have changed, so the palette is chosen again
+		Unpacked->unlock();
+		ISurface* surface = CColorQuantizer::createPalettedSurface(Unpacked, Unpacked->getColorFormat());
+		copyPalettedSurface(surface, Surface);
+		surface->drop();
+		Unpacked->drop();
+		Unpacked = 0;
+	}
+
 	if (Surface != Texture)
 	{
 		#ifdef _DEBUG
 		os::Debuginfo::print("Performance warning, slow unlock of non power of 2 texture.");
 		#endif
-		Surface->copyToScaling(Texture);
+		scaleTexture(Surface, Texture, 0);
 	}
 
 	Surface->unlock();
+	updateRendererSurfaces();
 }
 
 
@@ -122,7 +269,10 @@ EDriverType CSoftwareTexture::getDriverType()
 //! returns color format of texture
 ECOLOR_FORMAT CSoftwareTexture::getColorFormat()
 {
-	return EHCF_R5G5B5;
+	if (Surface->getColorFormat() == EHCF_P8)
+		return Surface->getPalette()->getColorFormat();
+
+	return Surface->getColorFormat();
 }
 
 
@@ -130,7 +280,208 @@ ECOLOR_FORMAT CSoftwareTexture::getColorFormat()
 //! returns pitch of texture (in bytes)
 s32 CSoftwareTexture::getPitch()
 {
-	return Surface->getDimension().Width * 2;
+	if (Surface->getColorFormat() == EHCF_P8)
+		return Surface->getDimension().Width * Surface->getPalette()->getBytesPerPixel();
+
+	return Surface->getPitch();
+}
+
+
+
+//! returns the amount of mip maps
+s32 CSoftwareTexture::getMipMapCount()
+{
+	return MipMaps.size();
+}
+
+
+
+//! returns the mip maps
+ISurface* const* CSoftwareTexture::getMipMaps()
+{
+	return MipMaps.size() ? MipMaps.pointer() : 0;
+}
+
+
+
+//! returns the texture surface in the layout of the mip maps
+ISurface* CSoftwareTexture::getRendererTexture()
+{
+	return TiledTexture ? TiledTexture : Texture;
+}
+
+
+
+//! returns if the renderer texture and the mip maps are stored in tiles
+bool CSoftwareTexture::isTiled()
+{
+	return Tiled;
+}
+
+
+
+//! returns if the surfaces are EHCF_P8 surfaces
+bool CSoftwareTexture::isPaletted()
+{
+	return Surface && Surface->getColorFormat() == EHCF_P8;
+}
+
+
+
+//! returns the offset of a texel in a surface drawn by the renderers
+inline s32 CSoftwareTexture::getTexelOffset(s32 x, s32 y, const core::dimension2d<s32>& size) const
+{
+	if (!Tiled || size.Width < 4 || size.Height < 4)
+		return y * size.Width + x;
+
+	return (y & ~3) * size.Width + ((x & ~3) << 2) + ((y & 3) << 2) + (x & 3);
+}
+
+
+
+//! returns the average of 4 A8R8G8B8 texels
+static inline u32 average32(u32 a, u32 b, u32 c, u32 d)
+{
+	// every channel is averaged by itself, the masks keep the sums of
+	// two channels from running into each other
+	u32 rb = ((a & 0x00FF00FF) + (b & 0x00FF00FF) + (c & 0x00FF00FF) + (d & 0x00FF00FF) + 0x00020002) >> 2;
+	u32 ag = ((a >> 8) & 0x00FF00FF) + ((b >> 8) & 0x00FF00FF) + ((c >> 8) & 0x00FF00FF) + ((d >> 8) & 0x00FF00FF) + 0x00020002;
+
+	return (rb & 0x00FF00FF) | ((ag << 6) & 0xFF00FF00);
+}
+
+
+
+//! returns the average of 4 A1R5G5B5 texels, the alpha bit is set if it
+//! is set in half of the texels
+static inline u16 average16(u32 a, u32 b, u32 c, u32 d)
+{
+	u32 r = (((a>>10) & 0x1F) + ((b>>10) & 0x1F) + ((c>>10) & 0x1F) + ((d>>10) & 0x1F) + 2) >> 2;
+	u32 g = (((a>>5) & 0x1F) + ((b>>5) & 0x1F) + ((c>>5) & 0x1F) + ((d>>5) & 0x1F) + 2) >> 2;
+	u32 bl = ((a & 0x1F) + (b & 0x1F) + (c & 0x1F) + (d & 0x1F) + 2) >> 2;
+	u32 alpha = (a>>15) + (b>>15) + (c>>15) + (d>>15) >= 2 ? 0x8000 : 0;
+
+	return (u16)(alpha | (r<<10) | (g<<5) | bl);
+}
+
+
+
+//! updates the renderer texture and the mip maps
+void CSoftwareTexture::updateRendererSurfaces()
+{
+	if (TiledTexture)
+	{
+		const core::dimension2d<s32>& size = Texture->getDimension();
+		const s32 bytesPerPixel = Texture->getBytesPerPixel();
+
+		const void* src = Texture->lock();
+		void* dst = TiledTexture->lock();
+
+		for (s32 y=0; y<size.Height; ++y)
+			for (s32 x=0; x<size.Width; ++x)
+			{
+				if (bytesPerPixel == 4)
+					((u32*)dst)[getTexelOffset(x, y, size)] = ((const u32*)src)[y * size.Width + x];
+				else
+				if (bytesPerPixel == 2)
+					((u16*)dst)[getTexelOffset(x, y, size)] = ((const u16*)src)[y * size.Width + x];
+				else
+					((u8*)dst)[getTexelOffset(x, y, size)] = ((const u8*)src)[y * size.Width + x];
+			}
+
+		TiledTexture->unlock();
+		Texture->unlock();
+	}
+
+	if (isPaletted())
+		updatePalettedMipMaps();
+	else
+		updateMipMaps();
+}
+
+
+
+//! fills the mip maps with the renderer texture
+void CSoftwareTexture::updateMipMaps()
+{
+	ISurface* source = getRendererTexture();
+
+	for (u32 i=0; i<MipMaps.size(); ++i)
+	{
+		filterMipMap(source, MipMaps[i]);
+		source = MipMaps[i];
+	}
+}
+
+
+
+//! fills the mip maps of a paletted texture
+void CSoftwareTexture::updatePalettedMipMaps()
+{
+	// the levels are filtered in the colors of the palette. They are
+	// stored in the layout of the renderers already, the quantizer does
+	// not care about the order of the texels.
+	const ECOLOR_FORMAT format = getColorFormat();
+	ISurface* renderer = getRendererTexture();
+	ISurface* source = createSurface(format, renderer->getDimension());
+	renderer->copyTo(source, 0, 0);
+
+	for (u32 i=0; i<MipMaps.size(); ++i)
+	{
+		ISurface* level = createSurface(format, MipMaps[i]->getDimension());
+		filterMipMap(source, level);
+
+		ISurface* paletted = CColorQuantizer::createPalettedSurface(level, format);
+		copyPalettedSurface(paletted, MipMaps[i]);
+		paletted->drop();
+
+		source->drop();
+		source = level;
+	}
+
+	source->drop();
+}
+
+
+
+//! fills a mip map with the average of 2x2 texels of the level above
+void CSoftwareTexture::filterMipMap(ISurface* source, ISurface* target)
+{
+	const core::dimension2d<s32>& sourceSize = source->getDimension();
+	const core::dimension2d<s32>& targetSize = target->getDimension();
+	const bool is32 = target->getColorFormat() == EHCF_A8R8G8B8;
+
+	// levels of textures which are not square have a side of 1 texel
+	// before the other one, it is averaged from 1 texel instead of 2.
+	s32 dx = sourceSize.Width > 1 ? 1 : 0;
+	s32 dy = sourceSize.Height > 1 ? 1 : 0;
+
+	const void* src = source->lock();
+	void* dst = target->lock();
+
+	for (s32 y=0; y<targetSize.Height; ++y)
+		for (s32 x=0; x<targetSize.Width; ++x)
+		{
+			s32 a = getTexelOffset(x*2, y*2, sourceSize);
+			s32 b = getTexelOffset(x*2 + dx, y*2, sourceSize);
+			s32 c = getTexelOffset(x*2, y*2 + dy, sourceSize);
+			s32 d = getTexelOffset(x*2 + dx, y*2 + dy, sourceSize);
+			s32 o = getTexelOffset(x, y, targetSize);
+
+			if (is32)
+			{
+				const u32* t = (const u32*)src;
+				((u32*)dst)[o] = average32(t[a], t[b], t[c], t[d]);
+			}
+			else
+			{
+				const u16* t = (const u16*)src;
+				((u16*)dst)[o] = average16(t[a], t[b], t[c], t[d]);
+			}
+		}
+
+	target->unlock();
+	source->unlock();
 }
 
 
@@ -7,6 +7,8 @@
 
 #include "ITexture.h"
 #include "ISurface.h"
+#include "CThreadPool.h"
+#include "array.h"
 
 namespace irr
 {
@@ -20,8 +22,18 @@ class CSoftwareTexture : public ITexture
 {
 public:
 
-	//! constructor
-	CSoftwareTexture(ISurface* surface);
+	//! constructor. The surface is converted into the color format
+	//! if it has an other one. Of EHCF_P8 surfaces, only the palette is
+	//! converted, see isPaletted().
+	//! \param generateMipLevels: Creates the mip maps of the texture.
+	//! \param tiled: Stores the surfaces drawn by the triangle renderers
+	//! in tiles of 4x4 texels, see isTiled().
+	//! \param dithered: A8R8G8B8 surfaces are dithered when they are
+	//! converted into EHCF_R5G5B5.
+	//! \param threads: Surfaces which are no power of 2 are scaled by the
+	//! threads of the pool if there is one.
+	CSoftwareTexture(ISurface* surface, ECOLOR_FORMAT format, bool generateMipLevels = false,
+		bool tiled = false, bool dithered = false, CThreadPool* threads = 0);
 
 	//! destructor
 	virtual ~CSoftwareTexture();
@@ -50,13 +62,62 @@ public:
 	//! returns pitch of texture (in bytes)
 	virtual s32 getPitch();
 
+	//! returns the amount of mip maps, 0 if they were not generated
+	s32 getMipMapCount();
+
+	//! returns the mip maps, from the one of half the size of the
+	//! texture surface down to 1x1
+	ISurface* const* getMipMaps();
+
+	//! returns the texture surface in the layout of the mip maps, the
+	//! surface drawn by the triangle renderers
+	ISurface* getRendererTexture();
+
+	//! returns if the renderer texture and the mip maps are stored in
+	//! tiles of 4x4 texels. The tiles are stored row by row, and the
+	//! texels of a tile too, so the texels around a texel are mostly in
+	//! the same cache line. Surfaces smaller than 4 texels in a direction
+	//! are not tiled. The texture surface and lock() stay row by row.
+	bool isTiled();
+
+	//! returns if the texture was created from an EHCF_P8 surface. Its
+	//! surfaces keep 8 bit indices into a palette of the color format,
+	//! which saves half or three quarters of the memory. The renderer
+	//! texture shares the palette of the texture surface, every mip map has
+	//! one of its own. lock() returns the pixels in the color format of
+	//! the palette, unlock() quantizes them again.
+	bool isPaletted();
+
+	//! updates the renderer texture and the mip maps after the texture
+	//! surface was changed without lock(), like by drawing into it.
+	void updateRendererSurfaces();
+
 private:
 
 	//! returns the size of a texture which would be the optimize size for rendering it
 	inline s32 getTextureSizeFromSurfaceSize(s32 size);
 
+	//! returns the offset of a texel in a surface drawn by the renderers
+	inline s32 getTexelOffset(s32 x, s32 y, const core::dimension2d<s32>& size) const;
+
+	//! fills the mip maps with the renderer texture, filtered down by
+	//! the average of 2x2 texels for every level
+	void updateMipMaps();
+
+	//! fills the mip maps of a paletted texture. The levels are filtered
+	//! in the colors of the palette, and quantized again.
+	void updatePalettedMipMaps();
+
+	//! fills a mip map with the average of 2x2 texels of the level above,
+	//! both in the layout of the renderers
+	void filterMipMap(ISurface* source, ISurface* target);
+
 	ISurface* Surface;
 	ISurface* Texture;
+	ISurface* TiledTexture;		// 0 if the texture is not tiled
+	core::array<ISurface*> MipMaps;
+	ISurface* Unpacked;			// pixels of a paletted texture while it is locked
+	bool Tiled;
 
 };
 
@@ -5,6 +5,9 @@
 #include "CSurface.h"
 #include <memory.h>
 #include "Color.h"
+#include "CColorConverter.h"
+#include "CBlitKernels.h"
+#include "CSurfaceScaler.h"
 
 
 namespace irr
@@ -12,17 +15,65 @@ namespace irr
 namespace video  
 {
 
+//! returns the index of the color of a palette which is nearest to a color.
+//! Colors with and without the alpha bit are only chosen for each other if
+//! the palette has no other colors.
+static s32 getNearestPaletteIndex(ISurface* palette, Color color)
+{
+	s32 nearest = 0;
+	s32 nearestDistance = 0x7FFFFFFF;
+	bool alpha = color.getAlpha() >= 128;
+
+	for (s32 i=0; i<256; ++i)
+	{
+		Color c = palette->getPixel(i, 0);
+
+		s32 r = c.getRed() - color.getRed();
+		s32 g = c.getGreen() - color.getGreen();
+		s32 b = c.getBlue() - color.getBlue();
+		s32 distance = r*r + g*g + b*b;
+
+		if ((c.getAlpha() >= 128) != alpha)
+			distance += 3*256*256;
+
+		if (distance < nearestDistance)
+		{
+			nearest = i;
+			nearestDistance = distance;
+		}
+	}
+
+	return nearest;
+}
+
+
+
 //! constructor
-CSurface::CSurface(const core::dimension2d<s32>& size)
-: Size(size)
+CSurface::CSurface(ECOLOR_FORMAT format, const core::dimension2d<s32>& size)
+: Size(size), Format(format), Palette(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CSurface");
 	#endif
 
-	DataSize = Size.Width*Size.Height;
-	DataSizeInBytes = DataSize * sizeof(s16);
-	Data = new s16[DataSize];
+	if (Format != EHCF_A8R8G8B8)
+		Format = EHCF_R5G5B5;
+
+	createData();
+}
+
+
+
+//! constructor of an EHCF_P8 surface
+CSurface::CSurface(ISurface* palette, const core::dimension2d<s32>& size)
+: Size(size), Format(EHCF_P8), Palette(palette)
+{
+	#ifdef _DEBUG
+	setDebugName("CSurface");
+	#endif
+
+	Palette->grab();
+	createData();
 }
 
 
@@ -30,13 +81,32 @@ CSurface::CSurface(const core::dimension2d<s32>& size)
 //! destructor
 CSurface::~CSurface()
 {
-	delete [] Data;
+	delete [] (c8*)Data;
+
+	if (Palette)
+		Palette->drop();
+}
+
+
+
+//! allocates the pixels
+void CSurface::createData()
+{
+	if (Format == EHCF_P8)
+		BytesPerPixel = sizeof(u8);
+	else
+		BytesPerPixel = Format == EHCF_A8R8G8B8 ? sizeof(s32) : sizeof(s16);
+
+	Pitch = Size.Width * BytesPerPixel;
+	DataSize = Size.Width*Size.Height;
+	DataSizeInBytes = DataSize * BytesPerPixel;
+	Data = new c8[DataSizeInBytes];
 }
 
 
 
 //! lock function
-s16* CSurface::lock()
+void* CSurface::lock()
 {
 	return Data;
 }
@@ -57,78 +127,149 @@ const core::dimension2d<s32>& CSurface::getDimension()
 }
 
 
+//! returns the color format
+ECOLOR_FORMAT CSurface::getColorFormat()
+{
+	return Format;
+}
+
+
+
+//! returns the palette of an EHCF_P8 surface
+ISurface* CSurface::getPalette()
+{
+	return Palette;
+}
+
+
+
+//! returns the size of a pixel in bytes
+s32 CSurface::getBytesPerPixel()
+{
+	return BytesPerPixel;
+}
+
+
+
+//! returns the size of a row in bytes
+s32 CSurface::getPitch()
+{
+	return Pitch;
+}
+
+
+
+//! returns a color in the format of the surface
+inline s32 CSurface::getColorInFormat(Color color)
+{
+	if (Format == EHCF_A8R8G8B8)
+		return color.color;
+
+	if (Format == EHCF_P8)
+		return getNearestPaletteIndex(Palette, color);
+
+	return A8R8G8B8toA1R5G5B5(color.color);
+}
+
+
+
 //! gets a pixel
-s16 CSurface::getPixel(s32 x, s32 y)
+Color CSurface::getPixel(s32 x, s32 y)
 {
-	if (x<0 || y<0 || x>Size.Width || y>Size.Height)
+	if (x<0 || y<0 || x>=Size.Width || y>=Size.Height)
 		return 0;
-	
-	return Data[y*Size.Width + x];
+
+	if (Format == EHCF_A8R8G8B8)
+		return ((s32*)Data)[y*Size.Width + x];
+
+	if (Format == EHCF_P8)
+		return Palette->getPixel(((u8*)Data)[y*Size.Width + x], 0);
+
+	return A1R5G5B5toA8R8G8B8(((s16*)Data)[y*Size.Width + x]);
 }
 
 
 
 
 //! sets a pixel
-void CSurface::setPixel(s32 x, s32 y, s16 color)
+void CSurface::setPixel(s32 x, s32 y, Color color)
 {
 	clipX(x);
 	clipY(y);
-	Data[y*Size.Width + x] = color;
+	setPixelFast(x, y, getColorInFormat(color));
 }
 
 
 //! sets a pixel very fast and inline
-inline void CSurface::setPixelFast(s32 x, s32 y, s16 color)
+inline void CSurface::setPixelFast(s32 x, s32 y, s32 color)
 {
-	Data[y*Size.Width + x] = color;
+	if (Format == EHCF_A8R8G8B8)
+		((s32*)Data)[y*Size.Width + x] = color;
+	else
+	if (Format == EHCF_P8)
+		((u8*)Data)[y*Size.Width + x] = (u8)color;
+	else
+		((s16*)Data)[y*Size.Width + x] = (s16)color;
 }
 
 
 
 //! returns masks for pixels
-s16 CSurface::getRedMask()
+s32 CSurface::getRedMask()
 {
-	return 0x1F<<10;
+	if (Format == EHCF_P8)
+		return 0;
+
+	return Format == EHCF_A8R8G8B8 ? 0xFF<<16 : 0x1F<<10;
 }
 
 
 
 //! returns masks for pixels
-s16 CSurface::getGreenMask()
+s32 CSurface::getGreenMask()
 {
-	return 0x1F<<5;
+	if (Format == EHCF_P8)
+		return 0;
+
+	return Format == EHCF_A8R8G8B8 ? 0xFF<<8 : 0x1F<<5;
 }
 
 
 
 //! returns masks for pixels
-s16 CSurface::getBlueMask()
+s32 CSurface::getBlueMask()
 {
-	return 0x1F;
+	if (Format == EHCF_P8)
+		return 0;
+
+	return Format == EHCF_A8R8G8B8 ? 0xFF : 0x1F;
 }
 
 
 
 //! returns alpha mask
-s16 CSurface::getAlphaMask()
+s32 CSurface::getAlphaMask()
 {
-	return (s16)(0x1<<15);
+	if (Format == EHCF_P8)
+		return 0;
+
+	return Format == EHCF_A8R8G8B8 ? 0xFF<<24 : 0x1<<15;
 }
 
 
 
 //! fills the surface with black or white
-void CSurface::fill(s16 color)
+void CSurface::fill(Color color)
 {
-	s32* p = (s32*)Data;
-	s32* bufferEnd = p + (DataSize>>1);
-	s32 c = ((color & 0x0000ffff)<<16) | (color & 0x0000ffff);
-	while(p != bufferEnd)
+	s32 c = getColorInFormat(color);
+
+	if (Format == EHCF_P8)
 	{
-		*p = c;
-		++p;
+		memset(Data, c, DataSize);
+		return;
 	}
+
+	getBlitKernels(Format)->FillRow(Data, DataSize, c);
 }
 
 
@@ -191,49 +332,50 @@ void CSurface::drawRectangle(s32 x, s32 y, s32 x2, s32 y2, Color color)
 	if (y > y2)
 		exchange(y,y2);
 
+	if (x == x2)
+		return;
+
 	// draw
 
-	s32 l=y*Size.Width;
-	s32 ix;
+	s32 l=y*Size.Width + x;
 
-	if (color.getAlpha()==255)
+	if (Format == EHCF_P8)
 	{
-		// quickly draw without alpha.
+		// the colors of paletted surfaces are not blended, they are
+		// replaced by the nearest palette color.
 
-		s16 c = color.toA1R5G5B5();
+		u8 c = (u8)getColorInFormat(color);
 
 		for (s32 iy=y; iy<y2; ++iy)
 		{
-			for (ix=x; ix<x2; ++ix)
-				Data[l + ix] = c;
-
+			memset(&((u8*)Data)[l], c, x2-x);
 			l += Size.Width;
 		}
+
+		return;
 	}
-	else
-	{
-		// draw with alpha
 
-		s32 ia = color.getAlpha();
-		s32 a = 255-ia;
+	const SBlitKernels* kernels = getBlitKernels(Format);
 
-		s32 r = getRed(color.toA1R5G5B5()) * ia;
-		s32 g = getGreen(color.toA1R5G5B5()) * ia;
-		s32 b = getBlue(color.toA1R5G5B5()) * ia;
+	if (color.getAlpha()==255)
+	{
+		// quickly draw without alpha
 
-		s16 *src;
+		s32 c = getColorInFormat(color);
 
 		for (s32 iy=y; iy<y2; ++iy)
 		{
-			for (ix=x; ix<x2; ++ix)
-			{
-				src = &Data[l + ix];
-				*src =	video::RGB16(	
-					(video::getRed(*src)*a + r)>>5,
-					(video::getGreen(*src)*a + g)>>5,
-					(video::getBlue(*src)*a + b)>>5);
-			}
+			kernels->FillRow(&((c8*)Data)[l * BytesPerPixel], x2-x, c);
+			l += Size.Width;
+		}
+	}
+	else
+	{
+		// draw with alpha
 
+		for (s32 iy=y; iy<y2; ++iy)
+		{
+			kernels->BlendRow(&((c8*)Data)[l * BytesPerPixel], x2-x, color);
 			l += Size.Width;
 		}
 	}
@@ -295,8 +437,9 @@ void CSurface::copyTo(ISurface* target, const core::position2d<s32>& pos)
 //! copies this surface into another
 void CSurface::copyTo(ISurface* target, s32 x, s32 y)
 {
-	s16* data = target->lock();
+	c8* data = (c8*)target->lock();
 	core::dimension2d<s32> size = target->getDimension();
+	s32 targetBytesPerPixel = target->getBytesPerPixel();
 
 	// clip
 
@@ -310,16 +453,15 @@ void CSurface::copyTo(ISurface* target, s32 x, s32 y)
 
 	// copy
 
-	s32 ltarget=y*size.Width + x;
-	s32 lown=ownY*Size.Width + ownX;
-	size_t dataRowSizeInBytes = ownWidth*sizeof(s16);
+	s32 ltarget=(y*size.Width + x) * targetBytesPerPixel;
+	s32 lown=(ownY*Size.Width + ownX) * BytesPerPixel;
 
 	for (s32 iy=0; iy<ownHeight; ++iy)
 	{
-		memcpy(&data[ltarget], &Data[lown], dataRowSizeInBytes); 
+		convertRow(&((c8*)Data)[lown], ownWidth, &data[ltarget], target);
 
-		lown += Size.Width;
-		ltarget += size.Width;
+		lown += Pitch;
+		ltarget += size.Width * targetBytesPerPixel;
 	}
 
 	target->unlock();
@@ -414,16 +556,16 @@ void CSurface::copyTo(ISurface* target, const core::position2d<s32>& pos, const
 
 	// draw everything
 
-	s16* targetData = target->lock();
-	s32 ltarget = targetPos.Y * targetSurfaceSize.Width + targetPos.X;
-	s32 lsource = sourcePos.Y * Size.Width + sourcePos.X;
-	size_t dataRowSizeInBytes = sourceSize.Width * sizeof(s16);
+	c8* targetData = (c8*)target->lock();
+	s32 targetPitch = target->getPitch();
+	s32 ltarget = targetPos.Y * targetPitch + targetPos.X * target->getBytesPerPixel();
+	s32 lsource = sourcePos.Y * Pitch + sourcePos.X * BytesPerPixel;
 
 	for (s32 iy=0; iy<sourceSize.Height; ++iy)
 	{
-		memcpy(&targetData[ltarget], &Data[lsource], dataRowSizeInBytes); 
-		lsource += Size.Width;
-		ltarget += targetSurfaceSize.Width;
+		convertRow(&((c8*)Data)[lsource], sourceSize.Width, &targetData[ltarget], target);
+		lsource += Pitch;
+		ltarget += targetPitch;
 	}
 }
 
@@ -441,6 +583,10 @@ void CSurface::copyToWithAlpha(ISurface* target, const core::position2d<s32>& po
 	core::dimension2d<s32> sourceSize(sourceRect.getWidth(), sourceRect.getHeight());
 	const core::dimension2d<s32> targetSurfaceSize = target->getDimension();
 
+	// the indices of a paletted target have no alpha to test
+	if (target->getColorFormat() == EHCF_P8)
+		return;
+
 	// clip these coordinates
 
 	if (targetPos.X<0)
@@ -479,41 +625,42 @@ void CSurface::copyToWithAlpha(ISurface* target, const core::position2d<s32>& po
 
 	// draw everything
 
-	s16* targetData = target->lock();
-	s32 ltarget = targetPos.Y * targetSurfaceSize.Width + targetPos.X;
-	s32 lsource = sourcePos.Y * Size.Width + sourcePos.X;
-	size_t dataRowSizeInBytes = sourceSize.Width * sizeof(s16);
+	c8* targetData = (c8*)target->lock();
+	ECOLOR_FORMAT targetFormat = target->getColorFormat();
+	s32 targetPitch = target->getPitch();
+	s32 ltarget = targetPos.Y * targetPitch + targetPos.X * target->getBytesPerPixel();
+	s32 lsource = sourcePos.Y * Pitch + sourcePos.X * BytesPerPixel;
+	const SBlitKernels* kernels = getBlitKernels(targetFormat);
 
-	s16 alphaMask = getAlphaMask();
-	s16* p;
-	s16* end;
-	s16* t;
+	// pixels of an other format are converted into a row first
+	c8* row = 0;
+	if (targetFormat != Format)
+		row = new c8[sourceSize.Width * target->getBytesPerPixel()];
 
 	for (s32 iy=0; iy<sourceSize.Height; ++iy)
 	{
-		p = &Data[lsource];
-		end = p + (dataRowSizeInBytes>>1);
-		t = &targetData[ltarget];
+		const void* p = &((c8*)Data)[lsource];
 
-		while(p != end)
+		if (row)
 		{
-			if (*p & alphaMask)
-				*t = *p;
-
-			++t;
-			++p;
+			convertRow(p, sourceSize.Width, row, target);
+			p = row;
 		}
-		lsource += Size.Width;
-		ltarget += targetSurfaceSize.Width;
+
+		kernels->CopyRowWithAlpha(p, &targetData[ltarget], sourceSize.Width);
+
+		lsource += Pitch;
+		ltarget += targetPitch;
 	}
 
+	delete [] row;
 }
 
 
 
 
 //! copies this surface into another, using the alpha mask, an cliprect and a color to add with
-void CSurface::copyToWithAlpha(ISurface* target, const core::position2d<s32>& pos, const core::rectEx<s32>& sourceRect, s16 color, const core::rectEx<s32>* clipRect)
+void CSurface::copyToWithAlpha(ISurface* target, const core::position2d<s32>& pos, const core::rectEx<s32>& sourceRect, Color color, const core::rectEx<s32>* clipRect)
 {
 	if (sourceRect.UpperLeftCorner.X >= sourceRect.LowerRightCorner.X ||
 		sourceRect.UpperLeftCorner.Y >= sourceRect.LowerRightCorner.Y)
@@ -524,6 +671,10 @@ void CSurface::copyToWithAlpha(ISurface* target, const core::position2d<s32>& po
 	core::dimension2d<s32> sourceSize(sourceRect.getWidth(), sourceRect.getHeight());
 	const core::dimension2d<s32> targetSurfaceSize = target->getDimension();
 
+	// the indices of a paletted target have no alpha to test
+	if (target->getColorFormat() == EHCF_P8)
+		return;
+
 	// clip to cliprect if there is one
 	if (clipRect)
 	{
@@ -600,44 +751,100 @@ void CSurface::copyToWithAlpha(ISurface* target, const core::position2d<s32>& po
 
 	// draw everything
 
-	s16* targetData = target->lock();
-	s32 ltarget = targetPos.Y * targetSurfaceSize.Width + targetPos.X;
-	s32 lsource = sourcePos.Y * Size.Width + sourcePos.X;
-	size_t dataRowSizeInBytes = sourceSize.Width * sizeof(s16);
-
-	s16 alphaMask = getAlphaMask();
-	s16* p;
-	s16* end;
-	s16* t;
+	c8* targetData = (c8*)target->lock();
+	ECOLOR_FORMAT targetFormat = target->getColorFormat();
+	s32 targetPitch = target->getPitch();
+	s32 ltarget = targetPos.Y * targetPitch + targetPos.X * target->getBytesPerPixel();
+	s32 lsource = sourcePos.Y * Pitch + sourcePos.X * BytesPerPixel;
+	const SBlitKernels* kernels = getBlitKernels(targetFormat);
 
-	s32 r = getRed(color);
-	s32 g = getGreen(color);
-	s32 b = getBlue(color);
+	// pixels of an other format are converted into a row first
+	c8* row = 0;
+	if (targetFormat != Format)
+		row = new c8[sourceSize.Width * target->getBytesPerPixel()];
 
 	for (s32 iy=0; iy<sourceSize.Height; ++iy)
 	{
-		p = &Data[lsource];
-		end = p + (dataRowSizeInBytes>>1);
-		t = &targetData[ltarget];
+		const void* p = &((c8*)Data)[lsource];
 
-		while(p != end)
+		if (row)
 		{
-			if (*p & alphaMask)
-				*t = video::RGB16(video::getRed(*p) * (r) >>2, video::getGreen(*p) * (g) >>2, video::getBlue(*p) * (b) >>2);
+			convertRow(p, sourceSize.Width, row, target);
+			p = row;
+		}
+
+		kernels->ModulateRowWithAlpha(p, &targetData[ltarget], sourceSize.Width, color);
+
+		lsource += Pitch;
+		ltarget += targetPitch;
+	}
+
+	delete [] row;
+}
+
+
 
-			++t;
-			++p;
+//! converts a row of pixels into the format of a target surface
+void CSurface::convertRow(const void* source, s32 count, void* target, ISurface* targetSurface)
+{
+	ECOLOR_FORMAT targetFormat = targetSurface->getColorFormat();
+
+	if (Format == EHCF_P8 && targetFormat == EHCF_P8)
+	{
+		memcpy(target, source, count);
+		return;
+	}
+
+	if (Format == EHCF_P8)
+	{
+		// the palette is converted into the target format, the indices
+		// look up their colors in it
+		s32 colors[256];
+		CColorConverter::convertRow(Palette->lock(), Palette->getColorFormat(), 256, colors, targetFormat);
+		Palette->unlock();
+
+		const u8* p = (const u8*)source;
+
+		if (targetFormat == EHCF_A8R8G8B8)
+		{
+			for (s32 i=0; i<count; ++i)
+				((s32*)target)[i] = colors[p[i]];
 		}
-		lsource += Size.Width;
-		ltarget += targetSurfaceSize.Width;
+		else
+		{
+			for (s32 i=0; i<count; ++i)
+				((s16*)target)[i] = ((s16*)colors)[p[i]];
+		}
+
+		return;
 	}
+
+	if (targetFormat == EHCF_P8)
+	{
+		// slow, the nearest palette color is searched for every pixel
+		ISurface* palette = targetSurface->getPalette();
+
+		for (s32 i=0; i<count; ++i)
+		{
+			Color color = Format == EHCF_A8R8G8B8 ? ((const s32*)source)[i] :
+				A1R5G5B5toA8R8G8B8(((const s16*)source)[i]);
+
+			((u8*)target)[i] = (u8)getNearestPaletteIndex(palette, color);
+		}
+
+		return;
+	}
+
+	CColorConverter::convertRow(source, Format, count, target, targetFormat);
 }
 
 
 
 //! draws a line from to
-void CSurface::drawLine(const core::position2d<s32>& from, const core::position2d<s32>& to, s16 color)
+void CSurface::drawLine(const core::position2d<s32>& from, const core::position2d<s32>& to, Color lineColor)
 {
+	s32 color = getColorInFormat(lineColor);
+
 	s32 x = from.X;
     s32 y = from.Y;
 
@@ -693,73 +900,46 @@ void CSurface::drawLine(const core::position2d<s32>& from, const core::position2
 
 
 //! resizes the surface to a new size
-void CSurface::resizeTo(const core::dimension2d<s32>& size)
+void CSurface::resizeTo(const core::dimension2d<s32>& size, ESURFACE_SCALE_FILTER filter)
 {
-	// note: this is very very slow. (i didn't want to write a fast version.
-	// but hopefully, nobody wants to scale surfaces every frame.
-
 	if (!size.Width || !size.Height)
 		return;
 
 	s32 nDataSize = size.Width * size.Height;
-	s32 nDataSizeInBytes = nDataSize * sizeof(s16);
-	s16* nData = new s16[nDataSize];
+	s32 nDataSizeInBytes = nDataSize * BytesPerPixel;
+	c8* nData = new c8[nDataSizeInBytes];
 
-	f32 sourceXStep = (f32)Size.Width / (f32)size.Width;
-	f32 sourceYStep = (f32)Size.Height / (f32)size.Height;
-	f32 sy;
+	CSurfaceScaler::scale(Data, Size, nData, size, Format, filter);
 
-    for (s32 x=0; x<size.Width; ++x)
-	{
-		sy = 0.0f;
-
-		for (s32 y=0; y<size.Height; ++y)
-		{
-			nData[(s32)(y*size.Width + x)] = Data[(s32)(((s32)sy)*Size.Width + x*sourceXStep)];
-			sy+=sourceYStep;
-		}
-	}
-
-	delete [] Data;
+	delete [] (c8*)Data;
     DataSize = nDataSize;
 	DataSizeInBytes = nDataSizeInBytes;
 	Size = size;
+	Pitch = Size.Width * BytesPerPixel;
 	Data = nData;
 }
 
 
 
 //! copies this surface into another, scaling it to fit it.
-void CSurface::copyToScaling(ISurface* target)
+void CSurface::copyToScaling(ISurface* target, ESURFACE_SCALE_FILTER filter)
 {
-	// note: this is very very slow. (i didn't want to write a fast version.
-	// but hopefully, nobody wants to scale surfaces every frame.
-
 	core::dimension2d<s32> size = target->getDimension();
 
-	s32 nDataSize = size.Width * size.Height;
-	s32 nDataSizeInBytes = nDataSize * sizeof(s16);
-
 	if (!size.Width || !size.Height)
 		return;
 
-	s16* nData = target->lock();
-
-	f32 sourceXStep = (f32)Size.Width / (f32)size.Width;
-	f32 sourceYStep = (f32)Size.Height / (f32)size.Height;
-	f32 sy;
-
-    for (s32 x=0; x<size.Width; ++x)
+	if (target->getColorFormat() != Format)
 	{
-		sy = 0.0f;
-
-		for (s32 y=0; y<size.Height; ++y)
-		{
-			nData[(s32)(y*size.Width + x)] = Data[(s32)(((s32)sy)*Size.Width + x*sourceXStep)];
-			sy+=sourceYStep;
-		}
+		// scale in the own format and convert while copying
+		ISurface* scaled = Palette ? createPalettedSurface(Palette, size) : createSurface(Format, size);
+		copyToScaling(scaled, filter);
+		scaled->copyTo(target, 0, 0);
+		scaled->drop();
+		return;
 	}
 
+	CSurfaceScaler::scale(Data, Size, target->lock(), size, Format, filter);
 	target->unlock();
 }
 
@@ -768,7 +948,23 @@ void CSurface::copyToScaling(ISurface* target)
 //! creates a 16 bit surface
 ISurface* createSurface(const core::dimension2d<s32>& size)
 {
-	return new CSurface(size);
+	return new CSurface(EHCF_R5G5B5, size);
+}
+
+
+
+//! creates a surface with a color format
+ISurface* createSurface(ECOLOR_FORMAT format, const core::dimension2d<s32>& size)
+{
+	return new CSurface(format, size);
+}
+
+
+
+//! creates an EHCF_P8 surface
+ISurface* createPalettedSurface(ISurface* palette, const core::dimension2d<s32>& size)
+{
+	return new CSurface(palette, size);
 }
 
 
@@ -13,21 +13,23 @@ namespace video
 {
 
 /*!
-	16 bit surface
-	A1R5G5B5	
+	16 bit A1R5G5B5 or 32 bit A8R8G8B8 surface, or 8 bit EHCF_P8 surface
 */
 class CSurface : public ISurface
 {
 public:
 
 	//! constructor
-	CSurface(const core::dimension2d<s32>& size);
+	CSurface(ECOLOR_FORMAT format, const core::dimension2d<s32>& size);
+
+	//! constructor of an EHCF_P8 surface
+	CSurface(ISurface* palette, const core::dimension2d<s32>& size);
 
 	//! destructor
 	virtual ~CSurface();
 
 	//! lock function
-	virtual s16* lock();
+	virtual void* lock();
 
 	//! unlock function
 	virtual void unlock();
@@ -35,26 +37,38 @@ public:
 	//! returns dimension
 	virtual const core::dimension2d<s32>& getDimension();
 
+	//! returns the color format
+	virtual ECOLOR_FORMAT getColorFormat();
+
+	//! returns the palette of an EHCF_P8 surface
+	virtual ISurface* getPalette();
+
+	//! returns the size of a pixel in bytes
+	virtual s32 getBytesPerPixel();
+
+	//! returns the size of a row in bytes
+	virtual s32 getPitch();
+
 	//! sets a pixel
-	virtual void setPixel(s32 x, s32 y, s16 color);
+	virtual void setPixel(s32 x, s32 y, Color color);
 
 	//! gets a pixel
-	virtual s16 getPixel(s32 x, s32 y);
+	virtual Color getPixel(s32 x, s32 y);
 
 	//! returns masks for pixels
-	virtual s16 getRedMask();
+	virtual s32 getRedMask();
 
 	//! returns masks for pixels
-	virtual s16 getGreenMask();
+	virtual s32 getGreenMask();
 
 	//! returns masks for pixels
-	virtual s16 getBlueMask();
+	virtual s32 getBlueMask();
 
 	//! returns alpha mask
-	virtual s16 getAlphaMask();
+	virtual s32 getAlphaMask();
 
 	//! fills the surface with black or white
-	virtual void fill(s16 color);
+	virtual void fill(Color color);
 
 	//! draws a rectangle
 	virtual void drawRectangle(const core::rectEx<s32>& rect, Color color);
@@ -75,19 +89,22 @@ public:
 	virtual void copyToWithAlpha(ISurface* target, const core::position2d<s32>& pos, const core::rectEx<s32>& sourceRect);
 
 	//! copies this surface into another, using the alpha mask, an cliprect and a color to add with
-	virtual void copyToWithAlpha(ISurface* target, const core::position2d<s32>& pos, const core::rectEx<s32>& sourceRect, s16 color, const core::rectEx<s32>* clipRect = 0);
+	virtual void copyToWithAlpha(ISurface* target, const core::position2d<s32>& pos, const core::rectEx<s32>& sourceRect, Color color, const core::rectEx<s32>* clipRect = 0);
 
 	//! copies this surface into another, scaling it to fit it.
-	virtual void copyToScaling(ISurface* target);
+	virtual void copyToScaling(ISurface* target, ESURFACE_SCALE_FILTER filter = ESSF_NEAREST);
 
 	//! draws a line from to
-	virtual void drawLine(const core::position2d<s32>& from, const core::position2d<s32>& to, s16 color);
+	virtual void drawLine(const core::position2d<s32>& from, const core::position2d<s32>& to, Color color);
 	
 	//! resizes the surface to a new size
-	virtual void resizeTo(const core::dimension2d<s32>& size);
+	virtual void resizeTo(const core::dimension2d<s32>& size, ESURFACE_SCALE_FILTER filter = ESSF_NEAREST);
 
 private:
 
+	//! allocates the pixels
+	void createData();
+
 	//! clips a x coordinate into the screen
 	inline void clipX(s32 &x);
 
@@ -101,11 +118,21 @@ private:
 	//! and does not need to be drawn.
 	inline bool clipRect(const s32 targetWidth, const s32 targetHeight, s32& targetX, s32& targetY, s32& xInSource, s32& yInSource, s32& sourceWidth, s32& soureHeight);
 
-	//! sets a pixel very fast and inline
-	inline void setPixelFast(s32 x, s32 y, s16 color);
+	//! sets a pixel very fast and inline, the color has to be in the format of the surface
+	inline void setPixelFast(s32 x, s32 y, s32 color);
+
+	//! returns a color in the format of the surface
+	inline s32 getColorInFormat(Color color);
+
+	//! converts a row of pixels into the format of a target surface
+	void convertRow(const void* source, s32 count, void* target, ISurface* targetSurface);
 
-	s16* Data;
+	void* Data;
 	core::dimension2d<s32> Size;
+	ECOLOR_FORMAT Format;
+	ISurface* Palette;		// 0 if the format is not EHCF_P8
+	s32 BytesPerPixel;
+	s32 Pitch;
 	s32 DataSize;
 	s32 DataSizeInBytes;
 };
@@ -4,7 +4,7 @@
 
 #include "CSurfaceLoaderBmp.h"
 #include <string.h>
-#include "color.h"
+#include "Color.h"
 #include "CColorConverter.h"
 
 namespace irr
@@ -292,26 +292,26 @@ ISurface* CSurfaceLoaderBmp::loadImage(irr::io::IReadFile* file)
 
 	// create surface
 
-	ISurface* surface = createSurface(core::dimension2d<s32>(header.Width, header.Height));
+	ISurface* surface = createSurface(EHCF_A8R8G8B8, core::dimension2d<s32>(header.Width, header.Height));
 
 	switch(header.BPP)
 	{
 	case 1:
-		CColorConverter::convert1BitTo16BitFlipMirror(BmpData, surface->lock(), header.Width, header.Height, pitch);
+		CColorConverter::convert1BitTo32BitFlipMirror(BmpData, (s32*)surface->lock(), header.Width, header.Height, pitch);
 		surface->unlock();
 		break;
 	case 4:
-		CColorConverter::convert4BitTo16BitFlipMirror(BmpData, surface->lock(), header.Width, header.Height, pitch, PaletteData);
+		CColorConverter::convert4BitTo32BitFlipMirror(BmpData, (s32*)surface->lock(), header.Width, header.Height, pitch, PaletteData);
 		surface->unlock();
 		break;
 	case 8:
-		CColorConverter::convert8BitTo16BitFlipMirror(BmpData, surface->lock(), header.Width, header.Height, pitch, PaletteData);
+		CColorConverter::convert8BitTo32BitFlipMirror(BmpData, (s32*)surface->lock(), header.Width, header.Height, pitch, PaletteData);
 		surface->unlock();
 		break;
 	case 16:
 		break;
 	case 24:
-		CColorConverter::convert24BitTo16BitFlipMirror(BmpData, surface->lock(), header.Width, header.Height, pitch);
+		CColorConverter::convert24BitTo32BitFlipMirror(BmpData, (s32*)surface->lock(), header.Width, header.Height, pitch);
 		surface->unlock();
 		break;
 	case 32:
@@ -175,11 +175,11 @@ ISurface* CSurfaceLoaderJPG::loadImage(irr::io::IReadFile* file)
 
 	// convert image
 	
-	video::ISurface* surface = video::createSurface(core::dimension2d<s32>(width, height));
+	video::ISurface* surface = video::createSurface(video::EHCF_A8R8G8B8, core::dimension2d<s32>(width, height));
 
 	//CColorConverter::convert24BitTo16BitColorShuffle((c8*)((void*)output), surface->lock(), width, height, 0);
-	CColorConverter::convert24BitTo16BitFlipColorShuffle((c8*)((void*)output),
-		surface->lock(), width, height, 0);
+	CColorConverter::convert24BitTo32BitFlipColorShuffle((c8*)((void*)output),
+		(s32*)surface->lock(), width, height, 0);
 	
 	delete [] input;
 	delete [] output;
@@ -9,10 +9,18 @@
 
 #include <stdio.h>
 
+// on windows the engine links the jpeglib shipped in the jpeglib directory,
+// on other platforms the jpeglib of the system.
+#ifdef _WIN32
 extern "C" {
-#include "jpeglib/JCONFIG.h"
-#include "jpeglib/JPEGLIB.h"
+#include "jpeglib/JCONFIG.H"
+#include "jpeglib/JPEGLIB.H"
 }
+#else
+extern "C" {
+#include <jpeglib.h>
+}
+#endif
 
 
 namespace irr
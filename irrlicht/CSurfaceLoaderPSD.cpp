@@ -1,4 +1,4 @@
-#include "CSurfaceLoaderPSD.H"
+#include "CSurfaceLoaderPSD.h"
 #include <string.h>
 #include "os.h"
 #include "CColorConverter.h"
@@ -143,9 +143,9 @@ ISurface* CSurfaceLoaderPSD::loadImage(irr::io::IReadFile* file)
 	if (res)
 	{
 		// create surface
-		surface = video::createSurface(core::dimension2d<s32>(header.width, header.height));
-		CColorConverter::convert32BitTo16BitColorShuffle((c8*)((void*)imageData),
-			surface->lock(), header.width, header.height, 0);
+		surface = video::createSurface(video::EHCF_A8R8G8B8, core::dimension2d<s32>(header.width, header.height));
+		CColorConverter::convert32BitTo32BitColorShuffle((c8*)((void*)imageData),
+			(s32*)surface->lock(), header.width, header.height, 0);
 	}
 
 	delete [] imageData;
@@ -1,4 +1,4 @@
-#include "CSurfaceLoaderTGA.H"
+#include "CSurfaceLoaderTGA.h"
 #include <string.h>
 #include "os.h"
 #include "CColorConverter.h"
@@ -78,7 +78,9 @@ ISurface* CSurfaceLoaderTGA::loadImage(irr::io::IReadFile* file)
 
 	file->read(data, imageSize);
 
+	// 16 bit images keep their format, all others are loaded as 32 bit.
 	video::ISurface* surface = video::createSurface(
+		bytesPerPixel == 2 ? video::EHCF_R5G5B5 : video::EHCF_A8R8G8B8,
 		core::dimension2d<s32>(header.ImageWidth, header.ImageHeight));
 
 	switch(bytesPerPixel)
@@ -100,15 +102,15 @@ ISurface* CSurfaceLoaderTGA::loadImage(irr::io::IReadFile* file)
 		break;
 	case 3:
 		{
-			CColorConverter::convert24BitTo16BitFlipMirror(
-				data, surface->lock(), header.ImageWidth, header.ImageHeight, 0);
+			CColorConverter::convert24BitTo32BitFlipMirror(
+				data, (s32*)surface->lock(), header.ImageWidth, header.ImageHeight, 0);
 			surface->unlock();
 		}
 		break;
 	case 4:
 		{
-			CColorConverter::convert32BitTo16BitFlipMirrorColorShuffle(
-				data, surface->lock(), header.ImageWidth, header.ImageHeight, 0);
+			CColorConverter::convert32BitTo32BitFlipMirrorColorShuffle(
+				data, (s32*)surface->lock(), header.ImageWidth, header.ImageHeight, 0);
 			surface->unlock();
 		}		
 		break;
@@ -0,0 +1,754 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "CSurfaceScaler.h"
+#include "Color.h"
+#include <memory.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define _IRR_SCALE_KERNELS_X86_
+#endif
+
+#ifdef _IRR_SCALE_KERNELS_X86_
+
+#include <immintrin.h>
+
+// see CTRSpanKernels.cpp
+#ifdef __GNUC__
+#define _IRR_TARGET_SSE2_ __attribute__((target("sse2")))
+#define _IRR_TARGET_AVX2_ __attribute__((target("avx2")))
+#else
+#define _IRR_TARGET_SSE2_
+#define _IRR_TARGET_AVX2_
+#endif
+
+#endif
+
+namespace irr
+{
+namespace video
+{
+
+//! images with at least this amount of target pixels are scaled by all
+//! threads of the pool
+const s32 PARALLEL_SCALE_PIXELS = 256*256;
+
+//! amount of rows scaled by one part of a CScaleTask
+const s32 SCALE_TASK_PART_ROWS = 16;
+
+
+// The bilinear weights have 7 bits, so a pixel filtered along a row still
+// fits into a signed 16 bit channel: 255 * 128 = 32640. Mixing two rows of
+// them gives 255 * 128 * 128 at most, which is rounded and shifted back by
+// 14 bits.
+
+
+//! copies the pixels at offsets of a row
+static void scaleRowNearest(const s32* source, const s32* offsets, s32* target, s32 count)
+{
+	for (s32 i=0; i<count; ++i)
+		target[i] = source[offsets[i]];
+}
+
+
+
+//! mixes two pixels of a row for every target pixel
+static void filterRowBilinear(const s32* source, const s32* offsets, const s16* weights,
+	s16* target, s32 count)
+{
+	for (s32 i=0; i<count; ++i)
+	{
+		s32 a = source[offsets[2*i]];
+		s32 b = source[offsets[2*i+1]];
+		s32 wa = weights[2*i];
+		s32 wb = weights[2*i+1];
+
+		for (s32 c=0; c<4; ++c)
+			target[4*i+c] = (s16)(((a >> (c*8)) & 0xFF) * wa + ((b >> (c*8)) & 0xFF) * wb);
+	}
+}
+
+
+
+//! mixes two filtered rows into a row of pixels
+static void blendRowsBilinear(const s16* row0, const s16* row1, s32 weight, s32* target, s32 count)
+{
+	s32 w0 = 128 - weight;
+
+	for (s32 i=0; i<count; ++i)
+	{
+		s32 pixel = 0;
+
+		for (s32 c=0; c<4; ++c)
+			pixel |= ((row0[4*i+c] * w0 + row1[4*i+c] * weight + 8192) >> 14) << (c*8);
+
+		target[i] = pixel;
+	}
+}
+
+
+
+//! adds the channels of a row to the sums
+static void addRowBox(const s32* source, u32* sums, s32 count)
+{
+	for (s32 i=0; i<count; ++i)
+		for (s32 c=0; c<4; ++c)
+			sums[4*i+c] += (source[i] >> (c*8)) & 0xFF;
+}
+
+
+
+//! returns the average of a sum, multiplied with the reciprocal of its count
+static inline u32 getBoxAverage(u32 sum, u32 reciprocal)
+{
+	u32 average = (u32)(((s64)sum * reciprocal + 0x80000000) >> 32);
+	return average > 255 ? 255 : average;
+}
+
+
+
+//! averages the sums of the pixels covered by every target pixel
+static void averageRowBox(const u32* sums, const s32* offsets, const u32* reciprocals,
+	s32* target, s32 count)
+{
+	for (s32 i=0; i<count; ++i)
+	{
+		u32 s[4] = { 0, 0, 0, 0 };
+
+		for (s32 x=offsets[2*i]; x<offsets[2*i+1]; ++x)
+			for (s32 c=0; c<4; ++c)
+				s[c] += sums[4*x+c];
+
+		s32 pixel = 0;
+
+		for (s32 c=0; c<4; ++c)
+			pixel |= getBoxAverage(s[c], reciprocals[i]) << (c*8);
+
+		target[i] = pixel;
+	}
+}
+
+
+
+#ifdef _IRR_SCALE_KERNELS_X86_
+
+// SSE2 kernels. A pixel is unpacked into 4 channels of 16 or 32 bits, so
+// one register holds one or two pixels.
+
+
+//! mixes two pixels of a row for every target pixel, two target pixels
+//! per iteration. The bytes of both pixels are interleaved, so pmaddwd
+//! multiplies and adds them in one instruction.
+static _IRR_TARGET_SSE2_ void filterRowBilinearSSE2(const s32* source, const s32* offsets,
+	const s16* weights, s16* target, s32 count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	s32 i = 0;
+
+	for (; i+2 <= count; i += 2)
+	{
+		__m128i p0 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(source[offsets[2*i]]),
+			_mm_cvtsi32_si128(source[offsets[2*i+1]]));
+		__m128i p1 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(source[offsets[2*i+2]]),
+			_mm_cvtsi32_si128(source[offsets[2*i+3]]));
+
+		__m128i w0 = _mm_set1_epi32(((const s32*)weights)[i]);
+		__m128i w1 = _mm_set1_epi32(((const s32*)weights)[i+1]);
+
+		p0 = _mm_madd_epi16(_mm_unpacklo_epi8(p0, zero), w0);
+		p1 = _mm_madd_epi16(_mm_unpacklo_epi8(p1, zero), w1);
+
+		_mm_storeu_si128((__m128i*)(target + 4*i), _mm_packs_epi32(p0, p1));
+	}
+
+	filterRowBilinear(source, offsets + 2*i, weights + 2*i, target + 4*i, count - i);
+}
+
+
+
+//! mixes two filtered rows into a row of pixels, 4 pixels per iteration
+static _IRR_TARGET_SSE2_ void blendRowsBilinearSSE2(const s16* row0, const s16* row1, s32 weight,
+	s32* target, s32 count)
+{
+	const __m128i w = _mm_set1_epi32((weight << 16) | (128 - weight));
+	const __m128i round = _mm_set1_epi32(8192);
+	s32 i = 0;
+
+	for (; i+4 <= count; i += 4)
+	{
+		__m128i p[2];
+
+		for (s32 j=0; j<2; ++j)
+		{
+			__m128i a = _mm_loadu_si128((const __m128i*)(row0 + 4*i + 8*j));
+			__m128i b = _mm_loadu_si128((const __m128i*)(row1 + 4*i + 8*j));
+
+			__m128i lo = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a, b), w), round), 14);
+			__m128i hi = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a, b), w), round), 14);
+
+			p[j] = _mm_packs_epi32(lo, hi);
+		}
+
+		_mm_storeu_si128((__m128i*)(target + i), _mm_packus_epi16(p[0], p[1]));
+	}
+
+	blendRowsBilinear(row0 + 4*i, row1 + 4*i, weight, target + i, count - i);
+}
+
+
+
+//! adds the channels of a row to the sums, 4 pixels per iteration
+static _IRR_TARGET_SSE2_ void addRowBoxSSE2(const s32* source, u32* sums, s32 count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	s32 i = 0;
+
+	for (; i+4 <= count; i += 4)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i*)(source + i));
+		__m128i lo = _mm_unpacklo_epi8(p, zero);
+		__m128i hi = _mm_unpackhi_epi8(p, zero);
+		__m128i c[4] = { _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+			_mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero) };
+
+		for (s32 j=0; j<4; ++j)
+		{
+			__m128i* s = (__m128i*)(sums + 4*(i+j));
+			_mm_storeu_si128(s, _mm_add_epi32(_mm_loadu_si128(s), c[j]));
+		}
+	}
+
+	addRowBox(source + i, sums + 4*i, count - i);
+}
+
+
+
+//! averages the sums of the pixels covered by every target pixel. The 4
+//! sums of a pixel are added in one register, and multiplied with the
+//! reciprocal by pmuludq, two of them at once.
+static _IRR_TARGET_SSE2_ void averageRowBoxSSE2(const u32* sums, const s32* offsets,
+	const u32* reciprocals, s32* target, s32 count)
+{
+	const __m128i round = _mm_set_epi32(0, 0x80000000, 0, 0x80000000);
+	const __m128i high = _mm_set_epi32(-1, 0, -1, 0);
+
+	for (s32 i=0; i<count; ++i)
+	{
+		__m128i s = _mm_setzero_si128();
+
+		for (s32 x=offsets[2*i]; x<offsets[2*i+1]; ++x)
+			s = _mm_add_epi32(s, _mm_loadu_si128((const __m128i*)(sums + 4*x)));
+
+		__m128i r = _mm_set1_epi32(reciprocals[i]);
+		__m128i even = _mm_add_epi64(_mm_mul_epu32(s, r), round);
+		__m128i odd = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(s, 32), r), round);
+
+		s = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, high));
+		s = _mm_packs_epi32(s, s);
+
+		target[i] = _mm_cvtsi128_si32(_mm_packus_epi16(s, s));
+	}
+}
+
+
+
+// AVX2 kernels. The pixels of a row are gathered at their offsets, the
+// SSE2 versions of the kernels are used where there is nothing to gather.
+// The rest of a row is scaled by the SSE2 or scalar kernels, which are not
+// VEX encoded, so the upper halves of the ymm registers are cleared before.
+
+
+//! copies the pixels at offsets of a row, 8 pixels per iteration
+static _IRR_TARGET_AVX2_ void scaleRowNearestAVX2(const s32* source, const s32* offsets,
+	s32* target, s32 count)
+{
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+	{
+		__m256i o = _mm256_loadu_si256((const __m256i*)(offsets + i));
+		_mm256_storeu_si256((__m256i*)(target + i), _mm256_i32gather_epi32((const int*)source, o, 4));
+	}
+
+	_mm256_zeroupper();
+	scaleRowNearest(source, offsets + i, target + i, count - i);
+}
+
+
+
+//! mixes two pixels of a row for every target pixel, 4 target pixels per
+//! iteration. Both pixels of every target pixel are gathered next to each
+//! other, and their bytes are interleaved by pshufb.
+static _IRR_TARGET_AVX2_ void filterRowBilinearAVX2(const s32* source, const s32* offsets,
+	const s16* weights, s16* target, s32 count)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i interleave = _mm256_setr_epi8(
+		0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15,
+		0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15);
+	const __m256i even = _mm256_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2);
+	const __m256i odd = _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3);
+	s32 i = 0;
+
+	for (; i+4 <= count; i += 4)
+	{
+		__m256i o = _mm256_loadu_si256((const __m256i*)(offsets + 2*i));
+		__m256i p = _mm256_shuffle_epi8(_mm256_i32gather_epi32((const int*)source, o, 4), interleave);
+		__m256i w = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(weights + 2*i)));
+
+		// pixels 0 and 2, and 1 and 3, are in the halves of the registers
+		__m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(p, zero), _mm256_permutevar8x32_epi32(w, even));
+		__m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(p, zero), _mm256_permutevar8x32_epi32(w, odd));
+
+		_mm256_storeu_si256((__m256i*)(target + 4*i), _mm256_packs_epi32(lo, hi));
+	}
+
+	_mm256_zeroupper();
+	filterRowBilinearSSE2(source, offsets + 2*i, weights + 2*i, target + 4*i, count - i);
+}
+
+
+
+//! mixes two filtered rows into a row of pixels, 8 pixels per iteration
+static _IRR_TARGET_AVX2_ void blendRowsBilinearAVX2(const s16* row0, const s16* row1, s32 weight,
+	s32* target, s32 count)
+{
+	const __m256i w = _mm256_set1_epi32((weight << 16) | (128 - weight));
+	const __m256i round = _mm256_set1_epi32(8192);
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+	{
+		__m256i p[2];
+
+		for (s32 j=0; j<2; ++j)
+		{
+			__m256i a = _mm256_loadu_si256((const __m256i*)(row0 + 4*i + 16*j));
+			__m256i b = _mm256_loadu_si256((const __m256i*)(row1 + 4*i + 16*j));
+
+			__m256i lo = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), w), round), 14);
+			__m256i hi = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), w), round), 14);
+
+			p[j] = _mm256_packs_epi32(lo, hi);
+		}
+
+		// the pack works in the halves, the pixels are 0 1 4 5 2 3 6 7
+		__m256i pixels = _mm256_packus_epi16(p[0], p[1]);
+		_mm256_storeu_si256((__m256i*)(target + i), _mm256_permute4x64_epi64(pixels, 0xD8));
+	}
+
+	_mm256_zeroupper();
+	blendRowsBilinearSSE2(row0 + 4*i, row1 + 4*i, weight, target + i, count - i);
+}
+
+
+
+//! adds the channels of a row to the sums, 8 pixels per iteration
+static _IRR_TARGET_AVX2_ void addRowBoxAVX2(const s32* source, u32* sums, s32 count)
+{
+	s32 i = 0;
+
+	for (; i+8 <= count; i += 8)
+	{
+		for (s32 j=0; j<8; j += 2)
+		{
+			__m256i c = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(source + i + j)));
+			__m256i* s = (__m256i*)(sums + 4*(i+j));
+			_mm256_storeu_si256(s, _mm256_add_epi32(_mm256_loadu_si256(s), c));
+		}
+	}
+
+	_mm256_zeroupper();
+	addRowBoxSSE2(source + i, sums + 4*i, count - i);
+}
+
+#endif // _IRR_SCALE_KERNELS_X86_
+
+
+
+//! the kernels of every instruction set
+static const SScaleKernels ScaleKernels[ESKS_COUNT] =
+{
+	{ "scalar", scaleRowNearest, filterRowBilinear, blendRowsBilinear, addRowBox, averageRowBox },
+#ifdef _IRR_SCALE_KERNELS_X86_
+	{ "SSE2", scaleRowNearest, filterRowBilinearSSE2, blendRowsBilinearSSE2, addRowBoxSSE2, averageRowBoxSSE2 },
+	{ "AVX2", scaleRowNearestAVX2, filterRowBilinearAVX2, blendRowsBilinearAVX2, addRowBoxAVX2, averageRowBoxSSE2 }
+#endif
+};
+
+
+
+//! returns the scale kernels of an instruction set
+const SScaleKernels* getScaleKernels(ESpanKernelSet set)
+{
+	if (!isKernelSetSupported(set))
+		return 0;
+
+	return &ScaleKernels[set];
+}
+
+
+
+//! returns the fastest scale kernels the processor supports
+const SScaleKernels* getScaleKernels()
+{
+	static const SScaleKernels* best = 0;
+
+	for (s32 i=ESKS_COUNT-1; !best && i>=0; --i)
+		best = getScaleKernels((ESpanKernelSet)i);
+
+	return best;
+}
+
+
+
+//! calculates the source pixel of every target pixel along an axis, the
+//! one its left or upper border is in
+static void getNearestSteps(s32 sourceSize, s32 targetSize, s32* offsets)
+{
+	for (s32 i=0; i<targetSize; ++i)
+		offsets[i] = (s32)(((s64)i * sourceSize) / targetSize);
+}
+
+
+
+//! calculates the source pixels covered by every target pixel along an
+//! axis, from offsets[2*i] to offsets[2*i+1]. Every target pixel covers
+//! at least one source pixel.
+static void getBoxSteps(s32 sourceSize, s32 targetSize, s32* offsets)
+{
+	for (s32 i=0; i<targetSize; ++i)
+	{
+		offsets[2*i] = (s32)(((s64)i * sourceSize) / targetSize);
+		offsets[2*i+1] = (s32)(((s64)(i+1) * sourceSize) / targetSize);
+
+		if (offsets[2*i+1] <= offsets[2*i])
+			offsets[2*i+1] = offsets[2*i] + 1;
+	}
+}
+
+
+
+//! calculates the two source pixels nearest to the center of every target
+//! pixel along an axis, and their weights. The pixels at the border are
+//! repeated.
+static void getBilinearSteps(s32 sourceSize, s32 targetSize, s32* offsets, s16* weights)
+{
+	for (s32 i=0; i<targetSize; ++i)
+	{
+		// position of the center in 1/128 source pixels
+		s64 pos = ((s64)(2*i+1) * sourceSize * 64) / targetSize - 64;
+		if (pos < 0)
+			pos = 0;
+
+		s32 p = (s32)(pos >> 7);
+		s32 f = (s32)(pos & 127);
+
+		if (p >= sourceSize-1)
+		{
+			p = sourceSize-1;
+			f = 0;
+		}
+
+		offsets[2*i] = p;
+		offsets[2*i+1] = f ? p+1 : p;
+		weights[2*i] = (s16)(128 - f);
+		weights[2*i+1] = (s16)f;
+	}
+}
+
+
+
+//! copies the pixels at offsets of a row
+template <class T>
+static void scaleRowNearest(const T* source, const s32* offsets, T* target, s32 count)
+{
+	for (s32 i=0; i<count; ++i)
+		target[i] = source[offsets[i]];
+}
+
+
+
+//! Scales the rows of an image. The rows are independent of each other,
+//! so parts of them can be scaled by several threads.
+class CScaleTask : public IThreadTask
+{
+public:
+
+	CScaleTask(const void* source, const core::dimension2d<s32>& sourceSize,
+		void* target, const core::dimension2d<s32>& targetSize, ECOLOR_FORMAT format,
+		ESURFACE_SCALE_FILTER filter)
+		: Source((const c8*)source), SourceSize(sourceSize), Target((c8*)target),
+		TargetSize(targetSize), Format(format), Filter(filter),
+		Kernels(getScaleKernels()), XWeights(0), YWeights(0)
+	{
+		// the indices of a palette can not be mixed
+		if (Format == EHCF_P8)
+			Filter = ESSF_NEAREST;
+
+		BytesPerPixel = Format == EHCF_A8R8G8B8 ? 4 : Format == EHCF_P8 ? 1 : 2;
+
+		if (Filter == ESSF_NEAREST)
+		{
+			XOffsets = new s32[TargetSize.Width];
+			YOffsets = new s32[TargetSize.Height];
+			getNearestSteps(SourceSize.Width, TargetSize.Width, XOffsets);
+			getNearestSteps(SourceSize.Height, TargetSize.Height, YOffsets);
+		}
+		else
+		{
+			XOffsets = new s32[TargetSize.Width*2];
+			YOffsets = new s32[TargetSize.Height*2];
+
+			if (Filter == ESSF_BOX)
+			{
+				getBoxSteps(SourceSize.Width, TargetSize.Width, XOffsets);
+				getBoxSteps(SourceSize.Height, TargetSize.Height, YOffsets);
+			}
+			else
+			{
+				XWeights = new s16[TargetSize.Width*2];
+				YWeights = new s16[TargetSize.Height*2];
+				getBilinearSteps(SourceSize.Width, TargetSize.Width, XOffsets, XWeights);
+				getBilinearSteps(SourceSize.Height, TargetSize.Height, YOffsets, YWeights);
+			}
+		}
+	}
+
+	~CScaleTask()
+	{
+		delete [] XOffsets;
+		delete [] YOffsets;
+		delete [] XWeights;
+		delete [] YWeights;
+	}
+
+	virtual void runTask(s32 part, s32 thread)
+	{
+		s32 first = part * SCALE_TASK_PART_ROWS;
+		s32 last = first + SCALE_TASK_PART_ROWS;
+
+		scaleRows(first, last < TargetSize.Height ? last : TargetSize.Height);
+	}
+
+	//! scales the target rows from first to last-1
+	void scaleRows(s32 first, s32 last)
+	{
+		switch(Filter)
+		{
+		case ESSF_BOX:
+			scaleRowsBox(first, last);
+			break;
+		case ESSF_BILINEAR:
+			scaleRowsBilinear(first, last);
+			break;
+		default:
+			scaleRowsNearest(first, last);
+			break;
+		}
+	}
+
+private:
+
+	//! returns a row of the source as A8R8G8B8 pixels, R5G5B5 rows are
+	//! converted into the buffer. The alpha bit becomes 0 or 255, so it
+	//! is mixed like the other channels.
+	const s32* getSourceRow(s32 y, s32* buffer)
+	{
+		const void* row = Source + y * SourceSize.Width * BytesPerPixel;
+
+		if (Format == EHCF_A8R8G8B8)
+			return (const s32*)row;
+
+		const s16* p = (const s16*)row;
+
+		// without branches and members, so the compiler can vectorize it
+		const s32 count = SourceSize.Width;
+
+		for (s32 i=0; i<count; ++i)
+		{
+			s32 r = getRed(p[i]), g = getGreen(p[i]), b = getBlue(p[i]);
+
+			buffer[i] = (((s32)p[i] >> 15) << 24) |
+				(((r << 3) | (r >> 2)) << 16) | (((g << 3) | (g >> 2)) << 8) | ((b << 3) | (b >> 2));
+		}
+
+		return buffer;
+	}
+
+	//! returns where the A8R8G8B8 pixels of a target row are written to,
+	//! before they are stored with setTargetRow()
+	s32* getTargetRow(s32 y, s32* buffer)
+	{
+		if (Format == EHCF_A8R8G8B8)
+			return (s32*)(Target + y * TargetSize.Width * 4);
+
+		return buffer;
+	}
+
+	//! stores a target row, converts it if the target is R5G5B5
+	void setTargetRow(s32 y, const s32* row)
+	{
+		if (Format == EHCF_A8R8G8B8)
+			return;
+
+		s16* t = (s16*)(Target + y * TargetSize.Width * 2);
+		const s32 count = TargetSize.Width;
+
+		for (s32 i=0; i<count; ++i)
+			t[i] = A8R8G8B8toA1R5G5B5(row[i]);
+	}
+
+	void scaleRowsNearest(s32 first, s32 last)
+	{
+		const s32 pitch = TargetSize.Width * BytesPerPixel;
+
+		for (s32 y=first; y<last; ++y)
+		{
+			c8* t = Target + y * pitch;
+
+			// rows of a larger image repeat the row above them
+			if (y > first && YOffsets[y] == YOffsets[y-1])
+			{
+				memcpy(t, t - pitch, pitch);
+				continue;
+			}
+
+			const c8* s = Source + YOffsets[y] * SourceSize.Width * BytesPerPixel;
+
+			if (Format == EHCF_A8R8G8B8)
+				Kernels->ScaleRowNearest((const s32*)s, XOffsets, (s32*)t, TargetSize.Width);
+			else
+			if (Format == EHCF_P8)
+				scaleRowNearest((const u8*)s, XOffsets, (u8*)t, TargetSize.Width);
+			else
+				scaleRowNearest((const s16*)s, XOffsets, (s16*)t, TargetSize.Width);
+		}
+	}
+
+	void scaleRowsBilinear(s32 first, s32 last)
+	{
+		s32* source = new s32[SourceSize.Width];
+		s32* target = new s32[TargetSize.Width];
+
+		// the filtered source rows used by the last target row
+		s16* rows[2] = { new s16[TargetSize.Width*4], new s16[TargetSize.Width*4] };
+		s32 rowY[2] = { -1, -1 };
+
+		for (s32 y=first; y<last; ++y)
+		{
+			s32 y0 = YOffsets[2*y];
+			s32 y1 = YOffsets[2*y+1];
+
+			const s16* row0 = getFilteredRow(y0, y1, rows, rowY, source);
+			const s16* row1 = getFilteredRow(y1, y0, rows, rowY, source);
+
+			s32* t = getTargetRow(y, target);
+			Kernels->BlendRowsBilinear(row0, row1, YWeights[2*y+1], t, TargetSize.Width);
+			setTargetRow(y, t);
+		}
+
+		delete [] rows[0];
+		delete [] rows[1];
+		delete [] source;
+		delete [] target;
+	}
+
+	//! returns a source row filtered along the row. Keeps the row other
+	//! if it is one of the rows filtered before.
+	const s16* getFilteredRow(s32 y, s32 other, s16** rows, s32* rowY, s32* buffer)
+	{
+		if (rowY[0] == y)
+			return rows[0];
+
+		if (rowY[1] == y)
+			return rows[1];
+
+		s32 i = rowY[0] == other ? 1 : 0;
+
+		Kernels->FilterRowBilinear(getSourceRow(y, buffer), XOffsets, XWeights,
+			rows[i], TargetSize.Width);
+
+		rowY[i] = y;
+		return rows[i];
+	}
+
+	void scaleRowsBox(s32 first, s32 last)
+	{
+		s32* source = new s32[SourceSize.Width];
+		s32* target = new s32[TargetSize.Width];
+		u32* sums = new u32[SourceSize.Width*4];
+		u32* reciprocals = new u32[TargetSize.Width];
+		s32 reciprocalRows = 0;
+
+		for (s32 y=first; y<last; ++y)
+		{
+			s32 y0 = YOffsets[2*y];
+			s32 y1 = YOffsets[2*y+1];
+
+			memset(sums, 0, SourceSize.Width*4*sizeof(u32));
+
+			for (s32 sy=y0; sy<y1; ++sy)
+				Kernels->AddRowBox(getSourceRow(sy, source), sums, SourceSize.Width);
+
+			// 2^32 / the amount of pixels covered, rounded up
+			if (y1 - y0 != reciprocalRows)
+			{
+				reciprocalRows = y1 - y0;
+
+				for (s32 x=0; x<TargetSize.Width; ++x)
+				{
+					s64 count = (s64)(XOffsets[2*x+1] - XOffsets[2*x]) * reciprocalRows;
+					s64 r = (((s64)1 << 32) + count - 1) / count;
+					reciprocals[x] = r > 0xFFFFFFFF ? 0xFFFFFFFF : (u32)r;
+				}
+			}
+
+			s32* t = getTargetRow(y, target);
+			Kernels->AverageRowBox(sums, XOffsets, reciprocals, t, TargetSize.Width);
+			setTargetRow(y, t);
+		}
+
+		delete [] source;
+		delete [] target;
+		delete [] sums;
+		delete [] reciprocals;
+	}
+
+	const c8* Source;
+	core::dimension2d<s32> SourceSize;
+	c8* Target;
+	core::dimension2d<s32> TargetSize;
+	ECOLOR_FORMAT Format;
+	ESURFACE_SCALE_FILTER Filter;
+	s32 BytesPerPixel;
+	const SScaleKernels* Kernels;
+
+	s32* XOffsets;
+	s32* YOffsets;
+	s16* XWeights;
+	s16* YWeights;
+};
+
+
+
+//! scales pixels of a color format into a buffer of another size
+void CSurfaceScaler::scale(const void* source, const core::dimension2d<s32>& sourceSize,
+	void* target, const core::dimension2d<s32>& targetSize, ECOLOR_FORMAT format,
+	ESURFACE_SCALE_FILTER filter, CThreadPool* threads)
+{
+	if (sourceSize.Width <= 0 || sourceSize.Height <= 0 ||
+		targetSize.Width <= 0 || targetSize.Height <= 0)
+		return;
+
+	CScaleTask task(source, sourceSize, target, targetSize, format, filter);
+
+	if (threads && targetSize.Width * targetSize.Height >= PARALLEL_SCALE_PIXELS)
+		threads->run(&task, (targetSize.Height + SCALE_TASK_PART_ROWS - 1) / SCALE_TASK_PART_ROWS);
+	else
+		task.scaleRows(0, targetSize.Height);
+}
+
+} // end namespace video
+} // end namespace irr
\ No newline at end of file
@@ -0,0 +1,78 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __C_SURFACE_SCALER_H_INCLUDED__
+#define __C_SURFACE_SCALER_H_INCLUDED__
+
+#include "ISurface.h"
+#include "CTRSpanKernels.h"
+#include "CThreadPool.h"
+
+namespace irr
+{
+namespace video
+{
+	//! copies the A8R8G8B8 pixels at offsets of a source row into a row
+	typedef void (*TScaleRowNearest)(const s32* source, const s32* offsets,
+		s32* target, s32 count);
+
+	//! mixes two A8R8G8B8 pixels of a row for every target pixel, at the
+	//! offsets offsets[2*i] and offsets[2*i+1] with the weights
+	//! weights[2*i] and weights[2*i+1], which add up to 128. The target
+	//! gets 4 s16 channels per pixel, in the order of the bytes of a pixel.
+	typedef void (*TFilterRowBilinear)(const s32* source, const s32* offsets,
+		const s16* weights, s16* target, s32 count);
+
+	//! mixes two rows filtered by TFilterRowBilinear with the weights
+	//! 128-weight and weight into a row of A8R8G8B8 pixels
+	typedef void (*TBlendRowsBilinear)(const s16* row0, const s16* row1, s32 weight,
+		s32* target, s32 count);
+
+	//! adds the channels of a row of A8R8G8B8 pixels to 4 sums per pixel
+	typedef void (*TAddRowBox)(const s32* source, u32* sums, s32 count);
+
+	//! adds the sums of the pixels from offsets[2*i] to offsets[2*i+1] for
+	//! every target pixel, and multiplies them with reciprocals[i] / 2^32
+	//! into an A8R8G8B8 pixel
+	typedef void (*TAverageRowBox)(const u32* sums, const s32* offsets,
+		const u32* reciprocals, s32* target, s32 count);
+
+	//! row functions of the surface scaler for one instruction set. All sets
+	//! calculate exactly the same pixels.
+	struct SScaleKernels
+	{
+		const c8* Name;
+		TScaleRowNearest ScaleRowNearest;
+		TFilterRowBilinear FilterRowBilinear;
+		TBlendRowsBilinear BlendRowsBilinear;
+		TAddRowBox AddRowBox;
+		TAverageRowBox AverageRowBox;
+	};
+
+	//! returns the fastest scale kernels the processor supports
+	const SScaleKernels* getScaleKernels();
+
+	//! returns the scale kernels of an instruction set, or 0 if the
+	//! processor or the compiler does not support it.
+	const SScaleKernels* getScaleKernels(ESpanKernelSet set);
+
+	//! Scales pixels row by row, with fixed point positions precalculated
+	//! for every column and row. The filters work on A8R8G8B8 pixels,
+	//! R5G5B5 rows are converted while they are scaled.
+	class CSurfaceScaler
+	{
+	public:
+
+		//! scales pixels of a color format into a buffer of another size
+		//! \param threads: Large images are scaled by the threads of the
+		//! pool if there is one, some rows each.
+		static void scale(const void* source, const core::dimension2d<s32>& sourceSize,
+			void* target, const core::dimension2d<s32>& targetSize, ECOLOR_FORMAT format,
+			ESURFACE_SCALE_FILTER filter, CThreadPool* threads = 0);
+	};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
\ No newline at end of file
@@ -1,5 +1,5 @@
 #include "CTRTextureGouraud.h"
-#include "color.h"
+#include "Color.h"
 
 namespace irr
 {
@@ -23,26 +23,33 @@ public:
 	{
 		const S2DVertex *v1, *v2, *v3;
 
-		s16 color;
 		f32 tmpDiv; // temporary division factor
 		f32 longest; // saves the longest span
 		s32 height; // saves height of triangle
-		s16* targetSurface; // target pointer where to plot pixels
+		c8* targetSurface; // target pointer where to plot pixels
 		s32 spanEnd; // saves end of spans
 		f32 leftdeltaxf; // amount of pixels to increase on left side of triangle
 		f32 rightdeltaxf; // amount of pixels to increase on right side of triangle
 		s32 leftx, rightx; // position where we are 
-		f32 leftxf, rightxf; // same as above, but as f32 values
+		f32 leftxf, rightxf; // x of the edges at the rows they start
+		s32 leftEdgeY, rightEdgeY; // rows the edges start at
 		s32 span; // current span
 		core::rectEx<s32> TriangleRect;
 
 		s32 leftZValue, rightZValue;
 		s32 leftZStep, rightZStep;
-		TZBufferType* zTarget; // target of ZBuffer;
+		c8* zTarget; // target of ZBuffer;
+		SSpan pixels; // single pixels drawn by the span kernels
 
 		lockedSurface = RenderTarget->lock();
-		lockedZBuffer = ZBuffer->lock();
+		lockZBuffer();
+
+		pixels.Count = 1;
+		pixels.ZStep = 0;
 		
+		SRasterizerStatistics stats; // counted locally, added to Statistics at the end
+		stats.Triangles = triangleCount;
+
 		for (s32 i=0; i<triangleCount; ++i)
 		{
 			v1 = &vertices[*indexList];
@@ -60,13 +67,19 @@ public:
 					((v3->Pos.Y - v1->Pos.Y) * (v3->Pos.X - v2->Pos.X));
 
 				if (z < 0)
+				{
+					++stats.BackFaceCulled;
 					continue;
+				}
 			}
 
 			//near plane clipping
 
 			if (v1->ZValue<0 && v2->ZValue<0 && v3->ZValue<0)
+			{
+				++stats.NearPlaneCulled;
 				continue;
+			}
 
 			// sort for width for inscreen clipping
 
@@ -75,7 +88,10 @@ public:
 			if (v2->Pos.X > v3->Pos.X)	swapVertices(&v2, &v3);
 
 			if ((v1->Pos.X - v3->Pos.X) == 0)
+			{
+				++stats.DegenerateCulled;
 				continue;
+			}
 
 			TriangleRect.UpperLeftCorner.X = v1->Pos.X;
 			TriangleRect.LowerRightCorner.X = v3->Pos.X;
@@ -90,13 +106,19 @@ public:
 			TriangleRect.LowerRightCorner.Y = v3->Pos.Y;
 
 			if (!TriangleRect.isRectCollided(ViewPortRect))
+			{
+				++stats.ViewPortCulled;
 				continue;
+			}
 
 
 			// hhe des dreiecks berechnen
 			height = v3->Pos.Y - v1->Pos.Y;
 			if (!height)
+			{
+				++stats.DegenerateCulled;
 				continue;
+			}
 
 			// calculate longest span
 
@@ -106,14 +128,15 @@ public:
 			span = v1->Pos.Y;
 			leftxf = (f32)v1->Pos.X;
 			rightxf = (f32)v1->Pos.X;
+			leftEdgeY = rightEdgeY = v1->Pos.Y;
 
 			leftZValue = v1->ZValue;
 			rightZValue = v1->ZValue;
 
-			color = v1->Color;
+			pixels.Color = v1->Color;
 
-			targetSurface = lockedSurface + span * SurfaceWidth;
-			zTarget = lockedZBuffer + span * SurfaceWidth;
+			targetSurface = (c8*)lockedSurface + span * SurfacePitch;
+			zTarget = lockedZBuffer + span * ZBufferPitch;
 
 			if (longest < 0.0f)
 			{
@@ -161,10 +184,8 @@ public:
 						span = ViewPortRect.UpperLeftCorner.Y;
 					}
 
-					leftxf += leftdeltaxf*leftx;
-					rightxf += rightdeltaxf*leftx;
-					targetSurface += SurfaceWidth*leftx;
-					zTarget += SurfaceWidth*leftx;
+					targetSurface = (c8*)lockedSurface + span * SurfacePitch;
+					zTarget = lockedZBuffer + span * ZBufferPitch;
 					leftZValue += leftZStep*leftx;
 					rightZValue += rightZStep*leftx;
 				}
@@ -174,40 +195,44 @@ public:
 
 				while (span < spanEnd)
 				{
-					leftx = (s32)(leftxf);
-					rightx = (s32)(rightxf + 0.5f);
+					++stats.SpansTested;
+
+					// the edges are calculated for every span instead of adding up the
+					// deltas, so they do not drift and do not depend on the viewport.
+					leftx = (s32)(leftxf + leftdeltaxf * (span - leftEdgeY));
+					rightx = (s32)(rightxf + rightdeltaxf * (span - rightEdgeY) + 0.5f);
 
 					// perform some clipping
 
 					if (leftx>=ViewPortRect.UpperLeftCorner.X &&
 						leftx<=ViewPortRect.LowerRightCorner.X)
 					{
-						if (leftZValue > *(zTarget + leftx))
-						{
-							*(zTarget + leftx) = leftZValue;
-							*(targetSurface + leftx) = color;
-						}
+						pixels.Target = targetSurface + leftx * PixelSize;
+						pixels.ZTarget = zTarget + leftx * ZValueSize;
+						pixels.ZValue = leftZValue;
+
+						++stats.PixelsTested;
+						stats.PixelsWritten += SpanKernels->Draw[0](pixels);
 					}
 
 
 					if (rightx>=ViewPortRect.UpperLeftCorner.X &&
 						rightx<=ViewPortRect.LowerRightCorner.X)
 					{
-						if (rightZValue > *(zTarget + rightx))
-						{
-							*(zTarget + rightx) = rightZValue;
-							*(targetSurface + rightx) = color;
-						}
+						pixels.Target = targetSurface + rightx * PixelSize;
+						pixels.ZTarget = zTarget + rightx * ZValueSize;
+						pixels.ZValue = rightZValue;
+
+						++stats.PixelsTested;
+						stats.PixelsWritten += SpanKernels->Draw[0](pixels);
 
 					}
 
 					// draw the span
 
-					leftxf += leftdeltaxf;
-					rightxf += rightdeltaxf;
 					++span;
-					targetSurface += SurfaceWidth;
-					zTarget += SurfaceWidth;
+					targetSurface += SurfacePitch;
+					zTarget += ZBufferPitch;
 					leftZValue += leftZStep;
 					rightZValue += rightZStep;
 				}
@@ -224,6 +249,7 @@ public:
 
 					rightdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
 					rightxf = (f32)v2->Pos.X;
+					rightEdgeY = v2->Pos.Y;
 
 					rightZValue = v2->ZValue;
 					rightZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
@@ -234,6 +260,7 @@ public:
 
 					leftdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
 					leftxf = (f32)v2->Pos.X;
+					leftEdgeY = v2->Pos.Y;
 
 					leftZValue = v2->ZValue;
 					leftZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
@@ -245,6 +272,12 @@ public:
 
 		}
 
+		if (Statistics)
+		{
+			stats.ZTestFailed = stats.PixelsTested - stats.PixelsWritten;
+			Statistics->add(stats);
+		}
+
 		RenderTarget->unlock();
 		ZBuffer->unlock();
 	}
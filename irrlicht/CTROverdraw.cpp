@@ -1,20 +1,22 @@
 #include "CTRTextureGouraud.h"
-#include "color.h"
+#include "Color.h"
 
 namespace irr
 {
 namespace video
 {
 
-class CTRTextureFlat : public CTRTextureGouraud
+//! Renders the triangles like CTRFlat, but instead of a color it increments
+//! the pixels of the render target, which is a surface counting the writes.
+class CTROverdraw : public CTRTextureGouraud
 {
 public:
 
-	CTRTextureFlat(IZBuffer* zbuffer)
+	CTROverdraw(IZBuffer* zbuffer)
 		: CTRTextureGouraud(zbuffer)
 	{
 		#ifdef _DEBUG
-		setDebugName("CTRTextureFlat");
+		setDebugName("CTROverdraw");
 		#endif
 	}
 
@@ -26,28 +28,30 @@ public:
 		f32 tmpDiv; // temporary division factor
 		f32 longest; // saves the longest span
 		s32 height; // saves height of triangle
-		s16* targetSurface; // target pointer where to plot pixels
+		c8* targetSurface; // target pointer where to plot pixels
 		s32 spanEnd; // saves end of spans
 		f32 leftdeltaxf; // amount of pixels to increase on left side of triangle
 		f32 rightdeltaxf; // amount of pixels to increase on right side of triangle
 		s32 leftx, rightx; // position where we are 
-		f32 leftxf, rightxf; // same as above, but as f32 values
+		s32 spanWidth, spanSkip; // unclipped width of a span and pixels clipped at its left side
+		f32 leftxf, rightxf; // x of the edges at the rows they start
+		s32 leftEdgeY, rightEdgeY; // rows the edges start at
 		s32 span; // current span
 		s16 *hSpanBegin, *hSpanEnd; // pointer used when plotting pixels
-		s32 leftTx, rightTx, leftTy, rightTy; // texture interpolating values
-		s32 leftTxStep, rightTxStep, leftTyStep, rightTyStep; // texture interpolating values
-		s32 spanTx, spanTy, spanTxStep, spanTyStep; // values of Texturecoords when drawing a span
 		core::rectEx<s32> TriangleRect;
 
 		s32 leftZValue, rightZValue;
+		s32 written; // pixels written by a span
 		s32 leftZStep, rightZStep;
 		s32 spanZValue, spanZStep; // ZValues when drawing a span
-		TZBufferType* zTarget, *spanZTarget; // target of ZBuffer;
+		c8* zTarget; // target of ZBuffer;
 
 		lockedSurface = RenderTarget->lock();
-		lockedZBuffer = ZBuffer->lock();
-		lockedTexture = Texture->lock();
+		lockZBuffer();
 		
+		SRasterizerStatistics stats; // counted locally, added to Statistics at the end
+		stats.Triangles = triangleCount;
+
 		for (s32 i=0; i<triangleCount; ++i)
 		{
 			v1 = &vertices[*indexList];
@@ -65,13 +69,19 @@ public:
 					((v3->Pos.Y - v1->Pos.Y) * (v3->Pos.X - v2->Pos.X));
 
 				if (z < 0)
+				{
+					++stats.BackFaceCulled;
 					continue;
+				}
 			}
 
 			//near plane clipping
 
 			if (v1->ZValue<0 && v2->ZValue<0 && v3->ZValue<0)
+			{
+				++stats.NearPlaneCulled;
 				continue;
+			}
 
 			// sort for width for inscreen clipping
 
@@ -80,7 +90,10 @@ public:
 			if (v2->Pos.X > v3->Pos.X)	swapVertices(&v2, &v3);
 
 			if ((v1->Pos.X - v3->Pos.X) == 0)
+			{
+				++stats.DegenerateCulled;
 				continue;
+			}
 
 			TriangleRect.UpperLeftCorner.X = v1->Pos.X;
 			TriangleRect.LowerRightCorner.X = v3->Pos.X;
@@ -95,13 +108,27 @@ public:
 			TriangleRect.LowerRightCorner.Y = v3->Pos.Y;
 
 			if (!TriangleRect.isRectCollided(ViewPortRect))
+			{
+				++stats.ViewPortCulled;
+				continue;
+			}
+
+			// hierarchical z test
+
+			if (isOccluded(v1, v2, v3, TriangleRect))
+			{
+				++stats.HiZCulled;
 				continue;
+			}
 
 
 			// hhe des dreiecks berechnen
 			height = v3->Pos.Y - v1->Pos.Y;
 			if (!height)
+			{
+				++stats.DegenerateCulled;
 				continue;
+			}
 
 			// calculate longest span
 
@@ -111,43 +138,33 @@ public:
 			span = v1->Pos.Y;
 			leftxf = (f32)v1->Pos.X;
 			rightxf = (f32)v1->Pos.X;
+			leftEdgeY = rightEdgeY = v1->Pos.Y;
 
 			leftZValue = v1->ZValue;
 			rightZValue = v1->ZValue;
 
-			leftTx = rightTx = v1->TCoords.X;
-			leftTy = rightTy = v1->TCoords.Y;
-
-			targetSurface = lockedSurface + span * SurfaceWidth;
-			zTarget = lockedZBuffer + span * SurfaceWidth;
+			targetSurface = (c8*)lockedSurface + span * SurfacePitch;
+			zTarget = lockedZBuffer + span * ZBufferPitch;
 
 			if (longest < 0.0f)
 			{
 				tmpDiv = 1.0f / (f32)(v2->Pos.Y - v1->Pos.Y);
 				rightdeltaxf = (v2->Pos.X - v1->Pos.X) * tmpDiv;
 				rightZStep = (s32)((v2->ZValue - v1->ZValue) * tmpDiv);
-				rightTxStep = (s32)((v2->TCoords.X - rightTx) * tmpDiv);
-				rightTyStep = (s32)((v2->TCoords.Y - rightTy) * tmpDiv);
 
 				tmpDiv = 1.0f / (f32)height;
 				leftdeltaxf = (v3->Pos.X - v1->Pos.X) * tmpDiv;
 				leftZStep = (s32)((v3->ZValue - v1->ZValue) * tmpDiv);
-				leftTxStep = (s32)((v3->TCoords.X - leftTx) * tmpDiv);
-				leftTyStep = (s32)((v3->TCoords.Y - leftTy) * tmpDiv);
 			}
 			else
 			{
 				tmpDiv = 1.0f / (f32)height;
 				rightdeltaxf = (v3->Pos.X - v1->Pos.X) * tmpDiv;
 				rightZStep = (s32)((v3->ZValue - v1->ZValue) * tmpDiv);
-				rightTxStep = (s32)((v3->TCoords.X - rightTx) * tmpDiv);
-				rightTyStep = (s32)((v3->TCoords.Y - rightTy) * tmpDiv);
 
 				tmpDiv = 1.0f / (f32)(v2->Pos.Y - v1->Pos.Y);
 				leftdeltaxf = (v2->Pos.X - v1->Pos.X) * tmpDiv;
 				leftZStep = (s32)((v2->ZValue - v1->ZValue) * tmpDiv);
-				leftTxStep = (s32)((v2->TCoords.X - leftTx) * tmpDiv);
-				leftTyStep = (s32)((v2->TCoords.Y - leftTy) * tmpDiv);
 			}
 
 
@@ -175,17 +192,10 @@ public:
 						span = ViewPortRect.UpperLeftCorner.Y;
 					}
 
-					leftxf += leftdeltaxf*leftx;
-					rightxf += rightdeltaxf*leftx;
-					targetSurface += SurfaceWidth*leftx;
-					zTarget += SurfaceWidth*leftx;
+					targetSurface = (c8*)lockedSurface + span * SurfacePitch;
+					zTarget = lockedZBuffer + span * ZBufferPitch;
 					leftZValue += leftZStep*leftx;
 					rightZValue += rightZStep*leftx;
-
-					leftTx += leftTxStep*leftx;
-					leftTy += leftTyStep*leftx;
-					rightTx += rightTxStep*leftx;
-					rightTy += rightTyStep*leftx;
 				}
 
 
@@ -193,12 +203,20 @@ public:
 
 				while (span < spanEnd)
 				{
-					leftx = (s32)(leftxf);
-					rightx = (s32)(rightxf + 0.5f);
+					++stats.SpansTested;
+
+					// the edges are calculated for every span instead of adding up the
+					// deltas, so they do not drift and do not depend on the viewport.
+					leftx = (s32)(leftxf + leftdeltaxf * (span - leftEdgeY));
+					rightx = (s32)(rightxf + rightdeltaxf * (span - rightEdgeY) + 0.5f);
+					spanWidth = rightx - leftx;
+					spanSkip = leftx;
 
 					// perform some clipping
 
-					// TODO: clipping is not correct when leftx is clipped.
+					// the span is interpolated over its unclipped width, clipping
+					// the left side only skips pixels. This keeps the gradients
+					// independent of the viewport, which tiled rendering relies on.
 
 					if (leftx<ViewPortRect.UpperLeftCorner.X)
 						leftx = ViewPortRect.UpperLeftCorner.X;
@@ -212,52 +230,39 @@ public:
 						if (rightx>ViewPortRect.LowerRightCorner.X)
 							rightx = ViewPortRect.LowerRightCorner.X;
 
+					// skip the blocks of the hierarchical z buffer hiding the span
+
+					clipSpanToBlocks(span, leftx, rightx, leftZValue > rightZValue ? leftZValue : rightZValue);
+
 					// draw the span
 
-					if (rightx - leftx != 0)
+					if (rightx - leftx > 0)
 					{
-						tmpDiv = 1.0f / (rightx - leftx);
-						spanZValue = leftZValue;
+						tmpDiv = 1.0f / spanWidth;
+						spanSkip = leftx - spanSkip;
 						spanZStep = (s32)((rightZValue - leftZValue) * tmpDiv);
+						spanZValue = leftZValue + spanZStep * spanSkip;
+
+						hSpanBegin = (s16*)targetSurface + leftx;
+						hSpanEnd = (s16*)targetSurface + rightx;
+
+						stats.PixelsTested += rightx - leftx;
 
-						hSpanBegin = targetSurface + leftx;
-						spanZTarget = zTarget + leftx;
-						hSpanEnd = targetSurface + rightx;
-
-						spanTx = leftTx;	
-						spanTy = leftTy;
-						spanTxStep = (s32)((rightTx - leftTx) * tmpDiv);
-						spanTyStep = (s32)((rightTy - leftTy) * tmpDiv);
-
-						while (hSpanBegin < hSpanEnd)
-						{
-							if (spanZValue > *spanZTarget)
-							{
-								*spanZTarget = spanZValue;
-								*hSpanBegin = lockedTexture[((spanTy>>8)&textureYMask) * lockedTextureWidth + ((spanTx>>8)&textureXMask)];
-							}
-
-							spanTx += spanTxStep;
-							spanTy += spanTyStep;
-							
-							spanZValue += spanZStep;
-							++hSpanBegin;
-							++spanZTarget;
-						}
+						if (ZValueSize == sizeof(s32))
+							written = drawSpan((s32*)zTarget + leftx, hSpanBegin, hSpanEnd, spanZValue, spanZStep);
+						else
+							written = drawSpan((s16*)zTarget + leftx, hSpanBegin, hSpanEnd, spanZValue, spanZStep);
+
+						if (written)
+							markBlocks(span, leftx, rightx);
+						stats.PixelsWritten += written;
 					}
 
-					leftxf += leftdeltaxf;
-					rightxf += rightdeltaxf;
 					++span;
-					targetSurface += SurfaceWidth;
-					zTarget += SurfaceWidth;
+					targetSurface += SurfacePitch;
+					zTarget += ZBufferPitch;
 					leftZValue += leftZStep;
 					rightZValue += rightZStep;
-
-					leftTx += leftTxStep;
-					leftTy += leftTyStep;
-					rightTx += rightTxStep;
-					rightTy += rightTyStep;
 				}
 
 				if (triangleHalf>0) // break, we've gout only two halves
@@ -272,14 +277,10 @@ public:
 
 					rightdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
 					rightxf = (f32)v2->Pos.X;
+					rightEdgeY = v2->Pos.Y;
 
 					rightZValue = v2->ZValue;
 					rightZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
-
-					rightTx = v2->TCoords.X;
-					rightTy = v2->TCoords.Y;
-					rightTxStep = (s32)((v3->TCoords.X - rightTx) * tmpDiv);
-					rightTyStep = (s32)((v3->TCoords.Y - rightTy) * tmpDiv);
 				}
 				else
 				{
@@ -287,14 +288,10 @@ public:
 
 					leftdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
 					leftxf = (f32)v2->Pos.X;
+					leftEdgeY = v2->Pos.Y;
 
 					leftZValue = v2->ZValue;
 					leftZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
-
-					leftTx = v2->TCoords.X;
-					leftTy = v2->TCoords.Y;
-					leftTxStep = (s32)((v3->TCoords.X - leftTx) * tmpDiv);
-					leftTyStep = (s32)((v3->TCoords.Y - leftTy) * tmpDiv);
 				}
 
 
@@ -303,18 +300,48 @@ public:
 
 		}
 
+		if (Statistics)
+		{
+			stats.ZTestFailed = stats.PixelsTested - stats.PixelsWritten;
+			Statistics->add(stats);
+		}
+
 		RenderTarget->unlock();
 		ZBuffer->unlock();
-		Texture->unlock();
+	}
+
+private:
+
+	//! increments the pixels of a span which pass the z test, returns
+	//! the amount of incremented pixels.
+	template <class Z>
+	static s32 drawSpan(Z* zTarget, s16* hSpanBegin, s16* hSpanEnd, s32 zValue, s32 zStep)
+	{
+		s32 written = 0;
+
+		while (hSpanBegin < hSpanEnd)
+		{
+			if (zValue > *zTarget)
+			{
+				++written;
+				*zTarget = (Z)zValue;
+				++(*hSpanBegin);
+			}
+
+			zValue += zStep;
+			++hSpanBegin;
+			++zTarget;
+		}
 
+		return written;
 	}
 };
 
 
-//! creates a flat triangle renderer
-IK3DTriangleRenderer* createTriangleRendererTextureFlat(IZBuffer* zbuffer)
+//! creates a triangle renderer which counts how often each pixel is written
+IK3DTriangleRenderer* createTriangleRendererOverdraw(IZBuffer* zbuffer)
 {
-	return new CTRTextureFlat(zbuffer);
+	return new CTROverdraw(zbuffer);
 }
 
 } // end namespace video
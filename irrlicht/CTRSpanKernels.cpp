@@ -0,0 +1,2985 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "CTRSpanKernels.h"
+#include "Color.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define _IRR_SPAN_KERNELS_X86_
+#endif
+
+#ifdef _IRR_SPAN_KERNELS_X86_
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#include <immintrin.h>
+
+// gcc only generates code for the instruction sets enabled on the command
+// line, so the kernels are compiled for their set explicitly. They are only
+// called if the processor supports it.
+#ifdef __GNUC__
+#define _IRR_TARGET_SSE2_ __attribute__((target("sse2")))
+#define _IRR_TARGET_AVX2_ __attribute__((target("avx2")))
+#else
+#define _IRR_TARGET_SSE2_
+#define _IRR_TARGET_AVX2_
+#endif
+
+#endif
+
+namespace irr
+{
+namespace video
+{
+
+// The values are interpolated with unsigned integers, so they wrap around
+// like the vector registers do. Spans of triangles which are partly behind
+// the camera may run out of the range of the z values.
+// All kernels are templates of the type Z of the z buffer values, s16 for
+// EZF_16BIT and s32 for EZF_32BIT, and of the combination F of E_SPAN_FEATURE
+// flags they draw. The tables are filled with every combination when the
+// program starts, see SKernelTable.
+
+
+//! the pixels of 16 bit render targets and textures
+struct SPixel16
+{
+	typedef s16 Type;
+
+	//! returns a pixel of an A8R8G8B8 color
+	static inline s16 color(s32 color)
+	{
+		return X8R8G8B8toA1R5G5B5(color);
+	}
+
+	//! returns a pixel of 5.8 fixed point color channels
+	static inline s16 gouraud(u32 r, u32 g, u32 b)
+	{
+		return ((((s32)r>>8) & 0x1F)<<10) | ((((s32)g>>8) & 0x1F)<<5) | (((s32)b>>8) & 0x1F);
+	}
+
+	//! modulates a texel with 5.8 fixed point color channels
+	static inline s16 modulate(s16 texel, u32 r, u32 g, u32 b)
+	{
+		return video::RGB16(video::getRed(texel) * ((s32)r>>8) >>2, video::getGreen(texel) * ((s32)g>>8) >>2, video::getBlue(texel) * ((s32)b>>8) >>2);
+	}
+
+	//! modulates a pixel with a lightmap texel, every channel is multiplied
+	//! like (pixel * light) >> 3 and saturated, which is 4 times the product.
+	static inline s16 lightmap(s16 pixel, s16 light)
+	{
+		s32 r = (video::getRed(pixel) * video::getRed(light)) >> 3;
+		s32 g = (video::getGreen(pixel) * video::getGreen(light)) >> 3;
+		s32 b = (video::getBlue(pixel) * video::getBlue(light)) >> 3;
+
+		return ((r < 0x1F ? r : 0x1F)<<10) | ((g < 0x1F ? g : 0x1F)<<5) | (b < 0x1F ? b : 0x1F);
+	}
+
+	//! returns the 8 bit alpha of a texel, 255 if its alpha bit is set
+	static inline s32 alpha(s16 texel)
+	{
+		return (texel & 0x8000) ? 0xFF : 0;
+	}
+
+	//! returns the weight of an 8 bit alpha, from 0 to 32
+	static inline s32 weight(s32 alpha)
+	{
+		return (alpha + (alpha>>7)) >> 3;
+	}
+
+	//! blends a pixel over a pixel of the target, every channel is mixed
+	//! like (pixel * w + dest * (32-w)) >> 5 with the weight of the alpha.
+	static inline s16 blend(s16 pixel, s16 dest, s32 alpha)
+	{
+		s32 w = weight(alpha);
+		s32 r = (video::getRed(pixel) * w + video::getRed(dest) * (32-w)) >> 5;
+		s32 g = (video::getGreen(pixel) * w + video::getGreen(dest) * (32-w)) >> 5;
+		s32 b = (video::getBlue(pixel) * w + video::getBlue(dest) * (32-w)) >> 5;
+
+		return (r<<10) | (g<<5) | b;
+	}
+
+	//! scales a pixel by the weight of an alpha, like (pixel * w) >> 5
+	static inline s16 scale(s16 pixel, s32 alpha)
+	{
+		s32 w = weight(alpha);
+
+		return (((video::getRed(pixel) * w) >> 5)<<10) | (((video::getGreen(pixel) * w) >> 5)<<5) |
+			((video::getBlue(pixel) * w) >> 5);
+	}
+
+	//! adds a pixel to a pixel of the target, the channels are saturated
+	static inline s16 add(s16 pixel, s16 dest)
+	{
+		s32 r = video::getRed(pixel) + video::getRed(dest);
+		s32 g = video::getGreen(pixel) + video::getGreen(dest);
+		s32 b = video::getBlue(pixel) + video::getBlue(dest);
+
+		return ((r < 0x1F ? r : 0x1F)<<10) | ((g < 0x1F ? g : 0x1F)<<5) | (b < 0x1F ? b : 0x1F);
+	}
+
+	//! filters 4 texels with weights adding up to 256, every channel is
+	//! mixed like (t0 * w0 + t1 * w1 + t2 * w2 + t3 * w3) >> 8. The alpha bit
+	//! is set if the texels having it weigh at least half.
+	static inline s16 filter(s16 t0, s16 t1, s16 t2, s16 t3, s32 w0, s32 w1, s32 w2, s32 w3)
+	{
+		s32 r = (video::getRed(t0) * w0 + video::getRed(t1) * w1 + video::getRed(t2) * w2 + video::getRed(t3) * w3) >> 8;
+		s32 g = (video::getGreen(t0) * w0 + video::getGreen(t1) * w1 + video::getGreen(t2) * w2 + video::getGreen(t3) * w3) >> 8;
+		s32 b = (video::getBlue(t0) * w0 + video::getBlue(t1) * w1 + video::getBlue(t2) * w2 + video::getBlue(t3) * w3) >> 8;
+		s32 a = (t0 < 0 ? w0 : 0) + (t1 < 0 ? w1 : 0) + (t2 < 0 ? w2 : 0) + (t3 < 0 ? w3 : 0);
+
+		return (a >= 128 ? 0x8000 : 0) | (r<<10) | (g<<5) | b;
+	}
+};
+
+
+
+//! the pixels of 32 bit render targets and textures. The channels have 8
+//! bits, colors which are calculated get an alpha value of 0 like in the
+//! 16 bit kernels.
+struct SPixel32
+{
+	typedef s32 Type;
+
+	//! returns a pixel of an A8R8G8B8 color
+	static inline s32 color(s32 color)
+	{
+		return color & 0x00FFFFFF;
+	}
+
+	//! returns a pixel of 8.8 fixed point color channels
+	static inline s32 gouraud(u32 r, u32 g, u32 b)
+	{
+		return ((r & 0xFF00)<<8) | (g & 0xFF00) | ((b & 0xFF00)>>8);
+	}
+
+	//! modulates a texel with 8.8 fixed point color channels, every channel
+	//! is multiplied like (texel * (color+1)) >> 8, so a full color keeps the texel.
+	static inline s32 modulate(s32 texel, u32 r, u32 g, u32 b)
+	{
+		return (((((texel>>16) & 0xFF) * ((((s32)r>>8) & 0xFF) + 1)) >> 8) << 16) |
+			(((((texel>>8) & 0xFF) * ((((s32)g>>8) & 0xFF) + 1)) >> 8) << 8) |
+			(((texel & 0xFF) * ((((s32)b>>8) & 0xFF) + 1)) >> 8);
+	}
+
+	//! modulates a pixel with a lightmap texel, every channel is multiplied
+	//! like (pixel * light) >> 6 and saturated, which is 4 times the product.
+	static inline s32 lightmap(s32 pixel, s32 light)
+	{
+		s32 r = (((pixel>>16) & 0xFF) * ((light>>16) & 0xFF)) >> 6;
+		s32 g = (((pixel>>8) & 0xFF) * ((light>>8) & 0xFF)) >> 6;
+		s32 b = ((pixel & 0xFF) * (light & 0xFF)) >> 6;
+
+		return ((r < 0xFF ? r : 0xFF)<<16) | ((g < 0xFF ? g : 0xFF)<<8) | (b < 0xFF ? b : 0xFF);
+	}
+
+	//! returns the alpha of a texel
+	static inline s32 alpha(s32 texel)
+	{
+		return (texel>>24) & 0xFF;
+	}
+
+	//! returns the weight of an alpha, from 0 to 256
+	static inline s32 weight(s32 alpha)
+	{
+		return alpha + (alpha>>7);
+	}
+
+	//! blends a pixel over a pixel of the target, every channel is mixed
+	//! like (pixel * w + dest * (256-w)) >> 8 with the weight of the alpha.
+	static inline s32 blend(s32 pixel, s32 dest, s32 alpha)
+	{
+		s32 w = weight(alpha);
+		s32 r = (((pixel>>16) & 0xFF) * w + ((dest>>16) & 0xFF) * (256-w)) >> 8;
+		s32 g = (((pixel>>8) & 0xFF) * w + ((dest>>8) & 0xFF) * (256-w)) >> 8;
+		s32 b = ((pixel & 0xFF) * w + (dest & 0xFF) * (256-w)) >> 8;
+
+		return (r<<16) | (g<<8) | b;
+	}
+
+	//! scales a pixel by the weight of an alpha, like (pixel * w) >> 8
+	static inline s32 scale(s32 pixel, s32 alpha)
+	{
+		s32 w = weight(alpha);
+
+		return (((((pixel>>16) & 0xFF) * w) >> 8)<<16) | (((((pixel>>8) & 0xFF) * w) >> 8)<<8) |
+			(((pixel & 0xFF) * w) >> 8);
+	}
+
+	//! adds a pixel to a pixel of the target, the channels are saturated
+	static inline s32 add(s32 pixel, s32 dest)
+	{
+		s32 r = ((pixel>>16) & 0xFF) + ((dest>>16) & 0xFF);
+		s32 g = ((pixel>>8) & 0xFF) + ((dest>>8) & 0xFF);
+		s32 b = (pixel & 0xFF) + (dest & 0xFF);
+
+		return ((r < 0xFF ? r : 0xFF)<<16) | ((g < 0xFF ? g : 0xFF)<<8) | (b < 0xFF ? b : 0xFF);
+	}
+
+	//! filters 4 texels with weights adding up to 256, every channel
+	//! including alpha is mixed like (t0 * w0 + t1 * w1 + t2 * w2 + t3 * w3) >> 8.
+	static inline s32 filter(s32 t0, s32 t1, s32 t2, s32 t3, s32 w0, s32 w1, s32 w2, s32 w3)
+	{
+		s32 pixel = 0;
+
+		for (s32 shift=0; shift<32; shift+=8)
+			pixel |= (((t0>>shift) & 0xFF) * w0 + ((t1>>shift) & 0xFF) * w1 +
+				((t2>>shift) & 0xFF) * w2 + ((t3>>shift) & 0xFF) * w3) >> 8 << shift;
+
+		return pixel;
+	}
+};
+
+
+
+//! blends a pixel with a pixel of the target as the blend features of F ask for
+template <class P, u32 F>
+static inline typename P::Type blendPixel(typename P::Type pixel, typename P::Type dest, s32 alpha)
+{
+	if (F & ESF_BLEND_ADD)
+		return P::add((F & ESF_BLEND_ALPHA) ? P::scale(pixel, alpha) : pixel, dest);
+
+	return P::blend(pixel, dest, alpha);
+}
+
+
+
+//! returns the offset of a texel in the texture of a span. The texel
+//! coordinates are masked already.
+static inline s32 getTexelOffset(const SSpan& span, s32 x, s32 y)
+{
+	if (!span.TextureTiled)
+		return y * span.TextureWidth + x;
+
+	return (y & ~3) * span.TextureWidth + ((x & ~3) << 2) + ((y & 3) << 2) + (x & 3);
+}
+
+
+
+//! returns the texel at an offset of a texture, looked up in the palette
+//! if the texture has 8 bit indices
+template <class T>
+static inline T getTexel(const void* texture, const void* palette, s32 offset)
+{
+	if (palette)
+		return ((const T*)palette)[((const u8*)texture)[offset]];
+
+	return ((const T*)texture)[offset];
+}
+
+
+
+//! fetches a texel filtered bilinearly from the 4 texels around 8.8 fixed
+//! point texture coordinates, with 4 bit weights. The texels are centered
+//! half a texel behind the coordinates they are fetched with without
+//! filtering, so a texture is not shifted when filtering is switched on.
+template <class P>
+static inline typename P::Type fetchBilinear(const SSpan& span, u32 tx, u32 ty)
+{
+	typedef typename P::Type T;
+
+	const s32 x = (s32)(tx - 0x80);
+	const s32 y = (s32)(ty - 0x80);
+	const s32 fx = (x>>4) & 0xF;
+	const s32 fy = (y>>4) & 0xF;
+
+	const s32 x0 = (x>>8) & span.TextureXMask;
+	const s32 x1 = (x0+1) & span.TextureXMask;
+	const s32 y0 = (y>>8) & span.TextureYMask;
+	const s32 y1 = (y0+1) & span.TextureYMask;
+
+	const s32 w3 = fx * fy;
+	const s32 w1 = fx * 16 - w3;
+	const s32 w2 = fy * 16 - w3;
+	const s32 w0 = 256 - fx * 16 - w2;
+
+	return P::filter(getTexel<T>(span.Texture, span.Palette, getTexelOffset(span, x0, y0)),
+		getTexel<T>(span.Texture, span.Palette, getTexelOffset(span, x1, y0)),
+		getTexel<T>(span.Texture, span.Palette, getTexelOffset(span, x0, y1)),
+		getTexel<T>(span.Texture, span.Palette, getTexelOffset(span, x1, y1)), w0, w1, w2, w3);
+}
+
+
+
+//! draws a span of the pixel format P, the vector kernels draw the 
+//! rest of their spans with it.
+template <class Z, class P, u32 F>
+static s32 drawSpanScalar(const SSpan& span)
+{
+	typedef typename P::Type T;
+
+	s32 written = 0;
+	u32 z = span.ZValue;
+	Z* zTarget = (Z*)span.ZTarget;
+	u32 r = 0, g = 0, b = 0, a = 0;
+	u32 tx = 0, ty = 0;
+	u32 tx2 = 0, ty2 = 0;
+	T color = 0;
+	s32 alpha = (span.Color>>24) & 0xFF;
+	T* target = (T*)span.Target;
+
+	if (F & ESF_GOURAUD)
+	{
+		r = span.R;
+		g = span.G;
+		b = span.B;
+		a = span.A;
+	}
+
+	if (F & ESF_TEXTURE)
+	{
+		tx = span.Tx;
+		ty = span.Ty;
+	}
+	else
+	if (!(F & ESF_GOURAUD))
+		color = P::color(span.Color);
+
+	if (F & ESF_LIGHTMAP)
+	{
+		tx2 = span.Tx2;
+		ty2 = span.Ty2;
+	}
+
+	for (s32 i=0; i<span.Count; ++i)
+	{
+		if ((F & ESF_NO_ZTEST) || (s32)z > zTarget[i])
+		{
+			++written;
+
+			if (!(F & (ESF_NO_ZTEST | ESF_NO_ZWRITE)))
+				zTarget[i] = (Z)z;
+
+			T pixel;
+
+			if (F & ESF_TEXTURE)
+			{
+				T texel = (F & ESF_BILINEAR) ? fetchBilinear<P>(span, tx, ty) :
+					getTexel<T>(span.Texture, span.Palette, getTexelOffset(span, ((s32)tx>>8)&span.TextureXMask, ((s32)ty>>8)&span.TextureYMask));
+				pixel = (F & ESF_GOURAUD) ? P::modulate(texel, r, g, b) : texel;
+
+				if (F & ESF_BLEND_ALPHA)
+				{
+					alpha = P::alpha(texel);
+
+					if (F & ESF_GOURAUD)
+						alpha = alpha * ((((s32)a>>8) & 0xFF) + 1) >> 8;
+				}
+			}
+			else
+			{
+				pixel = (F & ESF_GOURAUD) ? P::gouraud(r, g, b) : color;
+
+				if (F & ESF_GOURAUD)
+					alpha = ((s32)a>>8) & 0xFF;
+			}
+
+			if (F & ESF_LIGHTMAP)
+				pixel = P::lightmap(pixel, getTexel<T>(span.Texture2, span.Palette2,
+					(((s32)ty2>>8)&span.Texture2YMask) * span.Texture2Width + (((s32)tx2>>8)&span.Texture2XMask)));
+
+			if (F & (ESF_BLEND_ADD | ESF_BLEND_ALPHA))
+				pixel = blendPixel<P, F>(pixel, target[i], alpha);
+
+			target[i] = pixel;
+		}
+
+		if (F & ESF_GOURAUD)
+		{
+			r += span.StepR;
+			g += span.StepG;
+			b += span.StepB;
+			a += span.StepA;
+		}
+
+		if (F & ESF_TEXTURE)
+		{
+			tx += span.TxStep;
+			ty += span.TyStep;
+		}
+
+		if (F & ESF_LIGHTMAP)
+		{
+			tx2 += span.Tx2Step;
+			ty2 += span.Ty2Step;
+		}
+
+		z += span.ZStep;
+	}
+
+	return written;
+}
+
+
+
+//! selects the vector kernel of the shading features of a combination by
+//! overloading, so only the kernels of the combinations are compiled.
+template <u32 F>
+struct SFeatures
+{
+};
+
+
+
+//! the scalar kernels of a pixel format
+template <class P>
+struct SKernelsScalar
+{
+	template <class Z, u32 F>
+	static TDrawSpan get()
+	{
+		return drawSpanScalar<Z, P, F>;
+	}
+};
+
+
+
+//! fills a table with the kernels of the combinations of features from F
+//! down to 0. K is a struct like SKernelsScalar.
+template <class K, class Z, u32 F>
+struct SKernelTable
+{
+	static void fill(TDrawSpan* table)
+	{
+		table[F] = K::template get<Z, F>();
+		SKernelTable<K, Z, F-1>::fill(table);
+	}
+};
+
+template <class K, class Z>
+struct SKernelTable<K, Z, 0>
+{
+	static void fill(TDrawSpan* table)
+	{
+		table[0] = K::template get<Z, 0>();
+	}
+};
+
+
+
+//! fills the kernels of a set for both z buffer formats
+template <class K>
+static void fillKernels(SSpanKernels* kernels, const c8* name)
+{
+	kernels[EZF_16BIT].Name = name;
+	kernels[EZF_32BIT].Name = name;
+	SKernelTable<K, s16, ESF_COUNT-1>::fill(kernels[EZF_16BIT].Draw);
+	SKernelTable<K, s32, ESF_COUNT-1>::fill(kernels[EZF_32BIT].Draw);
+}
+
+
+
+static SSpanKernels ScalarKernels[EZF_COUNT];
+static SSpanKernels ScalarKernels32[EZF_COUNT];
+
+
+
+#ifdef _IRR_SPAN_KERNELS_X86_
+
+//! returns the amount of set bits
+static inline s32 countBits(u32 bits)
+{
+	bits = bits - ((bits >> 1) & 0x55555555);
+	bits = (bits & 0x33333333) + ((bits >> 2) & 0x33333333);
+	bits = (bits + (bits >> 4)) & 0x0F0F0F0F;
+	return (bits * 0x01010101) >> 24;
+}
+
+
+
+//! returns a span with the remaining pixels of a span. The values
+//! are taken from the first lane of the vectors.
+static inline SSpan getRestOfSpan(const SSpan& span, s32 done, s32 pixelSize, s32 zSize, s32 z, s32 r, s32 g, s32 b, s32 tx, s32 ty)
+{
+	SSpan rest = span;
+	rest.Target = (c8*)span.Target + done * pixelSize;
+	rest.ZTarget = (c8*)span.ZTarget + done * zSize;
+	rest.Count -= done;
+	rest.ZValue = z;
+	rest.R = r;
+	rest.G = g;
+	rest.B = b;
+	rest.Tx = tx;
+	rest.Ty = ty;
+	return rest;
+}
+
+
+
+//! returns a span which has the lightmap of a span as texture, so the
+//! texels of the lightmap can be fetched like the ones of the texture.
+static inline SSpan getLightmapLayer(const SSpan& span)
+{
+	SSpan layer = span;
+	layer.Texture = span.Texture2;
+	layer.TextureWidth = span.Texture2Width;
+	layer.TextureXMask = span.Texture2XMask;
+	layer.TextureYMask = span.Texture2YMask;
+	layer.TextureTiled = false;
+	layer.Palette = span.Palette2;
+	return layer;
+}
+
+
+
+// SSE2 kernels, 8 pixels per iteration. The values are interpolated in two
+// registers of 4 32 bit lanes, the pixels and 16 bit z values are written 
+// as 8 16 bit lanes.
+
+//! returns 4 lanes of a linear interpolation
+static _IRR_TARGET_SSE2_ inline __m128i rampSSE2(u32 value, u32 step)
+{
+	return _mm_setr_epi32(value, value + step, value + step*2, value + step*3);
+}
+
+
+
+//! casts 2x4 32 bit lanes to 8 16 bit lanes
+static _IRR_TARGET_SSE2_ inline __m128i truncateSSE2(__m128i a, __m128i b)
+{
+	a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+	b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+	return _mm_packs_epi32(a, b);
+}
+
+
+
+//! returns a where the mask is set, otherwise b
+static _IRR_TARGET_SSE2_ inline __m128i selectSSE2(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+
+
+//! z test and z write of 8 pixels as far as the features F enable them,
+//! returns the mask of the pixels which passed.
+template <u32 F>
+static _IRR_TARGET_SSE2_ inline __m128i zTestSSE2(s16* zTarget, __m128i z0, __m128i z1)
+{
+	if (F & ESF_NO_ZTEST)
+		return _mm_set1_epi32(-1);
+
+	__m128i old = _mm_loadu_si128((const __m128i*)zTarget);
+	__m128i old0 = _mm_srai_epi32(_mm_unpacklo_epi16(old, old), 16);
+	__m128i old1 = _mm_srai_epi32(_mm_unpackhi_epi16(old, old), 16);
+
+	__m128i mask = _mm_packs_epi32(_mm_cmpgt_epi32(z0, old0), _mm_cmpgt_epi32(z1, old1));
+
+	if (!(F & ESF_NO_ZWRITE))
+		_mm_storeu_si128((__m128i*)zTarget, selectSSE2(mask, truncateSSE2(z0, z1), old));
+	return mask;
+}
+
+
+
+//! z test and z write of 8 pixels with 32 bit z values, returns the
+//! mask of the pixels which passed as 8 16 bit lanes.
+template <u32 F>
+static _IRR_TARGET_SSE2_ inline __m128i zTestSSE2(s32* zTarget, __m128i z0, __m128i z1)
+{
+	if (F & ESF_NO_ZTEST)
+		return _mm_set1_epi32(-1);
+
+	__m128i old0 = _mm_loadu_si128((const __m128i*)zTarget);
+	__m128i old1 = _mm_loadu_si128((const __m128i*)(zTarget + 4));
+
+	__m128i mask0 = _mm_cmpgt_epi32(z0, old0);
+	__m128i mask1 = _mm_cmpgt_epi32(z1, old1);
+
+	if (!(F & ESF_NO_ZWRITE))
+	{
+		_mm_storeu_si128((__m128i*)zTarget, selectSSE2(mask0, z0, old0));
+		_mm_storeu_si128((__m128i*)(zTarget + 4), selectSSE2(mask1, z1, old1));
+	}
+	return _mm_packs_epi32(mask0, mask1);
+}
+
+
+
+//! returns 8 color channels (value>>8) as 16 bit lanes
+static _IRR_TARGET_SSE2_ inline __m128i channelSSE2(__m128i c0, __m128i c1)
+{
+	return truncateSSE2(_mm_srai_epi32(c0, 8), _mm_srai_epi32(c1, 8));
+}
+
+
+
+//! returns the offsets of 4 texels like getTexelOffset() does. The
+//! multiplication only works for textures smaller than 32768.
+static _IRR_TARGET_SSE2_ inline __m128i texelOffsetsSSE2(const SSpan& span, __m128i x, __m128i y)
+{
+	const __m128i width = _mm_set1_epi32(span.TextureWidth);
+
+	if (!span.TextureTiled)
+		return _mm_add_epi32(_mm_madd_epi16(y, width), x);
+
+	const __m128i low = _mm_set1_epi32(3);
+
+	return _mm_add_epi32(
+		_mm_add_epi32(_mm_madd_epi16(_mm_andnot_si128(low, y), width), _mm_slli_epi32(_mm_andnot_si128(low, x), 2)),
+		_mm_add_epi32(_mm_slli_epi32(_mm_and_si128(y, low), 2), _mm_and_si128(x, low)));
+}
+
+
+
+//! loads 8 texels from their offsets, looked up in the palette if the
+//! texture has 8 bit indices
+static _IRR_TARGET_SSE2_ inline __m128i loadTexelsSSE2(const SSpan& span, const s32* o)
+{
+	if (span.Palette)
+	{
+		const u8* i = (const u8*)span.Texture;
+		const s16* p = (const s16*)span.Palette;
+
+		return _mm_setr_epi16(p[i[o[0]]], p[i[o[1]]], p[i[o[2]]], p[i[o[3]]],
+			p[i[o[4]]], p[i[o[5]]], p[i[o[6]]], p[i[o[7]]]);
+	}
+
+	const s16* t = (const s16*)span.Texture;
+
+	return _mm_setr_epi16(t[o[0]], t[o[1]], t[o[2]], t[o[3]],
+		t[o[4]], t[o[5]], t[o[6]], t[o[7]]);
+}
+
+
+
+//! fetches 8 texels. There is no gather instruction, so the texel
+//! offsets are calculated in the registers and the texels are loaded one
+//! by one. The multiplication only works for textures smaller than 32768.
+static _IRR_TARGET_SSE2_ inline __m128i fetchTexelsSSE2(const SSpan& span, __m128i tx0, __m128i tx1, __m128i ty0, __m128i ty1)
+{
+	const __m128i xMask = _mm_set1_epi32(span.TextureXMask);
+	const __m128i yMask = _mm_set1_epi32(span.TextureYMask);
+
+	s32 offsets[8];
+
+	__m128i o = texelOffsetsSSE2(span,
+		_mm_and_si128(_mm_srai_epi32(tx0, 8), xMask),
+		_mm_and_si128(_mm_srai_epi32(ty0, 8), yMask));
+	_mm_storeu_si128((__m128i*)offsets, o);
+
+	o = texelOffsetsSSE2(span,
+		_mm_and_si128(_mm_srai_epi32(tx1, 8), xMask),
+		_mm_and_si128(_mm_srai_epi32(ty1, 8), yMask));
+	_mm_storeu_si128((__m128i*)(offsets + 4), o);
+
+	return loadTexelsSSE2(span, offsets);
+}
+
+
+
+//! calculates the offsets of the 4 texels around 4 texture coordinates and
+//! the weights of the texels in the x and y direction, like fetchBilinear()
+//! does. The offsets are stored as 4 rows of 4 lanes, with a stride of 8.
+static _IRR_TARGET_SSE2_ inline void bilinearOffsetsSSE2(const SSpan& span, __m128i tx, __m128i ty,
+	s32* offsets, __m128i& fx, __m128i& fy)
+{
+	const __m128i xMask = _mm_set1_epi32(span.TextureXMask);
+	const __m128i yMask = _mm_set1_epi32(span.TextureYMask);
+	const __m128i half = _mm_set1_epi32(0x80);
+	const __m128i one = _mm_set1_epi32(1);
+
+	__m128i x = _mm_sub_epi32(tx, half);
+	__m128i y = _mm_sub_epi32(ty, half);
+
+	fx = _mm_and_si128(_mm_srai_epi32(x, 4), _mm_set1_epi32(0xF));
+	fy = _mm_and_si128(_mm_srai_epi32(y, 4), _mm_set1_epi32(0xF));
+
+	x = _mm_srai_epi32(x, 8);
+	y = _mm_srai_epi32(y, 8);
+
+	__m128i x0 = _mm_and_si128(x, xMask);
+	__m128i x1 = _mm_and_si128(_mm_add_epi32(x0, one), xMask);
+	__m128i y0 = _mm_and_si128(y, yMask);
+	__m128i y1 = _mm_and_si128(_mm_add_epi32(y0, one), yMask);
+
+	_mm_storeu_si128((__m128i*)offsets, texelOffsetsSSE2(span, x0, y0));
+	_mm_storeu_si128((__m128i*)(offsets + 8), texelOffsetsSSE2(span, x1, y0));
+	_mm_storeu_si128((__m128i*)(offsets + 16), texelOffsetsSSE2(span, x0, y1));
+	_mm_storeu_si128((__m128i*)(offsets + 24), texelOffsetsSSE2(span, x1, y1));
+}
+
+
+
+//! returns the weights of the 4 texels of bilinear filtering from the
+//! weights in the x and y direction, see fetchBilinear()
+static _IRR_TARGET_SSE2_ inline void bilinearWeightsSSE2(__m128i fx, __m128i fy, __m128i* w)
+{
+	w[3] = _mm_mullo_epi16(fx, fy);
+	w[1] = _mm_sub_epi16(_mm_slli_epi16(fx, 4), w[3]);
+	w[2] = _mm_sub_epi16(_mm_slli_epi16(fy, 4), w[3]);
+	w[0] = _mm_sub_epi16(_mm_sub_epi16(_mm_set1_epi16(256), _mm_slli_epi16(fx, 4)), w[2]);
+}
+
+
+
+//! fetches 8 texels filtered bilinearly like fetchBilinear<SPixel16>() does.
+//! The 5 bit channels and the weights are multiplied in 16 bit lanes.
+static _IRR_TARGET_SSE2_ inline __m128i fetchBilinearSSE2(const SSpan& span, __m128i tx0, __m128i tx1, __m128i ty0, __m128i ty1)
+{
+	s32 offsets[32];
+	__m128i fx0, fx1, fy0, fy1;
+
+	bilinearOffsetsSSE2(span, tx0, ty0, offsets, fx0, fy0);
+	bilinearOffsetsSSE2(span, tx1, ty1, offsets + 4, fx1, fy1);
+
+	__m128i w[4];
+	bilinearWeightsSSE2(_mm_packs_epi32(fx0, fx1), _mm_packs_epi32(fy0, fy1), w);
+
+	const __m128i mask = _mm_set1_epi16(0x1F);
+
+	__m128i r = _mm_setzero_si128();
+	__m128i g = _mm_setzero_si128();
+	__m128i b = _mm_setzero_si128();
+	__m128i a = _mm_setzero_si128();
+
+	for (s32 j=0; j<4; ++j)
+	{
+		__m128i texel = loadTexelsSSE2(span, offsets + j*8);
+
+		r = _mm_add_epi16(r, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(texel, 10), mask), w[j]));
+		g = _mm_add_epi16(g, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(texel, 5), mask), w[j]));
+		b = _mm_add_epi16(b, _mm_mullo_epi16(_mm_and_si128(texel, mask), w[j]));
+		a = _mm_add_epi16(a, _mm_and_si128(_mm_srai_epi16(texel, 15), w[j]));
+	}
+
+	return _mm_or_si128(_mm_or_si128(
+		_mm_and_si128(_mm_cmpgt_epi16(a, _mm_set1_epi16(127)), _mm_set1_epi16((s16)0x8000)),
+		_mm_slli_epi16(_mm_srli_epi16(r, 8), 10)),
+		_mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(g, 8), 5), _mm_srli_epi16(b, 8)));
+}
+
+
+
+//! fetches 8 texels of the texture, filtered if F has ESF_BILINEAR
+template <u32 F>
+static _IRR_TARGET_SSE2_ inline __m128i fetchTextureSSE2(const SSpan& span, __m128i tx0, __m128i tx1, __m128i ty0, __m128i ty1)
+{
+	if (F & ESF_BILINEAR)
+		return fetchBilinearSSE2(span, tx0, tx1, ty0, ty1);
+
+	return fetchTexelsSSE2(span, tx0, tx1, ty0, ty1);
+}
+
+
+
+//! modulates 8 texels with 8 colors like RGB16(getRed(texel) * r >> 2, ..) does.
+//! Only the bits 5 to 9 of the products are used, so the low 16 bits are enough.
+static _IRR_TARGET_SSE2_ inline __m128i modulateSSE2(__m128i texel, __m128i r, __m128i g, __m128i b)
+{
+	const __m128i mask = _mm_set1_epi16(0x1F);
+
+	__m128i pr = _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(texel, 10), mask), r);
+	__m128i pg = _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(texel, 5), mask), g);
+	__m128i pb = _mm_mullo_epi16(_mm_and_si128(texel, mask), b);
+
+	return _mm_or_si128(_mm_or_si128(
+		_mm_and_si128(_mm_slli_epi16(pr, 5), _mm_set1_epi16(0x1F<<10)),
+		_mm_and_si128(pg, _mm_set1_epi16(0x1F<<5))),
+		_mm_and_si128(_mm_srli_epi16(pb, 5), mask));
+}
+
+
+
+//! draws a span with a single color
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanFlatSSE2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m128i color = _mm_set1_epi16(X8R8G8B8toA1R5G5B5(span.Color));
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			__m128i* target = (__m128i*)((s16*)span.Target + i);
+			_mm_storeu_si128(target, selectSSE2(mask, color, _mm_loadu_si128(target)));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+	}
+
+	if (i < span.Count)
+		written += drawSpanScalar<Z, SPixel16, F>(getRestOfSpan(span, i, sizeof(s16), sizeof(Z), _mm_cvtsi128_si32(z0), 0, 0, 0, 0, 0));
+
+	return written;
+}
+
+
+
+//! draws a span with interpolated colors
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanGouraudSSE2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	const __m128i rStep = _mm_set1_epi32((u32)span.StepR * 4);
+	const __m128i gStep = _mm_set1_epi32((u32)span.StepG * 4);
+	const __m128i bStep = _mm_set1_epi32((u32)span.StepB * 4);
+	const __m128i mask5 = _mm_set1_epi16(0x1F);
+
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i r0 = rampSSE2(span.R, span.StepR);
+	__m128i g0 = rampSSE2(span.G, span.StepG);
+	__m128i b0 = rampSSE2(span.B, span.StepB);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+	__m128i r1 = _mm_add_epi32(r0, rStep);
+	__m128i g1 = _mm_add_epi32(g0, gStep);
+	__m128i b1 = _mm_add_epi32(b0, bStep);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			__m128i color = _mm_or_si128(_mm_or_si128(
+				_mm_slli_epi16(_mm_and_si128(channelSSE2(r0, r1), mask5), 10),
+				_mm_slli_epi16(_mm_and_si128(channelSSE2(g0, g1), mask5), 5)),
+				_mm_and_si128(channelSSE2(b0, b1), mask5));
+
+			__m128i* target = (__m128i*)((s16*)span.Target + i);
+			_mm_storeu_si128(target, selectSSE2(mask, color, _mm_loadu_si128(target)));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+		r0 = _mm_add_epi32(r1, rStep);
+		r1 = _mm_add_epi32(r0, rStep);
+		g0 = _mm_add_epi32(g1, gStep);
+		g1 = _mm_add_epi32(g0, gStep);
+		b0 = _mm_add_epi32(b1, bStep);
+		b1 = _mm_add_epi32(b0, bStep);
+	}
+
+	if (i < span.Count)
+		written += drawSpanScalar<Z, SPixel16, F>(getRestOfSpan(span, i, sizeof(s16), sizeof(Z), _mm_cvtsi128_si32(z0),
+			_mm_cvtsi128_si32(r0), _mm_cvtsi128_si32(g0), _mm_cvtsi128_si32(b0), 0, 0));
+
+	return written;
+}
+
+
+
+//! draws a textured span
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanTextureFlatSSE2(const SSpan& span)
+{
+	if (span.TextureWidth > 0x7FFF || span.TextureYMask > 0x7FFF)
+		return drawSpanScalar<Z, SPixel16, F>(span);
+
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	const __m128i txStep = _mm_set1_epi32((u32)span.TxStep * 4);
+	const __m128i tyStep = _mm_set1_epi32((u32)span.TyStep * 4);
+
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i tx0 = rampSSE2(span.Tx, span.TxStep);
+	__m128i ty0 = rampSSE2(span.Ty, span.TyStep);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+	__m128i tx1 = _mm_add_epi32(tx0, txStep);
+	__m128i ty1 = _mm_add_epi32(ty0, tyStep);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			__m128i color = fetchTextureSSE2<F>(span, tx0, tx1, ty0, ty1);
+
+			__m128i* target = (__m128i*)((s16*)span.Target + i);
+			_mm_storeu_si128(target, selectSSE2(mask, color, _mm_loadu_si128(target)));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+		tx0 = _mm_add_epi32(tx1, txStep);
+		tx1 = _mm_add_epi32(tx0, txStep);
+		ty0 = _mm_add_epi32(ty1, tyStep);
+		ty1 = _mm_add_epi32(ty0, tyStep);
+	}
+
+	if (i < span.Count)
+		written += drawSpanScalar<Z, SPixel16, F>(getRestOfSpan(span, i, sizeof(s16), sizeof(Z), _mm_cvtsi128_si32(z0),
+			0, 0, 0, _mm_cvtsi128_si32(tx0), _mm_cvtsi128_si32(ty0)));
+
+	return written;
+}
+
+
+
+//! draws a textured span modulated by interpolated colors
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanTextureGouraudSSE2(const SSpan& span)
+{
+	if (span.TextureWidth > 0x7FFF || span.TextureYMask > 0x7FFF)
+		return drawSpanScalar<Z, SPixel16, F>(span);
+
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	const __m128i rStep = _mm_set1_epi32((u32)span.StepR * 4);
+	const __m128i gStep = _mm_set1_epi32((u32)span.StepG * 4);
+	const __m128i bStep = _mm_set1_epi32((u32)span.StepB * 4);
+	const __m128i txStep = _mm_set1_epi32((u32)span.TxStep * 4);
+	const __m128i tyStep = _mm_set1_epi32((u32)span.TyStep * 4);
+
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i r0 = rampSSE2(span.R, span.StepR);
+	__m128i g0 = rampSSE2(span.G, span.StepG);
+	__m128i b0 = rampSSE2(span.B, span.StepB);
+	__m128i tx0 = rampSSE2(span.Tx, span.TxStep);
+	__m128i ty0 = rampSSE2(span.Ty, span.TyStep);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+	__m128i r1 = _mm_add_epi32(r0, rStep);
+	__m128i g1 = _mm_add_epi32(g0, gStep);
+	__m128i b1 = _mm_add_epi32(b0, bStep);
+	__m128i tx1 = _mm_add_epi32(tx0, txStep);
+	__m128i ty1 = _mm_add_epi32(ty0, tyStep);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			__m128i color = modulateSSE2(fetchTextureSSE2<F>(span, tx0, tx1, ty0, ty1),
+				channelSSE2(r0, r1), channelSSE2(g0, g1), channelSSE2(b0, b1));
+
+			__m128i* target = (__m128i*)((s16*)span.Target + i);
+			_mm_storeu_si128(target, selectSSE2(mask, color, _mm_loadu_si128(target)));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+		r0 = _mm_add_epi32(r1, rStep);
+		r1 = _mm_add_epi32(r0, rStep);
+		g0 = _mm_add_epi32(g1, gStep);
+		g1 = _mm_add_epi32(g0, gStep);
+		b0 = _mm_add_epi32(b1, bStep);
+		b1 = _mm_add_epi32(b0, bStep);
+		tx0 = _mm_add_epi32(tx1, txStep);
+		tx1 = _mm_add_epi32(tx0, txStep);
+		ty0 = _mm_add_epi32(ty1, tyStep);
+		ty1 = _mm_add_epi32(ty0, tyStep);
+	}
+
+	if (i < span.Count)
+		written += drawSpanScalar<Z, SPixel16, F>(getRestOfSpan(span, i, sizeof(s16), sizeof(Z), _mm_cvtsi128_si32(z0),
+			_mm_cvtsi128_si32(r0), _mm_cvtsi128_si32(g0), _mm_cvtsi128_si32(b0),
+			_mm_cvtsi128_si32(tx0), _mm_cvtsi128_si32(ty0)));
+
+	return written;
+}
+
+
+
+//! modulates 8 pixels with 8 lightmap texels like SPixel16::lightmap() does
+static _IRR_TARGET_SSE2_ inline __m128i lightmapSSE2(__m128i pixel, __m128i light)
+{
+	const __m128i mask = _mm_set1_epi16(0x1F);
+
+	__m128i r = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(pixel, 10), mask),
+		_mm_and_si128(_mm_srli_epi16(light, 10), mask)), 3);
+	__m128i g = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(pixel, 5), mask),
+		_mm_and_si128(_mm_srli_epi16(light, 5), mask)), 3);
+	__m128i b = _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(pixel, mask),
+		_mm_and_si128(light, mask)), 3);
+
+	return _mm_or_si128(_mm_or_si128(
+		_mm_slli_epi16(_mm_min_epi16(r, mask), 10),
+		_mm_slli_epi16(_mm_min_epi16(g, mask), 5)),
+		_mm_min_epi16(b, mask));
+}
+
+
+
+//! draws a textured span modulated by the lightmap
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanTextureLightmapSSE2(const SSpan& span)
+{
+	if (span.TextureWidth > 0x7FFF || span.TextureYMask > 0x7FFF ||
+		span.Texture2Width > 0x7FFF || span.Texture2YMask > 0x7FFF)
+		return drawSpanScalar<Z, SPixel16, F>(span);
+
+	s32 written = 0;
+	s32 i = 0;
+
+	const SSpan lightmap = getLightmapLayer(span);
+
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	const __m128i txStep = _mm_set1_epi32((u32)span.TxStep * 4);
+	const __m128i tyStep = _mm_set1_epi32((u32)span.TyStep * 4);
+	const __m128i tx2Step = _mm_set1_epi32((u32)span.Tx2Step * 4);
+	const __m128i ty2Step = _mm_set1_epi32((u32)span.Ty2Step * 4);
+
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i tx0 = rampSSE2(span.Tx, span.TxStep);
+	__m128i ty0 = rampSSE2(span.Ty, span.TyStep);
+	__m128i tx20 = rampSSE2(span.Tx2, span.Tx2Step);
+	__m128i ty20 = rampSSE2(span.Ty2, span.Ty2Step);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+	__m128i tx1 = _mm_add_epi32(tx0, txStep);
+	__m128i ty1 = _mm_add_epi32(ty0, tyStep);
+	__m128i tx21 = _mm_add_epi32(tx20, tx2Step);
+	__m128i ty21 = _mm_add_epi32(ty20, ty2Step);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			__m128i color = lightmapSSE2(fetchTextureSSE2<F>(span, tx0, tx1, ty0, ty1),
+				fetchTexelsSSE2(lightmap, tx20, tx21, ty20, ty21));
+
+			__m128i* target = (__m128i*)((s16*)span.Target + i);
+			_mm_storeu_si128(target, selectSSE2(mask, color, _mm_loadu_si128(target)));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+		tx0 = _mm_add_epi32(tx1, txStep);
+		tx1 = _mm_add_epi32(tx0, txStep);
+		ty0 = _mm_add_epi32(ty1, tyStep);
+		ty1 = _mm_add_epi32(ty0, tyStep);
+		tx20 = _mm_add_epi32(tx21, tx2Step);
+		tx21 = _mm_add_epi32(tx20, tx2Step);
+		ty20 = _mm_add_epi32(ty21, ty2Step);
+		ty21 = _mm_add_epi32(ty20, ty2Step);
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s16), sizeof(Z), _mm_cvtsi128_si32(z0),
+			0, 0, 0, _mm_cvtsi128_si32(tx0), _mm_cvtsi128_si32(ty0));
+		rest.Tx2 = _mm_cvtsi128_si32(tx20);
+		rest.Ty2 = _mm_cvtsi128_si32(ty20);
+		written += drawSpanScalar<Z, SPixel16, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! blends 8 pixels with 8 pixels of the target like blendPixel<SPixel16, F>()
+//! does. The alpha values are 8 16 bit lanes.
+template <u32 F>
+static _IRR_TARGET_SSE2_ inline __m128i blendSSE2(__m128i pixel, __m128i dest, __m128i alpha)
+{
+	const __m128i mask = _mm_set1_epi16(0x1F);
+
+	__m128i r = _mm_and_si128(_mm_srli_epi16(pixel, 10), mask);
+	__m128i g = _mm_and_si128(_mm_srli_epi16(pixel, 5), mask);
+	__m128i b = _mm_and_si128(pixel, mask);
+	__m128i dr = _mm_and_si128(_mm_srli_epi16(dest, 10), mask);
+	__m128i dg = _mm_and_si128(_mm_srli_epi16(dest, 5), mask);
+	__m128i db = _mm_and_si128(dest, mask);
+
+	__m128i w = _mm_srli_epi16(_mm_add_epi16(alpha, _mm_srli_epi16(alpha, 7)), 3);
+
+	if (F & ESF_BLEND_ADD)
+	{
+		if (F & ESF_BLEND_ALPHA)
+		{
+			r = _mm_srli_epi16(_mm_mullo_epi16(r, w), 5);
+			g = _mm_srli_epi16(_mm_mullo_epi16(g, w), 5);
+			b = _mm_srli_epi16(_mm_mullo_epi16(b, w), 5);
+		}
+
+		r = _mm_min_epi16(_mm_add_epi16(r, dr), mask);
+		g = _mm_min_epi16(_mm_add_epi16(g, dg), mask);
+		b = _mm_min_epi16(_mm_add_epi16(b, db), mask);
+	}
+	else
+	{
+		__m128i iw = _mm_sub_epi16(_mm_set1_epi16(32), w);
+
+		r = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(r, w), _mm_mullo_epi16(dr, iw)), 5);
+		g = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(g, w), _mm_mullo_epi16(dg, iw)), 5);
+		b = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(b, w), _mm_mullo_epi16(db, iw)), 5);
+	}
+
+	return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 10), _mm_slli_epi16(g, 5)), b);
+}
+
+
+
+//! draws a textured span blended with the target, modulated by
+//! interpolated colors and alpha values with ESF_GOURAUD
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanTextureBlendSSE2(const SSpan& span)
+{
+	if (span.TextureWidth > 0x7FFF || span.TextureYMask > 0x7FFF)
+		return drawSpanScalar<Z, SPixel16, F>(span);
+
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	const __m128i rStep = _mm_set1_epi32((u32)span.StepR * 4);
+	const __m128i gStep = _mm_set1_epi32((u32)span.StepG * 4);
+	const __m128i bStep = _mm_set1_epi32((u32)span.StepB * 4);
+	const __m128i aStep = _mm_set1_epi32((u32)span.StepA * 4);
+	const __m128i txStep = _mm_set1_epi32((u32)span.TxStep * 4);
+	const __m128i tyStep = _mm_set1_epi32((u32)span.TyStep * 4);
+	const __m128i mask8 = _mm_set1_epi16(0xFF);
+
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i r0 = rampSSE2(span.R, span.StepR);
+	__m128i g0 = rampSSE2(span.G, span.StepG);
+	__m128i b0 = rampSSE2(span.B, span.StepB);
+	__m128i a0 = rampSSE2(span.A, span.StepA);
+	__m128i tx0 = rampSSE2(span.Tx, span.TxStep);
+	__m128i ty0 = rampSSE2(span.Ty, span.TyStep);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+	__m128i r1 = _mm_add_epi32(r0, rStep);
+	__m128i g1 = _mm_add_epi32(g0, gStep);
+	__m128i b1 = _mm_add_epi32(b0, bStep);
+	__m128i a1 = _mm_add_epi32(a0, aStep);
+	__m128i tx1 = _mm_add_epi32(tx0, txStep);
+	__m128i ty1 = _mm_add_epi32(ty0, tyStep);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			__m128i texel = fetchTextureSSE2<F>(span, tx0, tx1, ty0, ty1);
+			__m128i color = texel;
+			__m128i alpha = _mm_setzero_si128();
+
+			if (F & ESF_GOURAUD)
+				color = modulateSSE2(texel, channelSSE2(r0, r1), channelSSE2(g0, g1), channelSSE2(b0, b1));
+
+			if (F & ESF_BLEND_ALPHA)
+			{
+				alpha = _mm_and_si128(_mm_srai_epi16(texel, 15), mask8);
+
+				if (F & ESF_GOURAUD)
+					alpha = _mm_srli_epi16(_mm_mullo_epi16(alpha,
+						_mm_add_epi16(_mm_and_si128(channelSSE2(a0, a1), mask8), _mm_set1_epi16(1))), 8);
+			}
+
+			__m128i* target = (__m128i*)((s16*)span.Target + i);
+			__m128i old = _mm_loadu_si128(target);
+			_mm_storeu_si128(target, selectSSE2(mask, blendSSE2<F>(color, old, alpha), old));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+		tx0 = _mm_add_epi32(tx1, txStep);
+		tx1 = _mm_add_epi32(tx0, txStep);
+		ty0 = _mm_add_epi32(ty1, tyStep);
+		ty1 = _mm_add_epi32(ty0, tyStep);
+
+		if (F & ESF_GOURAUD)
+		{
+			r0 = _mm_add_epi32(r1, rStep);
+			r1 = _mm_add_epi32(r0, rStep);
+			g0 = _mm_add_epi32(g1, gStep);
+			g1 = _mm_add_epi32(g0, gStep);
+			b0 = _mm_add_epi32(b1, bStep);
+			b1 = _mm_add_epi32(b0, bStep);
+			a0 = _mm_add_epi32(a1, aStep);
+			a1 = _mm_add_epi32(a0, aStep);
+		}
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s16), sizeof(Z), _mm_cvtsi128_si32(z0),
+			_mm_cvtsi128_si32(r0), _mm_cvtsi128_si32(g0), _mm_cvtsi128_si32(b0),
+			_mm_cvtsi128_si32(tx0), _mm_cvtsi128_si32(ty0));
+		rest.A = _mm_cvtsi128_si32(a0);
+		written += drawSpanScalar<Z, SPixel16, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! the SSE2 kernels of 16 bit targets
+struct SKernelsSSE2
+{
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<0>)
+	{
+		return drawSpanFlatSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_GOURAUD>)
+	{
+		return drawSpanGouraudSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE>)
+	{
+		return drawSpanTextureFlatSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD>)
+	{
+		return drawSpanTextureGouraudSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_LIGHTMAP>)
+	{
+		return drawSpanTextureLightmapSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ADD>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ADD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ADD>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ADD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	//! the other combinations with a lightmap or blending are only drawn by
+	//! the scalar kernels
+	template <class Z, u32 F, u32 S>
+	static TDrawSpan get(SFeatures<S>)
+	{
+		return drawSpanScalar<Z, SPixel16, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get()
+	{
+		return get<Z, F>(SFeatures<F & (ESF_GOURAUD | ESF_TEXTURE | ESF_LIGHTMAP |
+			ESF_BLEND_ADD | ESF_BLEND_ALPHA)>());
+	}
+};
+
+static SSpanKernels SSE2Kernels[EZF_COUNT];
+
+
+// SSE2 32 bit kernels, 8 pixels per iteration like the 16 bit ones. The z
+// test works on 8 16 bit lanes, the pixels are written as 2x4 32 bit lanes.
+
+//! writes 8 pixels where the 16 bit lanes of the mask are set
+static _IRR_TARGET_SSE2_ inline void store32SSE2(s32* target, __m128i mask, __m128i color0, __m128i color1)
+{
+	__m128i* t = (__m128i*)target;
+	_mm_storeu_si128(t, selectSSE2(_mm_unpacklo_epi16(mask, mask), color0, _mm_loadu_si128(t)));
+	_mm_storeu_si128(t + 1, selectSSE2(_mm_unpackhi_epi16(mask, mask), color1, _mm_loadu_si128(t + 1)));
+}
+
+
+
+//! returns 4 colors of the 8.8 fixed point channels
+static _IRR_TARGET_SSE2_ inline __m128i color32SSE2(__m128i r, __m128i g, __m128i b)
+{
+	const __m128i mask = _mm_set1_epi32(0xFF00);
+
+	return _mm_or_si128(_mm_or_si128(
+		_mm_slli_epi32(_mm_and_si128(r, mask), 8),
+		_mm_and_si128(g, mask)),
+		_mm_srli_epi32(_mm_and_si128(b, mask), 8));
+}
+
+
+
+//! loads 4 texels from their offsets, see loadTexelsSSE2()
+static _IRR_TARGET_SSE2_ inline __m128i loadTexels32SSE2(const SSpan& span, const s32* o)
+{
+	if (span.Palette)
+	{
+		const u8* i = (const u8*)span.Texture;
+		const s32* p = (const s32*)span.Palette;
+
+		return _mm_setr_epi32(p[i[o[0]]], p[i[o[1]]], p[i[o[2]]], p[i[o[3]]]);
+	}
+
+	const s32* t = (const s32*)span.Texture;
+
+	return _mm_setr_epi32(t[o[0]], t[o[1]], t[o[2]], t[o[3]]);
+}
+
+
+
+//! fetches 4 texels, see fetchTexelsSSE2()
+static _IRR_TARGET_SSE2_ inline __m128i fetchTexels32SSE2(const SSpan& span, __m128i tx, __m128i ty)
+{
+	s32 offsets[4];
+
+	__m128i o = texelOffsetsSSE2(span,
+		_mm_and_si128(_mm_srai_epi32(tx, 8), _mm_set1_epi32(span.TextureXMask)),
+		_mm_and_si128(_mm_srai_epi32(ty, 8), _mm_set1_epi32(span.TextureYMask)));
+	_mm_storeu_si128((__m128i*)offsets, o);
+
+	return loadTexels32SSE2(span, offsets);
+}
+
+
+
+//! fetches 4 texels filtered bilinearly like fetchBilinear<SPixel32>() does.
+//! The channels of 2 texels at once are multiplied with the weights in 16
+//! bit lanes, the sums of the 4 products are below 65536.
+static _IRR_TARGET_SSE2_ inline __m128i fetchBilinear32SSE2(const SSpan& span, __m128i tx, __m128i ty)
+{
+	s32 offsets[32];
+	__m128i fx, fy;
+
+	bilinearOffsetsSSE2(span, tx, ty, offsets, fx, fy);
+
+	__m128i w[4];
+	bilinearWeightsSSE2(_mm_packs_epi32(fx, fx), _mm_packs_epi32(fy, fy), w);
+
+	const __m128i zero = _mm_setzero_si128();
+
+	__m128i lo = _mm_setzero_si128();
+	__m128i hi = _mm_setzero_si128();
+
+	for (s32 j=0; j<4; ++j)
+	{
+		__m128i texel = loadTexels32SSE2(span, offsets + j*8);
+
+		// the weight of every texel for its 4 channels
+		__m128i weight = _mm_unpacklo_epi16(w[j], w[j]);
+
+		lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_unpacklo_epi8(texel, zero), _mm_unpacklo_epi32(weight, weight)));
+		hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_unpackhi_epi8(texel, zero), _mm_unpackhi_epi32(weight, weight)));
+	}
+
+	return _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+}
+
+
+
+//! fetches 4 texels of the texture, filtered if F has ESF_BILINEAR
+template <u32 F>
+static _IRR_TARGET_SSE2_ inline __m128i fetchTexture32SSE2(const SSpan& span, __m128i tx, __m128i ty)
+{
+	if (F & ESF_BILINEAR)
+		return fetchBilinear32SSE2(span, tx, ty);
+
+	return fetchTexels32SSE2(span, tx, ty);
+}
+
+
+
+//! modulates 4 texels with 4 colors like modulate32() does. The channels
+//! are multiplied in 16 bit lanes, the factor of the alpha channel is 0.
+static _IRR_TARGET_SSE2_ inline __m128i modulate32SSE2(__m128i texel, __m128i r, __m128i g, __m128i b)
+{
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i one = _mm_set1_epi32(1);
+	const __m128i zero = _mm_setzero_si128();
+
+	r = _mm_add_epi32(_mm_and_si128(_mm_srai_epi32(r, 8), mask), one);
+	g = _mm_add_epi32(_mm_and_si128(_mm_srai_epi32(g, 8), mask), one);
+	b = _mm_add_epi32(_mm_and_si128(_mm_srai_epi32(b, 8), mask), one);
+
+	__m128i bg = _mm_or_si128(b, _mm_slli_epi32(g, 16));
+
+	__m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(texel, zero), _mm_unpacklo_epi32(bg, r));
+	__m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(texel, zero), _mm_unpackhi_epi32(bg, r));
+
+	return _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+}
+
+
+
+//! draws a span with a single color
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanFlat32SSE2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m128i color = _mm_set1_epi32(span.Color & 0x00FFFFFF);
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			store32SSE2((s32*)span.Target + i, mask, color, color);
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+	}
+
+	if (i < span.Count)
+		written += drawSpanScalar<Z, SPixel32, F>(getRestOfSpan(span, i, sizeof(s32), sizeof(Z), _mm_cvtsi128_si32(z0), 0, 0, 0, 0, 0));
+
+	return written;
+}
+
+
+
+//! draws a span with interpolated colors
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanGouraud32SSE2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	const __m128i rStep = _mm_set1_epi32((u32)span.StepR * 4);
+	const __m128i gStep = _mm_set1_epi32((u32)span.StepG * 4);
+	const __m128i bStep = _mm_set1_epi32((u32)span.StepB * 4);
+
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i r0 = rampSSE2(span.R, span.StepR);
+	__m128i g0 = rampSSE2(span.G, span.StepG);
+	__m128i b0 = rampSSE2(span.B, span.StepB);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+	__m128i r1 = _mm_add_epi32(r0, rStep);
+	__m128i g1 = _mm_add_epi32(g0, gStep);
+	__m128i b1 = _mm_add_epi32(b0, bStep);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			store32SSE2((s32*)span.Target + i, mask,
+				color32SSE2(r0, g0, b0), color32SSE2(r1, g1, b1));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+		r0 = _mm_add_epi32(r1, rStep);
+		r1 = _mm_add_epi32(r0, rStep);
+		g0 = _mm_add_epi32(g1, gStep);
+		g1 = _mm_add_epi32(g0, gStep);
+		b0 = _mm_add_epi32(b1, bStep);
+		b1 = _mm_add_epi32(b0, bStep);
+	}
+
+	if (i < span.Count)
+		written += drawSpanScalar<Z, SPixel32, F>(getRestOfSpan(span, i, sizeof(s32), sizeof(Z), _mm_cvtsi128_si32(z0),
+			_mm_cvtsi128_si32(r0), _mm_cvtsi128_si32(g0), _mm_cvtsi128_si32(b0), 0, 0));
+
+	return written;
+}
+
+
+
+//! draws a textured span
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanTextureFlat32SSE2(const SSpan& span)
+{
+	if (span.TextureWidth > 0x7FFF || span.TextureYMask > 0x7FFF)
+		return drawSpanScalar<Z, SPixel32, F>(span);
+
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	const __m128i txStep = _mm_set1_epi32((u32)span.TxStep * 4);
+	const __m128i tyStep = _mm_set1_epi32((u32)span.TyStep * 4);
+
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i tx0 = rampSSE2(span.Tx, span.TxStep);
+	__m128i ty0 = rampSSE2(span.Ty, span.TyStep);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+	__m128i tx1 = _mm_add_epi32(tx0, txStep);
+	__m128i ty1 = _mm_add_epi32(ty0, tyStep);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			store32SSE2((s32*)span.Target + i, mask,
+				fetchTexture32SSE2<F>(span, tx0, ty0), fetchTexture32SSE2<F>(span, tx1, ty1));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+		tx0 = _mm_add_epi32(tx1, txStep);
+		tx1 = _mm_add_epi32(tx0, txStep);
+		ty0 = _mm_add_epi32(ty1, tyStep);
+		ty1 = _mm_add_epi32(ty0, tyStep);
+	}
+
+	if (i < span.Count)
+		written += drawSpanScalar<Z, SPixel32, F>(getRestOfSpan(span, i, sizeof(s32), sizeof(Z), _mm_cvtsi128_si32(z0),
+			0, 0, 0, _mm_cvtsi128_si32(tx0), _mm_cvtsi128_si32(ty0)));
+
+	return written;
+}
+
+
+
+//! draws a textured span modulated by interpolated colors
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanTextureGouraud32SSE2(const SSpan& span)
+{
+	if (span.TextureWidth > 0x7FFF || span.TextureYMask > 0x7FFF)
+		return drawSpanScalar<Z, SPixel32, F>(span);
+
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	const __m128i rStep = _mm_set1_epi32((u32)span.StepR * 4);
+	const __m128i gStep = _mm_set1_epi32((u32)span.StepG * 4);
+	const __m128i bStep = _mm_set1_epi32((u32)span.StepB * 4);
+	const __m128i txStep = _mm_set1_epi32((u32)span.TxStep * 4);
+	const __m128i tyStep = _mm_set1_epi32((u32)span.TyStep * 4);
+
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i r0 = rampSSE2(span.R, span.StepR);
+	__m128i g0 = rampSSE2(span.G, span.StepG);
+	__m128i b0 = rampSSE2(span.B, span.StepB);
+	__m128i tx0 = rampSSE2(span.Tx, span.TxStep);
+	__m128i ty0 = rampSSE2(span.Ty, span.TyStep);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+	__m128i r1 = _mm_add_epi32(r0, rStep);
+	__m128i g1 = _mm_add_epi32(g0, gStep);
+	__m128i b1 = _mm_add_epi32(b0, bStep);
+	__m128i tx1 = _mm_add_epi32(tx0, txStep);
+	__m128i ty1 = _mm_add_epi32(ty0, tyStep);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			store32SSE2((s32*)span.Target + i, mask,
+				modulate32SSE2(fetchTexture32SSE2<F>(span, tx0, ty0), r0, g0, b0),
+				modulate32SSE2(fetchTexture32SSE2<F>(span, tx1, ty1), r1, g1, b1));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+		r0 = _mm_add_epi32(r1, rStep);
+		r1 = _mm_add_epi32(r0, rStep);
+		g0 = _mm_add_epi32(g1, gStep);
+		g1 = _mm_add_epi32(g0, gStep);
+		b0 = _mm_add_epi32(b1, bStep);
+		b1 = _mm_add_epi32(b0, bStep);
+		tx0 = _mm_add_epi32(tx1, txStep);
+		tx1 = _mm_add_epi32(tx0, txStep);
+		ty0 = _mm_add_epi32(ty1, tyStep);
+		ty1 = _mm_add_epi32(ty0, tyStep);
+	}
+
+	if (i < span.Count)
+		written += drawSpanScalar<Z, SPixel32, F>(getRestOfSpan(span, i, sizeof(s32), sizeof(Z), _mm_cvtsi128_si32(z0),
+			_mm_cvtsi128_si32(r0), _mm_cvtsi128_si32(g0), _mm_cvtsi128_si32(b0),
+			_mm_cvtsi128_si32(tx0), _mm_cvtsi128_si32(ty0)));
+
+	return written;
+}
+
+
+
+//! modulates 4 pixels with 4 lightmap texels like SPixel32::lightmap() does.
+//! The products are saturated by the pack, the alpha channel is cleared.
+static _IRR_TARGET_SSE2_ inline __m128i lightmap32SSE2(__m128i pixel, __m128i light)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	__m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(pixel, zero), _mm_unpacklo_epi8(light, zero));
+	__m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(pixel, zero), _mm_unpackhi_epi8(light, zero));
+
+	return _mm_and_si128(_mm_packus_epi16(_mm_srli_epi16(lo, 6), _mm_srli_epi16(hi, 6)),
+		_mm_set1_epi32(0x00FFFFFF));
+}
+
+
+
+//! draws a textured span modulated by the lightmap
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanTextureLightmap32SSE2(const SSpan& span)
+{
+	if (span.TextureWidth > 0x7FFF || span.TextureYMask > 0x7FFF ||
+		span.Texture2Width > 0x7FFF || span.Texture2YMask > 0x7FFF)
+		return drawSpanScalar<Z, SPixel32, F>(span);
+
+	s32 written = 0;
+	s32 i = 0;
+
+	const SSpan lightmap = getLightmapLayer(span);
+
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	const __m128i txStep = _mm_set1_epi32((u32)span.TxStep * 4);
+	const __m128i tyStep = _mm_set1_epi32((u32)span.TyStep * 4);
+	const __m128i tx2Step = _mm_set1_epi32((u32)span.Tx2Step * 4);
+	const __m128i ty2Step = _mm_set1_epi32((u32)span.Ty2Step * 4);
+
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i tx0 = rampSSE2(span.Tx, span.TxStep);
+	__m128i ty0 = rampSSE2(span.Ty, span.TyStep);
+	__m128i tx20 = rampSSE2(span.Tx2, span.Tx2Step);
+	__m128i ty20 = rampSSE2(span.Ty2, span.Ty2Step);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+	__m128i tx1 = _mm_add_epi32(tx0, txStep);
+	__m128i ty1 = _mm_add_epi32(ty0, tyStep);
+	__m128i tx21 = _mm_add_epi32(tx20, tx2Step);
+	__m128i ty21 = _mm_add_epi32(ty20, ty2Step);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			store32SSE2((s32*)span.Target + i, mask,
+				lightmap32SSE2(fetchTexture32SSE2<F>(span, tx0, ty0), fetchTexels32SSE2(lightmap, tx20, ty20)),
+				lightmap32SSE2(fetchTexture32SSE2<F>(span, tx1, ty1), fetchTexels32SSE2(lightmap, tx21, ty21)));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+		tx0 = _mm_add_epi32(tx1, txStep);
+		tx1 = _mm_add_epi32(tx0, txStep);
+		ty0 = _mm_add_epi32(ty1, tyStep);
+		ty1 = _mm_add_epi32(ty0, tyStep);
+		tx20 = _mm_add_epi32(tx21, tx2Step);
+		tx21 = _mm_add_epi32(tx20, tx2Step);
+		ty20 = _mm_add_epi32(ty21, ty2Step);
+		ty21 = _mm_add_epi32(ty20, ty2Step);
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s32), sizeof(Z), _mm_cvtsi128_si32(z0),
+			0, 0, 0, _mm_cvtsi128_si32(tx0), _mm_cvtsi128_si32(ty0));
+		rest.Tx2 = _mm_cvtsi128_si32(tx20);
+		rest.Ty2 = _mm_cvtsi128_si32(ty20);
+		written += drawSpanScalar<Z, SPixel32, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! blends 4 pixels with 4 pixels of the target like blendPixel<SPixel32, F>()
+//! does. The channels are mixed in 16 bit lanes, the alpha values are 4 32
+//! bit lanes and the alpha channel of the result is cleared.
+template <u32 F>
+static _IRR_TARGET_SSE2_ inline __m128i blend32SSE2(__m128i pixel, __m128i dest, __m128i alpha)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	// the weight of every pixel in the 4 16 bit lanes of its channels
+	__m128i w = _mm_add_epi32(alpha, _mm_srli_epi32(alpha, 7));
+	w = _mm_or_si128(w, _mm_slli_epi32(w, 16));
+	__m128i wlo = _mm_unpacklo_epi32(w, w);
+	__m128i whi = _mm_unpackhi_epi32(w, w);
+
+	__m128i lo = _mm_unpacklo_epi8(pixel, zero);
+	__m128i hi = _mm_unpackhi_epi8(pixel, zero);
+	__m128i result;
+
+	if (F & ESF_BLEND_ADD)
+	{
+		if (F & ESF_BLEND_ALPHA)
+			pixel = _mm_packus_epi16(_mm_srli_epi16(_mm_mullo_epi16(lo, wlo), 8),
+				_mm_srli_epi16(_mm_mullo_epi16(hi, whi), 8));
+
+		result = _mm_adds_epu8(pixel, dest);
+	}
+	else
+	{
+		const __m128i full = _mm_set1_epi16(256);
+
+		lo = _mm_add_epi16(_mm_mullo_epi16(lo, wlo),
+			_mm_mullo_epi16(_mm_unpacklo_epi8(dest, zero), _mm_sub_epi16(full, wlo)));
+		hi = _mm_add_epi16(_mm_mullo_epi16(hi, whi),
+			_mm_mullo_epi16(_mm_unpackhi_epi8(dest, zero), _mm_sub_epi16(full, whi)));
+
+		result = _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+	}
+
+	return _mm_and_si128(result, _mm_set1_epi32(0x00FFFFFF));
+}
+
+
+
+//! returns the alpha values of 4 texels as 32 bit lanes, modulated by the
+//! interpolated alpha values with ESF_GOURAUD
+template <u32 F>
+static _IRR_TARGET_SSE2_ inline __m128i alpha32SSE2(__m128i texel, __m128i a)
+{
+	__m128i alpha = _mm_srli_epi32(texel, 24);
+
+	if (F & ESF_GOURAUD)
+		alpha = _mm_srli_epi32(_mm_madd_epi16(alpha,
+			_mm_add_epi32(_mm_and_si128(_mm_srai_epi32(a, 8), _mm_set1_epi32(0xFF)), _mm_set1_epi32(1))), 8);
+
+	return alpha;
+}
+
+
+
+//! draws a textured span blended with the target, modulated by
+//! interpolated colors and alpha values with ESF_GOURAUD
+template <class Z, u32 F>
+static _IRR_TARGET_SSE2_ s32 drawSpanTextureBlend32SSE2(const SSpan& span)
+{
+	if (span.TextureWidth > 0x7FFF || span.TextureYMask > 0x7FFF)
+		return drawSpanScalar<Z, SPixel32, F>(span);
+
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m128i zStep = _mm_set1_epi32((u32)span.ZStep * 4);
+	const __m128i rStep = _mm_set1_epi32((u32)span.StepR * 4);
+	const __m128i gStep = _mm_set1_epi32((u32)span.StepG * 4);
+	const __m128i bStep = _mm_set1_epi32((u32)span.StepB * 4);
+	const __m128i aStep = _mm_set1_epi32((u32)span.StepA * 4);
+	const __m128i txStep = _mm_set1_epi32((u32)span.TxStep * 4);
+	const __m128i tyStep = _mm_set1_epi32((u32)span.TyStep * 4);
+
+	__m128i z0 = rampSSE2(span.ZValue, span.ZStep);
+	__m128i r0 = rampSSE2(span.R, span.StepR);
+	__m128i g0 = rampSSE2(span.G, span.StepG);
+	__m128i b0 = rampSSE2(span.B, span.StepB);
+	__m128i a0 = rampSSE2(span.A, span.StepA);
+	__m128i tx0 = rampSSE2(span.Tx, span.TxStep);
+	__m128i ty0 = rampSSE2(span.Ty, span.TyStep);
+	__m128i z1 = _mm_add_epi32(z0, zStep);
+	__m128i r1 = _mm_add_epi32(r0, rStep);
+	__m128i g1 = _mm_add_epi32(g0, gStep);
+	__m128i b1 = _mm_add_epi32(b0, bStep);
+	__m128i a1 = _mm_add_epi32(a0, aStep);
+	__m128i tx1 = _mm_add_epi32(tx0, txStep);
+	__m128i ty1 = _mm_add_epi32(ty0, tyStep);
+
+	for (; i+8 <= span.Count; i += 8)
+	{
+		__m128i mask = zTestSSE2<F>((Z*)span.ZTarget + i, z0, z1);
+		s32 bits = _mm_movemask_epi8(mask);
+
+		if (bits)
+		{
+			__m128i texel0 = fetchTexture32SSE2<F>(span, tx0, ty0);
+			__m128i texel1 = fetchTexture32SSE2<F>(span, tx1, ty1);
+			__m128i color0 = texel0;
+			__m128i color1 = texel1;
+			__m128i alpha0 = _mm_setzero_si128();
+			__m128i alpha1 = _mm_setzero_si128();
+
+			if (F & ESF_GOURAUD)
+			{
+				color0 = modulate32SSE2(texel0, r0, g0, b0);
+				color1 = modulate32SSE2(texel1, r1, g1, b1);
+			}
+
+			if (F & ESF_BLEND_ALPHA)
+			{
+				alpha0 = alpha32SSE2<F>(texel0, a0);
+				alpha1 = alpha32SSE2<F>(texel1, a1);
+			}
+
+			s32* target = (s32*)span.Target + i;
+			store32SSE2(target, mask,
+				blend32SSE2<F>(color0, _mm_loadu_si128((const __m128i*)target), alpha0),
+				blend32SSE2<F>(color1, _mm_loadu_si128((const __m128i*)(target + 4)), alpha1));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm_add_epi32(z1, zStep);
+		z1 = _mm_add_epi32(z0, zStep);
+		tx0 = _mm_add_epi32(tx1, txStep);
+		tx1 = _mm_add_epi32(tx0, txStep);
+		ty0 = _mm_add_epi32(ty1, tyStep);
+		ty1 = _mm_add_epi32(ty0, tyStep);
+
+		if (F & ESF_GOURAUD)
+		{
+			r0 = _mm_add_epi32(r1, rStep);
+			r1 = _mm_add_epi32(r0, rStep);
+			g0 = _mm_add_epi32(g1, gStep);
+			g1 = _mm_add_epi32(g0, gStep);
+			b0 = _mm_add_epi32(b1, bStep);
+			b1 = _mm_add_epi32(b0, bStep);
+			a0 = _mm_add_epi32(a1, aStep);
+			a1 = _mm_add_epi32(a0, aStep);
+		}
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s32), sizeof(Z), _mm_cvtsi128_si32(z0),
+			_mm_cvtsi128_si32(r0), _mm_cvtsi128_si32(g0), _mm_cvtsi128_si32(b0),
+			_mm_cvtsi128_si32(tx0), _mm_cvtsi128_si32(ty0));
+		rest.A = _mm_cvtsi128_si32(a0);
+		written += drawSpanScalar<Z, SPixel32, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! the SSE2 kernels of 32 bit targets
+struct SKernels32SSE2
+{
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<0>)
+	{
+		return drawSpanFlat32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_GOURAUD>)
+	{
+		return drawSpanGouraud32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE>)
+	{
+		return drawSpanTextureFlat32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD>)
+	{
+		return drawSpanTextureGouraud32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_LIGHTMAP>)
+	{
+		return drawSpanTextureLightmap32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ADD>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ADD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ADD>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ADD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	//! the other combinations with a lightmap or blending are only drawn by
+	//! the scalar kernels
+	template <class Z, u32 F, u32 S>
+	static TDrawSpan get(SFeatures<S>)
+	{
+		return drawSpanScalar<Z, SPixel32, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get()
+	{
+		return get<Z, F>(SFeatures<F & (ESF_GOURAUD | ESF_TEXTURE | ESF_LIGHTMAP |
+			ESF_BLEND_ADD | ESF_BLEND_ALPHA)>());
+	}
+};
+
+static SSpanKernels SSE2Kernels32[EZF_COUNT];
+
+
+
+// AVX2 kernels, 16 pixels per iteration in two registers of 8 32 bit lanes.
+// Packing works inside the 128 bit halves of the registers, so the 16 bit
+// results are permuted back into order. The rest of a span is drawn by the
+// SSE2 kernels. They are not VEX encoded, so the upper halves of the ymm
+// registers are cleared before they are called, the compiler does not do
+// this for calls to functions of another target.
+
+//! returns 8 lanes of a linear interpolation
+static _IRR_TARGET_AVX2_ inline __m256i rampAVX2(u32 value, u32 step)
+{
+	return _mm256_setr_epi32(value, value + step, value + step*2, value + step*3,
+		value + step*4, value + step*5, value + step*6, value + step*7);
+}
+
+
+
+//! casts 2x8 32 bit lanes to 16 16 bit lanes
+static _IRR_TARGET_AVX2_ inline __m256i truncateAVX2(__m256i a, __m256i b)
+{
+	a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+	b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+	return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+}
+
+
+
+//! z test and z write of 16 pixels as far as the features F enable them,
+//! returns the mask of the pixels which passed.
+template <u32 F>
+static _IRR_TARGET_AVX2_ inline __m256i zTestAVX2(s16* zTarget, __m256i z0, __m256i z1)
+{
+	if (F & ESF_NO_ZTEST)
+		return _mm256_set1_epi32(-1);
+
+	__m256i old = _mm256_loadu_si256((const __m256i*)zTarget);
+	__m256i old0 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)zTarget));
+	__m256i old1 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(zTarget + 8)));
+
+	__m256i mask = _mm256_permute4x64_epi64(_mm256_packs_epi32(
+		_mm256_cmpgt_epi32(z0, old0), _mm256_cmpgt_epi32(z1, old1)), 0xD8);
+
+	if (!(F & ESF_NO_ZWRITE))
+		_mm256_storeu_si256((__m256i*)zTarget, _mm256_blendv_epi8(old, truncateAVX2(z0, z1), mask));
+	return mask;
+}
+
+
+
+//! z test and z write of 16 pixels with 32 bit z values, returns the
+//! mask of the pixels which passed as 16 16 bit lanes.
+template <u32 F>
+static _IRR_TARGET_AVX2_ inline __m256i zTestAVX2(s32* zTarget, __m256i z0, __m256i z1)
+{
+	if (F & ESF_NO_ZTEST)
+		return _mm256_set1_epi32(-1);
+
+	__m256i old0 = _mm256_loadu_si256((const __m256i*)zTarget);
+	__m256i old1 = _mm256_loadu_si256((const __m256i*)(zTarget + 8));
+
+	__m256i mask0 = _mm256_cmpgt_epi32(z0, old0);
+	__m256i mask1 = _mm256_cmpgt_epi32(z1, old1);
+
+	if (!(F & ESF_NO_ZWRITE))
+	{
+		_mm256_storeu_si256((__m256i*)zTarget, _mm256_blendv_epi8(old0, z0, mask0));
+		_mm256_storeu_si256((__m256i*)(zTarget + 8), _mm256_blendv_epi8(old1, z1, mask1));
+	}
+	return _mm256_permute4x64_epi64(_mm256_packs_epi32(mask0, mask1), 0xD8);
+}
+
+
+
+//! returns 16 color channels (value>>8) as 16 bit lanes
+static _IRR_TARGET_AVX2_ inline __m256i channelAVX2(__m256i c0, __m256i c1)
+{
+	return truncateAVX2(_mm256_srai_epi32(c0, 8), _mm256_srai_epi32(c1, 8));
+}
+
+
+
+//! returns the offsets of 8 texels like getTexelOffset() does
+static _IRR_TARGET_AVX2_ inline __m256i texelOffsetsAVX2(const SSpan& span, __m256i x, __m256i y)
+{
+	const __m256i width = _mm256_set1_epi32(span.TextureWidth);
+
+	if (!span.TextureTiled)
+		return _mm256_add_epi32(_mm256_mullo_epi32(y, width), x);
+
+	const __m256i low = _mm256_set1_epi32(3);
+
+	return _mm256_add_epi32(
+		_mm256_add_epi32(_mm256_mullo_epi32(_mm256_andnot_si256(low, y), width), _mm256_slli_epi32(_mm256_andnot_si256(low, x), 2)),
+		_mm256_add_epi32(_mm256_slli_epi32(_mm256_and_si256(y, low), 2), _mm256_and_si256(x, low)));
+}
+
+
+
+//! fetches 16 texels. The gather instruction only loads 32 bit values and
+//! would read behind the end of the texture, so the texels are loaded one by one.
+static _IRR_TARGET_AVX2_ inline __m256i fetchTexelsAVX2(const SSpan& span, __m256i tx0, __m256i tx1, __m256i ty0, __m256i ty1)
+{
+	const __m256i xMask = _mm256_set1_epi32(span.TextureXMask);
+	const __m256i yMask = _mm256_set1_epi32(span.TextureYMask);
+
+	s32 offsets[16];
+
+	__m256i o = texelOffsetsAVX2(span,
+		_mm256_and_si256(_mm256_srai_epi32(tx0, 8), xMask),
+		_mm256_and_si256(_mm256_srai_epi32(ty0, 8), yMask));
+	_mm256_storeu_si256((__m256i*)offsets, o);
+
+	o = texelOffsetsAVX2(span,
+		_mm256_and_si256(_mm256_srai_epi32(tx1, 8), xMask),
+		_mm256_and_si256(_mm256_srai_epi32(ty1, 8), yMask));
+	_mm256_storeu_si256((__m256i*)(offsets + 8), o);
+
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(loadTexelsSSE2(span, offsets)),
+		loadTexelsSSE2(span, offsets + 8), 1);
+}
+
+
+
+//! modulates 16 texels with 16 colors, see modulateSSE2()
+static _IRR_TARGET_AVX2_ inline __m256i modulateAVX2(__m256i texel, __m256i r, __m256i g, __m256i b)
+{
+	const __m256i mask = _mm256_set1_epi16(0x1F);
+
+	__m256i pr = _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(texel, 10), mask), r);
+	__m256i pg = _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(texel, 5), mask), g);
+	__m256i pb = _mm256_mullo_epi16(_mm256_and_si256(texel, mask), b);
+
+	return _mm256_or_si256(_mm256_or_si256(
+		_mm256_and_si256(_mm256_slli_epi16(pr, 5), _mm256_set1_epi16(0x1F<<10)),
+		_mm256_and_si256(pg, _mm256_set1_epi16(0x1F<<5))),
+		_mm256_and_si256(_mm256_srli_epi16(pb, 5), mask));
+}
+
+
+
+//! draws a span with a single color
+template <class Z, u32 F>
+static _IRR_TARGET_AVX2_ s32 drawSpanFlatAVX2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m256i color = _mm256_set1_epi16(X8R8G8B8toA1R5G5B5(span.Color));
+	const __m256i zStep = _mm256_set1_epi32((u32)span.ZStep * 8);
+	__m256i z0 = rampAVX2(span.ZValue, span.ZStep);
+	__m256i z1 = _mm256_add_epi32(z0, zStep);
+
+	for (; i+16 <= span.Count; i += 16)
+	{
+		__m256i mask = zTestAVX2<F>((Z*)span.ZTarget + i, z0, z1);
+		u32 bits = _mm256_movemask_epi8(mask);
+
+		if (bits)
+		{
+			__m256i* target = (__m256i*)((s16*)span.Target + i);
+			_mm256_storeu_si256(target, _mm256_blendv_epi8(_mm256_loadu_si256(target), color, mask));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm256_add_epi32(z1, zStep);
+		z1 = _mm256_add_epi32(z0, zStep);
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s16), sizeof(Z),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(z0)), 0, 0, 0, 0, 0);
+		_mm256_zeroupper();
+		written += drawSpanFlatSSE2<Z, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! draws a span with interpolated colors
+template <class Z, u32 F>
+static _IRR_TARGET_AVX2_ s32 drawSpanGouraudAVX2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m256i zStep = _mm256_set1_epi32((u32)span.ZStep * 8);
+	const __m256i rStep = _mm256_set1_epi32((u32)span.StepR * 8);
+	const __m256i gStep = _mm256_set1_epi32((u32)span.StepG * 8);
+	const __m256i bStep = _mm256_set1_epi32((u32)span.StepB * 8);
+	const __m256i mask5 = _mm256_set1_epi16(0x1F);
+
+	__m256i z0 = rampAVX2(span.ZValue, span.ZStep);
+	__m256i r0 = rampAVX2(span.R, span.StepR);
+	__m256i g0 = rampAVX2(span.G, span.StepG);
+	__m256i b0 = rampAVX2(span.B, span.StepB);
+	__m256i z1 = _mm256_add_epi32(z0, zStep);
+	__m256i r1 = _mm256_add_epi32(r0, rStep);
+	__m256i g1 = _mm256_add_epi32(g0, gStep);
+	__m256i b1 = _mm256_add_epi32(b0, bStep);
+
+	for (; i+16 <= span.Count; i += 16)
+	{
+		__m256i mask = zTestAVX2<F>((Z*)span.ZTarget + i, z0, z1);
+		u32 bits = _mm256_movemask_epi8(mask);
+
+		if (bits)
+		{
+			__m256i color = _mm256_or_si256(_mm256_or_si256(
+				_mm256_slli_epi16(_mm256_and_si256(channelAVX2(r0, r1), mask5), 10),
+				_mm256_slli_epi16(_mm256_and_si256(channelAVX2(g0, g1), mask5), 5)),
+				_mm256_and_si256(channelAVX2(b0, b1), mask5));
+
+			__m256i* target = (__m256i*)((s16*)span.Target + i);
+			_mm256_storeu_si256(target, _mm256_blendv_epi8(_mm256_loadu_si256(target), color, mask));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm256_add_epi32(z1, zStep);
+		z1 = _mm256_add_epi32(z0, zStep);
+		r0 = _mm256_add_epi32(r1, rStep);
+		r1 = _mm256_add_epi32(r0, rStep);
+		g0 = _mm256_add_epi32(g1, gStep);
+		g1 = _mm256_add_epi32(g0, gStep);
+		b0 = _mm256_add_epi32(b1, bStep);
+		b1 = _mm256_add_epi32(b0, bStep);
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s16), sizeof(Z),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(z0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(r0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(g0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(b0)), 0, 0);
+		_mm256_zeroupper();
+		written += drawSpanGouraudSSE2<Z, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! draws a textured span
+template <class Z, u32 F>
+static _IRR_TARGET_AVX2_ s32 drawSpanTextureFlatAVX2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m256i zStep = _mm256_set1_epi32((u32)span.ZStep * 8);
+	const __m256i txStep = _mm256_set1_epi32((u32)span.TxStep * 8);
+	const __m256i tyStep = _mm256_set1_epi32((u32)span.TyStep * 8);
+
+	__m256i z0 = rampAVX2(span.ZValue, span.ZStep);
+	__m256i tx0 = rampAVX2(span.Tx, span.TxStep);
+	__m256i ty0 = rampAVX2(span.Ty, span.TyStep);
+	__m256i z1 = _mm256_add_epi32(z0, zStep);
+	__m256i tx1 = _mm256_add_epi32(tx0, txStep);
+	__m256i ty1 = _mm256_add_epi32(ty0, tyStep);
+
+	for (; i+16 <= span.Count; i += 16)
+	{
+		__m256i mask = zTestAVX2<F>((Z*)span.ZTarget + i, z0, z1);
+		u32 bits = _mm256_movemask_epi8(mask);
+
+		if (bits)
+		{
+			__m256i color = fetchTexelsAVX2(span, tx0, tx1, ty0, ty1);
+
+			__m256i* target = (__m256i*)((s16*)span.Target + i);
+			_mm256_storeu_si256(target, _mm256_blendv_epi8(_mm256_loadu_si256(target), color, mask));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm256_add_epi32(z1, zStep);
+		z1 = _mm256_add_epi32(z0, zStep);
+		tx0 = _mm256_add_epi32(tx1, txStep);
+		tx1 = _mm256_add_epi32(tx0, txStep);
+		ty0 = _mm256_add_epi32(ty1, tyStep);
+		ty1 = _mm256_add_epi32(ty0, tyStep);
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s16), sizeof(Z),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(z0)), 0, 0, 0,
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(tx0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(ty0)));
+		_mm256_zeroupper();
+		written += drawSpanTextureFlatSSE2<Z, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! draws a textured span modulated by interpolated colors
+template <class Z, u32 F>
+static _IRR_TARGET_AVX2_ s32 drawSpanTextureGouraudAVX2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m256i zStep = _mm256_set1_epi32((u32)span.ZStep * 8);
+	const __m256i rStep = _mm256_set1_epi32((u32)span.StepR * 8);
+	const __m256i gStep = _mm256_set1_epi32((u32)span.StepG * 8);
+	const __m256i bStep = _mm256_set1_epi32((u32)span.StepB * 8);
+	const __m256i txStep = _mm256_set1_epi32((u32)span.TxStep * 8);
+	const __m256i tyStep = _mm256_set1_epi32((u32)span.TyStep * 8);
+
+	__m256i z0 = rampAVX2(span.ZValue, span.ZStep);
+	__m256i r0 = rampAVX2(span.R, span.StepR);
+	__m256i g0 = rampAVX2(span.G, span.StepG);
+	__m256i b0 = rampAVX2(span.B, span.StepB);
+	__m256i tx0 = rampAVX2(span.Tx, span.TxStep);
+	__m256i ty0 = rampAVX2(span.Ty, span.TyStep);
+	__m256i z1 = _mm256_add_epi32(z0, zStep);
+	__m256i r1 = _mm256_add_epi32(r0, rStep);
+	__m256i g1 = _mm256_add_epi32(g0, gStep);
+	__m256i b1 = _mm256_add_epi32(b0, bStep);
+	__m256i tx1 = _mm256_add_epi32(tx0, txStep);
+	__m256i ty1 = _mm256_add_epi32(ty0, tyStep);
+
+	for (; i+16 <= span.Count; i += 16)
+	{
+		__m256i mask = zTestAVX2<F>((Z*)span.ZTarget + i, z0, z1);
+		u32 bits = _mm256_movemask_epi8(mask);
+
+		if (bits)
+		{
+			__m256i color = modulateAVX2(fetchTexelsAVX2(span, tx0, tx1, ty0, ty1),
+				channelAVX2(r0, r1), channelAVX2(g0, g1), channelAVX2(b0, b1));
+
+			__m256i* target = (__m256i*)((s16*)span.Target + i);
+			_mm256_storeu_si256(target, _mm256_blendv_epi8(_mm256_loadu_si256(target), color, mask));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm256_add_epi32(z1, zStep);
+		z1 = _mm256_add_epi32(z0, zStep);
+		r0 = _mm256_add_epi32(r1, rStep);
+		r1 = _mm256_add_epi32(r0, rStep);
+		g0 = _mm256_add_epi32(g1, gStep);
+		g1 = _mm256_add_epi32(g0, gStep);
+		b0 = _mm256_add_epi32(b1, bStep);
+		b1 = _mm256_add_epi32(b0, bStep);
+		tx0 = _mm256_add_epi32(tx1, txStep);
+		tx1 = _mm256_add_epi32(tx0, txStep);
+		ty0 = _mm256_add_epi32(ty1, tyStep);
+		ty1 = _mm256_add_epi32(ty0, tyStep);
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s16), sizeof(Z),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(z0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(r0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(g0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(b0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(tx0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(ty0)));
+		_mm256_zeroupper();
+		written += drawSpanTextureGouraudSSE2<Z, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! the AVX2 kernels of 16 bit targets
+struct SKernelsAVX2
+{
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<0>)
+	{
+		return drawSpanFlatAVX2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_GOURAUD>)
+	{
+		return drawSpanGouraudAVX2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE>)
+	{
+		return drawSpanTextureFlatAVX2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD>)
+	{
+		return drawSpanTextureGouraudAVX2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_LIGHTMAP>)
+	{
+		return drawSpanTextureLightmapSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ADD>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ADD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ADD>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ADD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlendSSE2<Z, F>;
+	}
+
+	//! the other combinations with a lightmap or blending are only drawn by
+	//! the scalar kernels
+	template <class Z, u32 F, u32 S>
+	static TDrawSpan get(SFeatures<S>)
+	{
+		return drawSpanScalar<Z, SPixel16, F>;
+	}
+
+	//! bilinear filtering is drawn by the SSE2 kernels, the texels are
+	//! fetched one by one either way.
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_BILINEAR>)
+	{
+		return SKernelsSSE2::get<Z, F>();
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get()
+	{
+		return get<Z, F>(SFeatures<(F & ESF_TEXTURE) && (F & ESF_BILINEAR) ? ESF_BILINEAR :
+			F & (ESF_GOURAUD | ESF_TEXTURE | ESF_LIGHTMAP | ESF_BLEND_ADD | ESF_BLEND_ALPHA)>());
+	}
+};
+
+static SSpanKernels AVX2Kernels[EZF_COUNT];
+
+
+// AVX2 32 bit kernels, 16 pixels per iteration. The 32 bit texels can be
+// loaded with the gather instruction.
+
+//! writes 16 pixels where the 16 bit lanes of the mask are set
+static _IRR_TARGET_AVX2_ inline void store32AVX2(s32* target, __m256i mask, __m256i color0, __m256i color1)
+{
+	__m256i* t = (__m256i*)target;
+	__m256i mask0 = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(mask));
+	__m256i mask1 = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(mask, 1));
+	_mm256_storeu_si256(t, _mm256_blendv_epi8(_mm256_loadu_si256(t), color0, mask0));
+	_mm256_storeu_si256(t + 1, _mm256_blendv_epi8(_mm256_loadu_si256(t + 1), color1, mask1));
+}
+
+
+
+//! returns 8 colors of the 8.8 fixed point channels
+static _IRR_TARGET_AVX2_ inline __m256i color32AVX2(__m256i r, __m256i g, __m256i b)
+{
+	const __m256i mask = _mm256_set1_epi32(0xFF00);
+
+	return _mm256_or_si256(_mm256_or_si256(
+		_mm256_slli_epi32(_mm256_and_si256(r, mask), 8),
+		_mm256_and_si256(g, mask)),
+		_mm256_srli_epi32(_mm256_and_si256(b, mask), 8));
+}
+
+
+
+//! fetches 8 texels
+static _IRR_TARGET_AVX2_ inline __m256i fetchTexels32AVX2(const SSpan& span, __m256i tx, __m256i ty)
+{
+	__m256i o = texelOffsetsAVX2(span,
+		_mm256_and_si256(_mm256_srai_epi32(tx, 8), _mm256_set1_epi32(span.TextureXMask)),
+		_mm256_and_si256(_mm256_srai_epi32(ty, 8), _mm256_set1_epi32(span.TextureYMask)));
+
+	if (span.Palette)
+	{
+		// the indices are loaded one by one, a gather of 32 bit values
+		// would read behind the end of the texture
+		s32 offsets[8];
+		_mm256_storeu_si256((__m256i*)offsets, o);
+
+		const u8* i = (const u8*)span.Texture;
+		o = _mm256_setr_epi32(i[offsets[0]], i[offsets[1]], i[offsets[2]], i[offsets[3]],
+			i[offsets[4]], i[offsets[5]], i[offsets[6]], i[offsets[7]]);
+
+		return _mm256_i32gather_epi32((const int*)span.Palette, o, 4);
+	}
+
+	return _mm256_i32gather_epi32((const int*)span.Texture, o, 4);
+}
+
+
+
+//! modulates 8 texels with 8 colors, see modulate32SSE2()
+static _IRR_TARGET_AVX2_ inline __m256i modulate32AVX2(__m256i texel, __m256i r, __m256i g, __m256i b)
+{
+	const __m256i mask = _mm256_set1_epi32(0xFF);
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i zero = _mm256_setzero_si256();
+
+	r = _mm256_add_epi32(_mm256_and_si256(_mm256_srai_epi32(r, 8), mask), one);
+	g = _mm256_add_epi32(_mm256_and_si256(_mm256_srai_epi32(g, 8), mask), one);
+	b = _mm256_add_epi32(_mm256_and_si256(_mm256_srai_epi32(b, 8), mask), one);
+
+	__m256i bg = _mm256_or_si256(b, _mm256_slli_epi32(g, 16));
+
+	// the unpack and pack instructions work inside the 128 bit halves, so
+	// the pixels come out in order again.
+	__m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(texel, zero), _mm256_unpacklo_epi32(bg, r));
+	__m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(texel, zero), _mm256_unpackhi_epi32(bg, r));
+
+	return _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8));
+}
+
+
+
+//! draws a span with a single color
+template <class Z, u32 F>
+static _IRR_TARGET_AVX2_ s32 drawSpanFlat32AVX2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m256i color = _mm256_set1_epi32(span.Color & 0x00FFFFFF);
+	const __m256i zStep = _mm256_set1_epi32((u32)span.ZStep * 8);
+	__m256i z0 = rampAVX2(span.ZValue, span.ZStep);
+	__m256i z1 = _mm256_add_epi32(z0, zStep);
+
+	for (; i+16 <= span.Count; i += 16)
+	{
+		__m256i mask = zTestAVX2<F>((Z*)span.ZTarget + i, z0, z1);
+		u32 bits = _mm256_movemask_epi8(mask);
+
+		if (bits)
+		{
+			store32AVX2((s32*)span.Target + i, mask, color, color);
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm256_add_epi32(z1, zStep);
+		z1 = _mm256_add_epi32(z0, zStep);
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s32), sizeof(Z),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(z0)), 0, 0, 0, 0, 0);
+		_mm256_zeroupper();
+		written += drawSpanFlat32SSE2<Z, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! draws a span with interpolated colors
+template <class Z, u32 F>
+static _IRR_TARGET_AVX2_ s32 drawSpanGouraud32AVX2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m256i zStep = _mm256_set1_epi32((u32)span.ZStep * 8);
+	const __m256i rStep = _mm256_set1_epi32((u32)span.StepR * 8);
+	const __m256i gStep = _mm256_set1_epi32((u32)span.StepG * 8);
+	const __m256i bStep = _mm256_set1_epi32((u32)span.StepB * 8);
+
+	__m256i z0 = rampAVX2(span.ZValue, span.ZStep);
+	__m256i r0 = rampAVX2(span.R, span.StepR);
+	__m256i g0 = rampAVX2(span.G, span.StepG);
+	__m256i b0 = rampAVX2(span.B, span.StepB);
+	__m256i z1 = _mm256_add_epi32(z0, zStep);
+	__m256i r1 = _mm256_add_epi32(r0, rStep);
+	__m256i g1 = _mm256_add_epi32(g0, gStep);
+	__m256i b1 = _mm256_add_epi32(b0, bStep);
+
+	for (; i+16 <= span.Count; i += 16)
+	{
+		__m256i mask = zTestAVX2<F>((Z*)span.ZTarget + i, z0, z1);
+		u32 bits = _mm256_movemask_epi8(mask);
+
+		if (bits)
+		{
+			store32AVX2((s32*)span.Target + i, mask,
+				color32AVX2(r0, g0, b0), color32AVX2(r1, g1, b1));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm256_add_epi32(z1, zStep);
+		z1 = _mm256_add_epi32(z0, zStep);
+		r0 = _mm256_add_epi32(r1, rStep);
+		r1 = _mm256_add_epi32(r0, rStep);
+		g0 = _mm256_add_epi32(g1, gStep);
+		g1 = _mm256_add_epi32(g0, gStep);
+		b0 = _mm256_add_epi32(b1, bStep);
+		b1 = _mm256_add_epi32(b0, bStep);
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s32), sizeof(Z),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(z0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(r0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(g0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(b0)), 0, 0);
+		_mm256_zeroupper();
+		written += drawSpanGouraud32SSE2<Z, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! draws a textured span
+template <class Z, u32 F>
+static _IRR_TARGET_AVX2_ s32 drawSpanTextureFlat32AVX2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m256i zStep = _mm256_set1_epi32((u32)span.ZStep * 8);
+	const __m256i txStep = _mm256_set1_epi32((u32)span.TxStep * 8);
+	const __m256i tyStep = _mm256_set1_epi32((u32)span.TyStep * 8);
+
+	__m256i z0 = rampAVX2(span.ZValue, span.ZStep);
+	__m256i tx0 = rampAVX2(span.Tx, span.TxStep);
+	__m256i ty0 = rampAVX2(span.Ty, span.TyStep);
+	__m256i z1 = _mm256_add_epi32(z0, zStep);
+	__m256i tx1 = _mm256_add_epi32(tx0, txStep);
+	__m256i ty1 = _mm256_add_epi32(ty0, tyStep);
+
+	for (; i+16 <= span.Count; i += 16)
+	{
+		__m256i mask = zTestAVX2<F>((Z*)span.ZTarget + i, z0, z1);
+		u32 bits = _mm256_movemask_epi8(mask);
+
+		if (bits)
+		{
+			store32AVX2((s32*)span.Target + i, mask,
+				fetchTexels32AVX2(span, tx0, ty0), fetchTexels32AVX2(span, tx1, ty1));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm256_add_epi32(z1, zStep);
+		z1 = _mm256_add_epi32(z0, zStep);
+		tx0 = _mm256_add_epi32(tx1, txStep);
+		tx1 = _mm256_add_epi32(tx0, txStep);
+		ty0 = _mm256_add_epi32(ty1, tyStep);
+		ty1 = _mm256_add_epi32(ty0, tyStep);
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s32), sizeof(Z),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(z0)), 0, 0, 0,
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(tx0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(ty0)));
+		_mm256_zeroupper();
+		written += drawSpanTextureFlat32SSE2<Z, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! draws a textured span modulated by interpolated colors
+template <class Z, u32 F>
+static _IRR_TARGET_AVX2_ s32 drawSpanTextureGouraud32AVX2(const SSpan& span)
+{
+	s32 written = 0;
+	s32 i = 0;
+
+	const __m256i zStep = _mm256_set1_epi32((u32)span.ZStep * 8);
+	const __m256i rStep = _mm256_set1_epi32((u32)span.StepR * 8);
+	const __m256i gStep = _mm256_set1_epi32((u32)span.StepG * 8);
+	const __m256i bStep = _mm256_set1_epi32((u32)span.StepB * 8);
+	const __m256i txStep = _mm256_set1_epi32((u32)span.TxStep * 8);
+	const __m256i tyStep = _mm256_set1_epi32((u32)span.TyStep * 8);
+
+	__m256i z0 = rampAVX2(span.ZValue, span.ZStep);
+	__m256i r0 = rampAVX2(span.R, span.StepR);
+	__m256i g0 = rampAVX2(span.G, span.StepG);
+	__m256i b0 = rampAVX2(span.B, span.StepB);
+	__m256i tx0 = rampAVX2(span.Tx, span.TxStep);
+	__m256i ty0 = rampAVX2(span.Ty, span.TyStep);
+	__m256i z1 = _mm256_add_epi32(z0, zStep);
+	__m256i r1 = _mm256_add_epi32(r0, rStep);
+	__m256i g1 = _mm256_add_epi32(g0, gStep);
+	__m256i b1 = _mm256_add_epi32(b0, bStep);
+	__m256i tx1 = _mm256_add_epi32(tx0, txStep);
+	__m256i ty1 = _mm256_add_epi32(ty0, tyStep);
+
+	for (; i+16 <= span.Count; i += 16)
+	{
+		__m256i mask = zTestAVX2<F>((Z*)span.ZTarget + i, z0, z1);
+		u32 bits = _mm256_movemask_epi8(mask);
+
+		if (bits)
+		{
+			store32AVX2((s32*)span.Target + i, mask,
+				modulate32AVX2(fetchTexels32AVX2(span, tx0, ty0), r0, g0, b0),
+				modulate32AVX2(fetchTexels32AVX2(span, tx1, ty1), r1, g1, b1));
+			written += countBits(bits) / 2;
+		}
+
+		z0 = _mm256_add_epi32(z1, zStep);
+		z1 = _mm256_add_epi32(z0, zStep);
+		r0 = _mm256_add_epi32(r1, rStep);
+		r1 = _mm256_add_epi32(r0, rStep);
+		g0 = _mm256_add_epi32(g1, gStep);
+		g1 = _mm256_add_epi32(g0, gStep);
+		b0 = _mm256_add_epi32(b1, bStep);
+		b1 = _mm256_add_epi32(b0, bStep);
+		tx0 = _mm256_add_epi32(tx1, txStep);
+		tx1 = _mm256_add_epi32(tx0, txStep);
+		ty0 = _mm256_add_epi32(ty1, tyStep);
+		ty1 = _mm256_add_epi32(ty0, tyStep);
+	}
+
+	if (i < span.Count)
+	{
+		SSpan rest = getRestOfSpan(span, i, sizeof(s32), sizeof(Z),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(z0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(r0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(g0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(b0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(tx0)),
+			_mm_cvtsi128_si32(_mm256_castsi256_si128(ty0)));
+		_mm256_zeroupper();
+		written += drawSpanTextureGouraud32SSE2<Z, F>(rest);
+	}
+
+	return written;
+}
+
+
+
+//! the AVX2 kernels of 32 bit targets
+struct SKernels32AVX2
+{
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<0>)
+	{
+		return drawSpanFlat32AVX2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_GOURAUD>)
+	{
+		return drawSpanGouraud32AVX2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE>)
+	{
+		return drawSpanTextureFlat32AVX2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD>)
+	{
+		return drawSpanTextureGouraud32AVX2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_LIGHTMAP>)
+	{
+		return drawSpanTextureLightmap32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ADD>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_BLEND_ADD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ADD>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_TEXTURE | ESF_GOURAUD | ESF_BLEND_ADD | ESF_BLEND_ALPHA>)
+	{
+		return drawSpanTextureBlend32SSE2<Z, F>;
+	}
+
+	//! the other combinations with a lightmap or blending are only drawn by
+	//! the scalar kernels
+	template <class Z, u32 F, u32 S>
+	static TDrawSpan get(SFeatures<S>)
+	{
+		return drawSpanScalar<Z, SPixel32, F>;
+	}
+
+	//! bilinear filtering is drawn by the SSE2 kernels, the texels are
+	//! fetched one by one either way.
+	template <class Z, u32 F>
+	static TDrawSpan get(SFeatures<ESF_BILINEAR>)
+	{
+		return SKernels32SSE2::get<Z, F>();
+	}
+
+	template <class Z, u32 F>
+	static TDrawSpan get()
+	{
+		return get<Z, F>(SFeatures<(F & ESF_TEXTURE) && (F & ESF_BILINEAR) ? ESF_BILINEAR :
+			F & (ESF_GOURAUD | ESF_TEXTURE | ESF_LIGHTMAP | ESF_BLEND_ADD | ESF_BLEND_ALPHA)>());
+	}
+};
+
+static SSpanKernels AVX2Kernels32[EZF_COUNT];
+
+
+
+//! executes the cpuid instruction
+static void getCPUID(s32 leaf, s32 subLeaf, u32* regs)
+{
+#ifdef _MSC_VER
+	__cpuidex((int*)regs, leaf, subLeaf);
+#else
+	__cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+
+
+//! returns if the processor and the operating system support an instruction set
+static bool isSupportedX86(ESpanKernelSet set)
+{
+	u32 regs[4];
+
+	getCPUID(0, 0, regs);
+	u32 maxLeaf = regs[0];
+
+	if (maxLeaf < 1)
+		return false;
+
+	getCPUID(1, 0, regs);
+
+	if (set == ESKS_SSE2)
+		return (regs[3] & (1<<26)) != 0;
+
+	// avx2 needs the operating system to save the ymm registers
+	const u32 osxsave = 1<<27;
+	const u32 avx = 1<<28;
+	if ((regs[2] & (osxsave | avx)) != (osxsave | avx) || maxLeaf < 7)
+		return false;
+
+#ifdef _MSC_VER
+	u32 xcr0 = (u32)_xgetbv(0);
+#else
+	u32 xcr0, xcr0High;
+	__asm__ ("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+#endif
+
+	if ((xcr0 & 6) != 6)
+		return false;
+
+	getCPUID(7, 0, regs);
+	return (regs[1] & (1<<5)) != 0;
+}
+
+#endif // _IRR_SPAN_KERNELS_X86_
+
+
+
+//! fills the kernel tables when the program starts, before the renderers
+//! of several threads may look them up at the same time.
+static struct SKernelTables
+{
+	SKernelTables()
+	{
+		fillKernels<SKernelsScalar<SPixel16> >(ScalarKernels, "scalar");
+		fillKernels<SKernelsScalar<SPixel32> >(ScalarKernels32, "scalar");
+#ifdef _IRR_SPAN_KERNELS_X86_
+		fillKernels<SKernelsSSE2>(SSE2Kernels, "SSE2");
+		fillKernels<SKernels32SSE2>(SSE2Kernels32, "SSE2");
+		fillKernels<SKernelsAVX2>(AVX2Kernels, "AVX2");
+		fillKernels<SKernels32AVX2>(AVX2Kernels32, "AVX2");
+#endif
+	}
+} KernelTables;
+
+
+
+//! returns if the processor and the operating system support an instruction set
+bool isKernelSetSupported(ESpanKernelSet set)
+{
+	if (set == ESKS_SCALAR)
+		return true;
+
+#ifdef _IRR_SPAN_KERNELS_X86_
+	return isSupportedX86(set);
+#else
+	return false;
+#endif
+}
+
+
+
+//! returns a set of span kernels
+const SSpanKernels* getSpanKernels(ECOLOR_FORMAT format, E_ZBUFFER_FORMAT zFormat, ESpanKernelSet set)
+{
+	bool is32Bit = format == EHCF_A8R8G8B8;
+
+	switch(set)
+	{
+	case ESKS_SCALAR:
+		return is32Bit ? &ScalarKernels32[zFormat] : &ScalarKernels[zFormat];
+#ifdef _IRR_SPAN_KERNELS_X86_
+	case ESKS_SSE2:
+		if (!isKernelSetSupported(ESKS_SSE2))
+			return 0;
+		return is32Bit ? &SSE2Kernels32[zFormat] : &SSE2Kernels[zFormat];
+	case ESKS_AVX2:
+		if (!isKernelSetSupported(ESKS_AVX2))
+			return 0;
+		return is32Bit ? &AVX2Kernels32[zFormat] : &AVX2Kernels[zFormat];
+#endif
+	default:
+		return 0;
+	}
+}
+
+
+
+//! returns the fastest span kernels the processor supports.
+const SSpanKernels* getSpanKernels(ECOLOR_FORMAT format, E_ZBUFFER_FORMAT zFormat)
+{
+	static const SSpanKernels* best[2][EZF_COUNT] = { { 0, 0 }, { 0, 0 } };
+
+	const SSpanKernels*& kernels = best[format == EHCF_A8R8G8B8 ? 1 : 0][zFormat];
+
+	for (s32 i=ESKS_COUNT-1; !kernels && i>=0; --i)
+		kernels = getSpanKernels(format, zFormat, (ESpanKernelSet)i);
+
+	return kernels;
+}
+
+
+} // end namespace video
+} // end namespace irr
+
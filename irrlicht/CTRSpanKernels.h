@@ -0,0 +1,126 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __C_TR_SPAN_KERNELS_H_INCLUDED__
+#define __C_TR_SPAN_KERNELS_H_INCLUDED__
+
+#include "S2DVertex.h"
+#include "ITexture.h"
+#include "IVideoDriver.h"
+
+namespace irr
+{
+namespace video
+{
+	//! A horizontal span of pixels drawn by a span kernel. All values are
+	//! interpolated linearly, the colors and texture coordinates are 8.8 fixed
+	//! point values like in the triangle renderers. The colors have 5 bits
+	//! per channel for the 16 bit kernels and 8 bits for the 32 bit kernels,
+	//! the alpha value has 8 bits for both.
+	//! The target and the texture have the color format of the kernels, or
+	//! the texture has 8 bit indices into a palette of 256 colors of it.
+	struct SSpan
+	{
+		void* Target;				// first pixel of the span
+		void* ZTarget;				// z value of the first pixel
+		s32 Count;					// amount of pixels
+
+		s32 ZValue, ZStep;
+		s32 R, G, B, StepR, StepG, StepB;
+		s32 A, StepA;				// alpha of the vertices, for blending
+		s32 Tx, Ty, TxStep, TyStep;
+		s32 Tx2, Ty2, Tx2Step, Ty2Step;	// texture coordinates of the lightmap
+
+		s32 Color;					// A8R8G8B8 color of the flat kernel
+
+		const void* Texture;
+		s32 TextureWidth;
+		s32 TextureXMask, TextureYMask;
+		bool TextureTiled;			// stored in tiles of 4x4 texels, see CSoftwareTexture::isTiled()
+		const void* Palette;		// colors of an EHCF_P8 texture, 0 for other textures
+
+		const void* Texture2;		// lightmap
+		s32 Texture2Width;
+		s32 Texture2XMask, Texture2YMask;
+		const void* Palette2;		// colors of an EHCF_P8 lightmap, 0 for other lightmaps
+	};
+
+	//! draws a span.
+	//! \return Returns the amount of pixels which passed the z test.
+	typedef s32 (*TDrawSpan)(const SSpan& span);
+
+	//! features of a span kernel. The kernels are generated for every
+	//! combination of them at compile time, without any branches in the
+	//! loops over the pixels.
+	enum E_SPAN_FEATURE
+	{
+		//! R, G, B are interpolated, without ESF_TEXTURE the span is drawn in Color
+		ESF_GOURAUD = 1,
+
+		//! the texture is drawn, modulated by R, G, B with ESF_GOURAUD
+		ESF_TEXTURE = 2,
+
+		//! the z values are tested, but not written
+		ESF_NO_ZWRITE = 4,
+
+		//! the z values are neither tested nor written, all pixels are drawn
+		ESF_NO_ZTEST = 8,
+
+		//! the color is modulated by the lightmap Texture2 and brightened 4
+		//! times, like the lightmap material of the hardware drivers
+		ESF_LIGHTMAP = 16,
+
+		//! the color is added to the pixels of the target and saturated,
+		//! like EMT_TRANSPARENT_ADD_COLOR. With ESF_BLEND_ALPHA, the color
+		//! is scaled by its alpha before.
+		ESF_BLEND_ADD = 32,
+
+		//! the color is blended with the pixels of the target by its alpha.
+		//! The alpha is taken from the texture with ESF_TEXTURE, and is
+		//! modulated by A with ESF_GOURAUD. Without a texture it is A with
+		//! ESF_GOURAUD, otherwise the alpha of Color.
+		ESF_BLEND_ALPHA = 64,
+
+		//! the texels are filtered bilinearly from the 4 nearest ones, with
+		//! 4 bit weights. Only used with ESF_TEXTURE, not for the lightmap.
+		ESF_BILINEAR = 128,
+
+		//! amount of combinations of the features
+		ESF_COUNT = 256
+	};
+
+	//! span kernels for one instruction set, color format and z buffer
+	//! format. All sets of a format write exactly the same pixels.
+	struct SSpanKernels
+	{
+		const c8* Name;
+		TDrawSpan Draw[ESF_COUNT];	// indexed by combinations of E_SPAN_FEATURE flags
+	};
+
+	enum ESpanKernelSet
+	{
+		ESKS_SCALAR = 0,
+		ESKS_SSE2,
+		ESKS_AVX2,
+
+		ESKS_COUNT
+	};
+
+	//! returns if the processor and the operating system support the
+	//! instruction set of a kernel set.
+	bool isKernelSetSupported(ESpanKernelSet set);
+
+	//! returns the fastest span kernels the processor supports for
+	//! EHCF_R5G5B5 or EHCF_A8R8G8B8 targets.
+	const SSpanKernels* getSpanKernels(ECOLOR_FORMAT format, E_ZBUFFER_FORMAT zFormat);
+
+	//! returns a set of span kernels, or 0 if the processor or
+	//! the compiler does not support it.
+	const SSpanKernels* getSpanKernels(ECOLOR_FORMAT format, E_ZBUFFER_FORMAT zFormat, ESpanKernelSet set);
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -1,5 +1,5 @@
 #include "CTRTextureGouraud.h"
-#include "color.h"
+#include "Color.h"
 
 namespace irr
 {
@@ -26,12 +26,13 @@ public:
 		f32 tmpDiv; // temporary division factor
 		f32 longest; // saves the longest span
 		s32 height; // saves height of triangle
-		s16* targetSurface; // target pointer where to plot pixels
+		c8* targetSurface; // target pointer where to plot pixels
 		s32 spanEnd; // saves end of spans
 		f32 leftdeltaxf; // amount of pixels to increase on left side of triangle
 		f32 rightdeltaxf; // amount of pixels to increase on right side of triangle
 		s32 leftx, rightx; // position where we are 
-		f32 leftxf, rightxf; // same as above, but as f32 values
+		f32 leftxf, rightxf; // x of the edges at the rows they start
+		s32 leftEdgeY, rightEdgeY; // rows the edges start at
 		s32 span; // current span
 		s32 leftTx, rightTx, leftTy, rightTy; // texture interpolating values
 		s32 leftTxStep, rightTxStep, leftTyStep, rightTyStep; // texture interpolating values
@@ -39,12 +40,26 @@ public:
 
 		s32 leftZValue, rightZValue;
 		s32 leftZStep, rightZStep;
-		TZBufferType* zTarget; // target of ZBuffer;
+		c8* zTarget; // target of ZBuffer;
+		SSpan pixels; // single pixels drawn by the span kernels
 
 		lockedSurface = RenderTarget->lock();
-		lockedZBuffer = ZBuffer->lock();
+		lockZBuffer();
 		lockedTexture = Texture->lock();
+
+		pixels.Count = 1;
+		pixels.ZStep = 0;
+		pixels.TxStep = pixels.TyStep = 0;
+		pixels.Texture = lockedTexture;
+		pixels.TextureWidth = lockedTextureWidth;
+		pixels.TextureXMask = textureXMask;
+		pixels.TextureYMask = textureYMask;
+		pixels.TextureTiled = isTiled(Texture->getDimension());
+		pixels.Palette = lockPalette(Texture);
 		
+		SRasterizerStatistics stats; // counted locally, added to Statistics at the end
+		stats.Triangles = triangleCount;
+
 		for (s32 i=0; i<triangleCount; ++i)
 		{
 			v1 = &vertices[*indexList];
@@ -62,13 +77,19 @@ public:
 					((v3->Pos.Y - v1->Pos.Y) * (v3->Pos.X - v2->Pos.X));
 
 				if (z < 0)
+				{
+					++stats.BackFaceCulled;
 					continue;
+				}
 			}
 
 			//near plane clipping
 
 			if (v1->ZValue<0 && v2->ZValue<0 && v3->ZValue<0)
+			{
+				++stats.NearPlaneCulled;
 				continue;
+			}
 
 			// sort for width for inscreen clipping
 
@@ -77,7 +98,10 @@ public:
 			if (v2->Pos.X > v3->Pos.X)	swapVertices(&v2, &v3);
 
 			if ((v1->Pos.X - v3->Pos.X) == 0)
+			{
+				++stats.DegenerateCulled;
 				continue;
+			}
 
 			TriangleRect.UpperLeftCorner.X = v1->Pos.X;
 			TriangleRect.LowerRightCorner.X = v3->Pos.X;
@@ -92,13 +116,19 @@ public:
 			TriangleRect.LowerRightCorner.Y = v3->Pos.Y;
 
 			if (!TriangleRect.isRectCollided(ViewPortRect))
+			{
+				++stats.ViewPortCulled;
 				continue;
+			}
 
 
 			// hhe des dreiecks berechnen
 			height = v3->Pos.Y - v1->Pos.Y;
 			if (!height)
+			{
+				++stats.DegenerateCulled;
 				continue;
+			}
 
 			// calculate longest span
 
@@ -108,6 +138,7 @@ public:
 			span = v1->Pos.Y;
 			leftxf = (f32)v1->Pos.X;
 			rightxf = (f32)v1->Pos.X;
+			leftEdgeY = rightEdgeY = v1->Pos.Y;
 
 			leftZValue = v1->ZValue;
 			rightZValue = v1->ZValue;
@@ -115,8 +146,8 @@ public:
 			leftTx = rightTx = v1->TCoords.X;
 			leftTy = rightTy = v1->TCoords.Y;
 
-			targetSurface = lockedSurface + span * SurfaceWidth;
-			zTarget = lockedZBuffer + span * SurfaceWidth;
+			targetSurface = (c8*)lockedSurface + span * SurfacePitch;
+			zTarget = lockedZBuffer + span * ZBufferPitch;
 
 			if (longest < 0.0f)
 			{
@@ -172,10 +203,8 @@ public:
 						span = ViewPortRect.UpperLeftCorner.Y;
 					}
 
-					leftxf += leftdeltaxf*leftx;
-					rightxf += rightdeltaxf*leftx;
-					targetSurface += SurfaceWidth*leftx;
-					zTarget += SurfaceWidth*leftx;
+					targetSurface = (c8*)lockedSurface + span * SurfacePitch;
+					zTarget = lockedZBuffer + span * ZBufferPitch;
 					leftZValue += leftZStep*leftx;
 					rightZValue += rightZStep*leftx;
 
@@ -190,39 +219,47 @@ public:
 
 				while (span < spanEnd)
 				{
-					leftx = (s32)(leftxf);
-					rightx = (s32)(rightxf + 0.5f);
+					++stats.SpansTested;
+
+					// the edges are calculated for every span instead of adding up the
+					// deltas, so they do not drift and do not depend on the viewport.
+					leftx = (s32)(leftxf + leftdeltaxf * (span - leftEdgeY));
+					rightx = (s32)(rightxf + rightdeltaxf * (span - rightEdgeY) + 0.5f);
 
 					// perform some clipping
 
 					if (leftx>=ViewPortRect.UpperLeftCorner.X &&
 						leftx<=ViewPortRect.LowerRightCorner.X)
 					{
-						if (leftZValue > *(zTarget + leftx))
-						{
-							*(zTarget + leftx) = leftZValue;
-							*(targetSurface + leftx) = lockedTexture[((leftTy>>8)&textureYMask) * lockedTextureWidth + ((rightTx>>8)&textureXMask)];
-						}
+						pixels.Target = targetSurface + leftx * PixelSize;
+						pixels.ZTarget = zTarget + leftx * ZValueSize;
+						pixels.ZValue = leftZValue;
+						pixels.Tx = leftTx;
+						pixels.Ty = leftTy;
+
+						++stats.PixelsTested;
+						stats.PixelsWritten += SpanKernels->Draw[ESF_TEXTURE](pixels);
 					}
 
 
 					if (rightx>=ViewPortRect.UpperLeftCorner.X &&
 						rightx<=ViewPortRect.LowerRightCorner.X)
 					{
-						if (rightZValue > *(zTarget + rightx))
-						{
-							*(zTarget + rightx) = rightZValue;
-							*(targetSurface + rightx) = lockedTexture[((rightTy>>8)&textureYMask) * lockedTextureWidth + ((rightTx>>8)&textureXMask)];
-						}
+						pixels.Target = targetSurface + rightx * PixelSize;
+						pixels.ZTarget = zTarget + rightx * ZValueSize;
+						pixels.ZValue = rightZValue;
+						pixels.Tx = rightTx;
+						pixels.Ty = rightTy;
+
+						++stats.PixelsTested;
+						stats.PixelsWritten += SpanKernels->Draw[ESF_TEXTURE](pixels);
 
 					}
 
 
-					leftxf += leftdeltaxf;
-					rightxf += rightdeltaxf;
 					++span;
-					targetSurface += SurfaceWidth;
-					zTarget += SurfaceWidth;
+					targetSurface += SurfacePitch;
+					zTarget += ZBufferPitch;
 					leftZValue += leftZStep;
 					rightZValue += rightZStep;
 
@@ -244,6 +281,7 @@ public:
 
 					rightdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
 					rightxf = (f32)v2->Pos.X;
+					rightEdgeY = v2->Pos.Y;
 
 					rightZValue = v2->ZValue;
 					rightZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
@@ -259,6 +297,7 @@ public:
 
 					leftdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
 					leftxf = (f32)v2->Pos.X;
+					leftEdgeY = v2->Pos.Y;
 
 					leftZValue = v2->ZValue;
 					leftZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
@@ -275,6 +314,12 @@ public:
 
 		}
 
+		if (Statistics)
+		{
+			stats.ZTestFailed = stats.PixelsTested - stats.PixelsWritten;
+			Statistics->add(stats);
+		}
+
 		RenderTarget->unlock();
 		ZBuffer->unlock();
 		Texture->unlock();
@@ -1,6 +1,6 @@
 #include "CTRTextureGouraud.h"
 #include "os.h"
-#include "color.h"
+#include "Color.h"
 
 namespace irr
 {
@@ -9,13 +9,19 @@ namespace video
 
 //! constructor
 CTRTextureGouraud::CTRTextureGouraud(IZBuffer* zbuffer)
-: RenderTarget(0),	BackFaceCullingEnabled(true), SurfaceHeight(0), SurfaceWidth(0),
-	Texture(0)
+: RenderTarget(0), SurfaceWidth(0), SurfaceHeight(0),
+	SurfacePitch(0), PixelSize(2), ChannelShift(3), ChannelMask(0x1F),
+	BackFaceCullingEnabled(true), PerspectiveCorrection(false),
+	lockedZBuffer(0), ZBufferPitch(0), ZValueSize(2), lockedBlocks(0), BlockCountX(0),
+	Texture(0), MipMaps(0), MipMapCount(0), TextureTiled(false), lockedTexture2(0), lockedTexture2Width(0), texture2XMask(0), texture2YMask(0),
+	Texture2(0), Statistics(0), SpanKernels(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CTRTextureGouraud");
 	#endif
 
+	SpanKernels = getSpanKernels(EHCF_R5G5B5, EZF_16BIT);
+
 	ZBuffer = zbuffer;
 	if (ZBuffer)
 		zbuffer->grab();
@@ -34,6 +40,9 @@ CTRTextureGouraud::~CTRTextureGouraud()
 
 	if (Texture)
 		Texture->drop();
+
+	if (Texture2)
+		Texture2->drop();
 }
 
 
@@ -41,6 +50,9 @@ CTRTextureGouraud::~CTRTextureGouraud()
 //! sets the Texture
 void CTRTextureGouraud::setTexture(video::ISurface* texture)
 {
+	if (texture == Texture)
+		return;
+
 	if (Texture)
 		Texture->drop();
 
@@ -58,6 +70,48 @@ void CTRTextureGouraud::setTexture(video::ISurface* texture)
 
 
 
+//! sets the lightmap
+void CTRTextureGouraud::setTexture2(video::ISurface* texture)
+{
+	if (texture == Texture2)
+		return;
+
+	if (Texture2)
+		Texture2->drop();
+
+	Texture2 = texture;
+
+	if (Texture2)
+	{
+		Texture2->grab();
+		lockedTexture2Width = Texture2->getDimension().Width;
+
+		texture2XMask = lockedTexture2Width-1;
+		texture2YMask = Texture2->getDimension().Height-1;
+	}
+}
+
+
+
+
+//! sets the mip maps of the texture
+void CTRTextureGouraud::setMipMaps(video::ISurface* const* mipMaps, s32 count)
+{
+	MipMaps = mipMaps;
+	MipMapCount = mipMaps ? count : 0;
+	if (MipMapCount > MAX_MIPMAPS)
+		MipMapCount = MAX_MIPMAPS;
+}
+
+
+
+//! sets if the texture and its mip maps are stored in tiles
+void CTRTextureGouraud::setTextureTiled(bool tiled)
+{
+	TextureTiled = tiled;
+}
+
+
 
 //! en or disables the backface culling
 void CTRTextureGouraud::setBackfaceCulling(bool enabled)
@@ -67,9 +121,32 @@ void CTRTextureGouraud::setBackfaceCulling(bool enabled)
 
 
 
+//! sets the statistics the renderer adds its counters to
+void CTRTextureGouraud::setStatistics(SRasterizerStatistics* statistics)
+{
+	Statistics = statistics;
+}
+
+
+
+//! en or disables perspective correct texture coordinates
+void CTRTextureGouraud::setPerspectiveCorrection(bool enabled)
+{
+	PerspectiveCorrection = enabled;
+}
+
+
+
 //! sets a render target
 void CTRTextureGouraud::setRenderTarget(video::ISurface* surface, const core::rectEx<s32>& viewPort)
 {
+	// the tile rasterizer relies on this not touching the reference counters
+	if (surface == RenderTarget)
+	{
+		ViewPortRect = viewPort;
+		return;
+	}
+
 	if (RenderTarget)
 		RenderTarget->drop();
 
@@ -79,6 +156,22 @@ void CTRTextureGouraud::setRenderTarget(video::ISurface* surface, const core::re
 	{
 		SurfaceWidth = RenderTarget->getDimension().Width;
 		SurfaceHeight = RenderTarget->getDimension().Height;
+		SurfacePitch = RenderTarget->getPitch();
+		PixelSize = RenderTarget->getBytesPerPixel();
+
+		// vertex colors are interpolated with 5 bits per channel for
+		// 16 bit targets and with 8 bits for 32 bit targets.
+		if (RenderTarget->getColorFormat() == EHCF_A8R8G8B8)
+		{
+			ChannelShift = 0;
+			ChannelMask = 0xFF;
+		}
+		else
+		{
+			ChannelShift = 3;
+			ChannelMask = 0x1F;
+		}
+
 		RenderTarget->grab();
 		ViewPortRect = viewPort;
 	}		
@@ -86,366 +179,177 @@ void CTRTextureGouraud::setRenderTarget(video::ISurface* surface, const core::re
 
 
 
-//! draws an indexed triangle list
-void CTRTextureGouraud::drawIndexedTriangleList(S2DVertex* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount)
+//! locks the zbuffer and selects the span kernels
+void CTRTextureGouraud::lockZBuffer()
 {
-	const S2DVertex *v1, *v2, *v3;
-
-	s16 color;
-	f32 tmpDiv; // temporary division factor
-	f32 longest; // saves the longest span
-	s32 height; // saves height of triangle
-	s16* targetSurface; // target pointer where to plot pixels
-	s32 spanEnd; // saves end of spans
-	f32 leftdeltaxf; // amount of pixels to increase on left side of triangle
-	f32 rightdeltaxf; // amount of pixels to increase on right side of triangle
-	s32 leftx, rightx; // position where we are 
-	f32 leftxf, rightxf; // same as above, but as f32 values
-	s32 span; // current span
-	s16 *hSpanBegin, *hSpanEnd; // pointer used when plotting pixels
-	s32 leftR, leftG, leftB, rightR, rightG, rightB; // color values
-	s32 leftStepR, leftStepG, leftStepB,
-		rightStepR, rightStepG, rightStepB; // color steps
-	s32 spanR, spanG, spanB, spanStepR, spanStepG, spanStepB; // color interpolating values while drawing a span.
-	s32 leftTx, rightTx, leftTy, rightTy; // texture interpolating values
-	s32 leftTxStep, rightTxStep, leftTyStep, rightTyStep; // texture interpolating values
-	s32 spanTx, spanTy, spanTxStep, spanTyStep; // values of Texturecoords when drawing a span
-	core::rectEx<s32> TriangleRect;
-
-	s32 leftZValue, rightZValue;
-	s32 leftZStep, rightZStep;
-	s32 spanZValue, spanZStep; // ZValues when drawing a span
-	TZBufferType* zTarget, *spanZTarget; // target of ZBuffer;
-
-	lockedSurface = RenderTarget->lock();
-	lockedZBuffer = ZBuffer->lock();
-	lockedTexture = Texture->lock();
-	
-	for (s32 i=0; i<triangleCount; ++i)
-	{
-		v1 = &vertices[*indexList];
-		++indexList;
-		v2 = &vertices[*indexList];
-		++indexList;
-		v3 = &vertices[*indexList];
-		++indexList;
-
-		// back face culling
-
-		if (BackFaceCullingEnabled)
-		{
-			s32 z = ((v3->Pos.X - v1->Pos.X) * (v3->Pos.Y - v2->Pos.Y)) -
-				((v3->Pos.Y - v1->Pos.Y) * (v3->Pos.X - v2->Pos.X));
-
-			if (z < 0)
-				continue;
-		}
-
-		//near plane clipping
+	// the format of the zbuffer may change without a new render target,
+	// so the kernels are selected for every draw call.
+	lockedZBuffer = (c8*)ZBuffer->lock();
+	ZValueSize = ZBuffer->getBytesPerValue();
+	ZBufferPitch = ZBuffer->getSize().Width * ZValueSize;
+	SpanKernels = getSpanKernels(RenderTarget->getColorFormat(), ZBuffer->getFormat());
+
+	lockedBlocks = ZBuffer->lockBlocks();
+	BlockCountX = ZBuffer->getBlockCountX();
+}
 
-		if (v1->ZValue<0 && v2->ZValue<0 && v3->ZValue<0)
-			continue;
 
-		// sort for width for inscreen clipping
 
-		if (v1->Pos.X > v2->Pos.X)	swapVertices(&v1, &v2);
-		if (v1->Pos.X > v3->Pos.X)	swapVertices(&v1, &v3);
-		if (v2->Pos.X > v3->Pos.X)	swapVertices(&v2, &v3);
+//! returns if a triangle is hidden in all blocks it touches
+bool CTRTextureGouraud::isOccluded(const S2DVertex* v1, const S2DVertex* v2, const S2DVertex* v3,
+	const core::rectEx<s32>& triangleRect)
+{
+	// the z values are interpolated between the values of the vertices,
+	// so no pixel of the triangle is nearer than the nearest vertex.
+	s32 zMax = v1->ZValue;
+	if (v2->ZValue > zMax) zMax = v2->ZValue;
+	if (v3->ZValue > zMax) zMax = v3->ZValue;
+
+	// the renderers draw the pixels inside the rectangle, excluding the
+	// right and lower border.
+	core::rectEx<s32> rect(triangleRect);
+	rect.clipAgainst(ViewPortRect);
+
+	if (rect.getWidth() <= 0 || rect.getHeight() <= 0)
+		return false;
+
+	s32 x1 = rect.UpperLeftCorner.X >> ZBUFFER_BLOCK_SHIFT;
+	s32 y1 = rect.UpperLeftCorner.Y >> ZBUFFER_BLOCK_SHIFT;
+	s32 x2 = (rect.LowerRightCorner.X - 1) >> ZBUFFER_BLOCK_SHIFT;
+	s32 y2 = (rect.LowerRightCorner.Y - 1) >> ZBUFFER_BLOCK_SHIFT;
+
+	// all blocks are updated, not only the ones up to the first visible 
+	// block, so the spans can be clipped to them.
+	bool occluded = true;
+
+	for (s32 y=y1; y<=y2; ++y)
+	{
+		SZBufferBlock* block = lockedBlocks + y * BlockCountX + x1;
 
-		if ((v1->Pos.X - v3->Pos.X) == 0)
-			continue;
+		for (s32 x=x1; x<=x2; ++x, ++block)
+		{
+			if (block->MinZ < zMax && block->Dirty)
+				ZBuffer->updateBlock(x, y);
 
-		TriangleRect.UpperLeftCorner.X = v1->Pos.X;
-		TriangleRect.LowerRightCorner.X = v3->Pos.X;
+			if (block->MinZ < zMax)
+				occluded = false;
+		}
+	}
 
-		// sort for height for faster drawing.
+	return occluded;
+}
 
-		if (v1->Pos.Y > v2->Pos.Y)	swapVertices(&v1, &v2);
-		if (v1->Pos.Y > v3->Pos.Y)	swapVertices(&v1, &v3);
-		if (v2->Pos.Y > v3->Pos.Y)	swapVertices(&v2, &v3);
 
-		TriangleRect.UpperLeftCorner.Y = v1->Pos.Y;
-		TriangleRect.LowerRightCorner.Y = v3->Pos.Y;
 
-		if (!TriangleRect.isRectCollided(ViewPortRect))
-			continue;
+//! returns the mip map level with about one texel per pixel for a triangle
+s32 CTRTextureGouraud::getMipMapLevel(const S2DVertex* v1, const S2DVertex* v2, const S2DVertex* v3) const
+{
+	f32 pixels = (f32)(v2->Pos.X - v1->Pos.X) * (f32)(v3->Pos.Y - v1->Pos.Y) -
+		(f32)(v3->Pos.X - v1->Pos.X) * (f32)(v2->Pos.Y - v1->Pos.Y);
 
+	// the texture coordinates are 8.8 fixed point values
+	f32 texels = ((f32)(v2->TCoords.X - v1->TCoords.X) * (f32)(v3->TCoords.Y - v1->TCoords.Y) -
+		(f32)(v3->TCoords.X - v1->TCoords.X) * (f32)(v2->TCoords.Y - v1->TCoords.Y)) * (1.0f / 65536.0f);
 
-		// hhe des dreiecks berechnen
-		height = v3->Pos.Y - v1->Pos.Y;
-		if (!height)
-			continue;
+	if (pixels < 0.0f) pixels = -pixels;
+	if (texels < 0.0f) texels = -texels;
 
-		// calculate longest span
+	// every level has a quarter of the texels of the one before, the
+	// first one used has at most 4 texels per pixel.
+	s32 level = 0;
+	while (level < MipMapCount && texels >= pixels * 4.0f)
+	{
+		texels *= 0.25f;
+		++level;
+	}
 
-		longest = (v2->Pos.Y - v1->Pos.Y) / (f32)height * (v3->Pos.X - v1->Pos.X) + (v1->Pos.X - v2->Pos.X);
+	return level;
+}
 
-		spanEnd = v2->Pos.Y;
-		span = v1->Pos.Y;
-		leftxf = (f32)v1->Pos.X;
-		rightxf = (f32)v1->Pos.X;
 
-		leftZValue = v1->ZValue;
-		rightZValue = v1->ZValue;
 
-		leftR = rightR = video::getRed(v1->Color)<<8;
-		leftG = rightG = video::getGreen(v1->Color)<<8;
-		leftB = rightB = video::getBlue(v1->Color)<<8;
-		leftTx = rightTx = v1->TCoords.X;
-		leftTy = rightTy = v1->TCoords.Y;
+//! draws a span with perspective correct texture coordinates
+s32 CTRTextureGouraud::drawPerspectiveSpan(TDrawSpan kernel, SSpan& span, s32 x, s32 spanStart, s32 spanWidth,
+	const SPerspectiveValues& left, const SPerspectiveValues& right, bool lightmap)
+{
+	f32 tmpDiv = 1.0f / spanWidth;
+	f32 stepU = (right.U - left.U) * tmpDiv;
+	f32 stepV = (right.V - left.V) * tmpDiv;
+	f32 stepU2 = (right.U2 - left.U2) * tmpDiv;
+	f32 stepV2 = (right.V2 - left.V2) * tmpDiv;
+	f32 stepZ = (right.Z - left.Z) * tmpDiv;
+
+	s32 spanEnd = spanStart + spanWidth;
+	s32 end = x + span.Count;
+	s32 written = 0;
+
+	// the subspans start every PERSPECTIVE_SUBSPAN pixels from the start of
+	// the unclipped span, not at the first visible pixel, so their texture
+	// coordinates do not depend on the viewport or the tile it is clipped to.
+
+	s32 subspanStart = spanStart + ((x - spanStart) & ~(PERSPECTIVE_SUBSPAN-1));
+
+	tmpDiv = 1.0f / (left.Z + stepZ * (subspanStart - spanStart));
+	f32 startU = (left.U + stepU * (subspanStart - spanStart)) * tmpDiv;
+	f32 startV = (left.V + stepV * (subspanStart - spanStart)) * tmpDiv;
+	f32 startU2 = (left.U2 + stepU2 * (subspanStart - spanStart)) * tmpDiv;
+	f32 startV2 = (left.V2 + stepV2 * (subspanStart - spanStart)) * tmpDiv;
+	f32 endU2 = 0.0f, endV2 = 0.0f;
+
+	while (x < end)
+	{
+		s32 subspanEnd = subspanStart + PERSPECTIVE_SUBSPAN;
+		if (subspanEnd > spanEnd)
+			subspanEnd = spanEnd;
 
-		targetSurface = lockedSurface + span * SurfaceWidth;
-		zTarget = lockedZBuffer + span * SurfaceWidth;
+		// one division per subspan, its end is the start of the next one
+		tmpDiv = 1.0f / (left.Z + stepZ * (subspanEnd - spanStart));
+		f32 endU = (left.U + stepU * (subspanEnd - spanStart)) * tmpDiv;
+		f32 endV = (left.V + stepV * (subspanEnd - spanStart)) * tmpDiv;
 
-		if (longest < 0.0f)
-		{
-			tmpDiv = 1.0f / (f32)(v2->Pos.Y - v1->Pos.Y);
-			rightdeltaxf = (v2->Pos.X - v1->Pos.X) * tmpDiv;
-			rightZStep = (s32)((v2->ZValue - v1->ZValue) * tmpDiv);
-			rightStepR = (s32)(((video::getRed(v2->Color)<<8) - rightR) * tmpDiv);
-			rightStepG = (s32)(((video::getGreen(v2->Color)<<8) - rightG) * tmpDiv);
-			rightStepB = (s32)(((video::getBlue(v2->Color)<<8) - rightB) * tmpDiv);
-			rightTxStep = (s32)((v2->TCoords.X - rightTx) * tmpDiv);
-			rightTyStep = (s32)((v2->TCoords.Y - rightTy) * tmpDiv);
-
-			tmpDiv = 1.0f / (f32)height;
-			leftdeltaxf = (v3->Pos.X - v1->Pos.X) * tmpDiv;
-			leftZStep = (s32)((v3->ZValue - v1->ZValue) * tmpDiv);
-			leftStepR = (s32)(((video::getRed(v3->Color)<<8) - leftR) * tmpDiv);
-			leftStepG = (s32)(((video::getGreen(v3->Color)<<8) - leftG) * tmpDiv);
-			leftStepB = (s32)(((video::getBlue(v3->Color)<<8) - leftB) * tmpDiv);
-			leftTxStep = (s32)((v3->TCoords.X - leftTx) * tmpDiv);
-			leftTyStep = (s32)((v3->TCoords.Y - leftTy) * tmpDiv);
-		}
-		else
+		if (lightmap)
 		{
-			tmpDiv = 1.0f / (f32)height;
-			rightdeltaxf = (v3->Pos.X - v1->Pos.X) * tmpDiv;
-			rightZStep = (s32)((v3->ZValue - v1->ZValue) * tmpDiv);
-			rightStepR = (s32)(((video::getRed(v3->Color)<<8) - rightR) * tmpDiv);
-			rightStepG = (s32)(((video::getGreen(v3->Color)<<8) - rightG) * tmpDiv);
-			rightStepB = (s32)(((video::getBlue(v3->Color)<<8) - rightB) * tmpDiv);
-			rightTxStep = (s32)((v3->TCoords.X - rightTx) * tmpDiv);
-			rightTyStep = (s32)((v3->TCoords.Y - rightTy) * tmpDiv);
-
-			tmpDiv = 1.0f / (f32)(v2->Pos.Y - v1->Pos.Y);
-			leftdeltaxf = (v2->Pos.X - v1->Pos.X) * tmpDiv;
-			leftZStep = (s32)((v2->ZValue - v1->ZValue) * tmpDiv);
-			leftStepR = (s32)(((video::getRed(v2->Color)<<8) - leftR) * tmpDiv);
-			leftStepG = (s32)(((video::getGreen(v2->Color)<<8) - leftG) * tmpDiv);
-			leftStepB = (s32)(((video::getBlue(v2->Color)<<8) - leftB) * tmpDiv);
-			leftTxStep = (s32)((v2->TCoords.X - leftTx) * tmpDiv);
-			leftTyStep = (s32)((v2->TCoords.Y - leftTy) * tmpDiv);
+			endU2 = (left.U2 + stepU2 * (subspanEnd - spanStart)) * tmpDiv;
+			endV2 = (left.V2 + stepV2 * (subspanEnd - spanStart)) * tmpDiv;
 		}
 
+		tmpDiv = subspanEnd - subspanStart == PERSPECTIVE_SUBSPAN ?
+			1.0f / PERSPECTIVE_SUBSPAN : 1.0f / (subspanEnd - subspanStart);
 
-		// do it twice, once for the first half of the triangle,
-		// end then for the second half.
+		span.TxStep = (s32)((endU - startU) * tmpDiv);
+		span.TyStep = (s32)((endV - startV) * tmpDiv);
+		span.Tx = (s32)startU + span.TxStep * (x - subspanStart);
+		span.Ty = (s32)startV + span.TyStep * (x - subspanStart);
 
-		for (s32 triangleHalf=0; triangleHalf<2; ++triangleHalf)
+		if (lightmap)
 		{
-			if (spanEnd > ViewPortRect.LowerRightCorner.Y)
-				spanEnd = ViewPortRect.LowerRightCorner.Y;
-
-			// if the span <0, than we can skip these spans, 
-			// and proceed to the next spans which are really on the screen.
-			if (span < ViewPortRect.UpperLeftCorner.Y)
-			{
-				// we'll use leftx as temp variable
-				if (spanEnd < ViewPortRect.UpperLeftCorner.Y)
-				{
-					leftx = spanEnd - span;
-					span = spanEnd;
-				}
-				else
-				{
-					leftx = ViewPortRect.UpperLeftCorner.Y - span; 
-					span = ViewPortRect.UpperLeftCorner.Y;
-				}
-
-				leftxf += leftdeltaxf*leftx;
-				rightxf += rightdeltaxf*leftx;
-				targetSurface += SurfaceWidth*leftx;
-				zTarget += SurfaceWidth*leftx;
-				leftZValue += leftZStep*leftx;
-				rightZValue += rightZStep*leftx;
-
-				leftR += leftStepR*leftx;
-				leftG += leftStepG*leftx;
-				leftB += leftStepB*leftx;
-				rightR += rightStepR*leftx;
-				rightG += rightStepG*leftx;
-				rightB += rightStepB*leftx;
-
-				leftTx += leftTxStep*leftx;
-				leftTy += leftTyStep*leftx;
-				rightTx += rightTxStep*leftx;
-				rightTy += rightTyStep*leftx;
-			}
-
-
-			// the main loop. Go through every span and draw it.
-
-			while (span < spanEnd)
-			{
-				leftx = (s32)(leftxf);
-				rightx = (s32)(rightxf + 0.5f);
-
-				// perform some clipping
-
-				// TODO: clipping is not correct when leftx is clipped.
-
-				if (leftx<ViewPortRect.UpperLeftCorner.X)
-					leftx = ViewPortRect.UpperLeftCorner.X;
-				else
-					if (leftx>ViewPortRect.LowerRightCorner.X)
-						leftx = ViewPortRect.LowerRightCorner.X;
-
-				if (rightx<ViewPortRect.UpperLeftCorner.X)
-					rightx = ViewPortRect.UpperLeftCorner.X;
-				else
-					if (rightx>ViewPortRect.LowerRightCorner.X)
-						rightx = ViewPortRect.LowerRightCorner.X;
-
-				// draw the span
-
-				if (rightx - leftx != 0)
-				{
-					tmpDiv = 1.0f / (rightx - leftx);
-					spanZValue = leftZValue;
-					spanZStep = (s32)((rightZValue - leftZValue) * tmpDiv);
-
-					hSpanBegin = targetSurface + leftx;
-					spanZTarget = zTarget + leftx;
-					hSpanEnd = targetSurface + rightx;
-
-					spanR = leftR;	
-					spanG = leftG;	
-					spanB = leftB;
-					spanStepR = (s32)((rightR - leftR) * tmpDiv);
-					spanStepG = (s32)((rightG - leftG) * tmpDiv);
-					spanStepB = (s32)((rightB - leftB) * tmpDiv);
-
-					spanTx = leftTx;	
-					spanTy = leftTy;
-					spanTxStep = (s32)((rightTx - leftTx) * tmpDiv);
-					spanTyStep = (s32)((rightTy - leftTy) * tmpDiv);
-
-					while (hSpanBegin < hSpanEnd)
-					{
-						if (spanZValue > *spanZTarget)
-						{
-							*spanZTarget = spanZValue;
-							color = lockedTexture[((spanTy>>8)&textureYMask) * lockedTextureWidth + ((spanTx>>8)&textureXMask)];
-							*hSpanBegin = video::RGB16(video::getRed(color) * (spanR>>8) >>2, video::getGreen(color) * (spanG>>8) >>2, video::getBlue(color) * (spanB>>8) >>2);
-						}
-
-						spanR += spanStepR;
-						spanG += spanStepG;
-						spanB += spanStepB;
-
-						spanTx += spanTxStep;
-						spanTy += spanTyStep;
-						
-						spanZValue += spanZStep;
-						++hSpanBegin;
-						++spanZTarget;
-					}
-				}
-
-				leftxf += leftdeltaxf;
-				rightxf += rightdeltaxf;
-				++span;
-				targetSurface += SurfaceWidth;
-				zTarget += SurfaceWidth;
-				leftZValue += leftZStep;
-				rightZValue += rightZStep;
-
-				leftR += leftStepR;
-				leftG += leftStepG;
-				leftB += leftStepB;
-				rightR += rightStepR;
-				rightG += rightStepG;
-				rightB += rightStepB;
-
-				leftTx += leftTxStep;
-				leftTy += leftTyStep;
-				rightTx += rightTxStep;
-				rightTy += rightTyStep;
-			}
-
-			if (triangleHalf>0) // break, we've gout only two halves
-				break;
-
-
-			// setup variables for second half of the triangle.
-
-			if (longest < 0.0f)
-			{
-				tmpDiv = 1.0f / (v3->Pos.Y - v2->Pos.Y);
-
-				rightdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
-				rightxf = (f32)v2->Pos.X;
-
-				rightZValue = v2->ZValue;
-				rightZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
-
-				rightR = video::getRed(v2->Color)<<8;
-				rightG = video::getGreen(v2->Color)<<8;
-				rightB = video::getBlue(v2->Color)<<8;
-				rightStepR = (s32)(((video::getRed(v3->Color)<<8) - rightR) * tmpDiv);
-				rightStepG = (s32)(((video::getGreen(v3->Color)<<8) - rightG) * tmpDiv);
-				rightStepB = (s32)(((video::getBlue(v3->Color)<<8) - rightB) * tmpDiv);
-
-				rightTx = v2->TCoords.X;
-				rightTy = v2->TCoords.Y;
-				rightTxStep = (s32)((v3->TCoords.X - rightTx) * tmpDiv);
-				rightTyStep = (s32)((v3->TCoords.Y - rightTy) * tmpDiv);
-			}
-			else
-			{
-				tmpDiv = 1.0f / (v3->Pos.Y - v2->Pos.Y);
-
-				leftdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
-				leftxf = (f32)v2->Pos.X;
-
-				leftZValue = v2->ZValue;
-				leftZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
-
-				leftR = video::getRed(v2->Color)<<8;
-				leftG = video::getGreen(v2->Color)<<8;
-				leftB = video::getBlue(v2->Color)<<8;
-				leftStepR = (s32)(((video::getRed(v3->Color)<<8) - leftR) * tmpDiv);
-				leftStepG = (s32)(((video::getGreen(v3->Color)<<8) - leftG) * tmpDiv);
-				leftStepB = (s32)(((video::getBlue(v3->Color)<<8) - leftB) * tmpDiv);
-
-				leftTx = v2->TCoords.X;
-				leftTy = v2->TCoords.Y;
-				leftTxStep = (s32)((v3->TCoords.X - leftTx) * tmpDiv);
-				leftTyStep = (s32)((v3->TCoords.Y - leftTy) * tmpDiv);
-			}
-
-
-			spanEnd = v3->Pos.Y;
+			span.Tx2Step = (s32)((endU2 - startU2) * tmpDiv);
+			span.Ty2Step = (s32)((endV2 - startV2) * tmpDiv);
+			span.Tx2 = (s32)startU2 + span.Tx2Step * (x - subspanStart);
+			span.Ty2 = (s32)startV2 + span.Ty2Step * (x - subspanStart);
 		}
 
+		s32 count = (subspanEnd < end ? subspanEnd : end) - x;
+		span.Count = count;
+		written += kernel(span);
+
+		span.Target = (c8*)span.Target + count * PixelSize;
+		span.ZTarget = (c8*)span.ZTarget + count * ZValueSize;
+		span.ZValue += span.ZStep * count;
+		span.R += span.StepR * count;
+		span.G += span.StepG * count;
+		span.B += span.StepB * count;
+		span.A += span.StepA * count;
+
+		x += count;
+		subspanStart = subspanEnd;
+		startU = endU;
+		startV = endV;
+		startU2 = endU2;
+		startV2 = endV2;
 	}
 
-	RenderTarget->unlock();
-	ZBuffer->unlock();
-	Texture->unlock();
-}
-
-
-
-
-
-
-
-//! creates a flat triangle renderer
-IK3DTriangleRenderer* createTriangleRendererTextureGouraud(IZBuffer* zbuffer)
-{
-	return new CTRTextureGouraud(zbuffer);
+	return written;
 }
 
 
@@ -6,13 +6,66 @@
 #define __C_TRIANGLE_RENDERER_TEXTURE_GOURAUD_H_INCLUDED__
 
 #include "IK3DTriangleRenderer.h"
+#include "CTRSpanKernels.h"
 #include "rect.h"
 
 namespace irr
 {
 namespace video
 {
+	//! width of the subspans of perspective correct spans. The texture
+	//! coordinates are only divided by 1/w at the ends of the subspans, and
+	//! interpolated linearly inbetween. A power of two.
+	const s32 PERSPECTIVE_SUBSPAN = 16;
+
+	//! texture coordinates divided by w, and 1/w, which change linearly on
+	//! the screen unlike the texture coordinates themselves. U2 and V2 are
+	//! the coordinates of the lightmap.
+	struct SPerspectiveValues
+	{
+		f32 U, V, U2, V2, Z;
+	};
+
+	//! the perspective values along an edge of a triangle
+	struct SPerspectiveEdge
+	{
+		SPerspectiveValues Start;	// at the first row of the edge
+		SPerspectiveValues Step;	// per row
+
+		//! sets the edge from one vertex to another.
+		//! \param invHeight: 1 divided by the rows between the vertices.
+		inline void set(const S2DVertex* from, const S2DVertex* to, f32 invHeight)
+		{
+			// z values of distant vertices may round to 0 in a 16 bit zbuffer
+			f32 z1 = (f32)(from->ZValue > 1 ? from->ZValue : 1);
+			f32 z2 = (f32)(to->ZValue > 1 ? to->ZValue : 1);
+
+			Start.U = from->TCoords.X * z1;
+			Start.V = from->TCoords.Y * z1;
+			Start.U2 = from->TCoords2.X * z1;
+			Start.V2 = from->TCoords2.Y * z1;
+			Start.Z = z1;
+			Step.U = (to->TCoords.X * z2 - Start.U) * invHeight;
+			Step.V = (to->TCoords.Y * z2 - Start.V) * invHeight;
+			Step.U2 = (to->TCoords2.X * z2 - Start.U2) * invHeight;
+			Step.V2 = (to->TCoords2.Y * z2 - Start.V2) * invHeight;
+			Step.Z = (z2 - z1) * invHeight;
+		}
+
+		//! returns the values some rows below the first row of the edge
+		inline void get(s32 rows, SPerspectiveValues& values) const
+		{
+			values.U = Start.U + Step.U * rows;
+			values.V = Start.V + Step.V * rows;
+			values.U2 = Start.U2 + Step.U2 * rows;
+			values.V2 = Start.V2 + Step.V2 * rows;
+			values.Z = Start.Z + Step.Z * rows;
+		}
+	};
 
+	//! base of the triangle renderers. Holds the render target, zbuffer and
+	//! texture state and the helpers shared by the renderers, which only
+	//! implement drawIndexedTriangleList.
 	class CTRTextureGouraud : public IK3DTriangleRenderer
 	{
 	public:
@@ -26,15 +79,30 @@ namespace video
 		//! sets a render target
 		virtual void setRenderTarget(video::ISurface* surface, const core::rectEx<s32>& viewPort);
 
-		//! draws an indexed triangle list
-		virtual void drawIndexedTriangleList(S2DVertex* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount);
-
 		//! en or disables the backface culling
 		virtual void setBackfaceCulling(bool enabled = true);
 
 		//! sets the Texture
 		virtual void setTexture(video::ISurface* texture);
 
+		//! sets the lightmap
+		virtual void setTexture2(video::ISurface* texture);
+
+		//! sets the mip maps of the texture
+		virtual void setMipMaps(video::ISurface* const* mipMaps, s32 count);
+
+		//! the most mip maps used, enough for textures of 65536x65536
+		enum { MAX_MIPMAPS = 16 };
+
+		//! sets if the texture and its mip maps are stored in tiles
+		virtual void setTextureTiled(bool tiled);
+
+		//! sets the statistics the renderer adds its counters to
+		virtual void setStatistics(SRasterizerStatistics* statistics);
+
+		//! en or disables perspective correct texture coordinates
+		virtual void setPerspectiveCorrection(bool enabled);
+
 	protected:
 
 		//! vertauscht zwei vertizen
@@ -45,6 +113,97 @@ namespace video
 			*v2 = b;
 		}
 
+		//! returns if a texture surface of a size is stored in tiles of 4x4
+		//! texels. Surfaces smaller than a tile are stored row by row.
+		inline bool isTiled(const core::dimension2d<s32>& size) const
+		{
+			return TextureTiled && size.Width >= 4 && size.Height >= 4;
+		}
+
+		//! locks the palette of an EHCF_P8 texture surface for the span
+		//! kernels, returns 0 for other surfaces. Palettes are CSurfaces,
+		//! which do not need to be unlocked.
+		inline const void* lockPalette(video::ISurface* surface) const
+		{
+			return surface->getColorFormat() == EHCF_P8 ? surface->getPalette()->lock() : 0;
+		}
+
+		//! locks the zbuffer and selects the span kernels for the color
+		//! format of the render target and the format of the zbuffer
+		void lockZBuffer();
+
+		//! returns if a triangle is hidden in all blocks of the hierarchical
+		//! z buffer it touches. Updates the blocks it tests.
+		bool isOccluded(const S2DVertex* v1, const S2DVertex* v2, const S2DVertex* v3,
+			const core::rectEx<s32>& triangleRect);
+
+		//! shortens a span from both sides by the blocks it is hidden in. 
+		//! zMax is the largest z value of the span.
+		inline void clipSpanToBlocks(s32 y, s32& leftx, s32& rightx, s32 zMax) const
+		{
+			const SZBufferBlock* row = lockedBlocks + (y >> ZBUFFER_BLOCK_SHIFT) * BlockCountX;
+			const s32 mask = (1 << ZBUFFER_BLOCK_SHIFT) - 1;
+
+			while (leftx < rightx && row[leftx >> ZBUFFER_BLOCK_SHIFT].MinZ >= zMax)
+				leftx = (leftx | mask) + 1;
+
+			while (leftx < rightx && row[(rightx-1) >> ZBUFFER_BLOCK_SHIFT].MinZ >= zMax)
+				rightx = (rightx-1) & ~mask;
+		}
+
+		//! marks the blocks of a span as written
+		inline void markBlocks(s32 y, s32 leftx, s32 rightx)
+		{
+			SZBufferBlock* row = lockedBlocks + (y >> ZBUFFER_BLOCK_SHIFT) * BlockCountX;
+
+			for (s32 x = leftx >> ZBUFFER_BLOCK_SHIFT; x <= (rightx-1) >> ZBUFFER_BLOCK_SHIFT; ++x)
+				row[x].Dirty = true;
+		}
+
+		//! draws a span with perspective correct texture coordinates, in
+		//! subspans of PERSPECTIVE_SUBSPAN pixels. The span has to be set up
+		//! for its first visible pixel x, except for the texture coordinates.
+		//! \param spanStart: First pixel of the unclipped span.
+		//! \param spanWidth: Width of the unclipped span.
+		//! \param left: Perspective values at the left end of the span.
+		//! \param right: Perspective values at the right end of the span.
+		//! \param lightmap: True if the coordinates of the lightmap are needed.
+		//! \return Returns the amount of pixels written by the kernel.
+		s32 drawPerspectiveSpan(TDrawSpan kernel, SSpan& span, s32 x, s32 spanStart, s32 spanWidth,
+			const SPerspectiveValues& left, const SPerspectiveValues& right, bool lightmap);
+
+		//! returns the mip map level with about one texel per pixel for a
+		//! triangle, 0 for the texture itself. The level is selected by the
+		//! ratio of the area the triangle covers in the texture to the one
+		//! it covers on the screen.
+		s32 getMipMapLevel(const S2DVertex* v1, const S2DVertex* v2, const S2DVertex* v3) const;
+
+		//! returns the red channel of an A8R8G8B8 vertex color in the
+		//! precision of the render target
+		inline s32 getVertexRed(s32 color) const
+		{
+			return (color >> (16 + ChannelShift)) & ChannelMask;
+		}
+
+		//! returns the green channel of a vertex color
+		inline s32 getVertexGreen(s32 color) const
+		{
+			return (color >> (8 + ChannelShift)) & ChannelMask;
+		}
+
+		//! returns the blue channel of a vertex color
+		inline s32 getVertexBlue(s32 color) const
+		{
+			return (color >> ChannelShift) & ChannelMask;
+		}
+
+		//! returns the alpha of a vertex color, it has 8 bits for all
+		//! render targets
+		inline s32 getVertexAlpha(s32 color) const
+		{
+			return (color >> 24) & 0xFF;
+		}
+
 		video::ISurface* RenderTarget;
 		core::rectEx<s32> ViewPortRect;
 
@@ -52,13 +211,30 @@ namespace video
 
 		s32 SurfaceWidth;
 		s32 SurfaceHeight;
+		s32 SurfacePitch;
+		s32 PixelSize;
+		s32 ChannelShift, ChannelMask;
 		bool BackFaceCullingEnabled;
-		TZBufferType* lockedZBuffer;
-		s16* lockedSurface;
-		s16* lockedTexture;
+		bool PerspectiveCorrection;
+		c8* lockedZBuffer;
+		s32 ZBufferPitch;
+		s32 ZValueSize;
+		SZBufferBlock* lockedBlocks;
+		s32 BlockCountX;
+		void* lockedSurface;
+		void* lockedTexture;
 		s32 lockedTextureWidth;
 		s32 textureXMask, textureYMask;
 		video::ISurface* Texture;
+		video::ISurface* const* MipMaps;
+		s32 MipMapCount;			// at most MAX_MIPMAPS
+		bool TextureTiled;
+		void* lockedTexture2;
+		s32 lockedTexture2Width;
+		s32 texture2XMask, texture2YMask;
+		video::ISurface* Texture2;
+		SRasterizerStatistics* Statistics;
+		const SSpanKernels* SpanKernels;
 	};
 
 } // end namespace video
@@ -1,5 +1,5 @@
 #include "CTRTextureGouraud.h"
-#include "color.h"
+#include "Color.h"
 
 namespace irr
 {
@@ -23,16 +23,16 @@ public:
 	{
 		const S2DVertex *v1, *v2, *v3;
 
-		s16 color;
 		f32 tmpDiv; // temporary division factor
 		f32 longest; // saves the longest span
 		s32 height; // saves height of triangle
-		s16* targetSurface; // target pointer where to plot pixels
+		c8* targetSurface; // target pointer where to plot pixels
 		s32 spanEnd; // saves end of spans
 		f32 leftdeltaxf; // amount of pixels to increase on left side of triangle
 		f32 rightdeltaxf; // amount of pixels to increase on right side of triangle
 		s32 leftx, rightx; // position where we are 
-		f32 leftxf, rightxf; // same as above, but as f32 values
+		f32 leftxf, rightxf; // x of the edges at the rows they start
+		s32 leftEdgeY, rightEdgeY; // rows the edges start at
 		s32 span; // current span
 		s32 leftR, leftG, leftB, rightR, rightG, rightB; // color values
 		s32 leftStepR, leftStepG, leftStepB,
@@ -43,12 +43,27 @@ public:
 
 		s32 leftZValue, rightZValue;
 		s32 leftZStep, rightZStep;
-		TZBufferType* zTarget;//, *spanZTarget; // target of ZBuffer;
+		c8* zTarget;//, *spanZTarget; // target of ZBuffer;
+		SSpan pixels; // single pixels drawn by the span kernels
 
 		lockedSurface = RenderTarget->lock();
-		lockedZBuffer = ZBuffer->lock();
+		lockZBuffer();
 		lockedTexture = Texture->lock();
 
+		pixels.Count = 1;
+		pixels.ZStep = 0;
+		pixels.StepR = pixels.StepG = pixels.StepB = 0;
+		pixels.TxStep = pixels.TyStep = 0;
+		pixels.Texture = lockedTexture;
+		pixels.TextureWidth = lockedTextureWidth;
+		pixels.TextureXMask = textureXMask;
+		pixels.TextureYMask = textureYMask;
+		pixels.TextureTiled = isTiled(Texture->getDimension());
+		pixels.Palette = lockPalette(Texture);
+
+		SRasterizerStatistics stats; // counted locally, added to Statistics at the end
+		stats.Triangles = triangleCount;
+
 		for (s32 i=0; i<triangleCount; ++i)
 		{
 			v1 = &vertices[*indexList];
@@ -66,13 +81,19 @@ public:
 					((v3->Pos.Y - v1->Pos.Y) * (v3->Pos.X - v2->Pos.X));
 
 				if (z < 0)
+				{
+					++stats.BackFaceCulled;
 					continue;
+				}
 			}
 
 			//near plane clipping
 
 			if (v1->ZValue<0 && v2->ZValue<0 && v3->ZValue<0)
+			{
+				++stats.NearPlaneCulled;
 				continue;
+			}
 
 			// sort for width for inscreen clipping
 
@@ -81,7 +102,10 @@ public:
 			if (v2->Pos.X > v3->Pos.X)	swapVertices(&v2, &v3);
 
 			if ((v1->Pos.X - v3->Pos.X) == 0)
+			{
+				++stats.DegenerateCulled;
 				continue;
+			}
 
 			TriangleRect.UpperLeftCorner.X = v1->Pos.X;
 			TriangleRect.LowerRightCorner.X = v3->Pos.X;
@@ -96,13 +120,19 @@ public:
 			TriangleRect.LowerRightCorner.Y = v3->Pos.Y;
 
 			if (!TriangleRect.isRectCollided(ViewPortRect))
+			{
+				++stats.ViewPortCulled;
 				continue;
+			}
 
 
 			// hhe des dreiecks berechnen
 			height = v3->Pos.Y - v1->Pos.Y;
 			if (!height)
+			{
+				++stats.DegenerateCulled;
 				continue;
+			}
 
 			// calculate longest span
 
@@ -112,36 +142,37 @@ public:
 			span = v1->Pos.Y;
 			leftxf = (f32)v1->Pos.X;
 			rightxf = (f32)v1->Pos.X;
+			leftEdgeY = rightEdgeY = v1->Pos.Y;
 
 			leftZValue = v1->ZValue;
 			rightZValue = v1->ZValue;
 
-			leftR = rightR = video::getRed(v1->Color)<<8;
-			leftG = rightG = video::getGreen(v1->Color)<<8;
-			leftB = rightB = video::getBlue(v1->Color)<<8;
+			leftR = rightR = getVertexRed(v1->Color)<<8;
+			leftG = rightG = getVertexGreen(v1->Color)<<8;
+			leftB = rightB = getVertexBlue(v1->Color)<<8;
 			leftTx = rightTx = v1->TCoords.X;
 			leftTy = rightTy = v1->TCoords.Y;
 
-			targetSurface = lockedSurface + span * SurfaceWidth;
-			zTarget = lockedZBuffer + span * SurfaceWidth;
+			targetSurface = (c8*)lockedSurface + span * SurfacePitch;
+			zTarget = lockedZBuffer + span * ZBufferPitch;
 
 			if (longest < 0.0f)
 			{
 				tmpDiv = 1.0f / (f32)(v2->Pos.Y - v1->Pos.Y);
 				rightdeltaxf = (v2->Pos.X - v1->Pos.X) * tmpDiv;
 				rightZStep = (s32)((v2->ZValue - v1->ZValue) * tmpDiv);
-				rightStepR = (s32)(((video::getRed(v2->Color)<<8) - rightR) * tmpDiv);
-				rightStepG = (s32)(((video::getGreen(v2->Color)<<8) - rightG) * tmpDiv);
-				rightStepB = (s32)(((video::getBlue(v2->Color)<<8) - rightB) * tmpDiv);
+				rightStepR = (s32)(((getVertexRed(v2->Color)<<8) - rightR) * tmpDiv);
+				rightStepG = (s32)(((getVertexGreen(v2->Color)<<8) - rightG) * tmpDiv);
+				rightStepB = (s32)(((getVertexBlue(v2->Color)<<8) - rightB) * tmpDiv);
 				rightTxStep = (s32)((v2->TCoords.X - rightTx) * tmpDiv);
 				rightTyStep = (s32)((v2->TCoords.Y - rightTy) * tmpDiv);
 
 				tmpDiv = 1.0f / (f32)height;
 				leftdeltaxf = (v3->Pos.X - v1->Pos.X) * tmpDiv;
 				leftZStep = (s32)((v3->ZValue - v1->ZValue) * tmpDiv);
-				leftStepR = (s32)(((video::getRed(v3->Color)<<8) - leftR) * tmpDiv);
-				leftStepG = (s32)(((video::getGreen(v3->Color)<<8) - leftG) * tmpDiv);
-				leftStepB = (s32)(((video::getBlue(v3->Color)<<8) - leftB) * tmpDiv);
+				leftStepR = (s32)(((getVertexRed(v3->Color)<<8) - leftR) * tmpDiv);
+				leftStepG = (s32)(((getVertexGreen(v3->Color)<<8) - leftG) * tmpDiv);
+				leftStepB = (s32)(((getVertexBlue(v3->Color)<<8) - leftB) * tmpDiv);
 				leftTxStep = (s32)((v3->TCoords.X - leftTx) * tmpDiv);
 				leftTyStep = (s32)((v3->TCoords.Y - leftTy) * tmpDiv);
 			}
@@ -150,18 +181,18 @@ public:
 				tmpDiv = 1.0f / (f32)height;
 				rightdeltaxf = (v3->Pos.X - v1->Pos.X) * tmpDiv;
 				rightZStep = (s32)((v3->ZValue - v1->ZValue) * tmpDiv);
-				rightStepR = (s32)(((video::getRed(v3->Color)<<8) - rightR) * tmpDiv);
-				rightStepG = (s32)(((video::getGreen(v3->Color)<<8) - rightG) * tmpDiv);
-				rightStepB = (s32)(((video::getBlue(v3->Color)<<8) - rightB) * tmpDiv);
+				rightStepR = (s32)(((getVertexRed(v3->Color)<<8) - rightR) * tmpDiv);
+				rightStepG = (s32)(((getVertexGreen(v3->Color)<<8) - rightG) * tmpDiv);
+				rightStepB = (s32)(((getVertexBlue(v3->Color)<<8) - rightB) * tmpDiv);
 				rightTxStep = (s32)((v3->TCoords.X - rightTx) * tmpDiv);
 				rightTyStep = (s32)((v3->TCoords.Y - rightTy) * tmpDiv);
 
 				tmpDiv = 1.0f / (f32)(v2->Pos.Y - v1->Pos.Y);
 				leftdeltaxf = (v2->Pos.X - v1->Pos.X) * tmpDiv;
 				leftZStep = (s32)((v2->ZValue - v1->ZValue) * tmpDiv);
-				leftStepR = (s32)(((video::getRed(v2->Color)<<8) - leftR) * tmpDiv);
-				leftStepG = (s32)(((video::getGreen(v2->Color)<<8) - leftG) * tmpDiv);
-				leftStepB = (s32)(((video::getBlue(v2->Color)<<8) - leftB) * tmpDiv);
+				leftStepR = (s32)(((getVertexRed(v2->Color)<<8) - leftR) * tmpDiv);
+				leftStepG = (s32)(((getVertexGreen(v2->Color)<<8) - leftG) * tmpDiv);
+				leftStepB = (s32)(((getVertexBlue(v2->Color)<<8) - leftB) * tmpDiv);
 				leftTxStep = (s32)((v2->TCoords.X - leftTx) * tmpDiv);
 				leftTyStep = (s32)((v2->TCoords.Y - leftTy) * tmpDiv);
 			}
@@ -191,10 +222,8 @@ public:
 						span = ViewPortRect.UpperLeftCorner.Y;
 					}
 
-					leftxf += leftdeltaxf*leftx;
-					rightxf += rightdeltaxf*leftx;
-					targetSurface += SurfaceWidth*leftx;
-					zTarget += SurfaceWidth*leftx;
+					targetSurface = (c8*)lockedSurface + span * SurfacePitch;
+					zTarget = lockedZBuffer + span * ZBufferPitch;
 					leftZValue += leftZStep*leftx;
 					rightZValue += rightZStep*leftx;
 
@@ -216,40 +245,52 @@ public:
 
 				while (span < spanEnd)
 				{
-					leftx = (s32)(leftxf);
-					rightx = (s32)(rightxf + 0.5f);
+					++stats.SpansTested;
+
+					// the edges are calculated for every span instead of adding up the
+					// deltas, so they do not drift and do not depend on the viewport.
+					leftx = (s32)(leftxf + leftdeltaxf * (span - leftEdgeY));
+					rightx = (s32)(rightxf + rightdeltaxf * (span - rightEdgeY) + 0.5f);
 
 					// perform some clipping
 
 					if (leftx>=ViewPortRect.UpperLeftCorner.X &&
 						leftx<=ViewPortRect.LowerRightCorner.X)
 					{
-						if (leftZValue > *(zTarget + leftx))
-						{
-							*(zTarget + leftx) = leftZValue;
-							color = lockedTexture[((leftTy>>8)&textureYMask) * lockedTextureWidth + ((leftTx>>8)&textureXMask)];
-							*(targetSurface + leftx) = video::RGB16(video::getRed(color) * (leftR>>8) >>2, video::getGreen(color) * (leftG>>8) >>2, video::getBlue(color) * (leftR>>8) >>2);
-						}
+						pixels.Target = targetSurface + leftx * PixelSize;
+						pixels.ZTarget = zTarget + leftx * ZValueSize;
+						pixels.ZValue = leftZValue;
+						pixels.R = leftR;
+						pixels.G = leftG;
+						pixels.B = leftB;
+						pixels.Tx = leftTx;
+						pixels.Ty = leftTy;
+
+						++stats.PixelsTested;
+						stats.PixelsWritten += SpanKernels->Draw[ESF_TEXTURE | ESF_GOURAUD](pixels);
 					}
 
 
 					if (rightx>=ViewPortRect.UpperLeftCorner.X &&
 						rightx<=ViewPortRect.LowerRightCorner.X)
 					{
-						if (rightZValue > *(zTarget + rightx))
-						{
-							*(zTarget + rightx) = rightZValue;
-							color = lockedTexture[((rightTy>>8)&textureYMask) * lockedTextureWidth + ((rightTx>>8)&textureXMask)];
-							*(targetSurface + rightx) = video::RGB16(video::getRed(color) * (rightR>>8) >>2, video::getGreen(color) * (rightG>>8) >>2, video::getBlue(color) * (rightR>>8) >>2);
-						}
+						pixels.Target = targetSurface + rightx * PixelSize;
+						pixels.ZTarget = zTarget + rightx * ZValueSize;
+						pixels.ZValue = rightZValue;
+						pixels.R = rightR;
+						pixels.G = rightG;
+						pixels.B = rightB;
+						pixels.Tx = rightTx;
+						pixels.Ty = rightTy;
+
+						++stats.PixelsTested;
+						stats.PixelsWritten += SpanKernels->Draw[ESF_TEXTURE | ESF_GOURAUD](pixels);
 
 					}
 
-					leftxf += leftdeltaxf;
-					rightxf += rightdeltaxf;
 					++span;
-					targetSurface += SurfaceWidth;
-					zTarget += SurfaceWidth;
+					targetSurface += SurfacePitch;
+					zTarget += ZBufferPitch;
 					leftZValue += leftZStep;
 					rightZValue += rightZStep;
 
@@ -278,16 +319,17 @@ public:
 
 					rightdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
 					rightxf = (f32)v2->Pos.X;
+					rightEdgeY = v2->Pos.Y;
 
 					rightZValue = v2->ZValue;
 					rightZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
 
-					rightR = video::getRed(v2->Color)<<8;
-					rightG = video::getGreen(v2->Color)<<8;
-					rightB = video::getBlue(v2->Color)<<8;
-					rightStepR = (s32)(((video::getRed(v3->Color)<<8) - rightR) * tmpDiv);
-					rightStepG = (s32)(((video::getGreen(v3->Color)<<8) - rightG) * tmpDiv);
-					rightStepB = (s32)(((video::getBlue(v3->Color)<<8) - rightB) * tmpDiv);
+					rightR = getVertexRed(v2->Color)<<8;
+					rightG = getVertexGreen(v2->Color)<<8;
+					rightB = getVertexBlue(v2->Color)<<8;
+					rightStepR = (s32)(((getVertexRed(v3->Color)<<8) - rightR) * tmpDiv);
+					rightStepG = (s32)(((getVertexGreen(v3->Color)<<8) - rightG) * tmpDiv);
+					rightStepB = (s32)(((getVertexBlue(v3->Color)<<8) - rightB) * tmpDiv);
 
 					rightTx = v2->TCoords.X;
 					rightTy = v2->TCoords.Y;
@@ -300,16 +342,17 @@ public:
 
 					leftdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
 					leftxf = (f32)v2->Pos.X;
+					leftEdgeY = v2->Pos.Y;
 
 					leftZValue = v2->ZValue;
 					leftZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
 
-					leftR = video::getRed(v2->Color)<<8;
-					leftG = video::getGreen(v2->Color)<<8;
-					leftB = video::getBlue(v2->Color)<<8;
-					leftStepR = (s32)(((video::getRed(v3->Color)<<8) - leftR) * tmpDiv);
-					leftStepG = (s32)(((video::getGreen(v3->Color)<<8) - leftG) * tmpDiv);
-					leftStepB = (s32)(((video::getBlue(v3->Color)<<8) - leftB) * tmpDiv);
+					leftR = getVertexRed(v2->Color)<<8;
+					leftG = getVertexGreen(v2->Color)<<8;
+					leftB = getVertexBlue(v2->Color)<<8;
+					leftStepR = (s32)(((getVertexRed(v3->Color)<<8) - leftR) * tmpDiv);
+					leftStepG = (s32)(((getVertexGreen(v3->Color)<<8) - leftG) * tmpDiv);
+					leftStepB = (s32)(((getVertexBlue(v3->Color)<<8) - leftB) * tmpDiv);
 
 					leftTx = v2->TCoords.X;
 					leftTy = v2->TCoords.Y;
@@ -323,6 +366,12 @@ public:
 
 		}
 
+		if (Statistics)
+		{
+			stats.ZTestFailed = stats.PixelsTested - stats.PixelsWritten;
+			Statistics->add(stats);
+		}
+
 		RenderTarget->unlock();
 		ZBuffer->unlock();
 		Texture->unlock();
@@ -0,0 +1,761 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "CTRTextureGouraud.h"
+#include "Color.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! renderer of filled triangles with a combination F of E_SPAN_FEATURE flags.
+//! The features are constants, so the compiler removes the interpolation of
+//! the values the span kernel of F does not use.
+template <u32 F>
+class CTRTriangle : public CTRTextureGouraud
+{
+public:
+
+	CTRTriangle(IZBuffer* zbuffer)
+		: CTRTextureGouraud(zbuffer)
+	{
+		#ifdef _DEBUG
+		setDebugName("CTRTriangle");
+		#endif
+	}
+
+	//! draws an indexed triangle list
+	virtual void drawIndexedTriangleList(S2DVertex* vertices, s32, const u16* indexList, s32 triangleCount)
+	{
+		const S2DVertex *v1, *v2, *v3;
+
+		f32 tmpDiv; // temporary division factor
+		f32 longest; // saves the longest span
+		s32 height; // saves height of triangle
+		c8* targetSurface; // target pointer where to plot pixels
+		s32 spanEnd; // saves end of spans
+		f32 leftdeltaxf; // amount of pixels to increase on left side of triangle
+		f32 rightdeltaxf; // amount of pixels to increase on right side of triangle
+		s32 leftx, rightx; // position where we are
+		s32 spanWidth, spanSkip; // unclipped width of a span and pixels clipped at its left side
+		f32 leftxf, rightxf; // x of the edges at the rows they start
+		s32 leftEdgeY, rightEdgeY; // rows the edges start at
+		s32 span; // current span
+		s32 leftR = 0, leftG = 0, leftB = 0, rightR = 0, rightG = 0, rightB = 0; // color values
+		s32 leftStepR = 0, leftStepG = 0, leftStepB = 0,
+			rightStepR = 0, rightStepG = 0, rightStepB = 0; // color steps
+		s32 leftA = 0, rightA = 0, leftStepA = 0, rightStepA = 0; // alpha values and steps
+		s32 leftTx = 0, rightTx = 0, leftTy = 0, rightTy = 0; // texture interpolating values
+		s32 leftTxStep = 0, rightTxStep = 0, leftTyStep = 0, rightTyStep = 0; // texture interpolating values
+		s32 leftTx2 = 0, rightTx2 = 0, leftTy2 = 0, rightTy2 = 0; // lightmap interpolating values
+		s32 leftTx2Step = 0, rightTx2Step = 0, leftTy2Step = 0, rightTy2Step = 0; // lightmap interpolating values
+		SPerspectiveEdge leftEdge, rightEdge; // texture interpolating values for perspective correction
+		SPerspectiveValues leftValues, rightValues;
+		core::rectEx<s32> TriangleRect;
+
+		s32 leftZValue, rightZValue;
+		s32 written; // pixels written by a span
+		s32 leftZStep, rightZStep;
+		c8* zTarget; // target of ZBuffer
+		SSpan pixels; // span drawn by the span kernel
+		S2DVertex mipVertices[3]; // vertices with the texture coordinates of a mip map
+		s32 mipMapLevel = 0; // level the span kernel draws with, 0 for the texture
+		void* lockedMipMaps[MAX_MIPMAPS]; // locked when a triangle uses them first
+
+		for (s32 m=0; m<MipMapCount; ++m)
+			lockedMipMaps[m] = 0;
+
+		lockedSurface = RenderTarget->lock();
+		lockZBuffer();
+
+		const TDrawSpan drawSpan = SpanKernels->Draw[F];
+		const bool perspective = (F & (ESF_TEXTURE | ESF_LIGHTMAP)) && PerspectiveCorrection;
+
+		// perspective correct spans step all values of the span
+		pixels.R = pixels.G = pixels.B = pixels.A = 0;
+		pixels.StepR = pixels.StepG = pixels.StepB = pixels.StepA = 0;
+
+		if (F & ESF_TEXTURE)
+		{
+			lockedTexture = Texture->lock();
+
+			pixels.Texture = lockedTexture;
+			pixels.TextureWidth = lockedTextureWidth;
+			pixels.TextureXMask = textureXMask;
+			pixels.TextureYMask = textureYMask;
+			pixels.TextureTiled = isTiled(Texture->getDimension());
+			pixels.Palette = lockPalette(Texture);
+		}
+
+		if (F & ESF_LIGHTMAP)
+		{
+			lockedTexture2 = Texture2->lock();
+
+			pixels.Texture2 = lockedTexture2;
+			pixels.Texture2Width = lockedTexture2Width;
+			pixels.Texture2XMask = texture2XMask;
+			pixels.Texture2YMask = texture2YMask;
+			pixels.Palette2 = lockPalette(Texture2);
+		}
+
+		SRasterizerStatistics stats; // counted locally, added to Statistics at the end
+		stats.Triangles = triangleCount;
+
+		for (s32 i=0; i<triangleCount; ++i)
+		{
+			v1 = &vertices[*indexList];
+			++indexList;
+			v2 = &vertices[*indexList];
+			++indexList;
+			v3 = &vertices[*indexList];
+			++indexList;
+
+			// back face culling
+
+			if (BackFaceCullingEnabled)
+			{
+				s32 z = ((v3->Pos.X - v1->Pos.X) * (v3->Pos.Y - v2->Pos.Y)) -
+					((v3->Pos.Y - v1->Pos.Y) * (v3->Pos.X - v2->Pos.X));
+
+				if (z < 0)
+				{
+					++stats.BackFaceCulled;
+					continue;
+				}
+			}
+
+			//near plane clipping
+
+			if (v1->ZValue<0 && v2->ZValue<0 && v3->ZValue<0)
+			{
+				++stats.NearPlaneCulled;
+				continue;
+			}
+
+			// sort for width for inscreen clipping
+
+			if (v1->Pos.X > v2->Pos.X)	swapVertices(&v1, &v2);
+			if (v1->Pos.X > v3->Pos.X)	swapVertices(&v1, &v3);
+			if (v2->Pos.X > v3->Pos.X)	swapVertices(&v2, &v3);
+
+			if ((v1->Pos.X - v3->Pos.X) == 0)
+			{
+				++stats.DegenerateCulled;
+				continue;
+			}
+
+			TriangleRect.UpperLeftCorner.X = v1->Pos.X;
+			TriangleRect.LowerRightCorner.X = v3->Pos.X;
+
+			// sort for height for faster drawing.
+
+			if (v1->Pos.Y > v2->Pos.Y)	swapVertices(&v1, &v2);
+			if (v1->Pos.Y > v3->Pos.Y)	swapVertices(&v1, &v3);
+			if (v2->Pos.Y > v3->Pos.Y)	swapVertices(&v2, &v3);
+
+			TriangleRect.UpperLeftCorner.Y = v1->Pos.Y;
+			TriangleRect.LowerRightCorner.Y = v3->Pos.Y;
+
+			if (!TriangleRect.isRectCollided(ViewPortRect))
+			{
+				++stats.ViewPortCulled;
+				continue;
+			}
+
+			// hierarchical z test
+
+			if (!(F & ESF_NO_ZTEST) && isOccluded(v1, v2, v3, TriangleRect))
+			{
+				++stats.HiZCulled;
+				continue;
+			}
+
+
+			// mip map with about one texel per pixel
+
+			if ((F & ESF_TEXTURE) && MipMapCount)
+			{
+				const s32 level = getMipMapLevel(v1, v2, v3);
+
+				if (level != mipMapLevel)
+				{
+					video::ISurface* surface = Texture;
+					pixels.Texture = lockedTexture;
+
+					if (level)
+					{
+						surface = MipMaps[level-1];
+
+						if (!lockedMipMaps[level-1])
+							lockedMipMaps[level-1] = surface->lock();
+
+						pixels.Texture = lockedMipMaps[level-1];
+					}
+
+					mipMapLevel = level;
+					pixels.TextureWidth = surface->getDimension().Width;
+					pixels.TextureXMask = pixels.TextureWidth-1;
+					pixels.TextureYMask = surface->getDimension().Height-1;
+					pixels.TextureTiled = isTiled(surface->getDimension());
+					pixels.Palette = lockPalette(surface);
+				}
+
+				if (level)
+				{
+					mipVertices[0] = *v1;
+					mipVertices[1] = *v2;
+					mipVertices[2] = *v3;
+
+					for (s32 m=0; m<3; ++m)
+					{
+						mipVertices[m].TCoords.X >>= level;
+						mipVertices[m].TCoords.Y >>= level;
+					}
+
+					v1 = &mipVertices[0];
+					v2 = &mipVertices[1];
+					v3 = &mipVertices[2];
+				}
+			}
+
+			// calculate height of triangle
+			height = v3->Pos.Y - v1->Pos.Y;
+			if (!height)
+			{
+				++stats.DegenerateCulled;
+				continue;
+			}
+
+			// calculate longest span
+
+			longest = (v2->Pos.Y - v1->Pos.Y) / (f32)height * (v3->Pos.X - v1->Pos.X) + (v1->Pos.X - v2->Pos.X);
+
+			spanEnd = v2->Pos.Y;
+			span = v1->Pos.Y;
+			leftxf = (f32)v1->Pos.X;
+			rightxf = (f32)v1->Pos.X;
+			leftEdgeY = rightEdgeY = v1->Pos.Y;
+
+			leftZValue = v1->ZValue;
+			rightZValue = v1->ZValue;
+
+			if (F & ESF_GOURAUD)
+			{
+				leftR = rightR = getVertexRed(v1->Color)<<8;
+				leftG = rightG = getVertexGreen(v1->Color)<<8;
+				leftB = rightB = getVertexBlue(v1->Color)<<8;
+				leftA = rightA = getVertexAlpha(v1->Color)<<8;
+			}
+			else
+				pixels.Color = v1->Color;
+
+			if (F & ESF_TEXTURE)
+			{
+				leftTx = rightTx = v1->TCoords.X;
+				leftTy = rightTy = v1->TCoords.Y;
+			}
+
+			if (F & ESF_LIGHTMAP)
+			{
+				leftTx2 = rightTx2 = v1->TCoords2.X;
+				leftTy2 = rightTy2 = v1->TCoords2.Y;
+			}
+
+			targetSurface = (c8*)lockedSurface + span * SurfacePitch;
+			zTarget = lockedZBuffer + span * ZBufferPitch;
+
+			if (longest < 0.0f)
+			{
+				tmpDiv = 1.0f / (f32)(v2->Pos.Y - v1->Pos.Y);
+				rightdeltaxf = (v2->Pos.X - v1->Pos.X) * tmpDiv;
+				rightZStep = (s32)((v2->ZValue - v1->ZValue) * tmpDiv);
+				setColorSteps(v2, rightR, rightG, rightB, rightStepR, rightStepG, rightStepB, tmpDiv);
+				setAlphaSteps(v2, rightA, rightStepA, tmpDiv);
+				setTextureSteps(v1, v2, rightTx, rightTy, rightTxStep, rightTyStep, rightEdge, tmpDiv);
+				setLightmapSteps(v2, rightTx2, rightTy2, rightTx2Step, rightTy2Step, tmpDiv);
+
+				tmpDiv = 1.0f / (f32)height;
+				leftdeltaxf = (v3->Pos.X - v1->Pos.X) * tmpDiv;
+				leftZStep = (s32)((v3->ZValue - v1->ZValue) * tmpDiv);
+				setColorSteps(v3, leftR, leftG, leftB, leftStepR, leftStepG, leftStepB, tmpDiv);
+				setAlphaSteps(v3, leftA, leftStepA, tmpDiv);
+				setTextureSteps(v1, v3, leftTx, leftTy, leftTxStep, leftTyStep, leftEdge, tmpDiv);
+				setLightmapSteps(v3, leftTx2, leftTy2, leftTx2Step, leftTy2Step, tmpDiv);
+			}
+			else
+			{
+				tmpDiv = 1.0f / (f32)height;
+				rightdeltaxf = (v3->Pos.X - v1->Pos.X) * tmpDiv;
+				rightZStep = (s32)((v3->ZValue - v1->ZValue) * tmpDiv);
+				setColorSteps(v3, rightR, rightG, rightB, rightStepR, rightStepG, rightStepB, tmpDiv);
+				setAlphaSteps(v3, rightA, rightStepA, tmpDiv);
+				setTextureSteps(v1, v3, rightTx, rightTy, rightTxStep, rightTyStep, rightEdge, tmpDiv);
+				setLightmapSteps(v3, rightTx2, rightTy2, rightTx2Step, rightTy2Step, tmpDiv);
+
+				tmpDiv = 1.0f / (f32)(v2->Pos.Y - v1->Pos.Y);
+				leftdeltaxf = (v2->Pos.X - v1->Pos.X) * tmpDiv;
+				leftZStep = (s32)((v2->ZValue - v1->ZValue) * tmpDiv);
+				setColorSteps(v2, leftR, leftG, leftB, leftStepR, leftStepG, leftStepB, tmpDiv);
+				setAlphaSteps(v2, leftA, leftStepA, tmpDiv);
+				setTextureSteps(v1, v2, leftTx, leftTy, leftTxStep, leftTyStep, leftEdge, tmpDiv);
+				setLightmapSteps(v2, leftTx2, leftTy2, leftTx2Step, leftTy2Step, tmpDiv);
+			}
+
+
+			// do it twice, once for the first half of the triangle,
+			// end then for the second half.
+
+			for (s32 triangleHalf=0; triangleHalf<2; ++triangleHalf)
+			{
+				if (spanEnd > ViewPortRect.LowerRightCorner.Y)
+					spanEnd = ViewPortRect.LowerRightCorner.Y;
+
+				// if the span <0, than we can skip these spans,
+				// and proceed to the next spans which are really on the screen.
+				if (span < ViewPortRect.UpperLeftCorner.Y)
+				{
+					// we'll use leftx as temp variable
+					if (spanEnd < ViewPortRect.UpperLeftCorner.Y)
+					{
+						leftx = spanEnd - span;
+						span = spanEnd;
+					}
+					else
+					{
+						leftx = ViewPortRect.UpperLeftCorner.Y - span;
+						span = ViewPortRect.UpperLeftCorner.Y;
+					}
+
+					targetSurface = (c8*)lockedSurface + span * SurfacePitch;
+					zTarget = lockedZBuffer + span * ZBufferPitch;
+					leftZValue += leftZStep*leftx;
+					rightZValue += rightZStep*leftx;
+
+					if (F & ESF_GOURAUD)
+					{
+						leftR += leftStepR*leftx;
+						leftG += leftStepG*leftx;
+						leftB += leftStepB*leftx;
+						rightR += rightStepR*leftx;
+						rightG += rightStepG*leftx;
+						rightB += rightStepB*leftx;
+						leftA += leftStepA*leftx;
+						rightA += rightStepA*leftx;
+					}
+
+					if (F & ESF_TEXTURE)
+					{
+						leftTx += leftTxStep*leftx;
+						leftTy += leftTyStep*leftx;
+						rightTx += rightTxStep*leftx;
+						rightTy += rightTyStep*leftx;
+					}
+
+					if (F & ESF_LIGHTMAP)
+					{
+						leftTx2 += leftTx2Step*leftx;
+						leftTy2 += leftTy2Step*leftx;
+						rightTx2 += rightTx2Step*leftx;
+						rightTy2 += rightTy2Step*leftx;
+					}
+				}
+
+
+				// the main loop. Go through every span and draw it.
+
+				while (span < spanEnd)
+				{
+					++stats.SpansTested;
+
+					// the edges are calculated for every span instead of adding up the
+					// deltas, so they do not drift and do not depend on the viewport.
+					leftx = (s32)(leftxf + leftdeltaxf * (span - leftEdgeY));
+					rightx = (s32)(rightxf + rightdeltaxf * (span - rightEdgeY) + 0.5f);
+					spanWidth = rightx - leftx;
+					spanSkip = leftx;
+
+					// perform some clipping
+
+					// the span is interpolated over its unclipped width, clipping
+					// the left side only skips pixels. This keeps the gradients
+					// independent of the viewport, which tiled rendering relies on.
+
+					if (leftx<ViewPortRect.UpperLeftCorner.X)
+						leftx = ViewPortRect.UpperLeftCorner.X;
+					else
+						if (leftx>ViewPortRect.LowerRightCorner.X)
+							leftx = ViewPortRect.LowerRightCorner.X;
+
+					if (rightx<ViewPortRect.UpperLeftCorner.X)
+						rightx = ViewPortRect.UpperLeftCorner.X;
+					else
+						if (rightx>ViewPortRect.LowerRightCorner.X)
+							rightx = ViewPortRect.LowerRightCorner.X;
+
+					// skip the blocks of the hierarchical z buffer hiding the span
+
+					if (!(F & ESF_NO_ZTEST))
+						clipSpanToBlocks(span, leftx, rightx, leftZValue > rightZValue ? leftZValue : rightZValue);
+
+					// draw the span
+
+					if (rightx - leftx > 0)
+					{
+						tmpDiv = 1.0f / spanWidth;
+						spanSkip = leftx - spanSkip;
+
+						pixels.Target = targetSurface + leftx * PixelSize;
+						pixels.ZTarget = zTarget + leftx * ZValueSize;
+						pixels.Count = rightx - leftx;
+
+						pixels.ZStep = (s32)((rightZValue - leftZValue) * tmpDiv);
+						pixels.ZValue = leftZValue + pixels.ZStep * spanSkip;
+
+						if (F & ESF_GOURAUD)
+						{
+							pixels.StepR = (s32)((rightR - leftR) * tmpDiv);
+							pixels.StepG = (s32)((rightG - leftG) * tmpDiv);
+							pixels.StepB = (s32)((rightB - leftB) * tmpDiv);
+							pixels.R = leftR + pixels.StepR * spanSkip;
+							pixels.G = leftG + pixels.StepG * spanSkip;
+							pixels.B = leftB + pixels.StepB * spanSkip;
+						}
+
+						if ((F & ESF_GOURAUD) && (F & ESF_BLEND_ALPHA))
+						{
+							pixels.StepA = (s32)((rightA - leftA) * tmpDiv);
+							pixels.A = leftA + pixels.StepA * spanSkip;
+						}
+
+						stats.PixelsTested += pixels.Count;
+
+						if (perspective)
+						{
+							leftEdge.get(span - leftEdgeY, leftValues);
+							rightEdge.get(span - rightEdgeY, rightValues);
+							written = drawPerspectiveSpan(drawSpan, pixels,
+								leftx, leftx - spanSkip, spanWidth, leftValues, rightValues, (F & ESF_LIGHTMAP) != 0);
+						}
+						else
+						{
+							if (F & ESF_TEXTURE)
+							{
+								pixels.TxStep = (s32)((rightTx - leftTx) * tmpDiv);
+								pixels.TyStep = (s32)((rightTy - leftTy) * tmpDiv);
+								pixels.Tx = leftTx + pixels.TxStep * spanSkip;
+								pixels.Ty = leftTy + pixels.TyStep * spanSkip;
+							}
+
+							if (F & ESF_LIGHTMAP)
+							{
+								pixels.Tx2Step = (s32)((rightTx2 - leftTx2) * tmpDiv);
+								pixels.Ty2Step = (s32)((rightTy2 - leftTy2) * tmpDiv);
+								pixels.Tx2 = leftTx2 + pixels.Tx2Step * spanSkip;
+								pixels.Ty2 = leftTy2 + pixels.Ty2Step * spanSkip;
+							}
+
+							written = drawSpan(pixels);
+						}
+
+						// spans which do not write z values leave the blocks as they are
+						if (written && !(F & (ESF_NO_ZTEST | ESF_NO_ZWRITE)))
+							markBlocks(span, leftx, rightx);
+						stats.PixelsWritten += written;
+					}
+
+					++span;
+					targetSurface += SurfacePitch;
+					zTarget += ZBufferPitch;
+					leftZValue += leftZStep;
+					rightZValue += rightZStep;
+
+					if (F & ESF_GOURAUD)
+					{
+						leftR += leftStepR;
+						leftG += leftStepG;
+						leftB += leftStepB;
+						rightR += rightStepR;
+						rightG += rightStepG;
+						rightB += rightStepB;
+						leftA += leftStepA;
+						rightA += rightStepA;
+					}
+
+					if (F & ESF_TEXTURE)
+					{
+						leftTx += leftTxStep;
+						leftTy += leftTyStep;
+						rightTx += rightTxStep;
+						rightTy += rightTyStep;
+					}
+
+					if (F & ESF_LIGHTMAP)
+					{
+						leftTx2 += leftTx2Step;
+						leftTy2 += leftTy2Step;
+						rightTx2 += rightTx2Step;
+						rightTy2 += rightTy2Step;
+					}
+				}
+
+				if (triangleHalf>0) // break, we've gout only two halves
+					break;
+
+
+				// setup variables for second half of the triangle.
+
+				if (longest < 0.0f)
+				{
+					tmpDiv = 1.0f / (v3->Pos.Y - v2->Pos.Y);
+
+					rightdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
+					rightxf = (f32)v2->Pos.X;
+					rightEdgeY = v2->Pos.Y;
+
+					rightZValue = v2->ZValue;
+					rightZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
+
+					if (F & ESF_GOURAUD)
+					{
+						rightR = getVertexRed(v2->Color)<<8;
+						rightG = getVertexGreen(v2->Color)<<8;
+						rightB = getVertexBlue(v2->Color)<<8;
+						rightA = getVertexAlpha(v2->Color)<<8;
+						setColorSteps(v3, rightR, rightG, rightB, rightStepR, rightStepG, rightStepB, tmpDiv);
+						setAlphaSteps(v3, rightA, rightStepA, tmpDiv);
+					}
+
+					if (F & ESF_TEXTURE)
+					{
+						rightTx = v2->TCoords.X;
+						rightTy = v2->TCoords.Y;
+					}
+
+					if (F & ESF_LIGHTMAP)
+					{
+						rightTx2 = v2->TCoords2.X;
+						rightTy2 = v2->TCoords2.Y;
+					}
+
+					setTextureSteps(v2, v3, rightTx, rightTy, rightTxStep, rightTyStep, rightEdge, tmpDiv);
+					setLightmapSteps(v3, rightTx2, rightTy2, rightTx2Step, rightTy2Step, tmpDiv);
+				}
+				else
+				{
+					tmpDiv = 1.0f / (v3->Pos.Y - v2->Pos.Y);
+
+					leftdeltaxf = (v3->Pos.X - v2->Pos.X) * tmpDiv;
+					leftxf = (f32)v2->Pos.X;
+					leftEdgeY = v2->Pos.Y;
+
+					leftZValue = v2->ZValue;
+					leftZStep = (s32)((v3->ZValue - v2->ZValue) * tmpDiv);
+
+					if (F & ESF_GOURAUD)
+					{
+						leftR = getVertexRed(v2->Color)<<8;
+						leftG = getVertexGreen(v2->Color)<<8;
+						leftB = getVertexBlue(v2->Color)<<8;
+						leftA = getVertexAlpha(v2->Color)<<8;
+						setColorSteps(v3, leftR, leftG, leftB, leftStepR, leftStepG, leftStepB, tmpDiv);
+						setAlphaSteps(v3, leftA, leftStepA, tmpDiv);
+					}
+
+					if (F & ESF_TEXTURE)
+					{
+						leftTx = v2->TCoords.X;
+						leftTy = v2->TCoords.Y;
+					}
+
+					if (F & ESF_LIGHTMAP)
+					{
+						leftTx2 = v2->TCoords2.X;
+						leftTy2 = v2->TCoords2.Y;
+					}
+
+					setTextureSteps(v2, v3, leftTx, leftTy, leftTxStep, leftTyStep, leftEdge, tmpDiv);
+					setLightmapSteps(v3, leftTx2, leftTy2, leftTx2Step, leftTy2Step, tmpDiv);
+				}
+
+
+				spanEnd = v3->Pos.Y;
+			}
+
+		}
+
+		if (Statistics)
+		{
+			stats.ZTestFailed = stats.PixelsTested - stats.PixelsWritten;
+			Statistics->add(stats);
+		}
+
+		RenderTarget->unlock();
+		ZBuffer->unlock();
+
+		if (F & ESF_TEXTURE)
+		{
+			Texture->unlock();
+
+			for (s32 m=0; m<MipMapCount; ++m)
+				if (lockedMipMaps[m])
+					MipMaps[m]->unlock();
+		}
+
+		if (F & ESF_LIGHTMAP)
+			Texture2->unlock();
+	}
+
+private:
+
+	//! sets the color steps of an edge to a vertex, from the colors at its start
+	inline void setColorSteps(const S2DVertex* to, s32 r, s32 g, s32 b,
+		s32& stepR, s32& stepG, s32& stepB, f32 invHeight) const
+	{
+		if (!(F & ESF_GOURAUD))
+			return;
+
+		stepR = (s32)(((getVertexRed(to->Color)<<8) - r) * invHeight);
+		stepG = (s32)(((getVertexGreen(to->Color)<<8) - g) * invHeight);
+		stepB = (s32)(((getVertexBlue(to->Color)<<8) - b) * invHeight);
+	}
+
+	//! sets the alpha step of an edge to a vertex, from the alpha at its start.
+	//! The alpha is only interpolated for blending by the vertex alpha.
+	inline void setAlphaSteps(const S2DVertex* to, s32 a, s32& stepA, f32 invHeight) const
+	{
+		if (!((F & ESF_GOURAUD) && (F & ESF_BLEND_ALPHA)))
+			return;
+
+		stepA = (s32)(((getVertexAlpha(to->Color)<<8) - a) * invHeight);
+	}
+
+	//! sets the texture coordinate steps of an edge between two vertices,
+	//! from the texture coordinates at its start. The perspective edge 
+	//! holds the coordinates of the lightmap too.
+	inline void setTextureSteps(const S2DVertex* from, const S2DVertex* to, s32 tx, s32 ty,
+		s32& stepTx, s32& stepTy, SPerspectiveEdge& edge, f32 invHeight) const
+	{
+		if (F & ESF_TEXTURE)
+		{
+			stepTx = (s32)((to->TCoords.X - tx) * invHeight);
+			stepTy = (s32)((to->TCoords.Y - ty) * invHeight);
+		}
+
+		if (F & (ESF_TEXTURE | ESF_LIGHTMAP))
+			edge.set(from, to, invHeight);
+	}
+
+	//! sets the lightmap coordinate steps of an edge to a vertex, from the
+	//! lightmap coordinates at its start
+	inline void setLightmapSteps(const S2DVertex* to, s32 tx2, s32 ty2,
+		s32& stepTx2, s32& stepTy2, f32 invHeight) const
+	{
+		if (!(F & ESF_LIGHTMAP))
+			return;
+
+		stepTx2 = (s32)((to->TCoords2.X - tx2) * invHeight);
+		stepTy2 = (s32)((to->TCoords2.Y - ty2) * invHeight);
+	}
+};
+
+
+
+//! creates the renderer of a combination of features. The combinations are
+//! counted down from F at compile time, until the one asked for is found.
+template <u32 F>
+struct STriangleRendererFactory
+{
+	static IK3DTriangleRenderer* create(u32 features, IZBuffer* zbuffer)
+	{
+		if (features == F)
+			return new CTRTriangle<F>(zbuffer);
+
+		return STriangleRendererFactory<F-1>::create(features, zbuffer);
+	}
+};
+
+template <>
+struct STriangleRendererFactory<0>
+{
+	static IK3DTriangleRenderer* create(u32, IZBuffer* zbuffer)
+	{
+		return new CTRTriangle<0>(zbuffer);
+	}
+};
+
+
+
+//! creates a triangle renderer
+IK3DTriangleRenderer* createTriangleRenderer(ETriangleRenderer renderer, IZBuffer* zbuffer)
+{
+	switch(renderer)
+	{
+	case ETR_FLAT_WIRE:
+		return createTriangleRendererFlatWire(zbuffer);
+	case ETR_GOURAUD_WIRE:
+		return createTriangleRendererGouraudWire(zbuffer);
+	case ETR_TEXTURE_FLAT_WIRE:
+		return createTriangleRendererTextureFlatWire(zbuffer);
+	case ETR_TEXTURE_GOURAUD_WIRE:
+		return createTriangleRendererTextureGouraudWire(zbuffer);
+	case ETR_OVERDRAW:
+		return createTriangleRendererOverdraw(zbuffer);
+	default:
+		return STriangleRendererFactory<ESF_COUNT-1>::create(renderer, zbuffer);
+	}
+}
+
+
+
+//! returns the name of a triangle renderer
+core::stringc getTriangleRendererName(ETriangleRenderer renderer)
+{
+	switch(renderer)
+	{
+	case ETR_FLAT_WIRE:
+		return "flat wire";
+	case ETR_GOURAUD_WIRE:
+		return "gouraud wire";
+	case ETR_TEXTURE_FLAT_WIRE:
+		return "texture flat wire";
+	case ETR_TEXTURE_GOURAUD_WIRE:
+		return "texture gouraud wire";
+	case ETR_OVERDRAW:
+		return "overdraw";
+	default:
+		break;
+	}
+
+	core::stringc name;
+
+	if (renderer & ESF_TEXTURE)
+		name = (renderer & ESF_GOURAUD) ? "texture gouraud" : "texture flat";
+	else
+		name = (renderer & ESF_GOURAUD) ? "gouraud" : "flat";
+
+	if (renderer & ESF_LIGHTMAP)
+		name.append(core::stringc(" lightmap"));
+
+	if (renderer & ESF_BLEND_ADD)
+		name.append(core::stringc(" add"));
+
+	if (renderer & ESF_BLEND_ALPHA)
+		name.append(core::stringc(" alpha"));
+
+	if (renderer & ESF_BILINEAR)
+		name.append(core::stringc(" bilinear"));
+
+	if (renderer & ESF_NO_ZTEST)
+		name.append(core::stringc(" without z buffer"));
+	else
+	if (renderer & ESF_NO_ZWRITE)
+		name.append(core::stringc(" without z write"));
+
+	return name;
+}
+
+
+} // end namespace video
+} // end namespace irr
\ No newline at end of file
@@ -0,0 +1,299 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "CThreadPool.h"
+
+#ifdef WIN32
+
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600 // condition variables
+#endif
+#include <windows.h>
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+
+#endif
+
+namespace irr
+{
+
+#ifdef WIN32
+
+//! windows specific part of the thread pool
+struct CThreadPool::SPlatformData
+{
+	CRITICAL_SECTION Mutex;
+	CONDITION_VARIABLE WorkReady;
+	CONDITION_VARIABLE WorkDone;
+	HANDLE* Threads;
+
+	SPlatformData(s32 workerCount)
+	{
+		InitializeCriticalSection(&Mutex);
+		InitializeConditionVariable(&WorkReady);
+		InitializeConditionVariable(&WorkDone);
+		Threads = new HANDLE[workerCount];
+	}
+
+	~SPlatformData()
+	{
+		DeleteCriticalSection(&Mutex);
+		delete [] Threads;
+	}
+
+	void lock() { EnterCriticalSection(&Mutex); }
+	void unlock() { LeaveCriticalSection(&Mutex); }
+	void wait(CONDITION_VARIABLE* condition) { SleepConditionVariableCS(condition, &Mutex, INFINITE); }
+	void wakeAll(CONDITION_VARIABLE* condition) { WakeAllConditionVariable(condition); }
+
+	static DWORD WINAPI threadMain(LPVOID start)
+	{
+		SThreadStart* s = (SThreadStart*)start;
+		s->Pool->work(s->Index);
+		return 0;
+	}
+
+	void startThread(s32 worker, SThreadStart* start)
+	{
+		Threads[worker] = CreateThread(0, 0, threadMain, start, 0, 0);
+	}
+
+	void joinThread(s32 worker)
+	{
+		WaitForSingleObject(Threads[worker], INFINITE);
+		CloseHandle(Threads[worker]);
+	}
+};
+
+#else
+
+//! posix specific part of the thread pool
+struct CThreadPool::SPlatformData
+{
+	pthread_mutex_t Mutex;
+	pthread_cond_t WorkReady;
+	pthread_cond_t WorkDone;
+	pthread_t* Threads;
+
+	SPlatformData(s32 workerCount)
+	{
+		pthread_mutex_init(&Mutex, 0);
+		pthread_cond_init(&WorkReady, 0);
+		pthread_cond_init(&WorkDone, 0);
+		Threads = new pthread_t[workerCount];
+	}
+
+	~SPlatformData()
+	{
+		pthread_cond_destroy(&WorkDone);
+		pthread_cond_destroy(&WorkReady);
+		pthread_mutex_destroy(&Mutex);
+		delete [] Threads;
+	}
+
+	void lock() { pthread_mutex_lock(&Mutex); }
+	void unlock() { pthread_mutex_unlock(&Mutex); }
+	void wait(pthread_cond_t* condition) { pthread_cond_wait(condition, &Mutex); }
+	void wakeAll(pthread_cond_t* condition) { pthread_cond_broadcast(condition); }
+
+	static void* threadMain(void* start)
+	{
+		SThreadStart* s = (SThreadStart*)start;
+		s->Pool->work(s->Index);
+		return 0;
+	}
+
+	void startThread(s32 worker, SThreadStart* start)
+	{
+		pthread_create(&Threads[worker], 0, threadMain, start);
+	}
+
+	void joinThread(s32 worker)
+	{
+		pthread_join(Threads[worker], 0);
+	}
+};
+
+#endif
+
+
+
+//! constructor
+CThreadPool::CThreadPool(s32 threadCount)
+: Platform(0), Starts(0), ThreadCount(threadCount), Task(0), PartCount(0),
+	NextPart(0), PartsDone(0), Generation(0), Quit(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CThreadPool");
+	#endif
+
+	if (ThreadCount < 1)
+		ThreadCount = getProcessorCount();
+
+	if (ThreadCount < 2)
+	{
+		// no workers needed, everything is run by the calling thread
+		ThreadCount = 1;
+		return;
+	}
+
+	s32 workerCount = ThreadCount - 1;
+	Platform = new SPlatformData(workerCount);
+	Starts = new SThreadStart[workerCount];
+
+	for (s32 i=0; i<workerCount; ++i)
+	{
+		Starts[i].Pool = this;
+		Starts[i].Index = i + 1;
+		Platform->startThread(i, &Starts[i]);
+	}
+}
+
+
+
+//! destructor
+CThreadPool::~CThreadPool()
+{
+	if (!Platform)
+		return;
+
+	Platform->lock();
+	Quit = true;
+	Platform->wakeAll(&Platform->WorkReady);
+	Platform->unlock();
+
+	for (s32 i=0; i<ThreadCount-1; ++i)
+		Platform->joinThread(i);
+
+	delete Platform;
+	delete [] Starts;
+}
+
+
+
+//! returns the amount of threads working on a task, including the calling thread.
+s32 CThreadPool::getThreadCount()
+{
+	return ThreadCount;
+}
+
+
+
+//! runs all parts of a task and returns when all of them are finished.
+void CThreadPool::run(IThreadTask* task, s32 partCount)
+{
+	if (!task || partCount < 1)
+		return;
+
+	if (!Platform)
+	{
+		for (s32 i=0; i<partCount; ++i)
+			task->runTask(i, 0);
+		return;
+	}
+
+	Platform->lock();
+
+	Task = task;
+	PartCount = partCount;
+	NextPart = 0;
+	PartsDone = 0;
+	++Generation;
+	Platform->wakeAll(&Platform->WorkReady);
+
+	runParts(0);
+
+	while (PartsDone < PartCount)
+		Platform->wait(&Platform->WorkDone);
+
+	Task = 0;
+	PartCount = 0;
+	NextPart = 0;
+
+	Platform->unlock();
+}
+
+
+
+//! loop of the worker threads
+void CThreadPool::work(s32 thread)
+{
+	u32 generation = 0;
+
+	Platform->lock();
+
+	while(true)
+	{
+		while (!Quit && generation == Generation)
+			Platform->wait(&Platform->WorkReady);
+
+		if (Quit)
+			break;
+
+		generation = Generation;
+		runParts(thread);
+	}
+
+	Platform->unlock();
+}
+
+
+
+//! runs parts of the current task until there are none left.
+void CThreadPool::runParts(s32 thread)
+{
+	while (NextPart < PartCount)
+	{
+		s32 part = NextPart;
+		++NextPart;
+
+		Platform->unlock();
+		Task->runTask(part, thread);
+		Platform->lock();
+
+		++PartsDone;
+		if (PartsDone == PartCount)
+			Platform->wakeAll(&Platform->WorkDone);
+	}
+}
+
+
+
+//! locks the pool
+void CThreadPool::lock()
+{
+	if (Platform)
+		Platform->lock();
+}
+
+
+
+//! unlocks the pool
+void CThreadPool::unlock()
+{
+	if (Platform)
+		Platform->unlock();
+}
+
+
+
+//! returns the amount of processors of the system
+s32 CThreadPool::getProcessorCount()
+{
+#ifdef WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (s32)info.dwNumberOfProcessors;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (s32)count : 1;
+#endif
+}
+
+
+} // end namespace irr
+
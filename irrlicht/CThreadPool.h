@@ -0,0 +1,93 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __C_THREAD_POOL_H_INCLUDED__
+#define __C_THREAD_POOL_H_INCLUDED__
+
+#include "IUnknown.h"
+
+namespace irr
+{
+
+	//! A task which consists of independent parts, which can be run by a CThreadPool.
+	class IThreadTask
+	{
+	public:
+
+		//! destructor
+		virtual ~IThreadTask() {};
+
+		//! runs one part of the task.
+		//! \param part: Index of the part to run.
+		//! \param thread: Index of the thread running the part. 0 is the thread
+		//! which called CThreadPool::run(), the worker threads are 1 to getThreadCount()-1.
+		virtual void runTask(s32 part, s32 thread) = 0;
+	};
+
+
+
+	//! Keeps some worker threads alive, and runs the parts of tasks on them.
+	class CThreadPool : public IUnknown
+	{
+	public:
+
+		//! constructor
+		//! \param threadCount: Amount of threads working on a task, including the
+		//! thread calling run(). 0 uses one thread per processor.
+		CThreadPool(s32 threadCount);
+
+		//! destructor
+		virtual ~CThreadPool();
+
+		//! returns the amount of threads working on a task, including the calling thread.
+		s32 getThreadCount();
+
+		//! runs all parts of a task and returns when all of them are finished.
+		//! The calling thread works on the task too.
+		void run(IThreadTask* task, s32 partCount);
+
+		//! locks the pool. Parts of a task can use this to protect data shared
+		//! between the threads, like reference counters.
+		void lock();
+
+		//! unlocks the pool
+		void unlock();
+
+		//! returns the amount of processors of the system
+		static s32 getProcessorCount();
+
+	private:
+
+		struct SPlatformData;
+		friend struct SPlatformData;
+
+		struct SThreadStart
+		{
+			CThreadPool* Pool;
+			s32 Index;
+		};
+
+		//! loop of the worker threads
+		void work(s32 thread);
+
+		//! runs parts of the current task until there are none left. Has to
+		//! be called with the mutex locked, and returns with the mutex locked.
+		void runParts(s32 thread);
+
+		SPlatformData* Platform;
+		SThreadStart* Starts;
+		s32 ThreadCount;
+
+		IThreadTask* Task;
+		s32 PartCount;
+		s32 NextPart;
+		s32 PartsDone;
+		u32 Generation;		// increased with every task, wakes up the workers
+		bool Quit;
+	};
+
+} // end namespace irr
+
+#endif
+
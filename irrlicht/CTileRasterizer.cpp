@@ -0,0 +1,429 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "CTileRasterizer.h"
+
+namespace irr
+{
+namespace video
+{
+
+
+//! constructor
+CTileRasterizer::CTileRasterizer(IZBuffer* zbuffer, s32 threadCount, s32 tileHeight)
+: Threads(0), ThreadCount(0), ZBuffer(zbuffer), ZBufferClearPending(false),
+	Statistics(0), MaxTileHeight(tileHeight), TileHeight(tileHeight), TargetSize(0,0),
+	AllocatedVertex(0)
+{
+	#ifdef _DEBUG
+	setDebugName("CTileRasterizer");
+	#endif
+
+	if (ZBuffer)
+		ZBuffer->grab();
+
+	Threads = new CThreadPool(threadCount);
+	ThreadCount = Threads->getThreadCount();
+
+	// every thread gets its own renderers, they keep their state while drawing.
+
+	Renderers.set_used(ThreadCount * ETR_COUNT);
+	RendererStates.set_used(ThreadCount * ETR_COUNT);
+	ThreadStatistics.set_used(ThreadCount * ETR_COUNT);
+
+	for (s32 t=0; t<ThreadCount; ++t)
+	{
+		for (s32 i=0; i<ETR_COUNT; ++i)
+			Renderers[t * ETR_COUNT + i] = createTriangleRenderer((ETriangleRenderer)i, zbuffer);
+	}
+
+	for (s32 i=0; i<ThreadCount * ETR_COUNT; ++i)
+	{
+		RendererStates[i].Target = 0;
+		RendererStates[i].Texture = 0;
+		RendererStates[i].Texture2 = 0;
+	}
+}
+
+
+
+//! destructor
+CTileRasterizer::~CTileRasterizer()
+{
+	flush();
+
+	for (s32 i=0; i<(s32)Renderers.size(); ++i)
+		Renderers[i]->drop();
+
+	Threads->drop();
+
+	if (ZBuffer)
+		ZBuffer->drop();
+}
+
+
+
+//! returns the amount of threads drawing the tiles
+s32 CTileRasterizer::getThreadCount()
+{
+	return ThreadCount;
+}
+
+
+
+//! returns the threads drawing the tiles
+CThreadPool* CTileRasterizer::getThreadPool()
+{
+	return Threads;
+}
+
+
+
+//! sets the size of the render target.
+void CTileRasterizer::setTargetSize(const core::dimension2d<s32>& size)
+{
+	if (size == TargetSize)
+		return;
+
+	flush();
+
+	TargetSize = size;
+
+	// with less than two tiles per thread, the threads which got the tiles
+	// with the fewest triangles would wait for the others.
+	TileHeight = MaxTileHeight;
+	while (TileHeight > MIN_TILE_HEIGHT &&
+		(size.Height + TileHeight - 1) / TileHeight < ThreadCount * 2)
+		TileHeight /= 2;
+
+	Tiles.set_used((size.Height + TileHeight - 1) / TileHeight);
+
+	for (s32 i=0; i<(s32)Tiles.size(); ++i)
+	{
+		STile& tile = Tiles[i];
+		tile.Rect = core::rectEx<s32>(0, i * TileHeight, size.Width, (i+1) * TileHeight);
+		tile.Draws.set_used(0);
+		tile.Indices.set_used(0);
+		tile.ClearZBuffer = false;
+	}
+}
+
+
+
+//! returns memory for the transformed vertices of the next draw call.
+S2DVertex* CTileRasterizer::allocateVertices(s32 vertexCount)
+{
+	AllocatedVertex = Vertices.size();
+	Vertices.set_used(AllocatedVertex + vertexCount);
+	return Vertices.pointer() + AllocatedVertex;
+}
+
+
+
+//! records an indexed triangle list
+void CTileRasterizer::drawIndexedTriangleList(ETriangleRenderer renderer, video::ISurface* target,
+	const core::rectEx<s32>& viewPort, video::ISurface* texture, video::ISurface* texture2,
+	video::ISurface* const* mipMaps, s32 mipMapCount, bool textureTiled, bool backfaceCulling,
+	s32 vertexCount, const u16* indexList, s32 triangleCount)
+{
+	SDrawCall draw;
+	draw.Renderer = renderer;
+	draw.Target = target;
+	draw.Texture = texture;
+	draw.Texture2 = texture2;
+	draw.MipMaps = mipMaps;
+	draw.MipMapCount = mipMapCount;
+	draw.TextureTiled = textureTiled;
+	draw.ViewPort = viewPort;
+	draw.BackfaceCulling = backfaceCulling;
+	draw.FirstVertex = AllocatedVertex;
+	draw.VertexCount = vertexCount;
+
+	s32 drawCall = DrawCalls.size();
+
+	// the per triangle counters are done here, so triangles touching several
+	// tiles are counted once. The renderers only count spans and pixels.
+	SRasterizerStatistics stats;
+	stats.Triangles = triangleCount;
+
+	const S2DVertex* vertices = Vertices.pointer() + AllocatedVertex;
+	const S2DVertex *v1, *v2, *v3;
+	core::rectEx<s32> rect;
+	bool used = false;
+
+	for (s32 i=0; i<triangleCount; ++i, indexList += 3)
+	{
+		v1 = &vertices[indexList[0]];
+		v2 = &vertices[indexList[1]];
+		v3 = &vertices[indexList[2]];
+
+		// the same tests the renderers do, before binning
+
+		if (backfaceCulling)
+		{
+			s32 z = ((v3->Pos.X - v1->Pos.X) * (v3->Pos.Y - v2->Pos.Y)) -
+				((v3->Pos.Y - v1->Pos.Y) * (v3->Pos.X - v2->Pos.X));
+
+			if (z < 0)
+			{
+				++stats.BackFaceCulled;
+				continue;
+			}
+		}
+
+		if (v1->ZValue<0 && v2->ZValue<0 && v3->ZValue<0)
+		{
+			++stats.NearPlaneCulled;
+			continue;
+		}
+
+		rect.UpperLeftCorner.X = rect.LowerRightCorner.X = v1->Pos.X;
+		rect.UpperLeftCorner.Y = rect.LowerRightCorner.Y = v1->Pos.Y;
+
+		if (v2->Pos.X < rect.UpperLeftCorner.X) rect.UpperLeftCorner.X = v2->Pos.X;
+		if (v3->Pos.X < rect.UpperLeftCorner.X) rect.UpperLeftCorner.X = v3->Pos.X;
+		if (v2->Pos.Y < rect.UpperLeftCorner.Y) rect.UpperLeftCorner.Y = v2->Pos.Y;
+		if (v3->Pos.Y < rect.UpperLeftCorner.Y) rect.UpperLeftCorner.Y = v3->Pos.Y;
+		if (v2->Pos.X > rect.LowerRightCorner.X) rect.LowerRightCorner.X = v2->Pos.X;
+		if (v3->Pos.X > rect.LowerRightCorner.X) rect.LowerRightCorner.X = v3->Pos.X;
+		if (v2->Pos.Y > rect.LowerRightCorner.Y) rect.LowerRightCorner.Y = v2->Pos.Y;
+		if (v3->Pos.Y > rect.LowerRightCorner.Y) rect.LowerRightCorner.Y = v3->Pos.Y;
+
+		if (rect.getWidth() == 0 || rect.getHeight() == 0)
+		{
+			++stats.DegenerateCulled;
+			continue;
+		}
+
+		if (!rect.isRectCollided(viewPort))
+		{
+			++stats.ViewPortCulled;
+			continue;
+		}
+
+		// the renderers only write pixels inside the rectangle, excluding
+		// the right and lower border.
+
+		rect.clipAgainst(viewPort);
+
+		s32 tile1 = rect.UpperLeftCorner.Y / TileHeight;
+		s32 tile2 = (rect.LowerRightCorner.Y - 1) / TileHeight;
+
+		if (tile2 >= (s32)Tiles.size()) tile2 = Tiles.size() - 1;
+
+		for (s32 t=tile1; t<=tile2; ++t)
+			addTriangle(t, drawCall, indexList);
+
+		used = true;
+	}
+
+	if (Statistics)
+		Statistics[renderer].add(stats);
+
+	if (!used)
+	{
+		// nothing visible, free the vertices again.
+		Vertices.set_used(AllocatedVertex);
+		return;
+	}
+
+	// keep the surfaces alive until the draw call is flushed.
+	if (draw.Target)
+		draw.Target->grab();
+	if (draw.Texture)
+		draw.Texture->grab();
+	if (draw.Texture2)
+		draw.Texture2->grab();
+
+	DrawCalls.push_back(draw);
+}
+
+
+
+//! adds a triangle to a tile
+void CTileRasterizer::addTriangle(s32 tile, s32 drawCall, const u16* indices)
+{
+	STile& t = Tiles[tile];
+
+	if (!t.Draws.size())
+		UsedTiles.push_back(tile);
+
+	if (!t.Draws.size() || t.Draws[t.Draws.size()-1].DrawCall != drawCall)
+	{
+		STileDraw d;
+		d.DrawCall = drawCall;
+		d.FirstIndex = t.Indices.size();
+		d.TriangleCount = 0;
+		t.Draws.push_back(d);
+	}
+
+	++t.Draws[t.Draws.size()-1].TriangleCount;
+
+	t.Indices.push_back(indices[0]);
+	t.Indices.push_back(indices[1]);
+	t.Indices.push_back(indices[2]);
+}
+
+
+
+//! draws all recorded triangle lists
+void CTileRasterizer::flush()
+{
+	if (!DrawCalls.size() && !ZBufferClearPending)
+		return;
+
+	if (ZBufferClearPending)
+	{
+		// tiles without triangles still have to clear their zbuffer
+		for (s32 i=0; i<(s32)Tiles.size(); ++i)
+			if (Tiles[i].ClearZBuffer && !Tiles[i].Draws.size())
+				UsedTiles.push_back(i);
+
+		ZBufferClearPending = false;
+	}
+
+	Threads->run(this, UsedTiles.size());
+
+	// add the counters of the threads
+
+	if (Statistics)
+	{
+		for (s32 i=0; i<ThreadCount * ETR_COUNT; ++i)
+		{
+			SRasterizerStatistics& s = ThreadStatistics[i];
+			SRasterizerStatistics& total = Statistics[i % ETR_COUNT];
+
+			total.HiZCulled += s.HiZCulled;
+			total.SpansTested += s.SpansTested;
+			total.PixelsTested += s.PixelsTested;
+			total.ZTestFailed += s.PixelsTested - s.PixelsWritten;
+			total.PixelsWritten += s.PixelsWritten;
+			s.reset();
+		}
+	}
+
+	// clear the recorded draw calls
+
+	for (s32 i=0; i<(s32)UsedTiles.size(); ++i)
+	{
+		STile& t = Tiles[UsedTiles[i]];
+		t.Draws.set_used(0);
+		t.Indices.set_used(0);
+	}
+
+	for (s32 i=0; i<(s32)DrawCalls.size(); ++i)
+	{
+		if (DrawCalls[i].Target)
+			DrawCalls[i].Target->drop();
+		if (DrawCalls[i].Texture)
+			DrawCalls[i].Texture->drop();
+		if (DrawCalls[i].Texture2)
+			DrawCalls[i].Texture2->drop();
+	}
+
+	UsedTiles.set_used(0);
+	DrawCalls.set_used(0);
+	Vertices.set_used(0);
+}
+
+
+
+//! clears the zbuffer when the tiles are flushed
+void CTileRasterizer::clearZBuffer()
+{
+	flush();
+
+	for (s32 i=0; i<(s32)Tiles.size(); ++i)
+		Tiles[i].ClearZBuffer = true;
+
+	ZBufferClearPending = Tiles.size() != 0;
+}
+
+
+
+//! sets the statistics the counters are added to
+void CTileRasterizer::setStatistics(SRasterizerStatistics* statistics)
+{
+	flush();
+
+	Statistics = statistics;
+
+	for (s32 i=0; i<ThreadCount * ETR_COUNT; ++i)
+	{
+		ThreadStatistics[i].reset();
+		Renderers[i]->setStatistics(Statistics ? &ThreadStatistics[i] : 0);
+	}
+}
+
+
+
+//! en or disables perspective correct texture coordinates
+void CTileRasterizer::setPerspectiveCorrection(bool enabled)
+{
+	flush();
+
+	for (s32 i=0; i<ThreadCount * ETR_COUNT; ++i)
+		Renderers[i]->setPerspectiveCorrection(enabled);
+}
+
+
+
+//! draws the triangles of one tile
+void CTileRasterizer::runTask(s32 part, s32 thread)
+{
+	STile& tile = Tiles[UsedTiles[part]];
+
+	// the clear of the tile is still in the cache when drawing it
+	if (tile.ClearZBuffer)
+	{
+		ZBuffer->clear(tile.Rect);
+		tile.ClearZBuffer = false;
+	}
+
+	IK3DTriangleRenderer** renderers = &Renderers[thread * ETR_COUNT];
+	SRendererState* states = &RendererStates[thread * ETR_COUNT];
+
+	for (s32 i=0; i<(s32)tile.Draws.size(); ++i)
+	{
+		const STileDraw& tileDraw = tile.Draws[i];
+		const SDrawCall& draw = DrawCalls[tileDraw.DrawCall];
+
+		IK3DTriangleRenderer* r = renderers[draw.Renderer];
+		SRendererState& state = states[draw.Renderer];
+
+		core::rectEx<s32> clip(tile.Rect);
+		clip.clipAgainst(draw.ViewPort);
+
+		// the reference counting of the surfaces is not thread safe, so
+		// the renderers may only switch to other surfaces inside the lock.
+
+		if (state.Target != draw.Target || state.Texture != draw.Texture ||
+			state.Texture2 != draw.Texture2)
+		{
+			Threads->lock();
+			r->setRenderTarget(draw.Target, clip);
+			r->setTexture(draw.Texture);
+			r->setTexture2(draw.Texture2);
+			r->setMipMaps(draw.MipMaps, draw.MipMapCount);
+			r->setTextureTiled(draw.TextureTiled);
+			Threads->unlock();
+
+			state.Target = draw.Target;
+			state.Texture = draw.Texture;
+			state.Texture2 = draw.Texture2;
+		}
+		else
+			r->setRenderTarget(draw.Target, clip);
+
+		r->setBackfaceCulling(draw.BackfaceCulling);
+
+		r->drawIndexedTriangleList(&Vertices[draw.FirstVertex], draw.VertexCount,
+			&tile.Indices[tileDraw.FirstIndex], tileDraw.TriangleCount);
+	}
+}
+
+
+} // end namespace video
+} // end namespace irr
+
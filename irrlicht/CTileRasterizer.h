@@ -0,0 +1,155 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __C_TILE_RASTERIZER_H_INCLUDED__
+#define __C_TILE_RASTERIZER_H_INCLUDED__
+
+#include "IK3DTriangleRenderer.h"
+#include "CThreadPool.h"
+#include "array.h"
+
+namespace irr
+{
+namespace video
+{
+
+	//! rows the tiles are not made smaller than for more threads, each of them
+	//! sets up the triangles it touches once more.
+	const s32 MIN_TILE_HEIGHT = 16;
+
+	//! Draws triangle lists with several threads. The draw calls are recorded
+	//! and their triangles are sorted into screen tiles. When flushed, every tile
+	//! is drawn by one thread with its own set of triangle renderers, clipped to
+	//! the tile, so the threads never write the same pixels. Inside a tile, the
+	//! triangles are drawn in the order they were submitted.
+	//! The tiles are bands of rows over the whole width of the target. A
+	//! renderer sets up a triangle again for every tile it touches and walks
+	//! its rows there, but skips the rows above the tile, so only the setup
+	//! is repeated, and no span is split at the border of a tile.
+	class CTileRasterizer : public IUnknown, public IThreadTask
+	{
+	public:
+
+		//! constructor
+		//! \param threadCount: Amount of threads, 0 for one per processor.
+		//! \param tileHeight: Rows of the tiles, a multiple of the blocks of the
+		//! hierarchical z buffer, so no block is shared by two threads. Halved
+		//! down to MIN_TILE_HEIGHT while a target has less than two tiles per thread.
+		CTileRasterizer(IZBuffer* zbuffer, s32 threadCount, s32 tileHeight = 32);
+
+		//! destructor
+		virtual ~CTileRasterizer();
+
+		//! returns the amount of threads drawing the tiles
+		s32 getThreadCount();
+
+		//! returns the threads drawing the tiles. The driver uses them for
+		//! other work too, while no tiles are drawn.
+		CThreadPool* getThreadPool();
+
+		//! sets the size of the render target. Has to be called before drawing
+		//! into a target of another size, after flush().
+		void setTargetSize(const core::dimension2d<s32>& size);
+
+		//! returns memory for the transformed vertices of the next draw call.
+		//! The memory is valid until the next call to allocateVertices() or flush().
+		S2DVertex* allocateVertices(s32 vertexCount);
+
+		//! records an indexed triangle list using the vertices of the last allocateVertices() call.
+		//! The mip maps are not grabbed, they have to live as long as the texture.
+		void drawIndexedTriangleList(ETriangleRenderer renderer, video::ISurface* target,
+			const core::rectEx<s32>& viewPort, video::ISurface* texture, video::ISurface* texture2,
+			video::ISurface* const* mipMaps, s32 mipMapCount, bool textureTiled, bool backfaceCulling,
+			s32 vertexCount, const u16* indexList, s32 triangleCount);
+
+		//! draws all recorded triangle lists, returns when they are finished.
+		void flush();
+
+		//! clears the zbuffer. The clear is deferred to the next flush(), 
+		//! where every tile clears its part of the zbuffer right before 
+		//! drawing into it, in the thread drawing the tile.
+		void clearZBuffer();
+
+		//! sets the statistics the counters are added to, an array of
+		//! ETR_COUNT statistics, or 0 to disable counting.
+		void setStatistics(SRasterizerStatistics* statistics);
+
+		//! en or disables perspective correct texture coordinates
+		void setPerspectiveCorrection(bool enabled);
+
+		//! draws the triangles of one tile, called by the thread pool
+		virtual void runTask(s32 part, s32 thread);
+
+	private:
+
+		//! state of a recorded draw call
+		struct SDrawCall
+		{
+			ETriangleRenderer Renderer;
+			video::ISurface* Target;
+			video::ISurface* Texture;
+			video::ISurface* Texture2;
+			video::ISurface* const* MipMaps;
+			s32 MipMapCount;
+			bool TextureTiled;
+			core::rectEx<s32> ViewPort;
+			bool BackfaceCulling;
+			s32 FirstVertex;
+			s32 VertexCount;
+		};
+
+		//! triangles of a draw call which touch a tile
+		struct STileDraw
+		{
+			s32 DrawCall;
+			s32 FirstIndex;
+			s32 TriangleCount;
+		};
+
+		struct STile
+		{
+			core::rectEx<s32> Rect;
+			core::array<STileDraw> Draws;
+			core::array<u16> Indices;
+			bool ClearZBuffer;		// the zbuffer of the tile is cleared before drawing
+		};
+
+		//! surfaces a renderer of a thread is set to
+		struct SRendererState
+		{
+			video::ISurface* Target;
+			video::ISurface* Texture;
+			video::ISurface* Texture2;
+		};
+
+		//! adds a triangle to a tile
+		void addTriangle(s32 tile, s32 drawCall, const u16* indices);
+
+		CThreadPool* Threads;
+		s32 ThreadCount;
+		IZBuffer* ZBuffer;
+		bool ZBufferClearPending;
+
+		// ETR_COUNT renderers, states and statistics per thread
+		core::array<IK3DTriangleRenderer*> Renderers;
+		core::array<SRendererState> RendererStates;
+		core::array<SRasterizerStatistics> ThreadStatistics;
+		SRasterizerStatistics* Statistics;
+
+		s32 MaxTileHeight;
+		s32 TileHeight;			// rows of the tiles of the current target
+		core::dimension2d<s32> TargetSize;
+		core::array<STile> Tiles;
+		core::array<s32> UsedTiles;		// tiles with triangles, in the order of their first use
+
+		core::array<SDrawCall> DrawCalls;
+		core::array<S2DVertex> Vertices;
+		s32 AllocatedVertex;	// first vertex of the last allocateVertices() call
+	};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,105 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "CTimer.h"
+#include "os.h"
+
+namespace irr
+{
+
+
+//! constructor
+CTimer::CTimer()
+: Mode(ETM_REAL), VirtualTime(0), RealOffset(0), FixedStep(20)
+{
+	#ifdef _DEBUG
+	setDebugName("CTimer");
+	#endif
+}
+
+
+
+//! destructor
+CTimer::~CTimer()
+{
+}
+
+
+
+//! returns the current time of the clock in milliseconds
+u32 CTimer::getTime()
+{
+	if (Mode == ETM_REAL)
+		return os::Timer::getTime() - RealOffset;
+
+	return VirtualTime;
+}
+
+
+
+//! sets the current time of the clock
+void CTimer::setTime(u32 timeMs)
+{
+	if (Mode == ETM_REAL)
+		RealOffset = os::Timer::getTime() - timeMs;
+	else
+		VirtualTime = timeMs;
+}
+
+
+
+//! returns the time of the system in milliseconds
+u32 CTimer::getRealTime()
+{
+	return os::Timer::getTime();
+}
+
+
+
+//! sets the mode of the clock
+void CTimer::setMode(ETIMER_MODE mode)
+{
+	if (mode == Mode)
+		return;
+
+	u32 now = getTime();
+	Mode = mode;
+	setTime(now);
+}
+
+
+
+//! returns the mode of the clock
+ETIMER_MODE CTimer::getMode()
+{
+	return Mode;
+}
+
+
+
+//! sets the time step used in fixed step mode
+void CTimer::setFixedStep(u32 stepMs)
+{
+	FixedStep = stepMs;
+}
+
+
+
+//! returns the time step used in fixed step mode
+u32 CTimer::getFixedStep()
+{
+	return FixedStep;
+}
+
+
+
+//! advances the clock by one step if it is in fixed step mode
+void CTimer::tick()
+{
+	if (Mode == ETM_FIXED_STEP)
+		VirtualTime += FixedStep;
+}
+
+
+} // end namespace
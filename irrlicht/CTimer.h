@@ -0,0 +1,57 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __C_TIMER_H_INCLUDED__
+#define __C_TIMER_H_INCLUDED__
+
+#include "ITimer.h"
+
+namespace irr
+{
+
+	class CTimer : public ITimer
+	{
+	public:
+
+		//! constructor
+		CTimer();
+
+		//! destructor
+		virtual ~CTimer();
+
+		//! returns the current time of the clock in milliseconds
+		virtual u32 getTime();
+
+		//! sets the current time of the clock
+		virtual void setTime(u32 timeMs);
+
+		//! returns the time of the system in milliseconds
+		virtual u32 getRealTime();
+
+		//! sets the mode of the clock
+		virtual void setMode(ETIMER_MODE mode);
+
+		//! returns the mode of the clock
+		virtual ETIMER_MODE getMode();
+
+		//! sets the time step used in fixed step mode
+		virtual void setFixedStep(u32 stepMs);
+
+		//! returns the time step used in fixed step mode
+		virtual u32 getFixedStep();
+
+		//! advances the clock by one step if it is in fixed step mode
+		virtual void tick();
+
+	private:
+
+		ETIMER_MODE Mode;
+		u32 VirtualTime;	// time of the clock if not in real mode
+		u32 RealOffset;		// difference between system time and clock in real mode
+		u32 FixedStep;
+	};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,424 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#include "CVertexTransform.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define _IRR_TRANSFORM_KERNELS_X86_
+#endif
+
+#ifdef _IRR_TRANSFORM_KERNELS_X86_
+
+#include <immintrin.h>
+
+// see CTRSpanKernels.cpp. The avx2 kernel is not compiled with fma, the
+// products and sums have to be rounded like in the scalar kernel.
+#ifdef __GNUC__
+#define _IRR_TARGET_SSE2_ __attribute__((target("sse2")))
+#define _IRR_TARGET_AVX2_ __attribute__((target("avx2")))
+#else
+#define _IRR_TARGET_SSE2_
+#define _IRR_TARGET_AVX2_
+#endif
+
+#endif
+
+namespace irr
+{
+namespace video
+{
+
+// The position is multiplied with the rows of the matrix in the same order
+// as matrix4::multiplyWith1x4Matrix() does.
+
+
+//! returns the E_CLIP_CODE flags of a vertex in clip space
+static inline u32 getClipCodes(f32 x, f32 y, f32 z, f32 w)
+{
+	f32 g = w * GUARD_BAND;
+	u32 codes = 0;
+
+	if (z < 0.0f) codes |= ECC_NEAR;
+	if (x < -g) codes |= ECC_LEFT;
+	if (x > g) codes |= ECC_RIGHT;
+	if (y < -g) codes |= ECC_BOTTOM;
+	if (y > g) codes |= ECC_TOP;
+
+	return codes;
+}
+
+
+
+//! projects a vertex in clip space to the screen
+static inline void projectVertex(const STransformParameters& parameters,
+	f32 x, f32 y, f32 w, f32 tx, f32 ty, f32 tx2, f32 ty2, s32 color, S2DVertex& v)
+{
+	f32 zDiv = w == 0.0f ? 1.0f : (1.0f / w);
+
+	v.Pos.X = (s32)(parameters.ViewTransformWidth * (x * zDiv) + parameters.TranslationX);
+	v.Pos.Y = parameters.TranslationY - (s32)(parameters.ViewTransformHeight * (y * zDiv));
+	v.Color = color;
+	v.ZValue = (s32)(parameters.ZScale * zDiv);
+
+	v.TCoords.X = (s32)(tx * parameters.TextureWidth) << 8;
+	v.TCoords.Y = (s32)(ty * parameters.TextureHeight) << 8;
+	// the lightmap coordinates keep their fraction, a lightmap texel
+	// covers many pixels, so they would jump visibly without it.
+	v.TCoords2.X = (s32)(tx2 * parameters.Texture2Width * 256.0f);
+	v.TCoords2.Y = (s32)(ty2 * parameters.Texture2Height * 256.0f);
+}
+
+
+
+//! transforms a block of vertices one by one
+static void transformBlockScalar(const STransformParameters& parameters,
+	const SVertexBlock& block, S2DVertex* out, u8* clipCodes)
+{
+	const core::matrix4& m = parameters.Matrix;
+
+	for (s32 i=0; i<block.Count; ++i)
+	{
+		f32 x = m(0,0)*block.X[i] + m(0,1)*block.Y[i] + m(0,2)*block.Z[i] + m(0,3);
+		f32 y = m(1,0)*block.X[i] + m(1,1)*block.Y[i] + m(1,2)*block.Z[i] + m(1,3);
+		f32 z = m(2,0)*block.X[i] + m(2,1)*block.Y[i] + m(2,2)*block.Z[i] + m(2,3);
+		f32 w = m(3,0)*block.X[i] + m(3,1)*block.Y[i] + m(3,2)*block.Z[i] + m(3,3);
+
+		projectVertex(parameters, x, y, w, block.Tx[i], block.Ty[i],
+			block.Tx2[i], block.Ty2[i], block.Color[i], out[block.Index[i]]);
+
+		clipCodes[block.Index[i]] = (u8)getClipCodes(x, y, z, w);
+	}
+}
+
+
+
+//! writes the results of a kernel to the screen vertices
+static inline void storeVertices(const SVertexBlock& block, s32 first, s32 count,
+	const s32* posX, const s32* posY, const s32* z, const s32* tx, const s32* ty,
+	const s32* tx2, const s32* ty2, const s32* codes, S2DVertex* out, u8* clipCodes)
+{
+	for (s32 i=0; i<count; ++i)
+	{
+		S2DVertex& v = out[block.Index[first + i]];
+		clipCodes[block.Index[first + i]] = (u8)codes[i];
+
+		v.Pos.X = posX[i];
+		v.Pos.Y = posY[i];
+		v.Color = block.Color[first + i];
+		v.ZValue = z[i];
+		v.TCoords.X = tx[i];
+		v.TCoords.Y = ty[i];
+		v.TCoords2.X = tx2[i];
+		v.TCoords2.Y = ty2[i];
+	}
+}
+
+
+#ifdef _IRR_TRANSFORM_KERNELS_X86_
+
+// The kernels read whole registers from the block, also behind the last
+// vertex. These values are calculated too, but never stored.
+
+
+//! transforms a block of vertices, 4 at once
+static _IRR_TARGET_SSE2_ void transformBlockSSE2(const STransformParameters& parameters,
+	const SVertexBlock& block, S2DVertex* out, u8* clipCodes)
+{
+	const core::matrix4& m = parameters.Matrix;
+
+	const __m128 m00 = _mm_set1_ps(m(0,0)), m01 = _mm_set1_ps(m(0,1)), m02 = _mm_set1_ps(m(0,2)), m03 = _mm_set1_ps(m(0,3));
+	const __m128 m10 = _mm_set1_ps(m(1,0)), m11 = _mm_set1_ps(m(1,1)), m12 = _mm_set1_ps(m(1,2)), m13 = _mm_set1_ps(m(1,3));
+	const __m128 m20 = _mm_set1_ps(m(2,0)), m21 = _mm_set1_ps(m(2,1)), m22 = _mm_set1_ps(m(2,2)), m23 = _mm_set1_ps(m(2,3));
+	const __m128 m30 = _mm_set1_ps(m(3,0)), m31 = _mm_set1_ps(m(3,1)), m32 = _mm_set1_ps(m(3,2)), m33 = _mm_set1_ps(m(3,3));
+
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 zScale = _mm_set1_ps(parameters.ZScale);
+	const __m128 viewWidth = _mm_set1_ps((f32)parameters.ViewTransformWidth);
+	const __m128 viewHeight = _mm_set1_ps((f32)parameters.ViewTransformHeight);
+	const __m128 translationX = _mm_set1_ps((f32)parameters.TranslationX);
+	const __m128i translationY = _mm_set1_epi32(parameters.TranslationY);
+	const __m128 textureWidth = _mm_set1_ps((f32)parameters.TextureWidth);
+	const __m128 textureHeight = _mm_set1_ps((f32)parameters.TextureHeight);
+	const __m128 texture2Width = _mm_set1_ps(parameters.Texture2Width * 256.0f);
+	const __m128 texture2Height = _mm_set1_ps(parameters.Texture2Height * 256.0f);
+	const __m128 guardBand = _mm_set1_ps(GUARD_BAND);
+	const __m128i codeNear = _mm_set1_epi32(ECC_NEAR), codeLeft = _mm_set1_epi32(ECC_LEFT);
+	const __m128i codeRight = _mm_set1_epi32(ECC_RIGHT), codeBottom = _mm_set1_epi32(ECC_BOTTOM);
+	const __m128i codeTop = _mm_set1_epi32(ECC_TOP);
+
+	s32 posX[4], posY[4], z[4], tx[4], ty[4], tx2[4], ty2[4], codes[4];
+
+	for (s32 i=0; i<block.Count; i+=4)
+	{
+		__m128 vx = _mm_loadu_ps(block.X + i);
+		__m128 vy = _mm_loadu_ps(block.Y + i);
+		__m128 vz = _mm_loadu_ps(block.Z + i);
+
+		__m128 x = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, vx), _mm_mul_ps(m01, vy)), _mm_mul_ps(m02, vz)), m03);
+		__m128 y = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, vx), _mm_mul_ps(m11, vy)), _mm_mul_ps(m12, vz)), m13);
+		__m128 cz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, vx), _mm_mul_ps(m21, vy)), _mm_mul_ps(m22, vz)), m23);
+		__m128 w = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m30, vx), _mm_mul_ps(m31, vy)), _mm_mul_ps(m32, vz)), m33);
+
+		__m128 g = _mm_mul_ps(w, guardBand);
+		__m128 ng = _mm_sub_ps(zero, g);
+		__m128i c = _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(cz, zero)), codeNear);
+		c = _mm_or_si128(c, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(x, ng)), codeLeft));
+		c = _mm_or_si128(c, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(x, g)), codeRight));
+		c = _mm_or_si128(c, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(y, ng)), codeBottom));
+		c = _mm_or_si128(c, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(y, g)), codeTop));
+		_mm_storeu_si128((__m128i*)codes, c);
+
+		__m128 wZero = _mm_cmpeq_ps(w, zero);
+		__m128 zDiv = _mm_or_ps(_mm_and_ps(wZero, one), _mm_andnot_ps(wZero, _mm_div_ps(one, w)));
+
+		_mm_storeu_si128((__m128i*)posX, _mm_cvttps_epi32(
+			_mm_add_ps(_mm_mul_ps(viewWidth, _mm_mul_ps(x, zDiv)), translationX)));
+		_mm_storeu_si128((__m128i*)posY, _mm_sub_epi32(translationY,
+			_mm_cvttps_epi32(_mm_mul_ps(viewHeight, _mm_mul_ps(y, zDiv)))));
+		_mm_storeu_si128((__m128i*)z, _mm_cvttps_epi32(_mm_mul_ps(zScale, zDiv)));
+		_mm_storeu_si128((__m128i*)tx, _mm_slli_epi32(_mm_cvttps_epi32(
+			_mm_mul_ps(_mm_loadu_ps(block.Tx + i), textureWidth)), 8));
+		_mm_storeu_si128((__m128i*)ty, _mm_slli_epi32(_mm_cvttps_epi32(
+			_mm_mul_ps(_mm_loadu_ps(block.Ty + i), textureHeight)), 8));
+		_mm_storeu_si128((__m128i*)tx2, _mm_cvttps_epi32(
+			_mm_mul_ps(_mm_loadu_ps(block.Tx2 + i), texture2Width)));
+		_mm_storeu_si128((__m128i*)ty2, _mm_cvttps_epi32(
+			_mm_mul_ps(_mm_loadu_ps(block.Ty2 + i), texture2Height)));
+
+		storeVertices(block, i, block.Count - i < 4 ? block.Count - i : 4,
+			posX, posY, z, tx, ty, tx2, ty2, codes, out, clipCodes);
+	}
+}
+
+
+
+//! transforms a block of vertices, 8 at once
+static _IRR_TARGET_AVX2_ void transformBlockAVX2(const STransformParameters& parameters,
+	const SVertexBlock& block, S2DVertex* out, u8* clipCodes)
+{
+	const core::matrix4& m = parameters.Matrix;
+
+	const __m256 m00 = _mm256_set1_ps(m(0,0)), m01 = _mm256_set1_ps(m(0,1)), m02 = _mm256_set1_ps(m(0,2)), m03 = _mm256_set1_ps(m(0,3));
+	const __m256 m10 = _mm256_set1_ps(m(1,0)), m11 = _mm256_set1_ps(m(1,1)), m12 = _mm256_set1_ps(m(1,2)), m13 = _mm256_set1_ps(m(1,3));
+	const __m256 m20 = _mm256_set1_ps(m(2,0)), m21 = _mm256_set1_ps(m(2,1)), m22 = _mm256_set1_ps(m(2,2)), m23 = _mm256_set1_ps(m(2,3));
+	const __m256 m30 = _mm256_set1_ps(m(3,0)), m31 = _mm256_set1_ps(m(3,1)), m32 = _mm256_set1_ps(m(3,2)), m33 = _mm256_set1_ps(m(3,3));
+
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 zScale = _mm256_set1_ps(parameters.ZScale);
+	const __m256 viewWidth = _mm256_set1_ps((f32)parameters.ViewTransformWidth);
+	const __m256 viewHeight = _mm256_set1_ps((f32)parameters.ViewTransformHeight);
+	const __m256 translationX = _mm256_set1_ps((f32)parameters.TranslationX);
+	const __m256i translationY = _mm256_set1_epi32(parameters.TranslationY);
+	const __m256 textureWidth = _mm256_set1_ps((f32)parameters.TextureWidth);
+	const __m256 textureHeight = _mm256_set1_ps((f32)parameters.TextureHeight);
+	const __m256 texture2Width = _mm256_set1_ps(parameters.Texture2Width * 256.0f);
+	const __m256 texture2Height = _mm256_set1_ps(parameters.Texture2Height * 256.0f);
+	const __m256 guardBand = _mm256_set1_ps(GUARD_BAND);
+	const __m256i codeNear = _mm256_set1_epi32(ECC_NEAR), codeLeft = _mm256_set1_epi32(ECC_LEFT);
+	const __m256i codeRight = _mm256_set1_epi32(ECC_RIGHT), codeBottom = _mm256_set1_epi32(ECC_BOTTOM);
+	const __m256i codeTop = _mm256_set1_epi32(ECC_TOP);
+
+	s32 posX[8], posY[8], z[8], tx[8], ty[8], tx2[8], ty2[8], codes[8];
+
+	for (s32 i=0; i<block.Count; i+=8)
+	{
+		__m256 vx = _mm256_loadu_ps(block.X + i);
+		__m256 vy = _mm256_loadu_ps(block.Y + i);
+		__m256 vz = _mm256_loadu_ps(block.Z + i);
+
+		__m256 x = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, vx), _mm256_mul_ps(m01, vy)), _mm256_mul_ps(m02, vz)), m03);
+		__m256 y = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m10, vx), _mm256_mul_ps(m11, vy)), _mm256_mul_ps(m12, vz)), m13);
+		__m256 cz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m20, vx), _mm256_mul_ps(m21, vy)), _mm256_mul_ps(m22, vz)), m23);
+		__m256 w = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m30, vx), _mm256_mul_ps(m31, vy)), _mm256_mul_ps(m32, vz)), m33);
+
+		__m256 g = _mm256_mul_ps(w, guardBand);
+		__m256 ng = _mm256_sub_ps(zero, g);
+		__m256i c = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(cz, zero, _CMP_LT_OQ)), codeNear);
+		c = _mm256_or_si256(c, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(x, ng, _CMP_LT_OQ)), codeLeft));
+		c = _mm256_or_si256(c, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(x, g, _CMP_GT_OQ)), codeRight));
+		c = _mm256_or_si256(c, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(y, ng, _CMP_LT_OQ)), codeBottom));
+		c = _mm256_or_si256(c, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(y, g, _CMP_GT_OQ)), codeTop));
+		_mm256_storeu_si256((__m256i*)codes, c);
+
+		__m256 zDiv = _mm256_blendv_ps(_mm256_div_ps(one, w), one, _mm256_cmp_ps(w, zero, _CMP_EQ_OQ));
+
+		_mm256_storeu_si256((__m256i*)posX, _mm256_cvttps_epi32(
+			_mm256_add_ps(_mm256_mul_ps(viewWidth, _mm256_mul_ps(x, zDiv)), translationX)));
+		_mm256_storeu_si256((__m256i*)posY, _mm256_sub_epi32(translationY,
+			_mm256_cvttps_epi32(_mm256_mul_ps(viewHeight, _mm256_mul_ps(y, zDiv)))));
+		_mm256_storeu_si256((__m256i*)z, _mm256_cvttps_epi32(_mm256_mul_ps(zScale, zDiv)));
+		_mm256_storeu_si256((__m256i*)tx, _mm256_slli_epi32(_mm256_cvttps_epi32(
+			_mm256_mul_ps(_mm256_loadu_ps(block.Tx + i), textureWidth)), 8));
+		_mm256_storeu_si256((__m256i*)ty, _mm256_slli_epi32(_mm256_cvttps_epi32(
+			_mm256_mul_ps(_mm256_loadu_ps(block.Ty + i), textureHeight)), 8));
+		_mm256_storeu_si256((__m256i*)tx2, _mm256_cvttps_epi32(
+			_mm256_mul_ps(_mm256_loadu_ps(block.Tx2 + i), texture2Width)));
+		_mm256_storeu_si256((__m256i*)ty2, _mm256_cvttps_epi32(
+			_mm256_mul_ps(_mm256_loadu_ps(block.Ty2 + i), texture2Height)));
+
+		storeVertices(block, i, block.Count - i < 8 ? block.Count - i : 8,
+			posX, posY, z, tx, ty, tx2, ty2, codes, out, clipCodes);
+	}
+}
+
+#endif // _IRR_TRANSFORM_KERNELS_X86_
+
+
+
+//! returns the distance of a vertex to a clip plane, negative outside of it
+static inline f32 getPlaneDistance(const SClipVertex& v, u32 plane)
+{
+	switch(plane)
+	{
+	case ECC_NEAR:
+		return v.Z;
+	case ECC_LEFT:
+		return v.X + v.W * GUARD_BAND;
+	case ECC_RIGHT:
+		return v.W * GUARD_BAND - v.X;
+	case ECC_BOTTOM:
+		return v.Y + v.W * GUARD_BAND;
+	default:
+		return v.W * GUARD_BAND - v.Y;
+	}
+}
+
+
+
+//! interpolates between two vertices in clip space
+static inline void interpolateVertex(const SClipVertex& a, const SClipVertex& b,
+	f32 t, SClipVertex& out)
+{
+	out.X = a.X + (b.X - a.X) * t;
+	out.Y = a.Y + (b.Y - a.Y) * t;
+	out.Z = a.Z + (b.Z - a.Z) * t;
+	out.W = a.W + (b.W - a.W) * t;
+	out.Tx = a.Tx + (b.Tx - a.Tx) * t;
+	out.Ty = a.Ty + (b.Ty - a.Ty) * t;
+	out.Tx2 = a.Tx2 + (b.Tx2 - a.Tx2) * t;
+	out.Ty2 = a.Ty2 + (b.Ty2 - a.Ty2) * t;
+
+	// the color channels one by one
+	out.Color = 0;
+
+	for (s32 shift=0; shift<32; shift+=8)
+	{
+		s32 ca = (a.Color >> shift) & 0xff;
+		s32 cb = (b.Color >> shift) & 0xff;
+		out.Color |= ((ca + (s32)((cb - ca) * t)) & 0xff) << shift;
+	}
+}
+
+
+
+//! returns the E_CLIP_CODE flags of a vertex
+u32 getClipCodes(const SClipVertex& vertex)
+{
+	return getClipCodes(vertex.X, vertex.Y, vertex.Z, vertex.W);
+}
+
+
+
+//! clips a polygon against the planes in the clip codes.
+s32 clipPolygon(SClipVertex* polygon, s32 count, u32 clipCodes)
+{
+	SClipVertex temp[MAX_CLIPPED_VERTICES];
+	SClipVertex* in = polygon;
+	SClipVertex* out = temp;
+
+	for (u32 plane=ECC_NEAR; plane<=ECC_TOP && count>=3; plane<<=1)
+	{
+		if (!(clipCodes & plane))
+			continue;
+
+		s32 outCount = 0;
+		const SClipVertex* a = &in[count-1];
+		f32 da = getPlaneDistance(*a, plane);
+
+		for (s32 i=0; i<count && outCount<MAX_CLIPPED_VERTICES; ++i)
+		{
+			const SClipVertex* b = &in[i];
+			f32 db = getPlaneDistance(*b, plane);
+
+			if ((da >= 0.0f) != (db >= 0.0f))
+			{
+				// interpolated from the inside vertex, so the neighbour
+				// triangle gets exactly the same vertex on this edge.
+				if (da >= 0.0f)
+					interpolateVertex(*a, *b, da / (da - db), out[outCount++]);
+				else
+					interpolateVertex(*b, *a, db / (db - da), out[outCount++]);
+			}
+
+			if (db >= 0.0f && outCount<MAX_CLIPPED_VERTICES)
+				out[outCount++] = *b;
+
+			a = b;
+			da = db;
+		}
+
+		SClipVertex* swap = in;
+		in = out;
+		out = swap;
+		count = outCount;
+	}
+
+	if (in != polygon)
+		for (s32 i=0; i<count; ++i)
+			polygon[i] = in[i];
+
+	return count;
+}
+
+
+
+//! projects a vertex in clip space to the screen like the kernels do
+void projectVertex(const STransformParameters& parameters,
+	const SClipVertex& vertex, S2DVertex& out)
+{
+	projectVertex(parameters, vertex.X, vertex.Y, vertex.W,
+		vertex.Tx, vertex.Ty, vertex.Tx2, vertex.Ty2, vertex.Color, out);
+}
+
+
+
+//! returns the transform kernel of an instruction set
+TTransformBlock getTransformKernel(ESpanKernelSet set)
+{
+	if (!isKernelSetSupported(set))
+		return 0;
+
+	switch(set)
+	{
+	case ESKS_SCALAR:
+		return transformBlockScalar;
+#ifdef _IRR_TRANSFORM_KERNELS_X86_
+	case ESKS_SSE2:
+		return transformBlockSSE2;
+	case ESKS_AVX2:
+		return transformBlockAVX2;
+#endif
+	default:
+		return 0;
+	}
+}
+
+
+
+//! returns the fastest transform kernel the processor supports
+TTransformBlock getTransformKernel()
+{
+	static TTransformBlock best = 0;
+
+	for (s32 i=ESKS_COUNT-1; !best && i>=0; --i)
+		best = getTransformKernel((ESpanKernelSet)i);
+
+	return best;
+}
+
+} // end namespace video
+} // end namespace irr
+
@@ -0,0 +1,99 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __C_VERTEX_TRANSFORM_H_INCLUDED__
+#define __C_VERTEX_TRANSFORM_H_INCLUDED__
+
+#include "S2DVertex.h"
+#include "CTRSpanKernels.h"
+#include "matrix4.h"
+
+namespace irr
+{
+namespace video
+{
+	//! states of the transform from 3d vertices to screen vertices
+	struct STransformParameters
+	{
+		core::matrix4 Matrix;			// projection * view * world
+		s32 ViewTransformWidth;			// half width of the viewport
+		s32 ViewTransformHeight;		// half height of the viewport
+		s32 TranslationX, TranslationY;	// screen position of the viewport center
+		s32 TextureWidth, TextureHeight;
+		s32 Texture2Width, Texture2Height;	// size of the lightmap
+		f32 ZScale;						// z value of a vertex with w = 1
+	};
+
+	//! a block of vertices in structure of arrays layout, so the
+	//! transform kernels can work on several vertices at once.
+	struct SVertexBlock
+	{
+		enum { SIZE = 64 };
+
+		f32 X[SIZE], Y[SIZE], Z[SIZE];
+		f32 Tx[SIZE], Ty[SIZE];
+		f32 Tx2[SIZE], Ty2[SIZE];
+		s32 Color[SIZE];
+		u16 Index[SIZE];	// index of the screen vertex the result is written to
+		s32 Count;
+	};
+
+	//! planes of the clip space a vertex can be outside of. The sides of the
+	//! guard band are GUARD_BAND times as far from the center of the viewport
+	//! as its borders, the renderers clip everything inside it to the viewport.
+	enum E_CLIP_CODE
+	{
+		ECC_NEAR = 1,
+		ECC_LEFT = 2,
+		ECC_RIGHT = 4,
+		ECC_BOTTOM = 8,
+		ECC_TOP = 16
+	};
+
+	const f32 GUARD_BAND = 4.0f;
+
+	//! transforms a block of vertices and writes them to the screen vertices,
+	//! and the E_CLIP_CODE flags of each vertex to clipCodes. All kernels
+	//! calculate exactly the same screen vertices and clip codes.
+	typedef void (*TTransformBlock)(const STransformParameters& parameters,
+		const SVertexBlock& block, S2DVertex* out, u8* clipCodes);
+
+	//! returns the fastest transform kernel the processor supports
+	TTransformBlock getTransformKernel();
+
+	//! returns the transform kernel of an instruction set, or 0 if the
+	//! processor or the compiler does not support it.
+	TTransformBlock getTransformKernel(ESpanKernelSet set);
+
+	//! a vertex in clip space, before the perspective divide
+	struct SClipVertex
+	{
+		f32 X, Y, Z, W;
+		f32 Tx, Ty;
+		f32 Tx2, Ty2;
+		s32 Color;
+	};
+
+	//! the most vertices a clipped triangle can have, one more for every plane
+	const s32 MAX_CLIPPED_VERTICES = 8;
+
+	//! returns the E_CLIP_CODE flags of a vertex, the same the kernels calculate
+	u32 getClipCodes(const SClipVertex& vertex);
+
+	//! clips a polygon against the planes in the clip codes.
+	//! \param polygon: Vertices of the polygon, the clipped polygon is written
+	//! back. Has to have room for MAX_CLIPPED_VERTICES vertices.
+	//! \return Returns the amount of vertices of the clipped polygon, less than
+	//! 3 if nothing is left of it.
+	s32 clipPolygon(SClipVertex* polygon, s32 count, u32 clipCodes);
+
+	//! projects a vertex in clip space to the screen like the kernels do
+	void projectVertex(const STransformParameters& parameters,
+		const SClipVertex& vertex, S2DVertex& out);
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -13,8 +13,8 @@ namespace video
 
 //! constructor
 CVideoDirectX8::CVideoDirectX8(const core::dimension2d<s32>& screenSize, HWND window, 
-								bool fullscreen, io::IFileSystem* io, bool pureSoftware)
-: CVideoNull(io, screenSize), D3DLibrary(0), CurrentRenderMode(ERM_NONE), pID3DDevice(0),
+								bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler, bool pureSoftware)
+: CVideoNull(io, timer, profiler, screenSize), D3DLibrary(0), CurrentRenderMode(ERM_NONE), pID3DDevice(0),
  LastVertexType((video::E_VERTEX_TYPE)-1), ResetRenderStates(true), pID3D(0),
  LastSetLight(-1)
 {
@@ -933,9 +933,9 @@ s32 CVideoDirectX8::getMaximalDynamicLightAmount()
 
 //! creates a video driver
 IVideoDriver* createDirectX8Driver(const core::dimension2d<s32>& screenSize, HWND window, 
-								   u32 bits, bool fullscreen, io::IFileSystem* io, bool pureSoftware)
+								   u32 bits, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler, bool pureSoftware)
 {
-	CVideoDirectX8* dx8 =  new CVideoDirectX8(screenSize, window, fullscreen, io, pureSoftware);
+	CVideoDirectX8* dx8 =  new CVideoDirectX8(screenSize, window, fullscreen, io, timer, profiler, pureSoftware);
 	if (!dx8->initDriver(screenSize, window, bits, fullscreen, pureSoftware))
 	{
 		dx8->drop();
@@ -19,7 +19,7 @@ namespace video
 	{
 	public:
 		//! constructor
-		CVideoDirectX8(const core::dimension2d<s32>& screenSize, HWND window, bool fullscreen, io::IFileSystem* io, bool pureSoftware=false);
+		CVideoDirectX8(const core::dimension2d<s32>& screenSize, HWND window, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler, bool pureSoftware=false);
 
 		//! destructor
 		virtual ~CVideoDirectX8();
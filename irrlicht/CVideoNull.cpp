@@ -1,5 +1,6 @@
-#include "CVideoNull.H"
-#include "CSoftwareTexture.H"
+#include "CVideoNull.h"
+#include "CSoftwareTexture.h"
+#include "CColorQuantizer.h"
 #include "os.h"
 
 namespace irr
@@ -18,8 +19,9 @@ ISurfaceLoader* createSurfaceLoaderPSD();
 
 
 //! constructor
-CVideoNull::CVideoNull(io::IFileSystem* io, const core::dimension2d<s32>& screenSize)
-: ScreenSize(screenSize), ViewPort(0,0,0,0), FileSystem(io), PrimitivesDrawn(0)
+CVideoNull::CVideoNull(io::IFileSystem* io, ITimer* timer, IProfiler* profiler, const core::dimension2d<s32>& screenSize)
+: ScreenSize(screenSize), ViewPort(0,0,0,0), FileSystem(io), Timer(timer), Profiler(profiler), PrimitivesDrawn(0),
+	PalettedTextures(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CVideoNull");
@@ -30,6 +32,12 @@ CVideoNull::CVideoNull(io::IFileSystem* io, const core::dimension2d<s32>& screen
 	if (FileSystem)
 		FileSystem->grab();
 
+	if (Timer)
+		Timer->grab();
+
+	if (Profiler)
+		Profiler->grab();
+
 	// create surface loader
 
 	SurfaceLoader.push_back(video::createSurfaceLoaderBmp());
@@ -48,6 +56,12 @@ CVideoNull::~CVideoNull()
 	if (FileSystem)
 		FileSystem->drop();
 
+	if (Timer)
+		Timer->drop();
+
+	if (Profiler)
+		Profiler->drop();
+
 	// delete textures
 
 	deleteAllTextures();
@@ -74,6 +88,9 @@ void CVideoNull::deleteAllTextures()
 //! applications must call this method before performing any rendering. returns false if failed.
 bool CVideoNull::beginScene(bool backBuffer, bool zBuffer, Color color)
 {
+	if (Profiler)
+		Profiler->beginFrame();
+
 	PrimitivesDrawn = 0;
 	return true;
 }
@@ -83,7 +100,10 @@ bool CVideoNull::beginScene(bool backBuffer, bool zBuffer, Color color)
 //! applications must call this method after performing any rendering. returns false if failed.
 bool CVideoNull::endScene()
 {
-	FPSCounter.registerFrame(os::Timer::getTime());
+	FPSCounter.registerFrame(Timer ? Timer->getTime() : os::Timer::getTime());
+
+	if (Profiler)
+		Profiler->endFrame();
 	return true;
 }
 
@@ -211,6 +231,14 @@ video::ITexture* CVideoNull::loadTextureFromFile(io::IReadFile* file, bool gener
 		os::Debuginfo::print("Loaded texture", file->getFileName());
 		#endif
 
+		if (PalettedTextures)
+		{
+			// quantized here once for the surfaces of all loaders
+			ISurface* paletted = CColorQuantizer::createPalettedSurface(surface, surface->getColorFormat());
+			surface->drop();
+			surface = paletted;
+		}
+
 		texture = createDeviceDependentTexture(surface, generateMipLevels);
 		surface->drop();
 	}
@@ -262,7 +290,7 @@ video::ITexture* CVideoNull::findTexture(const c8* filename)
 //! creates a Texture
 ITexture* CVideoNull::addTexture(const core::dimension2d<s32>& size, const c8* name)
 {
-	ISurface* surface = createSurface(size);
+	ISurface* surface = createSurface(EHCF_A8R8G8B8, size);
 	ITexture* t = createDeviceDependentTexture(surface, false);
 	surface->drop();
 	addTexture(t, name);
@@ -276,7 +304,7 @@ ITexture* CVideoNull::addTexture(const core::dimension2d<s32>& size, const c8* n
 //! THIS METHOD HAS TO BE OVERRIDDEN BY DERIVED DRIVERS WITH OWN TEXTURES
 ITexture* CVideoNull::createDeviceDependentTexture(ISurface* surface, bool generateMipLevels)
 {
-	return new CSoftwareTexture(surface);
+	return new CSoftwareTexture(surface, surface->getColorFormat());
 }
 
 
@@ -387,10 +415,132 @@ s32 CVideoNull::getMaximalDynamicLightAmount()
 
 
 
+//! enables or disables the rasterizer statistics
+void CVideoNull::setRasterizerStatisticsEnabled(bool enabled)
+{
+}
+
+
+
+//! returns the amount of rasterizers the driver has statistics for
+s32 CVideoNull::getRasterizerCount()
+{
+	return 0;
+}
+
+
+
+//! returns the statistics of a rasterizer
+const SRasterizerStatistics* CVideoNull::getRasterizerStatistics(s32 index)
+{
+	return 0;
+}
+
+
+
+//! enables or disables the overdraw heat map
+void CVideoNull::setOverdrawHeatMap(bool enabled)
+{
+}
+
+
+
+//! sets the amount of threads the 3d scene is rasterized with
+void CVideoNull::setRasterizerThreads(s32 threadCount)
+{
+}
+
+
+
+//! sets the format of the z buffer
+void CVideoNull::setZBufferFormat(E_ZBUFFER_FORMAT format)
+{
+}
+
+
+
+//! enables or disables perspective correct texture mapping
+void CVideoNull::setPerspectiveCorrection(bool enabled)
+{
+}
+
+
+
+//! enables or disables bilinear filtering
+void CVideoNull::setBilinearFilter(bool enabled)
+{
+}
+
+
+
+//! selects if textures are stored in tiles
+void CVideoNull::setTiledTextures(bool enabled)
+{
+}
+
+
+
+//! selects if textures loaded from files are paletted
+void CVideoNull::setPalettedTextures(bool enabled)
+{
+}
+
+
+
+//! selects if textures are dithered to 16 bit
+void CVideoNull::setDitheredTextures(bool enabled)
+{
+}
+
+
+
+//! selects if lightmaps are precombined into the vertex colors
+void CVideoNull::setLightmapsPrecombined(bool precombined)
+{
+}
+
+
+
+//! enables or disables occlusion culling
+void CVideoNull::setOcclusionCullingEnabled(bool enabled)
+{
+}
+
+
+
+//! removes all occluders
+void CVideoNull::clearOcclusionBuffer()
+{
+}
+
+
+
+//! draws triangles into the occlusion buffer
+void CVideoNull::drawOccluders(const S3DVertex* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount)
+{
+}
+
+
+
+//! draws triangles into the occlusion buffer
+void CVideoNull::drawOccluders(const S3DVertex2TCoords* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount)
+{
+}
+
+
+
+//! returns if a box may be visible
+bool CVideoNull::isBoxVisible(const core::aabbox3d<f32>& box)
+{
+	return true;
+}
+
+
+
 //! creates a video driver
-IVideoDriver* createNullDriver(io::IFileSystem* io, const core::dimension2d<s32>& screenSize)
+IVideoDriver* createNullDriver(io::IFileSystem* io, ITimer* timer, IProfiler* profiler, const core::dimension2d<s32>& screenSize)
 {
-	return new CVideoNull(io, screenSize);
+	return new CVideoNull(io, timer, profiler, screenSize);
 }
 
 
@@ -7,6 +7,8 @@
 
 #include "IVideoDriver.h"
 #include "IFileSystem.h"
+#include "ITimer.h"
+#include "IProfiler.h"
 #include "ISurfacePresenter.h"
 #include "array.h"
 #include "irrstring.h"
@@ -23,7 +25,7 @@ namespace video
 	public:
 
 		//! constructor
-		CVideoNull(io::IFileSystem* io, const core::dimension2d<s32>& screenSize);
+		CVideoNull(io::IFileSystem* io, ITimer* timer, IProfiler* profiler, const core::dimension2d<s32>& screenSize);
 
 		//! destructor
 		virtual ~CVideoNull();
@@ -93,6 +95,57 @@ namespace video
 		//! returns the maximal amount of dynamic lights the device can handle
 		virtual s32 getMaximalDynamicLightAmount();
 
+		//! enables or disables the rasterizer statistics
+		virtual void setRasterizerStatisticsEnabled(bool enabled);
+
+		//! returns the amount of rasterizers the driver has statistics for
+		virtual s32 getRasterizerCount();
+
+		//! returns the statistics of a rasterizer
+		virtual const SRasterizerStatistics* getRasterizerStatistics(s32 index = -1);
+
+		//! enables or disables the overdraw heat map
+		virtual void setOverdrawHeatMap(bool enabled);
+
+		//! sets the amount of threads the 3d scene is rasterized with
+		virtual void setRasterizerThreads(s32 threadCount);
+
+		//! sets the format of the z buffer
+		virtual void setZBufferFormat(E_ZBUFFER_FORMAT format);
+
+		//! enables or disables perspective correct texture mapping
+		virtual void setPerspectiveCorrection(bool enabled);
+
+		//! enables or disables bilinear filtering
+		virtual void setBilinearFilter(bool enabled);
+
+		//! selects if textures are stored in tiles
+		virtual void setTiledTextures(bool enabled);
+
+		//! selects if textures loaded from files are paletted
+		virtual void setPalettedTextures(bool enabled);
+
+		//! selects if textures are dithered to 16 bit
+		virtual void setDitheredTextures(bool enabled);
+
+		//! selects if lightmaps are precombined into the vertex colors
+		virtual void setLightmapsPrecombined(bool precombined);
+
+		//! enables or disables occlusion culling
+		virtual void setOcclusionCullingEnabled(bool enabled);
+
+		//! removes all occluders
+		virtual void clearOcclusionBuffer();
+
+		//! draws triangles into the occlusion buffer
+		virtual void drawOccluders(const S3DVertex* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount);
+
+		//! draws triangles into the occlusion buffer
+		virtual void drawOccluders(const S3DVertex2TCoords* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount);
+
+		//! returns if a box may be visible
+		virtual bool isBoxVisible(const core::aabbox3d<f32>& box);
+
 	protected:
 
 		//! deletes all textures
@@ -126,6 +179,8 @@ namespace video
 		core::array<video::ISurfaceLoader*> SurfaceLoader;
 
 		io::IFileSystem* FileSystem;
+		ITimer* Timer;
+		IProfiler* Profiler;
 
 		core::rectEx<s32> ViewPort;
 		core::dimension2d<s32> ScreenSize;
@@ -133,6 +188,8 @@ namespace video
 		CFPSCounter FPSCounter;
 
 		u32 PrimitivesDrawn;
+
+		bool PalettedTextures;		// loaded surfaces are quantized to EHCF_P8
 	};
 
 } // end namespace video
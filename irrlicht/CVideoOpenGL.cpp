@@ -10,8 +10,8 @@ namespace video
 
 #ifdef WIN32
 //! win32 constructor and init code
-CVideoOpenGL::CVideoOpenGL(const core::dimension2d<s32>& screenSize, HWND window, bool fullscreen, io::IFileSystem* io)
-: CVideoNull(io, screenSize), HDc(0), HRc(0), Window(window)
+CVideoOpenGL::CVideoOpenGL(const core::dimension2d<s32>& screenSize, HWND window, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler)
+: CVideoNull(io, timer, profiler, screenSize), HDc(0), HRc(0), Window(window)
 {
 	#ifdef _DEBUG
 	setDebugName("CVideoOpenGL");
@@ -318,9 +318,9 @@ void CVideoOpenGL::setMaterial(const SMaterial& material)
 
 
 #ifdef WIN32
-IVideoDriver* createOpenGLDriver(const core::dimension2d<s32>& screenSize, HWND window, bool fullscreen, io::IFileSystem* io)
+IVideoDriver* createOpenGLDriver(const core::dimension2d<s32>& screenSize, HWND window, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler)
 {
-	CVideoOpenGL* ogl =  new CVideoOpenGL(screenSize, window, fullscreen, io);
+	CVideoOpenGL* ogl =  new CVideoOpenGL(screenSize, window, fullscreen, io, timer, profiler);
 	if (!ogl->initDriver(screenSize, window, fullscreen))
 	{
 		ogl->drop();
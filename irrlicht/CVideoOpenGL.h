@@ -27,7 +27,7 @@ namespace video
 
 		#ifdef WIN32
 		//! win32 constructor
-		CVideoOpenGL(const core::dimension2d<s32>& screenSize, HWND window, bool fullscreen, io::IFileSystem* io);
+		CVideoOpenGL(const core::dimension2d<s32>& screenSize, HWND window, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler);
 
 		//! inits the open gl driver
 		bool initDriver(const core::dimension2d<s32>& screenSize, HWND window, bool fullscreen);
@@ -2,17 +2,153 @@
 #include "CSoftwareTexture.h"
 #include "os.h"
 #include "S3DVertex.h"
+#include <memory.h>
+#include <math.h>
 
 namespace irr
 {
 namespace video
 {
 
+//! vertex lists with at least this amount of vertices are transformed
+//! by all threads of the tile rasterizer
+const s32 PARALLEL_TRANSFORM_VERTICES = 4096;
+
+//! amount of vertices transformed by one part of a CTransformTask
+const s32 TRANSFORM_TASK_PART_SIZE = 1024;
+
+
+
+//! returns the texture coordinates of the lightmap of a vertex. Vertices
+//! with one texture use it for both.
+static inline const core::vector2d<f32>& getTCoords2(const S3DVertex& v)
+{
+	return v.TCoords;
+}
+
+
+
+//! returns the texture coordinates of the lightmap of a vertex
+static inline const core::vector2d<f32>& getTCoords2(const S3DVertex2TCoords& v)
+{
+	return v.TCoords2;
+}
+
+
+
+//! copies vertices into blocks and transforms them with a kernel
+template <class T>
+static void transformVertexList(const T* vertices, const u16* list, s32 count,
+	const STransformParameters& parameters, TTransformBlock kernel, S2DVertex* out,
+	u8* clipCodes)
+{
+	SVertexBlock block;
+
+	for (s32 i=0; i<count; i+=SVertexBlock::SIZE)
+	{
+		block.Count = count - i < SVertexBlock::SIZE ? count - i : SVertexBlock::SIZE;
+
+		for (s32 j=0; j<block.Count; ++j)
+		{
+			const T& v = vertices[list[i+j]];
+
+			block.X[j] = v.Pos.X;
+			block.Y[j] = v.Pos.Y;
+			block.Z[j] = v.Pos.Z;
+			block.Tx[j] = v.TCoords.X;
+			block.Ty[j] = v.TCoords.Y;
+			block.Tx2[j] = getTCoords2(v).X;
+			block.Ty2[j] = getTCoords2(v).Y;
+			block.Color[j] = v.Color.color;
+			block.Index[j] = list[i+j];
+		}
+
+		kernel(parameters, block, out, clipCodes);
+	}
+}
+
+
+
+//! transforms parts of a vertex list on the threads of a pool. Every
+//! vertex is in the list only once, so the parts write different vertices.
+template <class T>
+class CTransformTask : public IThreadTask
+{
+public:
+
+	CTransformTask(const T* vertices, const u16* list, s32 count,
+		const STransformParameters& parameters, TTransformBlock kernel, S2DVertex* out,
+		u8* clipCodes)
+		: Vertices(vertices), List(list), Count(count), Parameters(parameters),
+		Kernel(kernel), Out(out), ClipCodes(clipCodes) {}
+
+	virtual void runTask(s32 part, s32 thread)
+	{
+		s32 first = part * TRANSFORM_TASK_PART_SIZE;
+		s32 count = Count - first < TRANSFORM_TASK_PART_SIZE ? Count - first : TRANSFORM_TASK_PART_SIZE;
+
+		transformVertexList(Vertices, List + first, count, Parameters, Kernel, Out, ClipCodes);
+	}
+
+private:
+
+	const T* Vertices;
+	const u16* List;
+	s32 Count;
+	const STransformParameters& Parameters;
+	TTransformBlock Kernel;
+	S2DVertex* Out;
+	u8* ClipCodes;
+};
+
+
+
+//! transforms the vertices of a list, with several threads if there are many
+template <class T>
+static void transformVertices(const T* vertices, const u16* list, s32 count,
+	const STransformParameters& parameters, TTransformBlock kernel, S2DVertex* out,
+	u8* clipCodes, CThreadPool* threads)
+{
+	if (threads && count >= PARALLEL_TRANSFORM_VERTICES)
+	{
+		CTransformTask<T> task(vertices, list, count, parameters, kernel, out, clipCodes);
+		threads->run(&task, (count + TRANSFORM_TASK_PART_SIZE - 1) / TRANSFORM_TASK_PART_SIZE);
+	}
+	else
+		transformVertexList(vertices, list, count, parameters, kernel, out, clipCodes);
+}
+
+
+
+//! transforms a vertex into clip space like the kernels do
+template <class T>
+static void getClipVertex(const void* vertices, s32 index, const core::matrix4& m, SClipVertex& out)
+{
+	const T& v = ((const T*)vertices)[index];
+
+	out.X = m(0,0)*v.Pos.X + m(0,1)*v.Pos.Y + m(0,2)*v.Pos.Z + m(0,3);
+	out.Y = m(1,0)*v.Pos.X + m(1,1)*v.Pos.Y + m(1,2)*v.Pos.Z + m(1,3);
+	out.Z = m(2,0)*v.Pos.X + m(2,1)*v.Pos.Y + m(2,2)*v.Pos.Z + m(2,3);
+	out.W = m(3,0)*v.Pos.X + m(3,1)*v.Pos.Y + m(3,2)*v.Pos.Z + m(3,3);
+	out.Tx = v.TCoords.X;
+	out.Ty = v.TCoords.Y;
+	out.Tx2 = getTCoords2(v).X;
+	out.Ty2 = getTCoords2(v).Y;
+	out.Color = v.Color.color;
+}
+
+
 
 //! constructor
-CVideoSoftware::CVideoSoftware(const core::dimension2d<s32>& windowSize, bool fullscreen, io::IFileSystem* io, video::ISurfacePresenter* presenter)
-: CVideoNull(io, windowSize), CurrentTriangleRenderer(0), Texture(0),
-	 ZBuffer(0), RenderTargetTexture(0), RenderTargetSurface(0)
+CVideoSoftware::CVideoSoftware(const core::dimension2d<s32>& windowSize, ECOLOR_FORMAT format, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler, video::ISurfacePresenter* presenter)
+: CVideoNull(io, timer, profiler, windowSize), TransformGeneration(0), TransformKernel(0),
+	 RenderTargetTexture(0), RenderTargetSurface(0), CurrentTriangleRenderer(0),
+	 CurrentRenderer(ETR_FLAT), ZBuffer(0), Texture(0), Texture2(0), LightmapsPrecombined(false),
+	 LightmapToVertices(false), StatisticsEnabled(false), OverdrawHeatMap(false),
+	 OverdrawSurface(0), TileRasterizer(0),
+	 PerspectiveCorrection(false), BilinearFilter(false), TiledTextures(false),
+	 DitheredTextures(false),
+	 OcclusionBuffer(0), OcclusionCulling(true)
 {
 	#ifdef _DEBUG
 	setDebugName("CVideoSoftware");
@@ -20,29 +156,37 @@ CVideoSoftware::CVideoSoftware(const core::dimension2d<s32>& windowSize, bool fu
 
 	os::Debuginfo::print("Warning: The 3d pipeline of the software device is not 100% implemented yet!");
 
-	// create backbuffer
+	// create backbuffer. The triangle renderers and textures use its color format.
 
-	BackBuffer = video::createSurface(windowSize);
+	BackBuffer = video::createSurface(format, windowSize);
 	BackBuffer->fill(0);
 	
 	// get presenter
 
 	Presenter = presenter;
 
+	// select the fastest vertex transform
+
+	TransformKernel = getTransformKernel();
+
 	// create z buffer
 
 	ZBuffer = irr::video::createZBuffer(BackBuffer->getDimension());
 
+	// create occlusion buffer
+
+	OcclusionBuffer = new COcclusionBuffer();
+
 	// create triangle renderers
 
-	TriangleRenderers[ETR_FLAT] = createTriangleRendererFlat(ZBuffer);
-	TriangleRenderers[ETR_FLAT_WIRE] = createTriangleRendererFlatWire(ZBuffer);
-	TriangleRenderers[ETR_GOURAUD] = createTriangleRendererGouraud(ZBuffer);
-	TriangleRenderers[ETR_GOURAUD_WIRE] = createTriangleRendererGouraudWire(ZBuffer);
-	TriangleRenderers[ETR_TEXTURE_FLAT] = createTriangleRendererTextureFlat(ZBuffer);
-	TriangleRenderers[ETR_TEXTURE_FLAT_WIRE] = createTriangleRendererTextureFlatWire(ZBuffer);
-	TriangleRenderers[ETR_TEXTURE_GOURAUD] = createTriangleRendererTextureGouraud(ZBuffer);
-	TriangleRenderers[ETR_TEXTURE_GOURAUD_WIRE] = createTriangleRendererTextureGouraudWire(ZBuffer);
+	for (s32 i=0; i<ETR_COUNT; ++i)
+	{
+		TriangleRenderers[i] = createTriangleRenderer((ETriangleRenderer)i, ZBuffer);
+		RendererNames[i] = getTriangleRendererName((ETriangleRenderer)i);
+		Statistics[i].Name = RendererNames[i].c_str();
+	}
+
+	TotalStatistics.Name = "total";
 
 	// select render target
 
@@ -58,6 +202,15 @@ CVideoSoftware::CVideoSoftware(const core::dimension2d<s32>& windowSize, bool fu
 //! destructor
 CVideoSoftware::~CVideoSoftware()
 {
+	// delete tile rasterizer, draws the remaining triangles
+
+	if (TileRasterizer)
+		TileRasterizer->drop();
+
+	// delete occlusion buffer
+
+	OcclusionBuffer->drop();
+
 	// delete Backbuffer
 	BackBuffer->drop();
 
@@ -77,11 +230,17 @@ CVideoSoftware::~CVideoSoftware()
 	if (Texture)
 		Texture->drop();
 
+	if (Texture2)
+		Texture2->drop();
+
 	if (RenderTargetTexture)
 		RenderTargetTexture->drop();
 
 	if (RenderTargetSurface)
 		RenderTargetSurface->drop();
+
+	if (OverdrawSurface)
+		OverdrawSurface->drop();
 }
 
 
@@ -90,13 +249,40 @@ CVideoSoftware::~CVideoSoftware()
 void CVideoSoftware::switchToTriangleRenderer(ETriangleRenderer renderer)
 {
 	video::ISurface* s = 0;
+	video::ISurface* const* mipMaps = 0;
+	s32 mipMapCount = 0;
+	bool tiled = false;
 	if (Texture)
-		s = ((CSoftwareTexture*)Texture)->getTexture();
+	{
+		s = ((CSoftwareTexture*)Texture)->getRendererTexture();
+		mipMaps = ((CSoftwareTexture*)Texture)->getMipMaps();
+		mipMapCount = ((CSoftwareTexture*)Texture)->getMipMapCount();
+		tiled = ((CSoftwareTexture*)Texture)->isTiled();
+	}
+
+	video::ISurface* s2 = 0;
+	if (Texture2)
+		s2 = ((CSoftwareTexture*)Texture2)->getTexture();
 
+	CurrentRenderer = renderer;
 	CurrentTriangleRenderer = TriangleRenderers[renderer];
 	CurrentTriangleRenderer->setBackfaceCulling(Material.BackfaceCulling == true);
 	CurrentTriangleRenderer->setTexture(s);
-	CurrentTriangleRenderer->setRenderTarget(RenderTargetSurface, ViewPort);
+	CurrentTriangleRenderer->setTexture2(s2);
+	CurrentTriangleRenderer->setMipMaps(mipMaps, mipMapCount);
+	CurrentTriangleRenderer->setTextureTiled(tiled);
+	CurrentTriangleRenderer->setRenderTarget(getTriangleRenderTarget(), ViewPort);
+}
+
+
+
+//! returns the surface the current triangle renderer draws into
+video::ISurface* CVideoSoftware::getTriangleRenderTarget()
+{
+	if (CurrentRenderer == ETR_OVERDRAW)
+		return OverdrawSurface;
+
+	return RenderTargetSurface;
 }
 
 
@@ -104,22 +290,62 @@ void CVideoSoftware::switchToTriangleRenderer(ETriangleRenderer renderer)
 void CVideoSoftware::selectRightTriangleRenderer()
 {
 	ETriangleRenderer renderer = ETR_FLAT;
+	LightmapToVertices = false;
 
-	if (Texture)
+	if (!Material.Wireframe)
 	{
-		if (!Material.GouraudShading)
-			renderer = (!Material.Wireframe) ? ETR_TEXTURE_FLAT : ETR_TEXTURE_FLAT_WIRE;
+		// the filled renderers are numbered by the features they draw with
+		u32 features = 0;
+
+		if (Texture)
+			features |= ESF_TEXTURE;
+
+		// like in the hardware drivers, the vertex colors do not light
+		// lightmapped materials. Precombined lightmaps replace them.
+		if (Texture2 && !LightmapsPrecombined)
+			features |= ESF_LIGHTMAP;
+		else
+		if (Texture2)
+		{
+			features |= ESF_GOURAUD;
+			LightmapToVertices = true;
+		}
 		else
-			renderer = (!Material.Wireframe) ? ETR_TEXTURE_GOURAUD : ETR_TEXTURE_GOURAUD_WIRE;
+		if (Material.GouraudShading)
+			features |= ESF_GOURAUD;
+
+		// transparent materials are blended with the pixels behind them.
+		// Like in the hardware drivers, they test the z buffer without
+		// writing into it.
+		if (Material.MaterialType == EMT_TRANSPARENT_ADD_COLOR)
+			features |= ESF_BLEND_ADD;
+		else
+		if (Material.MaterialType == EMT_TRANSPARENT_ALPHA_CHANNEL)
+			features |= ESF_BLEND_ALPHA;
+
+		if (Texture && BilinearFilter && Material.BilinearFilter)
+			features |= ESF_BILINEAR;
+
+		if (!Material.ZBuffer)
+			features |= ESF_NO_ZTEST;
+		else
+		if (!Material.ZWriteEnable || Material.isTransparent())
+			features |= ESF_NO_ZWRITE;
+
+		renderer = (ETriangleRenderer)(ETR_FLAT + features);
 	}
 	else
 	{
-		if (!Material.GouraudShading)
-			renderer = (!Material.Wireframe) ? ETR_FLAT : ETR_FLAT_WIRE;
+		if (Texture)
+			renderer = Material.GouraudShading ? ETR_TEXTURE_GOURAUD_WIRE : ETR_TEXTURE_FLAT_WIRE;
 		else
-			renderer = (!Material.Wireframe) ? ETR_GOURAUD : ETR_GOURAUD_WIRE;
+			renderer = Material.GouraudShading ? ETR_GOURAUD_WIRE : ETR_FLAT_WIRE;
 	}
 
+	// the heat map is only drawn into the back buffer, not into textures
+	if (OverdrawHeatMap && RenderTargetSurface == BackBuffer)
+		renderer = ETR_OVERDRAW;
+
 	switchToTriangleRenderer(renderer);
 }
 
@@ -129,10 +355,18 @@ void CVideoSoftware::selectRightTriangleRenderer()
 //! presents the rendered scene on the screen, returns false if failed
 bool CVideoSoftware::endScene()
 {
-	CVideoNull::endScene();
+	flushTiles();
 
-	Presenter->present(BackBuffer);
-	return true;
+	if (OverdrawHeatMap)
+		resolveOverdrawHeatMap();
+
+	{
+		SProfileScope zone(Profiler, "CVideoSoftware::present");
+		Presenter->present(BackBuffer);
+	}
+
+	// finishes the frame of the profiler, so present has to be called before.
+	return CVideoNull::endScene();
 }
 
 
@@ -143,13 +377,13 @@ bool CVideoSoftware::queryFeature(EK3D_VIDEO_DRIVER_FEATURE feature)
 	switch (feature)
 	{
 	case EK3DVDF_BILINEAR_FILER:
-		return false;
+		return true;
 	case EK3DVDF_RENDER_TO_TARGET:
 		return true;
 	case EK3DVDF_HARDWARE_TL:
 		return false;
 	case EK3DVDF_MIP_MAP:
-		return false;
+		return true;
 	};
 
 	return false;
@@ -192,10 +426,35 @@ void CVideoSoftware::setTexture(video::ITexture* texture)
 
 
 
+//! sets the current lightmap
+void CVideoSoftware::setTexture2(video::ITexture* texture)
+{
+	#ifdef _DEBUG
+	if (texture && texture->getDriverType() != DT_SOFTWARE)
+	{
+		os::Debuginfo::print("Fatal Error: Tried to set a texture not owned by this driver.");
+		return;
+	}
+	#endif
+
+	if (Texture2)
+		Texture2->drop();
+
+	Texture2 = texture;
+
+	if (Texture2)
+		Texture2->grab();
+}
+
+
+
 //! sets a material
 void CVideoSoftware::setMaterial(const SMaterial& material)
 {
 	Material = material;
+
+	// the renderer is selected by setTexture(), after both textures are set.
+	setTexture2(Material.MaterialType == EMT_LIGHTMAP ? Material.Texture2 : 0);
 	setTexture(Material.Texture1);
 }
 
@@ -205,11 +464,27 @@ bool CVideoSoftware::beginScene(bool backBuffer, bool zBuffer, Color color)
 {
 	CVideoNull::beginScene(backBuffer, zBuffer, color);
 
+	flushTiles();
+
 	if (backBuffer)
-		BackBuffer->fill(color.toA1R5G5B5());
+		BackBuffer->fill(color);
 
-	if (ZBuffer)
-		ZBuffer->clear();
+	if (zBuffer && ZBuffer)
+	{
+		// with tiles, every tile clears its part of the zbuffer
+		// in parallel, right before drawing into it.
+		if (TileRasterizer)
+			TileRasterizer->clearZBuffer();
+		else
+			ZBuffer->clear();
+	}
+
+	if (OverdrawHeatMap)
+		OverdrawSurface->fill(0);
+
+	if (StatisticsEnabled)
+		for (s32 i=0; i<ETR_COUNT; ++i)
+			Statistics[i].reset();
 
 	return true;
 }
@@ -227,7 +502,13 @@ void CVideoSoftware::setRenderTarget(video::ITexture* texture)
 	#endif
 
 	if (RenderTargetTexture)
+	{
+		// the surfaces the renderers draw of the texture are updated
+		// with what was drawn into it
+		flushTiles();
+		((CSoftwareTexture*)RenderTargetTexture)->updateRendererSurfaces();
 		RenderTargetTexture->drop();
+	}
 
 	RenderTargetTexture = texture;
 
@@ -244,6 +525,8 @@ void CVideoSoftware::setRenderTarget(video::ITexture* texture)
 //! sets a render target
 void CVideoSoftware::setRenderTarget(video::ISurface* surface)
 {
+	flushTiles();
+
 	if (RenderTargetSurface)
 		RenderTargetSurface->drop();
 
@@ -263,6 +546,9 @@ void CVideoSoftware::setRenderTarget(video::ISurface* surface)
 
 	if (ZBuffer)
 		ZBuffer->setSize(RenderTargetSize);
+
+	if (TileRasterizer)
+		TileRasterizer->setTargetSize(RenderTargetSize);
 }
 
 
@@ -272,18 +558,18 @@ void CVideoSoftware::setViewPort(const core::rectEx<s32>& area)
 {
 	ViewPort = area;
 
-	//TODO: the clipping is not correct, because the projection is affected.
-	// to correct this, ViewPortSize and Render2DTranslation will have to be corrected.
+	// the projection uses the whole viewport, the renderers only draw
+	// the part of it inside the render target.
+	ViewPortSize.Width = area.getWidth();
+	ViewPortSize.Height = area.getHeight();
+	Render2DTranslation.X = (ViewPortSize.Width / 2) + area.UpperLeftCorner.X;
+	Render2DTranslation.Y = area.UpperLeftCorner.Y + ViewPortSize.Height - (ViewPortSize.Height / 2);
+
 	core::rectEx<s32> rendert(0,0,RenderTargetSize.Width,RenderTargetSize.Height);
 	ViewPort.clipAgainst(rendert);
 
-	ViewPortSize.Width = ViewPort.getWidth();
-	ViewPortSize.Height = ViewPort.getHeight();
-	Render2DTranslation.X = (ViewPortSize.Width / 2) + ViewPort.UpperLeftCorner.X;
-	Render2DTranslation.Y = ViewPort.UpperLeftCorner.Y + ViewPortSize.Height - (ViewPortSize.Height / 2);// + ViewPort.UpperLeftCorner.Y;
-
 	if (CurrentTriangleRenderer)
-		CurrentTriangleRenderer->setRenderTarget(RenderTargetSurface, ViewPort);
+		CurrentTriangleRenderer->setRenderTarget(getTriangleRenderTarget(), ViewPort);
 }
 
 
@@ -296,55 +582,44 @@ void CVideoSoftware::drawIndexedTriangleList(const S3DVertex* vertices, s32 vert
 
 	CVideoNull::drawIndexedTriangleList(vertices, vertexCount, indexList, triangleCount);
 
-	if ((s32)TransformedPoints.size() < vertexCount)
-		TransformedPoints.set_used(vertexCount);
-
-	const S3DVertex* currentVertex = vertices;
-	S2DVertex* tp = &TransformedPoints[0];
-
-	core::dimension2d<s32> textureSize(0,0);
-	f32 zDiv;
-
-	if (Texture)
-		textureSize = ((CSoftwareTexture*)Texture)->getTexture()->getDimension();
+	S2DVertex* transformed = 0;
 
-	f32 transformedPos[4]; // transform all points in the list
+	if (TileRasterizer)
+		transformed = TileRasterizer->allocateVertices(vertexCount);
+	else
+	{
+		if ((s32)TransformedPoints.size() < vertexCount)
+			TransformedPoints.set_used(vertexCount);
 
-	core::matrix4 matrix(TransformationMatrix[TS_PROJECTION]);
-	matrix *= TransformationMatrix[TS_VIEW];
-	matrix *= TransformationMatrix[TS_WORLD];
+		transformed = &TransformedPoints[0];
+	}
 
-	s32 ViewTransformWidth = (ViewPortSize.Width>>1);
-	s32 ViewTransformHeight = (ViewPortSize.Height>>1);
+	STransformParameters parameters;
+	s32 count;
 
-	for (s32 i=0; i<vertexCount; ++i)
+	// transform the points referenced by the index list
 	{
-		transformedPos[0] = currentVertex->Pos.X;
-		transformedPos[1] = currentVertex->Pos.Y;
-		transformedPos[2] = currentVertex->Pos.Z;
-		transformedPos[3] = 1.0f;
+		SProfileScope zone(Profiler, "CVideoSoftware transform");
 
-		matrix.multiplyWith1x4Matrix(transformedPos);
-		zDiv = transformedPos[3] == 0.0f ? 1.0f : (1.0f / transformedPos[3]);
+		getTransformParameters(parameters);
 
-		tp->Pos.X = (s32)(ViewTransformWidth * (transformedPos[0] * zDiv) + (Render2DTranslation.X));
-		tp->Pos.Y = (Render2DTranslation.Y - (s32)(ViewTransformHeight * (transformedPos[1] * zDiv)));
-		tp->Color = currentVertex->Color.toA1R5G5B5();
-		tp->ZValue = (TZBufferType)(32767.0f * zDiv);
+		count = collectReferencedVertices(indexList, triangleCount * 3, vertexCount);
 
-		tp->TCoords.X = (s32)(currentVertex->TCoords.X * textureSize.Width);
-		tp->TCoords.X <<= 8;
-		tp->TCoords.Y = (s32)(currentVertex->TCoords.Y * textureSize.Height);
-		tp->TCoords.Y <<= 8;
+		transformVertices(vertices, TransformList.pointer(), count, parameters,
+			TransformKernel, transformed, ClipCodes.pointer(),
+			TileRasterizer ? TileRasterizer->getThreadPool() : 0);
 
-		++currentVertex;
-		++tp;
+		combineLightmap(transformed, TransformList.pointer(), count);
 	}
 
+	// draw all transformed points from the index list, clip the triangles
+	// crossing the near plane or the guard band first.
 
-	// draw all transformed points from the index list
-	CurrentTriangleRenderer->drawIndexedTriangleList(&TransformedPoints[0],
-		vertexCount, indexList, triangleCount);
+	if (!isClippingNeeded(count))
+		drawTransformedTriangleList(transformed, vertexCount, indexList, triangleCount);
+	else
+		drawClippedTriangleList(vertices, getClipVertex<S3DVertex>, parameters,
+			transformed, vertexCount, indexList, triangleCount);
 }
 
 
@@ -357,55 +632,44 @@ void CVideoSoftware::drawIndexedTriangleList(const S3DVertex2TCoords* vertices,
 
 	CVideoNull::drawIndexedTriangleList(vertices, vertexCount, indexList, triangleCount);
 
-	if ((s32)TransformedPoints.size() < vertexCount)
-		TransformedPoints.set_used(vertexCount);
+	S2DVertex* transformed = 0;
 
-	const S3DVertex2TCoords* currentVertex = vertices;
-	S2DVertex* tp = &TransformedPoints[0];
-
-	core::dimension2d<s32> textureSize(0,0);
-	f32 zDiv;
-
-	if (Texture)
-		textureSize = ((CSoftwareTexture*)Texture)->getTexture()->getDimension();
-
-	f32 transformedPos[4]; // transform all points in the list
+	if (TileRasterizer)
+		transformed = TileRasterizer->allocateVertices(vertexCount);
+	else
+	{
+		if ((s32)TransformedPoints.size() < vertexCount)
+			TransformedPoints.set_used(vertexCount);
 
-	core::matrix4 matrix(TransformationMatrix[TS_PROJECTION]);
-	matrix *= TransformationMatrix[TS_VIEW];
-	matrix *= TransformationMatrix[TS_WORLD];
+		transformed = &TransformedPoints[0];
+	}
 
-	s32 ViewTransformWidth = (ViewPortSize.Width>>1);
-	s32 ViewTransformHeight = (ViewPortSize.Height>>1);
+	STransformParameters parameters;
+	s32 count;
 
-	for (s32 i=0; i<vertexCount; ++i)
+	// transform the points referenced by the index list
 	{
-		transformedPos[0] = currentVertex->Pos.X;
-		transformedPos[1] = currentVertex->Pos.Y;
-		transformedPos[2] = currentVertex->Pos.Z;
-		transformedPos[3] = 1.0f;
+		SProfileScope zone(Profiler, "CVideoSoftware transform");
 
-		matrix.multiplyWith1x4Matrix(transformedPos);
-		zDiv = transformedPos[3] == 0.0f ? 1.0f : (1.0f / transformedPos[3]);
+		getTransformParameters(parameters);
 
-		tp->Pos.X = (s32)(ViewTransformWidth * (transformedPos[0] * zDiv) + (Render2DTranslation.X));
-		tp->Pos.Y = (Render2DTranslation.Y - (s32)(ViewTransformHeight * (transformedPos[1] * zDiv)));
-		tp->Color = currentVertex->Color.toA1R5G5B5();
-		tp->ZValue = (TZBufferType)(32767.0f * zDiv);
+		count = collectReferencedVertices(indexList, triangleCount * 3, vertexCount);
 
-		tp->TCoords.X = (s32)(currentVertex->TCoords.X * textureSize.Width);
-		tp->TCoords.X <<= 8;
-		tp->TCoords.Y = (s32)(currentVertex->TCoords.Y * textureSize.Height);
-		tp->TCoords.Y <<= 8;
+		transformVertices(vertices, TransformList.pointer(), count, parameters,
+			TransformKernel, transformed, ClipCodes.pointer(),
+			TileRasterizer ? TileRasterizer->getThreadPool() : 0);
 
-		++currentVertex;
-		++tp;
+		combineLightmap(transformed, TransformList.pointer(), count);
 	}
 
+	// draw all transformed points from the index list, clip the triangles
+	// crossing the near plane or the guard band first.
 
-	// draw all transformed points from the index list
-	CurrentTriangleRenderer->drawIndexedTriangleList(&TransformedPoints[0],
-		vertexCount, indexList, triangleCount);
+	if (!isClippingNeeded(count))
+		drawTransformedTriangleList(transformed, vertexCount, indexList, triangleCount);
+	else
+		drawClippedTriangleList(vertices, getClipVertex<S3DVertex2TCoords>, parameters,
+			transformed, vertexCount, indexList, triangleCount);
 }
 
 
@@ -413,6 +677,8 @@ void CVideoSoftware::drawIndexedTriangleList(const S3DVertex2TCoords* vertices,
 //! draws an 2d image
 void CVideoSoftware::draw2DImage(video::ITexture* texture, const core::position2d<s32>& destPos)
 {
+	flushTiles();
+
 	if (texture)
 	{
 		#ifdef _DEBUG
@@ -433,6 +699,8 @@ void CVideoSoftware::draw2DImage(video::ITexture* texture, const core::position2
 //! draws an 2d image, using a color (if color is other then Color(255,255,255,255)) and the alpha channel of the texture if wanted.
 void CVideoSoftware::draw2DImage(video::ITexture* texture, const core::position2d<s32>& destPos, const core::rectEx<s32>& sourceRect, const core::rectEx<s32>* clipRect, Color color, bool useAlphaChannelOfTexture)
 {
+	flushTiles();
+
 	if (texture)
 	{
 		#ifdef _DEBUG
@@ -444,7 +712,7 @@ void CVideoSoftware::draw2DImage(video::ITexture* texture, const core::position2
 		#endif
 
 		if (useAlphaChannelOfTexture)
-			((CSoftwareTexture*)texture)->getSurface()->copyToWithAlpha(BackBuffer, destPos, sourceRect, color.toA1R5G5B5(), clipRect);
+			((CSoftwareTexture*)texture)->getSurface()->copyToWithAlpha(BackBuffer, destPos, sourceRect, color, clipRect);
 		else
 			((CSoftwareTexture*)texture)->getSurface()->copyTo(BackBuffer, destPos, sourceRect, clipRect);
 	}
@@ -455,6 +723,8 @@ void CVideoSoftware::draw2DImage(video::ITexture* texture, const core::position2
 //! draw an 2d rectangle
 void CVideoSoftware::draw2DRectangle(Color color, const core::rectEx<s32>& pos, const core::rectEx<s32>* clip)
 {
+	flushTiles();
+
 	if (clip)
 	{
 		core::rectEx<s32> p(pos);
@@ -467,10 +737,600 @@ void CVideoSoftware::draw2DRectangle(Color color, const core::rectEx<s32>& pos,
 
 
 
+//! enables or disables the rasterizer statistics
+void CVideoSoftware::setRasterizerStatisticsEnabled(bool enabled)
+{
+	StatisticsEnabled = enabled;
+
+	for (s32 i=0; i<ETR_COUNT; ++i)
+	{
+		Statistics[i].reset();
+		TriangleRenderers[i]->setStatistics(enabled ? &Statistics[i] : 0);
+	}
+
+	if (TileRasterizer)
+		TileRasterizer->setStatistics(enabled ? Statistics : 0);
+}
+
+
+
+//! returns the amount of rasterizers the driver has statistics for
+s32 CVideoSoftware::getRasterizerCount()
+{
+	return ETR_COUNT;
+}
+
+
+
+//! returns the statistics of a rasterizer
+const SRasterizerStatistics* CVideoSoftware::getRasterizerStatistics(s32 index)
+{
+	if (!StatisticsEnabled || index < -1 || index >= ETR_COUNT)
+		return 0;
+
+	if (index != -1)
+		return &Statistics[index];
+
+	TotalStatistics.reset();
+	for (s32 i=0; i<ETR_COUNT; ++i)
+		TotalStatistics.add(Statistics[i]);
+
+	return &TotalStatistics;
+}
+
+
+
+//! creates a texture in the color format of the back buffer, so the
+//! triangle renderers and the 2d functions do not have to convert it.
+video::ITexture* CVideoSoftware::createDeviceDependentTexture(ISurface* surface, bool generateMipLevels)
+{
+	return new CSoftwareTexture(surface, BackBuffer->getColorFormat(), generateMipLevels, TiledTextures,
+		DitheredTextures, TileRasterizer ? TileRasterizer->getThreadPool() : 0);
+}
+
+
+
+//! enables or disables the overdraw heat map
+void CVideoSoftware::setOverdrawHeatMap(bool enabled)
+{
+	OverdrawHeatMap = enabled;
+
+	if (OverdrawHeatMap && !OverdrawSurface)
+	{
+		OverdrawSurface = video::createSurface(BackBuffer->getDimension());
+		OverdrawSurface->fill(0);
+	}
+
+	selectRightTriangleRenderer();
+}
+
+
+
+//! sets the amount of threads the 3d scene is rasterized with
+void CVideoSoftware::setRasterizerThreads(s32 threadCount)
+{
+	if (threadCount < 1)
+		threadCount = CThreadPool::getProcessorCount();
+
+	if (TileRasterizer)
+	{
+		if (TileRasterizer->getThreadCount() == threadCount)
+			return;
+
+		TileRasterizer->drop();
+		TileRasterizer = 0;
+	}
+
+	if (threadCount == 1)
+		return;
+
+	TileRasterizer = new CTileRasterizer(ZBuffer, threadCount);
+	TileRasterizer->setTargetSize(RenderTargetSize);
+	TileRasterizer->setStatistics(StatisticsEnabled ? Statistics : 0);
+	TileRasterizer->setPerspectiveCorrection(PerspectiveCorrection);
+}
+
+
+
+//! sets the format of the z buffer
+void CVideoSoftware::setZBufferFormat(E_ZBUFFER_FORMAT format)
+{
+	if (!ZBuffer || ZBuffer->getFormat() == format)
+		return;
+
+	// the renderers select their span kernels for the new format
+	// with the next draw call.
+	flushTiles();
+	ZBuffer->setFormat(format);
+}
+
+
+
+//! enables or disables perspective correct texture mapping
+void CVideoSoftware::setPerspectiveCorrection(bool enabled)
+{
+	PerspectiveCorrection = enabled;
+
+	for (s32 i=0; i<ETR_COUNT; ++i)
+		TriangleRenderers[i]->setPerspectiveCorrection(enabled);
+
+	if (TileRasterizer)
+		TileRasterizer->setPerspectiveCorrection(enabled);
+}
+
+
+
+//! enables or disables bilinear filtering
+void CVideoSoftware::setBilinearFilter(bool enabled)
+{
+	BilinearFilter = enabled;
+	selectRightTriangleRenderer();
+}
+
+
+
+//! selects if textures are stored in tiles
+void CVideoSoftware::setTiledTextures(bool enabled)
+{
+	TiledTextures = enabled;
+}
+
+
+
+//! selects if textures loaded from files are paletted
+void CVideoSoftware::setPalettedTextures(bool enabled)
+{
+	PalettedTextures = enabled;
+}
+
+
+
+//! selects if textures are dithered to 16 bit
+void CVideoSoftware::setDitheredTextures(bool enabled)
+{
+	DitheredTextures = enabled;
+}
+
+
+
+//! selects if lightmaps are precombined into the vertex colors
+void CVideoSoftware::setLightmapsPrecombined(bool precombined)
+{
+	LightmapsPrecombined = precombined;
+	selectRightTriangleRenderer();
+}
+
+
+
+//! replaces the colors of transformed vertices by the lightmap
+void CVideoSoftware::combineLightmap(S2DVertex* vertices, const u16* list, s32 count)
+{
+	if (!LightmapToVertices)
+		return;
+
+	for (s32 i=0; i<count; ++i)
+		combineLightmap(vertices[list[i]]);
+}
+
+
+
+//! replaces the color of a transformed vertex by the lightmap
+void CVideoSoftware::combineLightmap(S2DVertex& vertex)
+{
+	video::ISurface* lightmap = ((CSoftwareTexture*)Texture2)->getTexture();
+	const core::dimension2d<s32>& size = lightmap->getDimension();
+
+	Color light = lightmap->getPixel((vertex.TCoords2.X >> 8) & (size.Width-1),
+		(vertex.TCoords2.Y >> 8) & (size.Height-1));
+
+	// brightened 4 times like the lightmaps of the hardware drivers, but
+	// the vertex colors can only darken the texture.
+	s32 r = light.getRed() << 2;
+	s32 g = light.getGreen() << 2;
+	s32 b = light.getBlue() << 2;
+
+	vertex.Color = Color(255, r < 255 ? r : 255, g < 255 ? g : 255, b < 255 ? b : 255).color;
+}
+
+
+
+//! enables or disables occlusion culling
+void CVideoSoftware::setOcclusionCullingEnabled(bool enabled)
+{
+	OcclusionCulling = enabled;
+}
+
+
+
+//! removes all occluders
+void CVideoSoftware::clearOcclusionBuffer()
+{
+	if (OcclusionCulling)
+		OcclusionBuffer->clear(ViewPortSize);
+}
+
+
+
+//! draws triangles into the occlusion buffer
+void CVideoSoftware::drawOccluders(const S3DVertex* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount)
+{
+	if (!OcclusionCulling)
+		return;
+
+	SProfileScope zone(Profiler, "CVideoSoftware occluders");
+	setOcclusionTransform();
+	OcclusionBuffer->drawIndexedTriangleList(&vertices[0].Pos, sizeof(S3DVertex),
+		vertexCount, indexList, triangleCount);
+}
+
+
+
+//! draws triangles into the occlusion buffer
+void CVideoSoftware::drawOccluders(const S3DVertex2TCoords* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount)
+{
+	if (!OcclusionCulling)
+		return;
+
+	SProfileScope zone(Profiler, "CVideoSoftware occluders");
+	setOcclusionTransform();
+	OcclusionBuffer->drawIndexedTriangleList(&vertices[0].Pos, sizeof(S3DVertex2TCoords),
+		vertexCount, indexList, triangleCount);
+}
+
+
+
+//! returns if a box may be visible
+bool CVideoSoftware::isBoxVisible(const core::aabbox3d<f32>& box)
+{
+	if (!OcclusionCulling)
+		return true;
+
+	setOcclusionTransform();
+	return OcclusionBuffer->isBoxVisible(box);
+}
+
+
+
+//! sets the transformation of the occlusion buffer to the current states
+void CVideoSoftware::setOcclusionTransform()
+{
+	core::matrix4 transform = TransformationMatrix[TS_PROJECTION];
+	transform *= TransformationMatrix[TS_VIEW];
+	transform *= TransformationMatrix[TS_WORLD];
+
+	OcclusionBuffer->setTransform(transform);
+}
+
+
+
+//! draws transformed triangles with the current renderer, or records them for the tiles
+void CVideoSoftware::drawTransformedTriangleList(S2DVertex* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount)
+{
+	if (TileRasterizer)
+	{
+		SProfileScope zone(Profiler, "CVideoSoftware bin");
+
+		video::ISurface* texture = 0;
+		video::ISurface* const* mipMaps = 0;
+		s32 mipMapCount = 0;
+		bool tiled = false;
+		if (Texture)
+		{
+			texture = ((CSoftwareTexture*)Texture)->getRendererTexture();
+			mipMaps = ((CSoftwareTexture*)Texture)->getMipMaps();
+			mipMapCount = ((CSoftwareTexture*)Texture)->getMipMapCount();
+			tiled = ((CSoftwareTexture*)Texture)->isTiled();
+		}
+
+		video::ISurface* texture2 = 0;
+		if (Texture2)
+			texture2 = ((CSoftwareTexture*)Texture2)->getTexture();
+
+		TileRasterizer->drawIndexedTriangleList(CurrentRenderer, getTriangleRenderTarget(),
+			ViewPort, texture, texture2, mipMaps, mipMapCount, tiled, Material.BackfaceCulling == true,
+			vertexCount, indexList, triangleCount);
+		return;
+	}
+
+	SProfileScope zone(Profiler, "CVideoSoftware rasterize");
+	CurrentTriangleRenderer->drawIndexedTriangleList(vertices, vertexCount, indexList, triangleCount);
+}
+
+
+
+//! fills the parameters of the vertex transform with the current states
+void CVideoSoftware::getTransformParameters(STransformParameters& parameters)
+{
+	parameters.Matrix = TransformationMatrix[TS_PROJECTION];
+	parameters.Matrix *= TransformationMatrix[TS_VIEW];
+	parameters.Matrix *= TransformationMatrix[TS_WORLD];
+
+	parameters.ViewTransformWidth = ViewPortSize.Width>>1;
+	parameters.ViewTransformHeight = ViewPortSize.Height>>1;
+	parameters.TranslationX = Render2DTranslation.X;
+	parameters.TranslationY = Render2DTranslation.Y;
+
+	core::dimension2d<s32> textureSize(0,0);
+
+	if (Texture)
+		textureSize = ((CSoftwareTexture*)Texture)->getTexture()->getDimension();
+
+	parameters.TextureWidth = textureSize.Width;
+	parameters.TextureHeight = textureSize.Height;
+
+	core::dimension2d<s32> texture2Size(0,0);
+
+	if (Texture2)
+		texture2Size = ((CSoftwareTexture*)Texture2)->getTexture()->getDimension();
+
+	parameters.Texture2Width = texture2Size.Width;
+	parameters.Texture2Height = texture2Size.Height;
+
+	// the z values are 1/w, scaled so a vertex at the near plane of a
+	// perspective projection gets the largest value of the zbuffer.
+	const core::matrix4& projection = TransformationMatrix[TS_PROJECTION];
+	f32 nearPlane = 1.0f;
+
+	if (projection(3,3) == 0.0f && projection(2,2) != 0.0f)
+		nearPlane = (f32)fabs(projection(2,3) / projection(2,2));
+
+	parameters.ZScale = ZBuffer->getMaxValue() * nearPlane;
+}
+
+
+
+//! collects the vertices referenced by an index list into TransformList
+s32 CVideoSoftware::collectReferencedVertices(const u16* indexList, s32 indexCount, s32 vertexCount)
+{
+	// the vertices are tagged with the generation of the draw call, so every
+	// vertex is in the list only once, and vertices not referenced are not in it.
+
+	if ((s32)TransformTags.size() < vertexCount)
+	{
+		s32 oldSize = TransformTags.size();
+		TransformTags.set_used(vertexCount);
+
+		for (s32 i=oldSize; i<vertexCount; ++i)
+			TransformTags[i] = 0;
+	}
+
+	++TransformGeneration;
+
+	if (!TransformGeneration)
+	{
+		// the counter wrapped around, so old tags could look current.
+		for (u32 i=0; i<TransformTags.size(); ++i)
+			TransformTags[i] = 0;
+
+		TransformGeneration = 1;
+	}
+
+	if ((s32)TransformList.size() < vertexCount)
+	{
+		TransformList.set_used(vertexCount);
+		ClipCodes.set_used(vertexCount);
+	}
+
+	u32* tags = TransformTags.pointer();
+	u16* list = TransformList.pointer();
+	s32 count = 0;
+
+	for (s32 i=0; i<indexCount; ++i)
+	{
+		const u16 index = indexList[i];
+
+		if (tags[index] != TransformGeneration)
+		{
+			tags[index] = TransformGeneration;
+			list[count++] = index;
+		}
+	}
+
+	return count;
+}
+
+
+
+//! returns if a vertex of the transformed list is outside of a clip plane
+bool CVideoSoftware::isClippingNeeded(s32 count)
+{
+	const u8* codes = ClipCodes.pointer();
+	const u16* list = TransformList.pointer();
+	u32 allCodes = 0;
+
+	for (s32 i=0; i<count; ++i)
+		allCodes |= codes[list[i]];
+
+	return allCodes != 0;
+}
+
+
+
+//! clips the triangles crossing the near plane or the guard band and draws all triangles
+void CVideoSoftware::drawClippedTriangleList(const void* vertices, TGetClipVertex getClipVertex,
+	const STransformParameters& parameters, S2DVertex* transformed, s32 vertexCount,
+	const u16* indexList, s32 triangleCount)
+{
+	// The triangles which need no clipping are drawn first, the clipped ones
+	// after them with their own vertices. Triangles completely outside of a
+	// plane are rejected here, the renderers never see them.
+
+	SRasterizerStatistics stats;
+	const u8* codes = ClipCodes.pointer();
+
+	UnclippedIndices.set_used(0);
+	ClippedTriangles.set_used(0);
+
+	for (s32 i=0; i<triangleCount*3; i+=3)
+	{
+		u32 c1 = codes[indexList[i]];
+		u32 c2 = codes[indexList[i+1]];
+		u32 c3 = codes[indexList[i+2]];
+
+		if (!(c1 | c2 | c3))
+		{
+			UnclippedIndices.push_back(indexList[i]);
+			UnclippedIndices.push_back(indexList[i+1]);
+			UnclippedIndices.push_back(indexList[i+2]);
+		}
+		else
+		if (c1 & c2 & c3)
+		{
+			++stats.Triangles;
+
+			if (c1 & c2 & c3 & ECC_NEAR)
+				++stats.NearPlaneCulled;
+			else
+				++stats.ViewPortCulled;
+		}
+		else
+			ClippedTriangles.push_back(i);
+	}
+
+	drawTransformedTriangleList(transformed, vertexCount,
+		UnclippedIndices.pointer(), UnclippedIndices.size() / 3);
+
+	// clip the others into polygons and draw them as triangle fans
+
+	{
+		SProfileScope zone(Profiler, "CVideoSoftware clip");
+
+		SClipVertex polygon[MAX_CLIPPED_VERTICES];
+
+		for (u32 t=0; t<ClippedTriangles.size(); ++t)
+		{
+			const u16* triangle = indexList + ClippedTriangles[t];
+
+			for (s32 k=0; k<3; ++k)
+				getClipVertex(vertices, triangle[k], parameters.Matrix, polygon[k]);
+
+			s32 count = clipPolygon(polygon, 3,
+				codes[triangle[0]] | codes[triangle[1]] | codes[triangle[2]]);
+
+			++stats.Clipped;
+
+			if (count < 3)
+				continue;
+
+			// the indices have 16 bit
+			if (ClippedVertices.size() + count > 65536)
+				drawClippedTriangles();
+
+			s32 first = ClippedVertices.size();
+			ClippedVertices.set_used(first + count);
+
+			for (s32 i=0; i<count; ++i)
+			{
+				projectVertex(parameters, polygon[i], ClippedVertices[first + i]);
+
+				if (LightmapToVertices)
+					combineLightmap(ClippedVertices[first + i]);
+			}
+
+			for (s32 i=2; i<count; ++i)
+			{
+				ClippedIndices.push_back(first);
+				ClippedIndices.push_back(first + i - 1);
+				ClippedIndices.push_back(first + i);
+			}
+		}
+	}
+
+	drawClippedTriangles();
+
+	if (StatisticsEnabled)
+		Statistics[CurrentRenderer].add(stats);
+}
+
+
+
+//! draws the triangles in ClippedVertices and ClippedIndices and empties them
+void CVideoSoftware::drawClippedTriangles()
+{
+	s32 vertexCount = ClippedVertices.size();
+
+	if (!vertexCount)
+		return;
+
+	S2DVertex* vertices = ClippedVertices.pointer();
+
+	if (TileRasterizer)
+	{
+		vertices = TileRasterizer->allocateVertices(vertexCount);
+
+		for (s32 i=0; i<vertexCount; ++i)
+			vertices[i] = ClippedVertices[i];
+	}
+
+	drawTransformedTriangleList(vertices, vertexCount,
+		ClippedIndices.pointer(), ClippedIndices.size() / 3);
+
+	ClippedVertices.set_used(0);
+	ClippedIndices.set_used(0);
+}
+
+
+
+//! draws the triangles recorded for the tiles
+void CVideoSoftware::flushTiles()
+{
+	if (!TileRasterizer)
+		return;
+
+	SProfileScope zone(Profiler, "CVideoSoftware rasterize tiles");
+	TileRasterizer->flush();
+}
+
+
+
+//! converts the write counts of the overdraw surface into colors in the back buffer
+void CVideoSoftware::resolveOverdrawHeatMap()
+{
+	static const s16 heatColors[] =
+	{
+		video::RGB16(0, 0, 0),
+		video::RGB16(0, 0, 255),
+		video::RGB16(0, 160, 255),
+		video::RGB16(0, 255, 0),
+		video::RGB16(255, 255, 0),
+		video::RGB16(255, 160, 0),
+		video::RGB16(255, 0, 0),
+		video::RGB16(255, 0, 255),
+		video::RGB16(255, 255, 255)
+	};
+
+	const s32 maxCount = sizeof(heatColors) / sizeof(s16) - 1;
+
+	const core::dimension2d<s32>& size = BackBuffer->getDimension();
+	s32 pixelCount = size.Width * size.Height;
+
+	s16* count = (s16*)OverdrawSurface->lock();
+
+	if (BackBuffer->getColorFormat() == EHCF_A8R8G8B8)
+	{
+		s32* target = (s32*)BackBuffer->lock();
+
+		for (s32 i=0; i<pixelCount; ++i)
+			target[i] = video::A1R5G5B5toA8R8G8B8(heatColors[count[i] < maxCount ? count[i] : maxCount]);
+	}
+	else
+	{
+		s16* target = (s16*)BackBuffer->lock();
+
+		for (s32 i=0; i<pixelCount; ++i)
+			target[i] = heatColors[count[i] < maxCount ? count[i] : maxCount];
+	}
+
+	BackBuffer->unlock();
+	OverdrawSurface->unlock();
+}
+
+
+
 //! creates a video driver
-IVideoDriver* createSoftwareDriver(const core::dimension2d<s32>& windowSize, bool fullscreen, io::IFileSystem* io, video::ISurfacePresenter* presenter)
+IVideoDriver* createSoftwareDriver(const core::dimension2d<s32>& windowSize, ECOLOR_FORMAT format, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler, video::ISurfacePresenter* presenter)
 {
-	return new CVideoSoftware(windowSize, fullscreen, io, presenter);
+	return new CVideoSoftware(windowSize, format, fullscreen, io, timer, profiler, presenter);
 }
 
 
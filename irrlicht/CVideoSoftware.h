@@ -6,6 +6,9 @@
 #define __C_K_VIDEO_SOFTWARE_H_INCLUDED__
 
 #include "IK3DTriangleRenderer.h"
+#include "CTileRasterizer.h"
+#include "CVertexTransform.h"
+#include "COcclusionBuffer.h"
 #include "CVideoNull.h"
 
 namespace irr
@@ -17,7 +20,7 @@ namespace video
 	public:
 
 		//! constructor
-		CVideoSoftware(const core::dimension2d<s32>& windowSize, bool fullscreen, io::IFileSystem* io, video::ISurfacePresenter* presenter);
+		CVideoSoftware(const core::dimension2d<s32>& windowSize, ECOLOR_FORMAT format, bool fullscreen, io::IFileSystem* io, ITimer* timer, IProfiler* profiler, video::ISurfacePresenter* presenter);
 
 		//! destructor
 		virtual ~CVideoSoftware();
@@ -58,6 +61,57 @@ namespace video
 		//! draw an 2d rectangle
 		virtual void draw2DRectangle(Color color, const core::rectEx<s32>& pos, const core::rectEx<s32>* clip = 0);
 
+		//! enables or disables the rasterizer statistics
+		virtual void setRasterizerStatisticsEnabled(bool enabled);
+
+		//! returns the amount of rasterizers the driver has statistics for
+		virtual s32 getRasterizerCount();
+
+		//! returns the statistics of a rasterizer
+		virtual const SRasterizerStatistics* getRasterizerStatistics(s32 index = -1);
+
+		//! enables or disables the overdraw heat map
+		virtual void setOverdrawHeatMap(bool enabled);
+
+		//! sets the amount of threads the 3d scene is rasterized with
+		virtual void setRasterizerThreads(s32 threadCount);
+
+		//! sets the format of the z buffer
+		virtual void setZBufferFormat(E_ZBUFFER_FORMAT format);
+
+		//! enables or disables perspective correct texture mapping
+		virtual void setPerspectiveCorrection(bool enabled);
+
+		//! enables or disables bilinear filtering
+		virtual void setBilinearFilter(bool enabled);
+
+		//! selects if textures are stored in tiles
+		virtual void setTiledTextures(bool enabled);
+
+		//! selects if textures loaded from files are paletted
+		virtual void setPalettedTextures(bool enabled);
+
+		//! selects if textures are dithered to 16 bit
+		virtual void setDitheredTextures(bool enabled);
+
+		//! selects if lightmaps are precombined into the vertex colors
+		virtual void setLightmapsPrecombined(bool precombined);
+
+		//! enables or disables occlusion culling
+		virtual void setOcclusionCullingEnabled(bool enabled);
+
+		//! removes all occluders
+		virtual void clearOcclusionBuffer();
+
+		//! draws triangles into the occlusion buffer
+		virtual void drawOccluders(const S3DVertex* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount);
+
+		//! draws triangles into the occlusion buffer
+		virtual void drawOccluders(const S3DVertex2TCoords* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount);
+
+		//! returns if a box may be visible
+		virtual bool isBoxVisible(const core::aabbox3d<f32>& box);
+
 	protected:
 
 		//! sets a render target
@@ -66,6 +120,19 @@ namespace video
 		//! sets the current Texture
 		void setTexture(video::ITexture* texture);
 
+		//! sets the current lightmap, 0 if the material has none
+		void setTexture2(video::ITexture* texture);
+
+		//! replaces the colors of transformed vertices by the lightmap at
+		//! their lightmap coordinates, if the lightmap is precombined.
+		void combineLightmap(S2DVertex* vertices, const u16* list, s32 count);
+
+		//! replaces the color of a transformed vertex by the lightmap
+		void combineLightmap(S2DVertex& vertex);
+
+		//! returns a device dependent texture from a software surface (ISurface)
+		virtual video::ITexture* createDeviceDependentTexture(ISurface* surface, bool generateMipLevels);
+
 		video::ISurface* BackBuffer;
 		video::ISurfacePresenter* Presenter;
 
@@ -75,7 +142,54 @@ namespace video
 		//! void selects the right triangle renderer based on the render states.
 		void selectRightTriangleRenderer();
 
+		//! returns the surface the current triangle renderer draws into
+		video::ISurface* getTriangleRenderTarget();
+
+		//! converts the write counts of the overdraw surface into colors in the back buffer
+		void resolveOverdrawHeatMap();
+
+		//! draws transformed triangles with the current renderer, or records them for the tiles
+		void drawTransformedTriangleList(S2DVertex* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount);
+
+		//! draws the triangles recorded for the tiles
+		void flushTiles();
+
+		//! fills the parameters of the vertex transform with the current states
+		void getTransformParameters(STransformParameters& parameters);
+
+		//! sets the transformation of the occlusion buffer to the current states
+		void setOcclusionTransform();
+
+		//! collects the vertices referenced by an index list into TransformList
+		//! \return Returns the amount of vertices in the list.
+		s32 collectReferencedVertices(const u16* indexList, s32 indexCount, s32 vertexCount);
+
+		//! returns if a vertex of the transformed list is outside of a clip plane
+		bool isClippingNeeded(s32 count);
+
+		//! transforms a vertex of a vertex array into clip space
+		typedef void (*TGetClipVertex)(const void* vertices, s32 index,
+			const core::matrix4& matrix, SClipVertex& out);
+
+		//! clips the triangles crossing the near plane or the guard band and draws all triangles
+		void drawClippedTriangleList(const void* vertices, TGetClipVertex getClipVertex,
+			const STransformParameters& parameters, S2DVertex* transformed, s32 vertexCount,
+			const u16* indexList, s32 triangleCount);
+
+		//! draws the triangles in ClippedVertices and ClippedIndices and empties them
+		void drawClippedTriangles();
+
 		core::array<S2DVertex> TransformedPoints;
+		core::array<u32> TransformTags;		// generation in which a vertex was transformed
+		u32 TransformGeneration;
+		core::array<u16> TransformList;		// vertices of the current draw call
+		TTransformBlock TransformKernel;
+
+		core::array<u8> ClipCodes;				// E_CLIP_CODE flags of the transformed vertices
+		core::array<u16> UnclippedIndices;		// triangles of the draw call which need no clipping
+		core::array<s32> ClippedTriangles;		// first index of the triangles which need clipping
+		core::array<S2DVertex> ClippedVertices;
+		core::array<u16> ClippedIndices;
 
 		video::ITexture* RenderTargetTexture;	
 		video::ISurface* RenderTargetSurface;	
@@ -92,8 +206,29 @@ namespace video
 		IZBuffer* ZBuffer;
 
 		video::ITexture* Texture;
+		video::ITexture* Texture2;			// lightmap of EMT_LIGHTMAP materials
+		bool LightmapsPrecombined;
+		bool LightmapToVertices;			// the current renderer needs the lightmap in the vertex colors
 		
 		SMaterial Material;
+
+		SRasterizerStatistics Statistics[ETR_COUNT];
+		core::stringc RendererNames[ETR_COUNT];	// names of the statistics
+		SRasterizerStatistics TotalStatistics;
+		bool StatisticsEnabled;
+
+		bool OverdrawHeatMap;
+		video::ISurface* OverdrawSurface;	// counts the writes per pixel
+
+		CTileRasterizer* TileRasterizer;	// 0 if not rasterizing with threads
+
+		bool PerspectiveCorrection;
+		bool BilinearFilter;
+		bool TiledTextures;
+		bool DitheredTextures;
+
+		COcclusionBuffer* OcclusionBuffer;
+		bool OcclusionCulling;
 	};
 
 } // end namespace video
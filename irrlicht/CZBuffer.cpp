@@ -3,23 +3,39 @@
 // For conditions of distribution and use, see copyright notice in Irrlicht.h
 
 #include "CZBuffer.h"
+#include <memory.h>
 
 namespace irr
 {
 namespace video
 {
 
+//! returns the smallest value of a rectangle of z values
+template <class Z>
+static inline s32 getMinZ(const Z* z, s32 pitch, s32 width, s32 height)
+{
+	Z minZ = *z;
+
+	for (s32 y=0; y<height; ++y, z += pitch)
+		for (s32 x=0; x<width; ++x)
+			if (z[x] < minZ)
+				minZ = z[x];
+
+	return minZ;
+}
+
 
 
 //! constructor
-CZBuffer::CZBuffer(const core::dimension2d<s32>& size)
-: Buffer(0), Size(0,0), TotalSize(0), BufferEnd(0)
+CZBuffer::CZBuffer(const core::dimension2d<s32>& size, E_ZBUFFER_FORMAT format)
+: Buffer(0), Blocks(0), BlockCountX(0), BlockCountY(0), Size(size),
+	Format(format), Pitch(0), TotalSize(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CZBuffer");
 	#endif
 
-	setSize(size);
+	reallocate();
 }
 
 
@@ -29,6 +45,9 @@ CZBuffer::~CZBuffer()
 {
 	if (Buffer)
 		delete [] Buffer;
+
+	if (Blocks)
+		delete [] Blocks;
 }
 
 
@@ -36,11 +55,42 @@ CZBuffer::~CZBuffer()
 //! clears the zbuffer
 void CZBuffer::clear()
 {
-	TZBufferType* p = Buffer;
-	while(p != BufferEnd)
+	// zero is the farthest value of all formats, so a memset does it.
+	memset(Buffer, 0, TotalSize);
+	memset(Blocks, 0, BlockCountX * BlockCountY * sizeof(SZBufferBlock));
+}
+
+
+
+//! clears a rectangle of the zbuffer
+void CZBuffer::clear(const core::rectEx<s32>& rect)
+{
+	core::rectEx<s32> r(rect);
+	r.clipAgainst(core::rectEx<s32>(0, 0, Size.Width, Size.Height));
+
+	s32 width = r.getWidth() * getBytesPerValue();
+	if (width <= 0 || r.getHeight() <= 0)
+		return;
+
+	// zero is not larger than any z value, so it is right for blocks 
+	// partly outside of the rectangle too.
+	s32 blockX1 = r.UpperLeftCorner.X >> ZBUFFER_BLOCK_SHIFT;
+	s32 blockX2 = (r.LowerRightCorner.X - 1) >> ZBUFFER_BLOCK_SHIFT;
+	s32 blockY2 = (r.LowerRightCorner.Y - 1) >> ZBUFFER_BLOCK_SHIFT;
+
+	for (s32 y=r.UpperLeftCorner.Y >> ZBUFFER_BLOCK_SHIFT; y<=blockY2; ++y)
+		memset(Blocks + y * BlockCountX + blockX1, 0, (blockX2 - blockX1 + 1) * sizeof(SZBufferBlock));
+
+	if (width == Pitch)
 	{
-		*p = 0; ++p;
+		memset(Buffer + r.UpperLeftCorner.Y * Pitch, 0, width * r.getHeight());
+		return;
 	}
+
+	c8* p = Buffer + r.UpperLeftCorner.Y * Pitch + r.UpperLeftCorner.X * getBytesPerValue();
+
+	for (s32 y=r.UpperLeftCorner.Y; y<r.LowerRightCorner.Y; ++y, p += Pitch)
+		memset(p, 0, width);
 }
 
 
@@ -52,13 +102,7 @@ void CZBuffer::setSize(const core::dimension2d<s32>& size)
 		return;
 
 	Size = size;
-
-	if (Buffer)
-		delete [] Buffer;
-
-	TotalSize = size.Width * size.Height;
-	Buffer = new TZBufferType[TotalSize];
-	BufferEnd = Buffer + TotalSize;
+	reallocate();
 }
 
 
@@ -71,8 +115,46 @@ const core::dimension2d<s32>& CZBuffer::getSize()
 
 
 
+//! sets the format of the z values
+void CZBuffer::setFormat(E_ZBUFFER_FORMAT format)
+{
+	if (format == Format)
+		return;
+
+	Format = format;
+	reallocate();
+}
+
+
+
+//! returns the format of the z values
+E_ZBUFFER_FORMAT CZBuffer::getFormat()
+{
+	return Format;
+}
+
+
+
+//! returns the size of a z value in bytes
+s32 CZBuffer::getBytesPerValue()
+{
+	return Format == EZF_32BIT ? sizeof(s32) : sizeof(s16);
+}
+
+
+
+//! returns the z value of a vertex at the near plane
+s32 CZBuffer::getMaxValue()
+{
+	// 32 bit values keep one bit of headroom, so the interpolation
+	// in the renderers never overflows.
+	return Format == EZF_32BIT ? 0x40000000 : 0x7fff;
+}
+
+
+
 //! locks the zbuffer
-TZBufferType* CZBuffer::lock()
+void* CZBuffer::lock()
 {
 	return Buffer;
 }
@@ -86,10 +168,70 @@ void CZBuffer::unlock()
 
 
 
+//! returns the blocks of the hierarchical z buffer
+SZBufferBlock* CZBuffer::lockBlocks()
+{
+	return Blocks;
+}
+
+
+
+//! returns the amount of blocks in a row
+s32 CZBuffer::getBlockCountX()
+{
+	return BlockCountX;
+}
+
+
+
+//! calculates MinZ of a block from its z values
+void CZBuffer::updateBlock(s32 x, s32 y)
+{
+	s32 size = 1 << ZBUFFER_BLOCK_SHIFT;
+	s32 left = x << ZBUFFER_BLOCK_SHIFT;
+	s32 top = y << ZBUFFER_BLOCK_SHIFT;
+	s32 width = Size.Width - left < size ? Size.Width - left : size;
+	s32 height = Size.Height - top < size ? Size.Height - top : size;
+
+	SZBufferBlock& block = Blocks[y * BlockCountX + x];
+
+	if (Format == EZF_32BIT)
+		block.MinZ = getMinZ((s32*)Buffer + top * Size.Width + left, Size.Width, width, height);
+	else
+		block.MinZ = getMinZ((s16*)Buffer + top * Size.Width + left, Size.Width, width, height);
+
+	block.Dirty = false;
+}
+
+
+
+//! allocates the buffer for the size and format
+void CZBuffer::reallocate()
+{
+	if (Buffer)
+		delete [] Buffer;
+
+	if (Blocks)
+		delete [] Blocks;
+
+	Pitch = Size.Width * getBytesPerValue();
+	TotalSize = Pitch * Size.Height;
+	Buffer = new c8[TotalSize];
+
+	s32 size = 1 << ZBUFFER_BLOCK_SHIFT;
+	BlockCountX = (Size.Width + size - 1) >> ZBUFFER_BLOCK_SHIFT;
+	BlockCountY = (Size.Height + size - 1) >> ZBUFFER_BLOCK_SHIFT;
+	Blocks = new SZBufferBlock[BlockCountX * BlockCountY];
+
+	clear();
+}
+
+
+
 //! creates a ZBuffer
-IZBuffer* createZBuffer(const core::dimension2d<s32>& size)
+IZBuffer* createZBuffer(const core::dimension2d<s32>& size, E_ZBUFFER_FORMAT format)
 {
-	return new CZBuffer(size);
+	return new CZBuffer(size, format);
 }
 
 	
@@ -17,7 +17,7 @@ namespace video
 	public:
 
 		//! constructor
-		CZBuffer(const core::dimension2d<s32>& size);
+		CZBuffer(const core::dimension2d<s32>& size, E_ZBUFFER_FORMAT format);
 
 		//! destructor
 		virtual ~CZBuffer();
@@ -25,23 +25,53 @@ namespace video
 		//! clears the zbuffer
 		virtual void clear();
 
+		//! clears a rectangle of the zbuffer
+		virtual void clear(const core::rectEx<s32>& rect);
+
 		//! sets the new size of the zbuffer
 		virtual void setSize(const core::dimension2d<s32>& size);
 
 		//! returns the size of the zbuffer
 		virtual const core::dimension2d<s32>& getSize();
 
+		//! sets the format of the z values
+		virtual void setFormat(E_ZBUFFER_FORMAT format);
+
+		//! returns the format of the z values
+		virtual E_ZBUFFER_FORMAT getFormat();
+
+		//! returns the size of a z value in bytes
+		virtual s32 getBytesPerValue();
+
+		//! returns the z value of a vertex at the near plane
+		virtual s32 getMaxValue();
+
 		//! locks the zbuffer
-		virtual TZBufferType* lock();
+		virtual void* lock();
 
 		//! unlocks the zbuffer
 		virtual void unlock();
 
+		//! returns the blocks of the hierarchical z buffer
+		virtual SZBufferBlock* lockBlocks();
+
+		//! returns the amount of blocks in a row
+		virtual s32 getBlockCountX();
+
+		//! calculates MinZ of a block from its z values
+		virtual void updateBlock(s32 x, s32 y);
+
 	private:
 
-		TZBufferType* Buffer;
-		TZBufferType* BufferEnd;
+		//! allocates the buffer for the size and format
+		void reallocate();
+
+		c8* Buffer;
+		SZBufferBlock* Blocks;
+		s32 BlockCountX, BlockCountY;
 		core::dimension2d<s32> Size;
+		E_ZBUFFER_FORMAT Format;
+		s32 Pitch;
 		s32 TotalSize;
 	};
 	
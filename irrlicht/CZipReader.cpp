@@ -5,7 +5,7 @@
 #include <string.h>
 #include "CZipReader.h"
 #include "os.h"
-#include "zlib\zlib.h"
+#include "zlib/zlib.h"
 
 
 namespace irr
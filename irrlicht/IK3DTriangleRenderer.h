@@ -11,22 +11,29 @@
 #include "rect.h"
 #include "IZBuffer.h"
 #include "ISurface.h"
+#include "SRasterizerStatistics.h"
+#include "CTRSpanKernels.h"
+#include "irrstring.h"
 
 namespace irr
 {
 namespace video
 {
 
+	//! the triangle renderers. The renderers of filled triangles are numbered
+	//! by the E_SPAN_FEATURE flags they draw with, so every combination of
+	//! flags has its own renderer.
 	enum ETriangleRenderer
 	{
 		ETR_FLAT = 0,
-		ETR_FLAT_WIRE,
-		ETR_GOURAUD,
+		ETR_GOURAUD = ESF_GOURAUD,
+		ETR_TEXTURE_FLAT = ESF_TEXTURE,
+		ETR_TEXTURE_GOURAUD = ESF_TEXTURE | ESF_GOURAUD,
+		ETR_FLAT_WIRE = ESF_COUNT,
 		ETR_GOURAUD_WIRE,
-		ETR_TEXTURE_FLAT,
 		ETR_TEXTURE_FLAT_WIRE,
-		ETR_TEXTURE_GOURAUD,
 		ETR_TEXTURE_GOURAUD_WIRE,
+		ETR_OVERDRAW,
 		ETR_COUNT
 	};
 
@@ -46,19 +53,44 @@ namespace video
 		//! sets the Texture
 		virtual void setTexture(video::ISurface* texture) = 0;
 
+		//! sets the lightmap. Only used by the renderers drawing with
+		//! ESF_LIGHTMAP.
+		virtual void setTexture2(video::ISurface* texture) = 0;
+
+		//! sets the mip maps of the texture, from the one of half its size
+		//! down to 1x1. The renderers of filled textured triangles draw
+		//! every triangle with the level which has about one texel per
+		//! pixel. The surfaces are not grabbed, they belong to the texture.
+		//! \param count: Amount of mip maps, 0 draws only the texture.
+		virtual void setMipMaps(video::ISurface* const* mipMaps, s32 count) = 0;
+
+		//! sets if the texture and its mip maps are stored in tiles of 4x4
+		//! texels, see CSoftwareTexture::isTiled()
+		virtual void setTextureTiled(bool tiled) = 0;
+
+		//! sets the statistics the renderer adds its counters to, 0 disables counting
+		virtual void setStatistics(SRasterizerStatistics* statistics) = 0;
+
+		//! en or disables perspective correct texture coordinates. Only used
+		//! by the renderers drawing filled textured triangles.
+		virtual void setPerspectiveCorrection(bool enabled) = 0;
+
 		//! draws an indexed triangle list
 		virtual void drawIndexedTriangleList(S2DVertex* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount) = 0;
 	};
 
 
-	IK3DTriangleRenderer* createTriangleRendererTextureGouraud(IZBuffer* zbuffer);
+	//! creates a triangle renderer
+	IK3DTriangleRenderer* createTriangleRenderer(ETriangleRenderer renderer, IZBuffer* zbuffer);
+
+	//! returns the name of a triangle renderer, like "texture gouraud"
+	core::stringc getTriangleRendererName(ETriangleRenderer renderer);
+
 	IK3DTriangleRenderer* createTriangleRendererTextureGouraudWire(IZBuffer* zbuffer);
-	IK3DTriangleRenderer* createTriangleRendererGouraud(IZBuffer* zbuffer);
 	IK3DTriangleRenderer* createTriangleRendererGouraudWire(IZBuffer* zbuffer);
-	IK3DTriangleRenderer* createTriangleRendererTextureFlat(IZBuffer* zbuffer);
 	IK3DTriangleRenderer* createTriangleRendererTextureFlatWire(IZBuffer* zbuffer);
-	IK3DTriangleRenderer* createTriangleRendererFlat(IZBuffer* zbuffer);
 	IK3DTriangleRenderer* createTriangleRendererFlatWire(IZBuffer* zbuffer);
+	IK3DTriangleRenderer* createTriangleRendererOverdraw(IZBuffer* zbuffer);
 
 
 } // end namespace video
@@ -8,15 +8,33 @@
 #include "IUnknown.h"
 #include "position2d.h"
 #include "rect.h"
-#include "color.h"
+#include "Color.h"
+#include "ITexture.h"
 
 namespace irr
 {
 namespace video  
 {
 
+//! Filters for scaling surfaces. Surfaces with a palette are always scaled
+//! with ESSF_NEAREST, their indices can not be mixed.
+enum ESURFACE_SCALE_FILTER
+{
+	//! every pixel gets the color of the pixel nearest to it
+	ESSF_NEAREST = 0,
+
+	//! every pixel gets the average of the pixels it covers. The best
+	//! filter for making surfaces smaller, like ESSF_NEAREST if they grow.
+	ESSF_BOX,
+
+	//! every pixel gets a mix of the 4 pixels nearest to its center. The
+	//! best filter for making surfaces larger.
+	ESSF_BILINEAR
+};
+
 /*!
-	interface for 16 bit A1R5G5B5 surface.
+	interface for a 16 bit A1R5G5B5 or a 32 bit A8R8G8B8 surface, or an
+	8 bit EHCF_P8 surface with indices into a palette of one of them.
 */
 class ISurface : public IUnknown
 {
@@ -25,8 +43,8 @@ public:
 	//! destructor
 	virtual ~ISurface() {};
 
-	//! lock function
-	virtual s16* lock() = 0;
+	//! lock function, returns the pixels in the format of getColorFormat()
+	virtual void* lock() = 0;
 
 	//! unlock function
 	virtual void unlock() = 0;
@@ -34,26 +52,39 @@ public:
 	//! returns dimension
 	virtual const core::dimension2d<s32>& getDimension() = 0;
 
+	//! returns the color format, EHCF_R5G5B5, EHCF_A8R8G8B8 or EHCF_P8
+	virtual ECOLOR_FORMAT getColorFormat() = 0;
+
+	//! returns the palette of an EHCF_P8 surface, a surface of 256x1
+	//! pixels with the colors of the indices. Returns 0 for other formats.
+	virtual ISurface* getPalette() = 0;
+
+	//! returns the size of a pixel in bytes
+	virtual s32 getBytesPerPixel() = 0;
+
+	//! returns the size of a row in bytes
+	virtual s32 getPitch() = 0;
+
 	//! sets a pixel
-	virtual void setPixel(s32 x, s32 y, s16 color) = 0;
+	virtual void setPixel(s32 x, s32 y, Color color) = 0;
 
 	//! gets a pixel
-	virtual s16 getPixel(s32 x, s32 y) = 0;
+	virtual Color getPixel(s32 x, s32 y) = 0;
 
 	//! returns masks for pixels
-	virtual s16 getRedMask() = 0;
+	virtual s32 getRedMask() = 0;
 
 	//! returns masks for pixels
-	virtual s16 getGreenMask() = 0;
+	virtual s32 getGreenMask() = 0;
 
 	//! returns masks for pixels
-	virtual s16 getBlueMask() = 0;
+	virtual s32 getBlueMask() = 0;
 
 	//! returns alpha mask
-	virtual s16 getAlphaMask() = 0;
+	virtual s32 getAlphaMask() = 0;
 
 	//! fillst the surface with black or white
-	virtual void fill(s16 color) = 0;
+	virtual void fill(Color color) = 0;
 
 	//! draws a rectangle
 	virtual void drawRectangle(const core::rectEx<s32>& rect, Color color) = 0;
@@ -61,7 +92,10 @@ public:
 	//! draws a rectangle
 	virtual void drawRectangle(s32 x, s32 y, s32 x2, s32 y2, Color color) = 0;
 
-	//! copies this surface into another
+	//! copies this surface into another. If the surfaces have different
+	//! color formats, the pixels are converted. Pixels copied into an
+	//! EHCF_P8 surface get the nearest color of its palette, indices
+	//! copied from one are expected to have the same palette.
 	virtual void copyTo(ISurface* target, s32 x, s32 y) = 0;
 
 	//! copies this surface into another
@@ -74,22 +108,30 @@ public:
 	virtual void copyToWithAlpha(ISurface* target, const core::position2d<s32>& pos, const core::rectEx<s32>& sourceRect) = 0;
 
 	//! copies this surface into another, using the alpha mask, an cliprect and a color to add with
-	virtual void copyToWithAlpha(ISurface* target, const core::position2d<s32>& pos, const core::rectEx<s32>& sourceRect, s16 color, const core::rectEx<s32>* clipRect = 0) = 0;
+	virtual void copyToWithAlpha(ISurface* target, const core::position2d<s32>& pos, const core::rectEx<s32>& sourceRect, Color color, const core::rectEx<s32>* clipRect = 0) = 0;
 
 	//! copies this surface into another, scaling it to fit it.
-	virtual void copyToScaling(ISurface* target) = 0;
+	virtual void copyToScaling(ISurface* target, ESURFACE_SCALE_FILTER filter = ESSF_NEAREST) = 0;
 
 	//! draws a line from to
-	virtual void drawLine(const core::position2d<s32>& from, const core::position2d<s32>& to, s16 color) = 0;
+	virtual void drawLine(const core::position2d<s32>& from, const core::position2d<s32>& to, Color color) = 0;
 
 	//! resizes the surface to a new size
-	virtual void resizeTo(const core::dimension2d<s32>& size) = 0;
+	virtual void resizeTo(const core::dimension2d<s32>& size, ESURFACE_SCALE_FILTER filter = ESSF_NEAREST) = 0;
 };
 
 
 //! creates a 16 bit surface
 ISurface* createSurface(const core::dimension2d<s32>& size);
 
+//! creates a surface with a color format. Formats other than EHCF_A8R8G8B8
+//! create a 16 bit EHCF_R5G5B5 surface.
+ISurface* createSurface(ECOLOR_FORMAT format, const core::dimension2d<s32>& size);
+
+//! creates an EHCF_P8 surface with a palette of 256x1 pixels. The palette
+//! is grabbed, so several surfaces can share it.
+ISurface* createPalettedSurface(ISurface* palette, const core::dimension2d<s32>& size);
+
 } // end namespace video
 } // end namespace irr
 
@@ -7,12 +7,33 @@
 
 #include "IUnknown.h"
 #include "dimension2d.h"
+#include "rect.h"
+#include "IVideoDriver.h"
 #include "S2DVertex.h"
 
 namespace irr
 {
 namespace video
 {
+	//! The z buffer keeps a z value for every block of 2^ZBUFFER_BLOCK_SHIFT
+	//! x 2^ZBUFFER_BLOCK_SHIFT pixels, so the renderers can skip triangles 
+	//! and parts of spans which are hidden behind the block.
+	const s32 ZBUFFER_BLOCK_SHIFT = 3;
+
+	//! a block of the hierarchical z buffer
+	struct SZBufferBlock
+	{
+		//! Not larger than any z value of the block. The z values only grow
+		//! until the next clear, so the value stays valid when pixels are
+		//! written, it only becomes less precise.
+		s32 MinZ;
+
+		//! Pixels were written since MinZ was calculated.
+		bool Dirty;
+	};
+
+	//! A z buffer storing 1/w for every pixel. The values are s16 or s32,
+	//! depending on the format, a cleared z buffer is all zero.
 	class IZBuffer : public IUnknown
 	{
 	public:
@@ -23,14 +44,39 @@ namespace video
 		//! clears the zbuffer
 		virtual void clear() = 0;
 
+		//! clears a rectangle of the zbuffer
+		virtual void clear(const core::rectEx<s32>& rect) = 0;
+
 		//! sets the new size of the zbuffer
 		virtual void setSize(const core::dimension2d<s32>& size) = 0;
 
 		//! returns the size of the zbuffer
 		virtual const core::dimension2d<s32>& getSize() = 0;
 
+		//! sets the format of the z values. The zbuffer is cleared.
+		virtual void setFormat(E_ZBUFFER_FORMAT format) = 0;
+
+		//! returns the format of the z values
+		virtual E_ZBUFFER_FORMAT getFormat() = 0;
+
+		//! returns the size of a z value in bytes
+		virtual s32 getBytesPerValue() = 0;
+
+		//! returns the z value of a vertex at the near plane, the values
+		//! of farther vertices are smaller.
+		virtual s32 getMaxValue() = 0;
+
 		//! locks the zbuffer
-		virtual TZBufferType* lock() = 0;
+		virtual void* lock() = 0;
+
+		//! returns the blocks of the hierarchical z buffer, row by row
+		virtual SZBufferBlock* lockBlocks() = 0;
+
+		//! returns the amount of blocks in a row
+		virtual s32 getBlockCountX() = 0;
+
+		//! calculates MinZ of a block from its z values and resets Dirty
+		virtual void updateBlock(s32 x, s32 y) = 0;
 
 		//! unlocks the zbuffer
 		virtual void unlock() = 0;
@@ -38,7 +84,7 @@ namespace video
 
 
 	//! creates a ZBuffer
-	IZBuffer* createZBuffer(const core::dimension2d<s32>& size);
+	IZBuffer* createZBuffer(const core::dimension2d<s32>& size, E_ZBUFFER_FORMAT format = EZF_16BIT);
 
 } // end namespace video
 } // end namespace irr
@@ -1,4 +1,7 @@
 #include <Irrlicht.h>
+
+#ifdef WIN32
+
 #include <windows.h>
 
 #ifdef _DEBUG
@@ -25,4 +28,6 @@ BOOL APIENTRY DllMain( HANDLE hModule,
 			break;
     }
     return TRUE;
-}
\ No newline at end of file
+}
+
+#endif
@@ -201,7 +201,7 @@ SOURCE=.\include\IFileSystem.h
 # End Source File
 # Begin Source File
 
-SOURCE=.\include\IReadFile.H
+SOURCE=.\include\IReadFile.h
 # End Source File
 # End Group
 # Begin Group "scene"
@@ -398,7 +398,7 @@ SOURCE=.\CGUIImage.cpp
 # End Source File
 # Begin Source File
 
-SOURCE=.\CGUIImage.H
+SOURCE=.\CGUIImage.h
 # End Source File
 # Begin Source File
 
@@ -7,6 +7,7 @@
 
 #include "aabbox3d.h"
 #include "array.h"
+#include "IVideoDriver.h"
 #include <memory.h>
 
 namespace irr
@@ -31,6 +32,7 @@ public:
 	struct SIndexChunk
 	{
 		core::array<u16> Indices;
+		core::array<u16> Occluders;	// the large triangles of the indices
 		s32 MaterialId;
 	};
 
@@ -84,6 +86,23 @@ public:
 		Root->getPolys(box, IndexData);
 	}
 
+	// returns all ids of polygons partially or full enclosed 
+	// by this bounding box, which may be visible from the camera.
+	// The large triangles of the nodes are drawn front to back into
+	// the occlusion buffer of the driver, and nodes behind them are
+	// skipped. The transformations of the driver have to be set.
+	// camera: position of the camera in object space.
+	// meshes: the meshes the tree was created with.
+	// occluders: if the polygons of a mesh hide what is behind them.
+	void calculatePolys(const core::aabbox3d<f32>& box, const core::vector3df& camera,
+		video::IVideoDriver* driver, const core::array<SMeshChunk>& meshes, const bool* occluders)
+	{
+		for (s32 i=0; i<IndexDataCount; ++i)
+			IndexData[i].CurrentSize = 0;
+
+		Root->getVisiblePolys(box, camera, driver, meshes, occluders, IndexData);
+	}
+
 	SIndexData* getIndexData()
 	{
 		return IndexData;
@@ -217,6 +236,36 @@ private:
 
 			} // end for all possible children
 
+			// the triangles which are large compared to the node are drawn
+			// as occluders. Small triangles hide little behind them, and 
+			// would make the occlusion buffer more expensive than what it
+			// saves.
+			core::vector3df extent = Box.MaxEdge - Box.MinEdge;
+			f32 size = extent.X;
+			if (extent.Y > size) size = extent.Y;
+			if (extent.Z > size) size = extent.Z;
+			f32 minArea = size * size / 64.0f;
+
+			for (u32 i=0; i<(*indices).size(); ++i)
+			{
+				SIndexChunk& chunk = (*indices)[i];
+
+				for (u32 t=0; t<chunk.Indices.size(); t+=3)
+				{
+					const core::vector3df& a = allmeshdata[i].Vertices[chunk.Indices[t]].Pos;
+					const core::vector3df& b = allmeshdata[i].Vertices[chunk.Indices[t+1]].Pos;
+					const core::vector3df& c = allmeshdata[i].Vertices[chunk.Indices[t+2]].Pos;
+
+					// the length of the cross product is twice the area
+					if ((b - a).crossProduct(c - a).getLength() >= 2.0f * minArea)
+					{
+						chunk.Occluders.push_back(chunk.Indices[t]);
+						chunk.Occluders.push_back(chunk.Indices[t+1]);
+						chunk.Occluders.push_back(chunk.Indices[t+2]);
+					}
+				}
+			}
+
 			IndexData = indices;
 		}
 
@@ -254,6 +303,62 @@ private:
 			}
 		}
 
+		// returns all ids of polygons partially or full enclosed 
+		// by this bounding box and not hidden by the occluders,
+		// and draws their large triangles as occluders.
+		void getVisiblePolys(const core::aabbox3d<f32>& box, const core::vector3df& camera,
+			video::IVideoDriver* driver, const core::array<SMeshChunk>& meshes,
+			const bool* occluders, SIndexData* idxdata)
+		{
+			if (!IndexData || !Box.intersectsWithBox(box) || !driver->isBoxVisible(Box))
+				return;
+
+			s32 cnt = (*IndexData).size();
+			for (s32 i=0; i<cnt; ++i)
+			{
+				s32 idxcnt = (*IndexData)[i].Indices.size();
+
+				if (idxcnt)
+				{
+					memcpy(&idxdata[i].Indices[idxdata[i].CurrentSize], 
+						&(*IndexData)[i].Indices[0], idxcnt * sizeof(s16));
+					idxdata[i].CurrentSize += idxcnt;
+
+					s32 occluderCount = (*IndexData)[i].Occluders.size();
+
+					if (occluders[i] && occluderCount)
+						driver->drawOccluders(meshes[i].Vertices.const_pointer(), 
+							meshes[i].Vertices.size(), &(*IndexData)[i].Occluders[0], occluderCount / 3);
+				}
+			}
+
+			// the children nearest to the camera first, so they 
+			// hide the ones behind them.
+			OctTreeNode* sorted[8];
+			f32 distance[8];
+			s32 count = 0;
+
+			for (s32 i=0; i<8; ++i)
+				if (Children[i])
+				{
+					core::vector3df d = (Children[i]->Box.MinEdge + Children[i]->Box.MaxEdge) / 2 - camera;
+					f32 dist = d.X*d.X + d.Y*d.Y + d.Z*d.Z;
+
+					s32 j = count++;
+					for (; j>0 && distance[j-1] > dist; --j)
+					{
+						sorted[j] = sorted[j-1];
+						distance[j] = distance[j-1];
+					}
+
+					sorted[j] = Children[i];
+					distance[j] = dist;
+				}
+
+			for (s32 i=0; i<count; ++i)
+				sorted[i]->getVisiblePolys(box, camera, driver, meshes, occluders, idxdata);
+		}
+
 	private:
 
 		core::aabbox3d<f32> Box;
@@ -7,8 +7,6 @@
 
 #include "vector2d.h"
 
-typedef signed short TZBufferType;
-
 namespace irr
 {
 namespace video
@@ -18,8 +16,9 @@ namespace video
 	{
 		core::vector2d<s32> Pos;		// position
 		core::vector2d<s32> TCoords;	// texture coordinates
-		TZBufferType ZValue;					// zvalue
-		s16 Color;
+		core::vector2d<s32> TCoords2;	// texture coordinates of the lightmap
+		s32 ZValue;								// 1/w, scaled to the z buffer format
+		s32 Color;								// A8R8G8B8 color
 	};
 
 
@@ -23,6 +23,13 @@ namespace video
 		return RGB16(color>>16, color>>8, color);
 	}
 
+	//! Converts a 32 bit A8R8G8B8 color to a 16 A1R5G5B5 color. The alpha
+	//! bit is set if the alpha value is 128 or more.
+	inline s16 A8R8G8B8toA1R5G5B5(s32 color)
+	{
+		return (((color >> 31) & 0x1)<<15) | RGB16(color>>16, color>>8, color);
+	}
+
 	//! Returns the red component from the color
 	inline s32 getRed(s16 color)
 	{
@@ -0,0 +1,39 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __I_FRAME_RECEIVER_H_INCLUDED__
+#define __I_FRAME_RECEIVER_H_INCLUDED__
+
+#include "irrTypes.h"
+#include "dimension2d.h"
+#include "ITexture.h"
+
+namespace irr
+{
+
+//! Interface of an object which can receive the finished frames of a headless device.
+/** Set it with IHeadlessDevice::setFrameReceiver(). Every time the software
+driver presents its back buffer, OnFrame() is called with the pixels of the
+finished frame. */
+class IFrameReceiver
+{
+public:
+
+	//! destructor
+	virtual ~IFrameReceiver() {};
+
+	//! Called when a frame was presented.
+	//! \param pixels: Pointer to the pixels of the frame, row by row.
+	//! The pointer is only valid during this call.
+	//! \param format: Color format of the pixels, video::EHCF_R5G5B5 or
+	//! video::EHCF_A8R8G8B8, depending on the bits the device was created with.
+	//! \param size: Size of the frame in pixels.
+	//! \param frameNumber: Number of the frame, starting with 0.
+	virtual void OnFrame(const void* pixels, video::ECOLOR_FORMAT format,
+		const core::dimension2d<s32>& size, u32 frameNumber) = 0;
+};
+
+} // end namespace
+
+#endif
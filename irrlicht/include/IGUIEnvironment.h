@@ -18,6 +18,8 @@ namespace irr
 		class IVideoDriver;
 	}
 
+	class ITimer;
+
 namespace gui
 {
 
@@ -59,6 +61,9 @@ public:
 	//! Returns the current video driver.
 	virtual video::IVideoDriver* getVideoDriver() = 0;
 
+	//! Returns the clock of the device, animated elements use this for timing.
+	virtual ITimer* getTimer() = 0;
+
 	//! Posts an input event to the environment.
 	virtual void postEventFromUser(SEvent event) = 0;
 
@@ -0,0 +1,65 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __I_HEADLESS_DEVICE_H_INCLUDED__
+#define __I_HEADLESS_DEVICE_H_INCLUDED__
+
+#include "IrrlichtDevice.h"
+#include "IFrameReceiver.h"
+
+namespace irr
+{
+	//! An Irrlicht device without a window. Create it with createHeadlessDevice().
+	/** The headless device renders into memory instead of a window, so it
+	can be used on machines without a display or a graphics card. Finished frames
+	of the software driver are kept in a ring of the last n frames and can be
+	handed to an IFrameReceiver. Input is not read from the system, but 
+	posted or scripted with postEventFromUser() and queueEvent().
+	*/
+	class IHeadlessDevice : public IrrlichtDevice
+	{
+	public:
+
+		//! destructor
+		virtual ~IHeadlessDevice() {};
+
+		//! Sets a receiver which gets every finished frame.
+		//! \param receiver: The new receiver, can be 0 to disable it.
+		virtual void setFrameReceiver(IFrameReceiver* receiver) = 0;
+
+		//! \return Returns the amount of frames presented so far.
+		virtual u32 getPresentedFrameCount() = 0;
+
+		//! Returns a frame out of the ring of the last presented frames.
+		//! \param age: Age of the frame. 0 is the last presented frame, 1 the one
+		//! before and so on.
+		//! \return Returns pointer to the pixels of the frame in the format
+		//! returned by getFrameFormat(), or 0 if there is no frame with this age.
+		//! The pointer is valid until the frame is overwritten by a newer one.
+		virtual const void* getFrame(u32 age) = 0;
+
+		//! \return Returns the color format of the frames, video::EHCF_R5G5B5 or
+		//! video::EHCF_A8R8G8B8.
+		virtual video::ECOLOR_FORMAT getFrameFormat() = 0;
+
+		//! \return Returns the size of the frames in pixels.
+		virtual const core::dimension2d<s32>& getFrameSize() = 0;
+
+		//! Posts an input event, as if it came from the user.
+		virtual void postEventFromUser(SEvent event) = 0;
+
+		//! Queues an input event which will be posted by run().
+		//! \param event: The event to post.
+		//! \param runCall: Number of the call to run() in which the event is posted,
+		//! starting with 0. If run() was already called more often, the event is
+		//! posted with the next call.
+		virtual void queueEvent(SEvent event, u32 runCall) = 0;
+
+		//! \return Returns how often run() was called so far.
+		virtual u32 getRunCount() = 0;
+	};
+
+} // end namespace
+
+#endif
@@ -0,0 +1,152 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __I_PROFILER_H_INCLUDED__
+#define __I_PROFILER_H_INCLUDED__
+
+#include "IUnknown.h"
+#include "array.h"
+
+namespace irr
+{
+	//! A measured zone of a profiled frame.
+	struct SProfileZone
+	{
+		//! Name of the zone. Must be a string which lives as long as the profiler,
+		//! usually a string literal.
+		const c8* Name;
+
+		//! Optional id, for example the id of the rendered scene node, -1 if not used.
+		s32 Id;
+
+		//! Index of the zone in SProfileFrame::Zones this zone is nested in, 
+		//! or -1 if this is a top level zone.
+		s32 Parent;
+
+		//! Nesting depth of the zone, 0 for top level zones.
+		u32 Depth;
+
+		//! Start of the zone in milliseconds, relative to the start of the frame.
+		f64 Start;
+
+		//! Time spent in the zone in milliseconds, including nested zones.
+		f64 Duration;
+	};
+
+	//! All zones measured during one frame.
+	struct SProfileFrame
+	{
+		//! Number of the frame, counted since the profiler has been created.
+		u32 FrameNumber;
+
+		//! Start of the frame in milliseconds of the system clock.
+		f64 Start;
+
+		//! Duration of the frame in milliseconds.
+		f64 Duration;
+
+		//! All zones of the frame, in the order they were entered. 
+		//! A parent is always stored before its children.
+		core::array<SProfileZone> Zones;
+	};
+
+	//! Hierarchical per frame CPU profiler.
+	/** The engine measures the time spent in the scene manager, in the single
+	scene nodes, in the video driver and in the gui environment with scoped 
+	zones. The zones of the last frames are kept in a ring and can be 
+	inspected or written into a trace file, which can be viewed with the 
+	chrome://tracing page of Google Chrome. A frame lasts from 
+	IVideoDriver::beginScene() until IVideoDriver::endScene().
+	The profiler is disabled by default, and costs nearly nothing then.
+	You can get it with IrrlichtDevice::getProfiler(). */
+	class IProfiler : public IUnknown
+	{
+	public:
+
+		//! constructor
+		IProfiler() : Enabled(false) {}
+
+		//! destructor
+		virtual ~IProfiler() {};
+
+		//! Enables or disables the profiler. 
+		virtual void setEnabled(bool enabled) = 0;
+
+		//! \return Returns true if the profiler is enabled.
+		bool isEnabled() const
+		{
+			return Enabled;
+		}
+
+		//! Sets how many of the last frames are kept. Removes all stored frames.
+		//! \param frameCount: Amount of frames kept in the ring, the default is 60.
+		virtual void setFrameRingSize(u32 frameCount) = 0;
+
+		//! \return Returns the amount of stored frames.
+		virtual u32 getStoredFrameCount() = 0;
+
+		//! Returns a stored frame.
+		//! \param age: 0 is the last finished frame, 1 the one before and so on.
+		//! \return Returns 0 if there is no such frame.
+		virtual const SProfileFrame* getFrame(u32 age) = 0;
+
+		//! Begins a new frame. Called by the video driver.
+		virtual void beginFrame() = 0;
+
+		//! Finishes the current frame and stores it in the ring. Called by the video driver.
+		virtual void endFrame() = 0;
+
+		//! Enters a zone. Zones may be nested. It is easier to use SProfileScope
+		//! instead of calling this directly.
+		//! \param name: Name of the zone, has to live as long as the profiler.
+		//! \param id: Optional id stored with the zone.
+		virtual void beginZone(const c8* name, s32 id=-1) = 0;
+
+		//! Leaves the zone entered last.
+		virtual void endZone() = 0;
+
+		//! Writes all stored frames into a file in the chrome trace event format.
+		//! \param filename: Name of the file to write.
+		//! \return Returns true if successful.
+		virtual bool writeChromeTrace(const c8* filename) = 0;
+
+	protected:
+
+		bool Enabled;
+	};
+
+
+	//! Measures the time from its construction until the end of the scope.
+	/** Does nothing if the profiler is 0 or disabled. Example:
+	\code
+	{
+		SProfileScope zone(profiler, "my zone");
+		doSomething();
+	}
+	\endcode */
+	class SProfileScope
+	{
+	public:
+
+		SProfileScope(IProfiler* profiler, const c8* name, s32 id=-1)
+			: Profiler(profiler && profiler->isEnabled() ? profiler : 0)
+		{
+			if (Profiler)
+				Profiler->beginZone(name, id);
+		}
+
+		~SProfileScope()
+		{
+			if (Profiler)
+				Profiler->endZone();
+		}
+
+	private:
+
+		IProfiler* Profiler;
+	};
+
+} // end namespace
+
+#endif
@@ -5,6 +5,7 @@
 #ifndef __I_READ_FILE_H_INCLUDED__
 #define __I_READ_FILE_H_INCLUDED__
 
+#include <stddef.h>
 #include "IUnknown.h"
 
 namespace irr
@@ -18,6 +18,9 @@ namespace io
 	class IFileSystem;
 }
 
+class ITimer;
+class IProfiler;
+
 namespace video
 {
 	class IVideoDriver;
@@ -94,6 +97,11 @@ namespace scene
 		//! This pointer should not be dropped. See IUnknown::drop() for more information.
 		virtual video::IVideoDriver* getVideoDriver() = 0;
 
+		//! Returns the clock all animations of the scene are driven by.
+		//! \return Returns pointer to the clock of the device.
+		//! This pointer should not be dropped. See IUnknown::drop() for more information.
+		virtual ITimer* getTimer() = 0;
+
 		//! Adds a test scene node for test purposes of the scene. It is a simple cube of (1,1,1) size. 
 		//! \param size: Size of the cube.
 		//! \param parent: Parent of the scene node. Can be NULL if no parent.
@@ -254,7 +262,7 @@ namespace scene
 
 
 	// creates a scenemanager
-	ISceneManager* createSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs);
+	ISceneManager* createSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs, ITimer* timer, IProfiler* profiler);
 
 } // end namespace scene
 } // end namespace irr
@@ -30,6 +30,10 @@ namespace video
 		//! Default 32 bit color format. 8 bits are used for every component:
 		//! red, green, blue and alpha.
 		EHCF_A8R8G8B8,
+
+		//! 8 bit indices into a palette of 256 colors, see ISurface::getPalette().
+		//! Only used by surfaces, textures return the format of their palette.
+		EHCF_P8,
 	};
 
 
@@ -0,0 +1,71 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __I_TIMER_H_INCLUDED__
+#define __I_TIMER_H_INCLUDED__
+
+#include "IUnknown.h"
+
+namespace irr
+{
+	//! Modes the clock of the device can run in.
+	enum ETIMER_MODE
+	{
+		//! The clock follows the real time of the system. This is the default.
+		ETM_REAL = 0,
+
+		//! The clock advances by a fixed amount of milliseconds every time 
+		//! IrrlichtDevice::run() is called, independent of how long a frame took.
+		//! Use this for frame accurate offline renders and reproduceable benchmarks.
+		ETM_FIXED_STEP,
+
+		//! The clock is stopped. All animations freeze until the mode is changed.
+		ETM_PAUSED
+	};
+
+	//! Clock of the device. 
+	/** All animators, animated meshes and the frames per second counter 
+	read the time from this clock instead of the system timer, so it
+	is possible to run the whole engine with a fixed time step or to 
+	pause it. You can get it with IrrlichtDevice::getTimer(). */
+	class ITimer : public IUnknown
+	{
+	public:
+
+		//! destructor
+		virtual ~ITimer() {};
+
+		//! \return Returns the current time of the clock in milliseconds.
+		virtual u32 getTime() = 0;
+
+		//! Sets the current time of the clock.
+		//! \param timeMs: New time in milliseconds.
+		virtual void setTime(u32 timeMs) = 0;
+
+		//! \return Returns the time of the system in milliseconds, independent
+		//! of the mode of the clock.
+		virtual u32 getRealTime() = 0;
+
+		//! Sets the mode of the clock. Switching modes does not make the clock jump, 
+		//! it continues from the time it had when the mode was changed.
+		virtual void setMode(ETIMER_MODE mode) = 0;
+
+		//! \return Returns the mode of the clock.
+		virtual ETIMER_MODE getMode() = 0;
+
+		//! Sets the time step used in the ETM_FIXED_STEP mode.
+		//! \param stepMs: Milliseconds the clock advances with every tick().
+		virtual void setFixedStep(u32 stepMs) = 0;
+
+		//! \return Returns the time step used in the ETM_FIXED_STEP mode.
+		virtual u32 getFixedStep() = 0;
+
+		//! Advances the clock by one step if it is in ETM_FIXED_STEP mode. 
+		//! This is done by IrrlichtDevice::run(), so usually there is no need to call it.
+		virtual void tick() = 0;
+	};
+
+} // end namespace
+
+#endif
@@ -9,11 +9,13 @@
 #include "Color.h"
 #include "ITexture.h"
 #include "matrix4.h"
+#include "aabbox3d.h"
 #include "dimension2d.h"
 #include "position2d.h"
 #include "IReadFile.h"
 #include "SMaterial.h"
 #include "SLight.h"
+#include "SRasterizerStatistics.h"
 
 namespace irr
 {
@@ -47,6 +49,18 @@ namespace video
 		TS_COUNT
 	};
 
+	//! Formats of the z buffer of the software driver.
+	enum E_ZBUFFER_FORMAT
+	{
+		//! 16 bit z values. Fast, but distant surfaces may flicker through
+		//! each other because of the low precision.
+		EZF_16BIT = 0,
+		//! 32 bit z values with 30 bits of precision.
+		EZF_32BIT,
+		//! Not used
+		EZF_COUNT
+	};
+
 	//! Interface to driver which is able to perform 2d and 3d gfx functions.
 	/** The IVideoDriver interface is one of the most important interfaces of
 	the Irrlicht Engine: All rendering and texture manipulating is done with
@@ -221,6 +235,134 @@ namespace video
 		//! Returns the maximal amount of dynamic lights the device can handle
 		//! \return Maximal amount of dynamic lights.
 		virtual s32 getMaximalDynamicLightAmount() = 0;
+
+		//! Enables or disables the counting of culled triangles, tested spans and pixels, 
+		//! failed z-tests and written pixels in the rasterizers. Only supported by the
+		//! software driver. The counters are reset by beginScene().
+		//! \param enabled: True to enable the statistics.
+		virtual void setRasterizerStatisticsEnabled(bool enabled) = 0;
+
+		//! Returns the amount of rasterizers the driver has statistics for.
+		//! \return Returns 0 if the driver does not support rasterizer statistics.
+		virtual s32 getRasterizerCount() = 0;
+
+		//! Returns the statistics of a rasterizer, counted since the last beginScene().
+		//! \param index: Index of the rasterizer, between 0 and getRasterizerCount()-1,
+		//! or -1 to get the sum of all rasterizers.
+		//! \return Returns 0 if the statistics are not available.
+		virtual const SRasterizerStatistics* getRasterizerStatistics(s32 index = -1) = 0;
+
+		//! Enables or disables the overdraw heat map. If enabled, the 3d scene is not
+		//! drawn normally, but every pixel of the back buffer shows how often it was
+		//! written, from black (never) over blue, green and yellow to red and white 
+		//! (8 times or more). Only supported by the software driver.
+		//! \param enabled: True to enable the heat map.
+		virtual void setOverdrawHeatMap(bool enabled) = 0;
+
+		//! Sets the amount of threads the 3d scene is rasterized with. With more
+		//! than one thread, the screen is split into tiles of rows over its
+		//! whole width, which are drawn in parallel. The triangles are then drawn when the scene is finished, 
+		//! before 2d drawing or when the render target is changed. Only 
+		//! supported by the software driver.
+		//! \param threadCount: Amount of threads. 1 (the default) draws every
+		//! triangle list immediately without tiles, 0 uses one thread per processor.
+		virtual void setRasterizerThreads(s32 threadCount) = 0;
+
+		//! Sets the format of the z buffer. The z values are 1/w, with the
+		//! largest value at the near plane of the projection, so the 
+		//! precision drops with the distance to the camera. 32 bit z values
+		//! remove most of the flickering of distant surfaces, at the cost 
+		//! of twice the memory bandwidth. Only supported by the software driver.
+		//! \param format: The new format, EZF_16BIT is the default.
+		virtual void setZBufferFormat(E_ZBUFFER_FORMAT format) = 0;
+
+		//! Enables or disables perspective correct texture mapping. When
+		//! disabled, the texture coordinates are interpolated linearly on the
+		//! screen, which distorts the textures of large triangles seen at a 
+		//! flat angle. When enabled, they are divided by the interpolated 1/w
+		//! once every 16 pixels, which costs some throughput. Only supported
+		//! by the software driver, disabled by default.
+		virtual void setPerspectiveCorrection(bool enabled) = 0;
+
+		//! Enables or disables bilinear filtering of the textures of
+		//! materials with the BilinearFilter flag. Every pixel is mixed from
+		//! the 4 nearest texels, which makes the texture fetch about 4 times
+		//! as expensive. Textures with mip maps are drawn with the mip map
+		//! fitting the size of every triangle either way. Only supported by
+		//! the software driver, disabled by default.
+		virtual void setBilinearFilter(bool enabled) = 0;
+
+		//! Selects if the textures created afterwards are stored in tiles
+		//! of 4x4 texels for the triangle renderers, which keeps the texels
+		//! around a texel mostly in the same cache line. Textures drawn at
+		//! a steep angle cause far fewer cache misses, at the cost of a
+		//! copy of every texture. ITexture::lock() still returns the texels
+		//! row by row. Only supported by the software driver, disabled by
+		//! default.
+		virtual void setTiledTextures(bool enabled) = 0;
+
+		//! Selects if the textures loaded from files afterwards are stored
+		//! with 8 bit indices into a palette of 256 colors, chosen for every
+		//! texture when it is loaded. They need half of the memory of 16 bit
+		//! textures and a quarter of 32 bit ones, and the renderers fetch
+		//! fewer cache lines, at the cost of the colors lost by quantizing.
+		//! ITexture::lock() still returns the pixels in the color format of
+		//! the texture. Only supported by the software driver, disabled by
+		//! default.
+		virtual void setPalettedTextures(bool enabled) = 0;
+
+		//! Selects if the textures created afterwards are dithered with an
+		//! ordered 4x4 pattern when their colors are reduced to 16 bit. The
+		//! pattern hides the bands of smooth color gradients, at the cost of
+		//! some noise. Only supported by the software driver with a 16 bit
+		//! back buffer, disabled by default.
+		virtual void setDitheredTextures(bool enabled) = 0;
+
+		//! Selects how materials of the type EMT_LIGHTMAP are drawn. By 
+		//! default, every pixel of the texture is modulated by the pixel of
+		//! the lightmap and brightened 4 times, like the hardware drivers do.
+		//! When precombined, the lightmap is only sampled at the vertices and
+		//! interpolated as vertex colors, which is faster but blurs the 
+		//! lighting of large triangles and cannot brighten the texture.
+		//! Only supported by the software driver, disabled by default.
+		virtual void setLightmapsPrecombined(bool precombined) = 0;
+
+		//! Enables or disables occlusion culling. When enabled, the scene
+		//! manager and the octree draw their geometry front to back into a 
+		//! low resolution occlusion buffer, and skip everything behind it.
+		//! Only supported by the software driver, enabled by default.
+		virtual void setOcclusionCullingEnabled(bool enabled) = 0;
+
+		//! Removes all occluders. Called by the scene manager before
+		//! the first scene node of a frame is rendered.
+		virtual void clearOcclusionBuffer() = 0;
+
+		//! Draws triangles into the occlusion buffer with the current
+		//! world, view and projection transformation. They hide
+		//! everything behind them from isBoxVisible(), but are not drawn 
+		//! to the screen.
+		//! \param vertices: Pointer to array of vertices.
+		//! \param vertexCount: Amount of vertices in the array.
+		//! \param indexList: Pointer to array of indizes.
+		//! \param triangleCount: amount of Triangles. Usually amount of indizes / 3.
+		virtual void drawOccluders(const S3DVertex* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount) = 0;
+
+		//! Draws triangles into the occlusion buffer with the current
+		//! world, view and projection transformation.
+		//! \param vertices: Pointer to array of vertices.
+		//! \param vertexCount: Amount of vertices in the array.
+		//! \param indexList: Pointer to array of indizes.
+		//! \param triangleCount: amount of Triangles. Usually amount of indizes / 3.
+		virtual void drawOccluders(const S3DVertex2TCoords* vertices, s32 vertexCount, const u16* indexList, s32 triangleCount) = 0;
+
+		//! Returns if a box may be visible with the current world, view 
+		//! and projection transformation.
+		//! \param box: Box in object space.
+		//! \return Returns false if the box is completely outside of the 
+		//! viewport or behind the occluders drawn since the last
+		//! clearOcclusionBuffer(), and true otherwise. Drivers without 
+		//! occlusion culling always return true.
+		virtual bool isBoxVisible(const core::aabbox3d<f32>& box) = 0;
 	};
 
 } // end namespace video
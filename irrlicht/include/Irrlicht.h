@@ -36,6 +36,7 @@
 #include "IEventReceiver.h"
 #include "IFileList.h"
 #include "IFileSystem.h"
+#include "IFrameReceiver.h"
 #include "IGUIButton.h"
 #include "IGUICheckbox.h"
 #include "IGUIElement.h"
@@ -48,10 +49,11 @@
 #include "IGUIScrollBar.h"
 #include "IGUISkin.h"
 #include "IGUIWindow.h"
+#include "IHeadlessDevice.h"
 #include "IMesh.h"
 #include "IMeshBuffer.h"
 #include "IQ3LevelMesh.h"
-#include "IReadFile.H"
+#include "IReadFile.h"
 #include "IrrlichtDevice.h"
 #include "irrmath.h"
 #include "irrstring.h"
@@ -80,11 +82,15 @@
 #include "SMeshBufferLightMap.h"
 #include "irrTypes.h"
 
+#ifdef WIN32
 #ifdef IRRLICHT_EXPORTS
 #define IRRLICHT_API __declspec(dllexport)
 #else
 #define IRRLICHT_API __declspec(dllimport)
 #endif
+#else
+#define IRRLICHT_API
+#endif
 
 //! Everything in the Irrlicht Engine can be found in this namespace.
 namespace irr
@@ -93,7 +99,8 @@ namespace irr
 	/** \param deviceType: Type of the device. This can currently be video::DT_NULL, 
 	video::DT_SOFTWARE,	video::DT_DIRECTX8 and video::DT_OPENGL.
 	\param windowSize: Size of the window or the video mode in fullscreen mode.
-	\param bits: Bits per pixel in fullscreen mode. Ignored if windowed mode.
+	\param bits: Bits per pixel in fullscreen mode. The software driver renders
+	with 32 bit colors if this is 32, and with 16 bit colors otherwise, also in windowed mode.
 	\param fullscreen: Should be set to true if the device should run in fullscreen. Otherwise
 		the device runs in window mode.
 	\param receiver: A user created event receiver.
@@ -103,6 +110,23 @@ namespace irr
 	IRRLICHT_API IrrlichtDevice* createDevice(video::EDriverType deviceType, 
 		const core::dimension2d<s32>& windowSize, u32 bits, bool fullscreen, IEventReceiver* receiver = 0);
 
+	//! Creates an Irrlicht device without a window, rendering only into memory.
+	/** On platforms other than Win32, createDevice() also returns a headless device.
+	\param deviceType: Type of the device. This can be video::DT_NULL or video::DT_SOFTWARE.
+	Other types will create a null device.
+	\param windowSize: Size of the back buffer.
+	\param frameRingSize: Amount of finished frames the device keeps in memory,
+	accessible with IHeadlessDevice::getFrame(). Can be 0.
+	\param receiver: A user created event receiver.
+	\param bits: Bits per pixel of the back buffer. The software driver renders
+	with 32 bit A8R8G8B8 colors if this is 32, and with 16 bit A1R5G5B5 colors otherwise.
+	\return Returns pointer to the created IHeadlessDevice or null if the 
+	device could not be created.
+	*/
+	IRRLICHT_API IHeadlessDevice* createHeadlessDevice(video::EDriverType deviceType, 
+		const core::dimension2d<s32>& windowSize, u32 frameRingSize = 1, IEventReceiver* receiver = 0,
+		u32 bits = 16);
+
 	// THE FOLLOWING IS AN EMPTY LIST OF ALL SUB NAMESPACES
 	// EXISTING ONLY FOR THE DOCUMENTION SOFTWARE DOXYGEN.
 
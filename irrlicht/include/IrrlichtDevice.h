@@ -14,6 +14,8 @@
 #include "IGUIEnvironment.h"
 #include "IEventReceiver.h"
 #include "ISceneManager.h"
+#include "ITimer.h"
+#include "IProfiler.h"
 
 namespace irr
 {
@@ -41,6 +43,14 @@ namespace irr
 		//! \return Returns a pointer to the scene manager.
 		virtual scene::ISceneManager* getSceneManager() = 0;
 
+		//! \return Returns a pointer to the clock of the device. All animations
+		//! and the frames per second counter are driven by this clock.
+		virtual ITimer* getTimer() = 0;
+
+		//! \return Returns a pointer to the profiler of the device. It is 
+		//! disabled by default, enable it with IProfiler::setEnabled().
+		virtual IProfiler* getProfiler() = 0;
+
 		//! Sets the caption of the window.
 		//! \param text: New text of the window caption.
 		virtual void setWindowCaption(const wchar_t* text) = 0;
@@ -37,7 +37,7 @@ struct S3DVertex
 
 	//! constructor
 	S3DVertex(const core::vector3df& pos, const core::vector3df& normal,
-		video::Color& color, const core::vector2d<f32>& tcoords)
+		const video::Color& color, const core::vector2d<f32>& tcoords)
 		: Pos(pos), Normal(normal), Color(color), TCoords(tcoords) {}
 
 	//! Position
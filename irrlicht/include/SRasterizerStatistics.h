@@ -0,0 +1,103 @@
+// Copyright (C) 2002-2003 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in Irrlicht.h
+
+#ifndef __S_RASTERIZER_STATISTICS_H_INCLUDED__
+#define __S_RASTERIZER_STATISTICS_H_INCLUDED__
+
+#include "irrTypes.h"
+
+namespace irr
+{
+namespace video  
+{
+
+//! structure holding the counters of a triangle rasterizer for one frame.
+/** Only the software driver fills this structure, see 
+IVideoDriver::setRasterizerStatisticsEnabled().
+*/
+struct SRasterizerStatistics
+{
+	SRasterizerStatistics() : Name(0)
+	{
+		reset();
+	}
+
+	//! sets all counters to zero.
+	void reset()
+	{
+		Triangles = 0;
+		BackFaceCulled = 0;
+		NearPlaneCulled = 0;
+		ViewPortCulled = 0;
+		DegenerateCulled = 0;
+		Clipped = 0;
+		HiZCulled = 0;
+		SpansTested = 0;
+		PixelsTested = 0;
+		ZTestFailed = 0;
+		PixelsWritten = 0;
+	}
+
+	//! adds the counters of another statistic to this one.
+	void add(const SRasterizerStatistics& other)
+	{
+		Triangles += other.Triangles;
+		BackFaceCulled += other.BackFaceCulled;
+		NearPlaneCulled += other.NearPlaneCulled;
+		ViewPortCulled += other.ViewPortCulled;
+		DegenerateCulled += other.DegenerateCulled;
+		Clipped += other.Clipped;
+		HiZCulled += other.HiZCulled;
+		SpansTested += other.SpansTested;
+		PixelsTested += other.PixelsTested;
+		ZTestFailed += other.ZTestFailed;
+		PixelsWritten += other.PixelsWritten;
+	}
+
+	//! Name of the rasterizer.
+	const c8* Name;
+
+	//! Triangles passed to the rasterizer.
+	u32 Triangles;
+
+	//! Triangles rejected because they were facing away from the camera.
+	u32 BackFaceCulled;
+
+	//! Triangles rejected because they were completely behind the near plane.
+	u32 NearPlaneCulled;
+
+	//! Triangles rejected because they were completely outside of the viewport.
+	u32 ViewPortCulled;
+
+	//! Triangles rejected because they had no width or height on the screen.
+	u32 DegenerateCulled;
+
+	//! Triangles which crossed the near plane or the guard band around the
+	//! viewport. The triangles they were clipped into are passed to the
+	//! rasterizer instead.
+	u32 Clipped;
+
+	//! Triangles rejected because they were hidden behind the pixels drawn
+	//! before them, in every block of the hierarchical z buffer they touched.
+	//! With several rasterizer threads, a triangle is counted for every 
+	//! screen tile it was hidden in.
+	u32 HiZCulled;
+
+	//! Horizontal spans the rasterizer walked through.
+	u32 SpansTested;
+
+	//! Pixels which were z-tested.
+	u32 PixelsTested;
+
+	//! Pixels which failed the z-test and were not drawn.
+	u32 ZTestFailed;
+
+	//! Pixels which were written into the render target.
+	u32 PixelsWritten;
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
@@ -44,7 +44,11 @@ typedef signed int			s32;
 
 //! 64 bit signed variable.
 /** This is a typedef for __int64, it ensures portability of the engine. */
+#ifdef _MSC_VER
 typedef __int64				s64; 
+#else
+typedef long long			s64; 
+#endif
 
 
 
@@ -59,7 +63,7 @@ typedef double				f64;
 
 } // end namespace
 
-#ifndef _WCHAR_T_DEFINED
+#if defined(_MSC_VER) && !defined(_WCHAR_T_DEFINED)
 //! A 16 bit wide character type.
 /**
 	Defines the wchar_t-type.
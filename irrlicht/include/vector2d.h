@@ -5,7 +5,8 @@
 #ifndef __IRR_POINT_2D_H_INCLUDED__
 #define __IRR_POINT_2D_H_INCLUDED__
 
-#include "irrTypes.h"
+#include <math.h>
+#include "irrmath.h"
 
 namespace irr
 {
@@ -90,7 +91,7 @@ public:
 	//! rotates the point around a center by an amount of degrees.
 	void rotateBy(f64 degrees, const vector2d<T>& center)
 	{
-		degrees *=gradPI2;
+		degrees *=GRAD_PI2;
 		T cs = (T)cos(degrees);
 		T sn = (T)sin(degrees);
 
@@ -106,7 +107,7 @@ public:
 	//! normalizes the vector.
 	void normalize()
 	{
-		f64 len = getLenght();
+		f64 len = getLength();
 		X /= len;
 		Y /= len;
 	}
@@ -88,12 +88,76 @@ namespace os
 		//return timeGetTime();
 	}
 
+	f64 Timer::getPreciseTime()
+	{
+		LARGE_INTEGER frequency, counter;
+		QueryPerformanceFrequency(&frequency);
+		QueryPerformanceCounter(&counter);
+		return (f64)counter.QuadPart * 1000.0 / (f64)frequency.QuadPart;
+	}
+
 } // end namespace os
 
 
 #else
 
-	// TODO: code a linux/unix/mac version
+// Linux/unix specific functions
+
+#include <string.h>
+#include <wchar.h>
+#include <sys/time.h>
+
+namespace irr
+{
+namespace os
+{
+
+	//! prints a debuginfo string
+	void Debuginfo::print(const c8* message, const c8* hint)
+	{
+		fprintf(stderr, "%s%s%s\n", message, hint ? ":" : " ", hint ? hint : " ");
+	}
+
+	//! prints a debuginfo string (unicode)
+	void Debuginfo::print(const wchar_t* message, const wchar_t* hint)
+	{
+		fprintf(stderr, "%ls%ls%ls\n", message, hint ? L":" : L" ", hint ? hint : L" ");
+	}
+
+	//! shows a warning message box
+	void Warning::show(const c8* warning, const c8* hint)
+	{
+		// there is no message box without a window system, so we only print it.
+		Warning::print(warning, hint);
+	}
+
+	//! shows a warning message box in unicode form
+	void Warning::show(const wchar_t* warning, const wchar_t* hint)
+	{
+		fprintf(stderr, "Warning: %ls%ls%ls\n", warning, hint ? L":" : L" ", hint ? hint : L" ");
+	}
+
+	//! prints a warning into the warning log
+	void Warning::print(const c8* message, const c8* hint)
+	{
+		fprintf(stderr, "Warning: %s%s%s\n", message, hint ? ":" : " ", hint ? hint : " ");
+	}
+
+	u32 Timer::getTime()
+	{
+		timeval tv;
+		gettimeofday(&tv, 0);
+		return (u32)(tv.tv_sec * 1000) + (u32)(tv.tv_usec / 1000);
+	}
+
+	f64 Timer::getPreciseTime()
+	{
+		timeval tv;
+		gettimeofday(&tv, 0);
+		return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+	}
+
+} // end namespace os
 
 #endif
 
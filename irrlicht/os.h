@@ -64,6 +64,10 @@ namespace os
 
 		//! returns the current time in milliseconds
 		static u32 getTime();
+
+		//! returns the current time in milliseconds with a resolution of 
+		//! microseconds or better. Used for profiling.
+		static f64 getPreciseTime();
 	};
 
 